@@ -0,0 +1,23 @@
+#include "alloc.h"
+
+void allocTrack(alloc_subsystem subsystem, size_t oldBytes, size_t newBytes, size_t requested)
+{
+	if (!sicStats) return;
+
+	// a block from before the stats were turned on is not in the usage, so it can't take the usage below zero
+	uint64_t* current = &sicStats->allocCurrent[subsystem];
+	*current = (*current > oldBytes) ? *current - oldBytes : 0;
+	*current += newBytes;
+	if (*current > sicStats->allocPeak[subsystem]) sicStats->allocPeak[subsystem] = *current;
+
+	sicStats->allocCurrentTotal = (sicStats->allocCurrentTotal > oldBytes) ? sicStats->allocCurrentTotal - oldBytes : 0;
+	sicStats->allocCurrentTotal += newBytes;
+	if (sicStats->allocCurrentTotal > sicStats->allocPeakTotal) sicStats->allocPeakTotal = sicStats->allocCurrentTotal;
+
+	if (newBytes > 0)
+	{
+		sicStats->allocCount[subsystem]++;
+		sicStats->allocations++;
+		sicStats->allocatedBytes += requested;
+	}
+}
@@ -0,0 +1,114 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef ALLOC_H
+#define ALLOC_H
+
+// Local includes //
+
+#include "stats.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <malloc.h>
+
+// Function declarations //
+
+/**
+ * @brief allocTrack is a function that moves the usage of a subsystem from oldBytes to newBytes and updates its peak. A block which is
+ * allocated is counted by its usable size, the same size which is taken off when it is freed, so the usage returns to zero.
+ *
+ * @param  subsystem - The subsystem the block belongs to.
+ * @param  oldBytes  - The usable size of the block before, 0 for a new block.
+ * @param  newBytes  - The usable size of the block after, 0 when it is freed.
+ * @param  requested - The number of bytes asked for, 0 when it is freed.
+ * @return void
+ */
+void allocTrack(alloc_subsystem subsystem, size_t oldBytes, size_t newBytes, size_t requested);
+
+/*
+ * The allocator is malloc, calloc, realloc and free with the subsystem the block is charged to. While sicStats is NULL that costs one untaken
+ * branch, and building with -DSIC_NO_STATS leaves only the plain call. A block has to be freed with the subsystem it was allocated with.
+ */
+
+/**
+ * @brief sicMalloc is malloc which charges the block to the given subsystem.
+ *
+ * @param  subsystem - The subsystem.
+ * @param  size      - The number of bytes.
+ * @return the block or NULL on error
+ */
+static inline void* sicMalloc(alloc_subsystem subsystem, size_t size)
+{
+	void* ptr = malloc(size);
+#ifndef SIC_NO_STATS
+	if (__builtin_expect(sicStats != NULL, 0) && ptr) allocTrack(subsystem, 0, malloc_usable_size(ptr), size);
+#else
+	(void)subsystem;
+#endif //SIC_NO_STATS
+	return ptr;
+}
+
+/**
+ * @brief sicCalloc is calloc which charges the block to the given subsystem.
+ *
+ * @param  subsystem - The subsystem.
+ * @param  count     - The number of elements.
+ * @param  size      - The size of an element.
+ * @return the zeroed block or NULL on error
+ */
+static inline void* sicCalloc(alloc_subsystem subsystem, size_t count, size_t size)
+{
+	void* ptr = calloc(count, size);
+#ifndef SIC_NO_STATS
+	if (__builtin_expect(sicStats != NULL, 0) && ptr) allocTrack(subsystem, 0, malloc_usable_size(ptr), count * size);
+#else
+	(void)subsystem;
+#endif //SIC_NO_STATS
+	return ptr;
+}
+
+/**
+ * @brief sicRealloc is realloc which charges the block to the given subsystem.
+ *
+ * @param  subsystem - The subsystem.
+ * @param  ptr       - The block to resize, or NULL.
+ * @param  size      - The new number of bytes.
+ * @return the resized block or NULL on error, in which case ptr is left as it was
+ */
+static inline void* sicRealloc(alloc_subsystem subsystem, void* ptr, size_t size)
+{
+#ifndef SIC_NO_STATS
+	size_t oldBytes = (__builtin_expect(sicStats != NULL, 0) && ptr) ? malloc_usable_size(ptr) : 0;
+	void* newPtr = realloc(ptr, size);
+	if (__builtin_expect(sicStats != NULL, 0) && newPtr) allocTrack(subsystem, oldBytes, malloc_usable_size(newPtr), size);
+	return newPtr;
+#else
+	(void)subsystem;
+	return realloc(ptr, size);
+#endif //SIC_NO_STATS
+}
+
+/**
+ * @brief sicFree is free for a block allocated with the given subsystem.
+ *
+ * @param  subsystem - The subsystem the block was allocated with.
+ * @param  ptr       - The block, may be NULL.
+ * @return void
+ */
+static inline void sicFree(alloc_subsystem subsystem, void* ptr)
+{
+#ifndef SIC_NO_STATS
+	if (__builtin_expect(sicStats != NULL, 0) && ptr) allocTrack(subsystem, malloc_usable_size(ptr), 0, 0);
+#else
+	(void)subsystem;
+#endif //SIC_NO_STATS
+	free(ptr);
+}
+
+#endif //ALLOC_H
@@ -0,0 +1,499 @@
+#include "assembler.h"
+
+// Structs //
+
+/**
+ * @brief asm_chunk is one piece of a source assembled by assembleBufferParallel. While lexing, session is the chunk's own session.
+ * While encoding, session is the merged session and firstLine/numLines are where the chunk's lines ended up in it.
+ */
+typedef struct {
+
+	const sic_assembler* assembler;
+	const char* text;
+	size_t len;
+	uint32_t firstLineNum;
+	uint32_t firstLine;
+	uint32_t numLines;
+	sic_session* session;
+	const sic_scoff_records* whole;
+	sic_scoff_records* records;
+	uint8_t failed;
+	uint32_t* remaining;
+
+} asm_chunk;
+
+sic_assembler* createAssembler(void)
+{
+	sic_assembler* assembler = (sic_assembler*)malloc(sizeof(sic_assembler));
+	if (!assembler)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the assembler.\n");
+		return NULL;
+	}
+
+	// construct the opcode table and the directive table
+	stats_clock clock;
+	trace_span span;
+	assembler->directiveTable = NULL;
+	assembler->objectFormat = SCOFF_FORMAT_TEXT;
+	assembler->emitLines = 0;
+	assembler->emitSymbols = 0;
+	statsBegin(&clock);
+	traceBegin(&span);
+	assembler->opTab = buildOpcodeTable();
+	traceEnd(&span, TRACE_CAT_PHASE, "optab_build", NULL);
+	statsEnd(&clock, STATS_PHASE_OPTAB);
+	if (assembler->opTab)
+	{
+		statsBegin(&clock);
+		traceBegin(&span);
+		assembler->directiveTable = buildDirectiveTable();
+		traceEnd(&span, TRACE_CAT_PHASE, "directive_table_build", NULL);
+		statsEnd(&clock, STATS_PHASE_DIRECTIVES);
+	}
+
+	if (!assembler->opTab || !assembler->directiveTable)
+	{
+		freeAssembler(assembler);
+		return NULL;
+	}
+
+#ifdef _DEBUG
+	printOptable(assembler->opTab);
+#endif //_DEBUG
+
+	return assembler;
+}
+
+void freeAssembler(sic_assembler* assembler)
+{
+	if (!assembler) return;
+
+	freeHashTableAndValues(assembler->directiveTable);
+	freeHashTableAndValues(assembler->opTab);
+	free(assembler);
+}
+
+uint8_t isAssemblySource(const char* name)
+{
+	const char* extensions[ASM_NUM_SOURCE_EXTENSIONS] = ASM_SOURCE_EXTENSIONS;
+	size_t len = strlen(name);
+
+	for (uint32_t i = 0; i < ASM_NUM_SOURCE_EXTENSIONS; i++)
+	{
+		size_t extLen = strlen(extensions[i]);
+		if (len > extLen && strcmp(name + len - extLen, extensions[i]) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief writeObject is a function that writes the records to the stream in the object format of the assembler.
+ *
+ * @param  assembler - The assembler
+ * @param  records   - The records to write
+ * @param  outStream - The stream
+ * @return records or NULL on error
+*/
+static sic_scoff_records* writeObject(const sic_assembler* assembler, sic_scoff_records* records, FILE* outStream)
+{
+	if (assembler->objectFormat == SCOFF_FORMAT_BIN)
+		return writeSCOFFBinToStream(records, outStream);
+	if (assembler->objectFormat == SCOFF_FORMAT_IMAGE)
+		return writeSCOFFImageToStream(records, outStream);
+	return writeSCOFFToStream(records, outStream);
+}
+
+assemble_status assembleFile(const sic_assembler* assembler, const char* filePath)
+{
+	FILE* SICFile = fopen(filePath, "r");
+	if (!SICFile)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", filePath);
+		return ASM_FAILED_OPEN;
+	}
+
+	assemble_status status = ASM_OKAY;
+	symbol_table* symbolTable = NULL;
+	sic_scoff_records* records = NULL;
+	sic_line_table* lineTable = NULL;
+	stats_clock clock;
+	trace_span span;
+
+	if (assembler->emitLines)
+	{
+		lineTable = createLineTable();
+		if (!lineTable)
+		{
+			fclose(SICFile);
+			return ASM_FAILED_SYMBOL_TABLE;
+		}
+	}
+
+	// Pass one //
+	statsBegin(&clock);
+	traceBegin(&span);
+	symbolTable = buildSymbolTable(SICFile, assembler->directiveTable, assembler->opTab, lineTable);
+	traceEnd(&span, TRACE_CAT_PHASE, "pass_one", filePath);
+	statsEnd(&clock, STATS_PHASE_PASS_ONE);
+	if (symbolTable != NULL)
+	{
+		STATS_ADD(symbols, symbolTable->ht->numElements);
+
+		// Pass two //
+		if (fseek(SICFile, 0L, SEEK_SET) == 0)
+		{
+			// Generate obj file
+			statsBegin(&clock);
+			traceBegin(&span);
+			records = generateSCOFFRecords(SICFile, assembler->directiveTable, assembler->opTab, symbolTable);
+			traceEnd(&span, TRACE_CAT_PHASE, "pass_two", filePath);
+			statsEnd(&clock, STATS_PHASE_PASS_TWO);
+			if (records != NULL)
+			{
+				STATS_ADD(textRecords, records->texts->numberOfElements);
+				STATS_ADD(modRecords, records->modifications->numberOfElements);
+
+				// write object file to disk
+				statsBegin(&clock);
+				traceBegin(&span);
+				sic_scoff_records* written = NULL;
+				if (assembler->objectFormat == SCOFF_FORMAT_BIN)
+					written = writeSCOFFBinToFile(records, (char*)filePath);
+				else if (assembler->objectFormat == SCOFF_FORMAT_IMAGE)
+					written = writeSCOFFImageToFile(records, (char*)filePath);
+				else
+					written = writeSCOFFToFile(records, (char*)filePath);
+				if (written == NULL || (lineTable && writeLineTableToFile(lineTable, filePath) == NULL) ||
+					(assembler->emitSymbols && writeSymbolMapToFile(symbolTable, filePath) == NULL))
+					status = ASM_FAILED_WRITING_TO_OBJ;
+				traceEnd(&span, TRACE_CAT_PHASE, "write", filePath);
+				statsEnd(&clock, STATS_PHASE_WRITE);
+			}
+			else
+				status = ASM_FAILED_RECORD_GEN;
+		}
+		else
+		{
+			fprintf(stderr, "[ERROR]: Can't seek to the beginning of the assembly file after pass one.\n");
+			status = ASM_FAILED_SEEK;
+		}
+	}
+	else
+		status = ASM_FAILED_SYMBOL_TABLE;
+
+	// clean up and free any allocated memory
+	switch (status)
+	{
+	case ASM_OKAY:
+	case ASM_FAILED_WRITING_TO_OBJ:
+		freeRecords(records);
+		// fall through
+	case ASM_FAILED_RECORD_GEN:
+	case ASM_FAILED_SEEK:
+		freeSymbolTable(symbolTable);
+		// fall through
+	case ASM_FAILED_SYMBOL_TABLE:
+	case ASM_FAILED_OPEN:
+	case ASM_FAILED_LEX:
+		break;
+	}
+	freeLineTable(lineTable);
+
+	if (fclose(SICFile) != 0)
+	{
+#ifdef _DEBUG
+		fprintf(stderr, "[WARN]: unable to close file pointer during cleanup.\n");
+#endif //_DEBUG
+	}
+
+	return status;
+}
+
+assemble_status assembleStream(const sic_assembler* assembler, FILE* inStream, FILE* outStream)
+{
+	assemble_status status = ASM_OKAY;
+	stats_clock clock;
+	trace_span span;
+
+	// lex every line once, the session keeps the per-line IR that pass two needs
+	statsBegin(&clock);
+	traceBegin(&span);
+	sic_session* session = loadSession(inStream, assembler->directiveTable, assembler->opTab);
+	traceEnd(&span, TRACE_CAT_PHASE, "lex", NULL);
+	statsEnd(&clock, STATS_PHASE_PASS_ONE);
+	if (!session) return ASM_FAILED_LEX;
+	STATS_ADD(lines, session->numLines);
+	STATS_ADD(symbols, session->numSymbols);
+
+	statsBegin(&clock);
+	traceBegin(&span);
+	sic_scoff_records* records = sessionGenerateRecords(session);
+	traceEnd(&span, TRACE_CAT_PHASE, "pass_two", NULL);
+	statsEnd(&clock, STATS_PHASE_PASS_TWO);
+	if (records != NULL)
+	{
+		STATS_ADD(textRecords, records->texts->numberOfElements);
+		STATS_ADD(modRecords, records->modifications->numberOfElements);
+
+		statsBegin(&clock);
+		traceBegin(&span);
+		if (writeObject(assembler, records, outStream) == NULL || fflush(outStream) != 0)
+			status = ASM_FAILED_WRITING_TO_OBJ;
+		traceEnd(&span, TRACE_CAT_PHASE, "write", NULL);
+		statsEnd(&clock, STATS_PHASE_WRITE);
+		freeRecords(records);
+	}
+	else
+		status = ASM_FAILED_RECORD_GEN;
+
+	freeSession(session);
+	return status;
+}
+
+assemble_status assembleBuffer(const sic_assembler* assembler, const char* source, size_t sourceLen, char** object, size_t* objectLen)
+{
+	*object = NULL;
+	*objectLen = 0;
+	if (sourceLen == 0)
+	{
+		fprintf(stderr, "[ERROR]: The assembly source is empty.\n");
+		return ASM_FAILED_LEX;
+	}
+
+	// wrap both buffers in streams so the stream pipeline can be reused as is
+	FILE* inStream = fmemopen((void*)source, sourceLen, "r");
+	FILE* outStream = open_memstream(object, objectLen);
+	if (!inStream || !outStream)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the in-memory streams for assembly.\n");
+		if (inStream) fclose(inStream);
+		if (outStream) fclose(outStream);
+		free(*object);
+		*object = NULL;
+		return ASM_FAILED_OPEN;
+	}
+
+	assemble_status status = assembleStream(assembler, inStream, outStream);
+	fclose(inStream);
+	if (fclose(outStream) != 0 && status == ASM_OKAY)
+		status = ASM_FAILED_WRITING_TO_OBJ;
+
+	if (status != ASM_OKAY)
+	{
+		free(*object);
+		*object = NULL;
+		*objectLen = 0;
+	}
+	return status;
+}
+
+/**
+ * @brief lexChunk is the scheduler task which lexes one chunk of a source into its own session.
+ *
+ * @param  arg - The asm_chunk* being lexed
+ * @return void
+*/
+static void lexChunk(void* arg)
+{
+	asm_chunk* chunk = (asm_chunk*)arg;
+	trace_span span;
+	traceBegin(&span);
+
+	chunk->session = createSession(chunk->assembler->directiveTable, chunk->assembler->opTab);
+	if (chunk->session)
+	{
+		chunk->session->firstLineNum = chunk->firstLineNum;
+		if (sessionAppendText(chunk->session, chunk->text, chunk->len) != SESSION_OKAY)
+			chunk->failed = 1;
+	}
+	else
+		chunk->failed = 1;
+
+	traceEnd(&span, TRACE_CAT_PHASE, "lex", NULL);
+	__atomic_sub_fetch(chunk->remaining, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief encodeChunk is the scheduler task which encodes the lines of one chunk into its own records.
+ *
+ * @param  arg - The asm_chunk* being encoded
+ * @return void
+*/
+static void encodeChunk(void* arg)
+{
+	asm_chunk* chunk = (asm_chunk*)arg;
+
+	trace_span span;
+	traceBegin(&span);
+
+	// modification records are named after the program so the chunk needs the header
+	chunk->records = createRecords();
+	if (chunk->records)
+	{
+		chunk->records->header = chunk->whole->header;
+		if (sessionEncodeLines(chunk->session, chunk->records, chunk->firstLine, chunk->firstLine + chunk->numLines) == NULL)
+			chunk->failed = 1;
+	}
+	else
+		chunk->failed = 1;
+
+	traceEnd(&span, TRACE_CAT_PHASE, "pass_two", NULL);
+	__atomic_sub_fetch(chunk->remaining, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief runChunks is a function that runs the task on every chunk through the scheduler and helps until all of them finished.
+ * A chunk which can't be queued is run right away. It returns 1 if any chunk failed.
+ *
+ * @param  sched     - The scheduler
+ * @param  task      - lexChunk or encodeChunk
+ * @param  chunks    - The chunks
+ * @param  numChunks - The number of chunks
+ * @param  remaining - The counter the chunks decrement
+ * @return 0 if every chunk succeeded, 1 otherwise
+*/
+static uint8_t runChunks(work_scheduler* sched, thread_pool_task task, asm_chunk* chunks, uint32_t numChunks, uint32_t* remaining)
+{
+	*remaining = numChunks;
+	for (uint32_t i = 0; i < numChunks; i++)
+	{
+		if (schedulerSubmit(sched, task, &chunks[i], chunks[i].len) == NULL)
+			task(&chunks[i]);
+	}
+	schedulerJoin(sched, remaining);
+
+	uint8_t failed = 0;
+	for (uint32_t i = 0; i < numChunks; i++)
+		failed |= chunks[i].failed;
+	return failed;
+}
+
+assemble_status assembleBufferParallel(const sic_assembler* assembler, work_scheduler* sched, const char* source, size_t sourceLen,
+	size_t chunkBytes, char** object, size_t* objectLen)
+{
+	if (!sched || chunkBytes == 0 || sourceLen <= chunkBytes)
+		return assembleBuffer(assembler, source, sourceLen, object, objectLen);
+
+	*object = NULL;
+	*objectLen = 0;
+	if (chunkBytes < ASM_MIN_CHUNK_BYTES) chunkBytes = ASM_MIN_CHUNK_BYTES;
+
+	uint32_t maxChunks = (uint32_t)(sourceLen / chunkBytes) + 1;
+	asm_chunk* chunks = (asm_chunk*)calloc(maxChunks, sizeof(asm_chunk));
+	if (!chunks)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the chunks of the source.\n");
+		return ASM_FAILED_LEX;
+	}
+
+	// cut after the first newline past every boundary so a chunk always starts a new line, the line numbers are counted up front for errors
+	uint32_t remaining = 0;
+	uint32_t numChunks = 0;
+	uint32_t lineNum = 0;
+	for (size_t pos = 0; pos < sourceLen; numChunks++)
+	{
+		size_t end = pos + chunkBytes;
+		if (end >= sourceLen)
+			end = sourceLen;
+		else
+		{
+			const char* newline = (const char*)memchr(source + end - 1, '\n', sourceLen - end + 1);
+			end = newline ? (size_t)(newline - source) + 1 : sourceLen;
+		}
+
+		asm_chunk* chunk = &chunks[numChunks];
+		chunk->assembler = assembler;
+		chunk->text = source + pos;
+		chunk->len = end - pos;
+		chunk->firstLineNum = lineNum;
+		chunk->remaining = &remaining;
+		lineNum += sessionTextLineCount(chunk->text, chunk->len);
+		pos = end;
+	}
+
+	// Pass one: lex every chunk in parallel, then merge them in order //
+	assemble_status status = ASM_OKAY;
+	sic_session* session = NULL;
+	sic_scoff_records* records = NULL;
+	trace_span span;
+
+	if (runChunks(sched, lexChunk, chunks, numChunks, &remaining) == 0)
+	{
+		// the merge is serial, it re-numbers the symbols and pushes every line size onto the prefix sums of the whole program
+		traceBegin(&span);
+		session = chunks[0].session;
+		chunks[0].session = NULL;
+		chunks[0].numLines = session->numLines;
+		for (uint32_t i = 1; i < numChunks && status == ASM_OKAY; i++)
+		{
+			chunks[i].firstLine = session->numLines;
+			chunks[i].numLines = chunks[i].session->numLines;
+			if (sessionAppendSession(session, chunks[i].session) != SESSION_OKAY)
+				status = ASM_FAILED_LEX;
+		}
+		traceEnd(&span, TRACE_CAT_PHASE, "merge", NULL);
+	}
+	else
+		status = ASM_FAILED_LEX;
+
+	// Pass two: check the whole program, encode every chunk in parallel, then join the records in order //
+	if (status == ASM_OKAY)
+	{
+		traceBegin(&span);
+		records = sessionBeginRecords(session);
+		traceEnd(&span, TRACE_CAT_PHASE, "resolve", NULL);
+		if (records)
+		{
+			for (uint32_t i = 0; i < numChunks; i++)
+			{
+				freeSession(chunks[i].session);
+				chunks[i].session = session;
+				chunks[i].whole = records;
+			}
+
+			if (runChunks(sched, encodeChunk, chunks, numChunks, &remaining) == 0)
+			{
+				for (uint32_t i = 0; i < numChunks; i++)
+				{
+					appendList(records->texts, chunks[i].records->texts);
+					appendList(records->modifications, chunks[i].records->modifications);
+				}
+			}
+			else
+				status = ASM_FAILED_RECORD_GEN;
+		}
+		else
+			status = ASM_FAILED_RECORD_GEN;
+	}
+
+	// write the joined records to the object buffer
+	if (status == ASM_OKAY)
+	{
+		traceBegin(&span);
+		FILE* outStream = open_memstream(object, objectLen);
+		if (!outStream || writeObject(assembler, records, outStream) == NULL)
+			status = ASM_FAILED_WRITING_TO_OBJ;
+		if (outStream && fclose(outStream) != 0)
+			status = ASM_FAILED_WRITING_TO_OBJ;
+		traceEnd(&span, TRACE_CAT_PHASE, "write", NULL);
+		if (status != ASM_OKAY)
+		{
+			free(*object);
+			*object = NULL;
+			*objectLen = 0;
+		}
+	}
+
+	// clean up and free any allocated memory
+	for (uint32_t i = 0; i < numChunks; i++)
+	{
+		if (chunks[i].records) freeRecords(chunks[i].records);
+		if (chunks[i].session != session) freeSession(chunks[i].session);
+	}
+	if (records) freeRecords(records);
+	freeSession(session);
+	free(chunks);
+	return status;
+}
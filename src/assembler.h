@@ -0,0 +1,157 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+// Local includes //
+
+#include "hash_table.h"
+#include "sic.h"
+#include "directive.h"
+#include "opcode.h"
+#include "scoff.h"
+#include "scoff_bin.h"
+#include "image.h"
+#include "session.h"
+#include "scheduler.h"
+#include "trace.h"
+#include "symbols.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define ASM_SOURCE_EXTENSIONS { ".sic", ".asm" }
+#define ASM_NUM_SOURCE_EXTENSIONS 2
+#define ASM_MIN_CHUNK_BYTES 4096
+
+// Structs and enums //
+
+/**
+ * @brief assemble_status enum is used to signal to the caller if anything went wrong during the assembly of a file, and at
+ * which step of the pipeline it happened. The error itself has already been printed to stderr.
+ */
+typedef enum
+{
+	ASM_OKAY = 0,
+	ASM_FAILED_OPEN,
+	ASM_FAILED_SYMBOL_TABLE,
+	ASM_FAILED_SEEK,
+	ASM_FAILED_RECORD_GEN,
+	ASM_FAILED_WRITING_TO_OBJ,
+	ASM_FAILED_LEX
+
+} assemble_status;
+
+/**
+ * @brief sic_assembler struct holds the tables which do not depend on the file being assembled. They are built once and
+ * only read afterwards, so one assembler can be shared by every file of a session and by several threads at once. The object
+ * format is the format every object is written in, the text SCOFF records unless it is set to binary after creation. When emitLines
+ * is set, assembleFile also writes the line table of each file next to its object, and when emitSymbols is set its symbol map.
+ */
+typedef struct
+{
+	hash_table* opTab;
+	hash_table* directiveTable;
+	scoff_format objectFormat;
+	uint8_t emitLines;
+	uint8_t emitSymbols;
+
+} sic_assembler;
+
+// Function declarations //
+
+/**
+ * @brief createAssembler is a function that builds the opcode table and the directive table. The function accepts nothing and returns
+ * the new assembler, or NULL if one of the tables could not be built.
+ *
+ * NOTE: that caller needs to free the memory after use by using freeAssembler().
+ *
+ * @param  void
+ * @return assembler or NULL on error
+ */
+sic_assembler* createAssembler(void);
+
+/**
+ * @brief freeAssembler is a function that frees the given assembler and its tables. The function returns nothing.
+ *
+ * @param  assembler - The assembler to be freed.
+ * @return void
+ */
+void freeAssembler(sic_assembler* assembler);
+
+/**
+ * @brief isAssemblySource is a function that checks if the file name ends with one of the SIC assembly source extensions (.sic or .asm).
+ *
+ * @param  name - The file name
+ * @return 1 if the file is an assembly source, 0 if not
+ */
+uint8_t isAssemblySource(const char* name);
+
+/**
+ * @brief assembleFile is a function that runs both passes over the SIC assembly file at the given path and writes the object file
+ * next to it, and the .lines and .syms files too if the assembler emits line tables and symbol maps. The function is reentrant, so several files can be assembled
+ * with the same assembler on different threads.
+ *
+ * @param  assembler - The assembler holding the opcode and directive tables.
+ * @param  filePath  - Path to the SIC assembly file.
+ * @return assemble status
+ */
+assemble_status assembleFile(const sic_assembler* assembler, const char* filePath);
+
+/**
+ * @brief assembleStream is a function that assembles SIC source read from a stream which can't be seeked, such as stdin, and writes the object
+ * file to another stream. The source is only read once. Each line is lexed into the compact IR of an assembly session, so only what pass two
+ * needs is buffered instead of the raw text.
+ *
+ * @param  assembler - The assembler holding the opcode and directive tables.
+ * @param  inStream  - The stream the SIC source is read from.
+ * @param  outStream - The stream the object file is written to.
+ * @return assemble status
+ */
+assemble_status assembleStream(const sic_assembler* assembler, FILE* inStream, FILE* outStream);
+
+/**
+ * @brief assembleBuffer is a function that assembles SIC source which is already in memory and returns the object file in a newly
+ * allocated buffer. It does no file I/O so the caller is free to read and write the files however it wants.
+ *
+ * NOTE: that caller needs to free the object buffer after use.
+ *
+ * @param  assembler - The assembler holding the opcode and directive tables.
+ * @param  source    - The SIC source, it does not need to be null-terminated.
+ * @param  sourceLen - The number of bytes in the source.
+ * @param  object    - Set to the allocated object file, or NULL on error.
+ * @param  objectLen - Set to the number of bytes in the object file.
+ * @return assemble status
+ */
+assemble_status assembleBuffer(const sic_assembler* assembler, const char* source, size_t sourceLen, char** object, size_t* objectLen);
+
+/**
+ * @brief assembleBufferParallel is a function that assembles a large in-memory source by splitting it into chunks of about chunkBytes,
+ * cut at line ends. The chunks are lexed into their own sessions as scheduler tasks, merged in order, checked, and then encoded as scheduler
+ * tasks again before their records are joined. The caller keeps helping the scheduler while it waits, so it may be a task itself.
+ * Sources no bigger than one chunk are assembled with assembleBuffer. The object is the same either way, but when several chunks have
+ * errors each of them is reported instead of only the first one.
+ *
+ * NOTE: that caller needs to free the object buffer after use.
+ *
+ * @param  assembler  - The assembler holding the opcode and directive tables.
+ * @param  sched      - The scheduler running the chunks, NULL to never split.
+ * @param  source     - The SIC source, it does not need to be null-terminated.
+ * @param  sourceLen  - The number of bytes in the source.
+ * @param  chunkBytes - The size of a chunk, 0 to never split.
+ * @param  object     - Set to the allocated object file, or NULL on error.
+ * @param  objectLen  - Set to the number of bytes in the object file.
+ * @return assemble status
+ */
+assemble_status assembleBufferParallel(const sic_assembler* assembler, work_scheduler* sched, const char* source, size_t sourceLen,
+	size_t chunkBytes, char** object, size_t* objectLen);
+
+#endif //ASSEMBLER_H
@@ -0,0 +1,438 @@
+#include "batch.h"
+#include "io_uring_engine.h"
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+/**
+ * @brief nowNs is a function that returns the monotonic clock in nanoseconds.
+ *
+ * @param  void
+ * @return current time in nanoseconds
+*/
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief addJob is a function that appends a job for the given source file to the batch. The object is written next to it
+ * with the .obj extension appended, the same as assembleFile does.
+ *
+ * @param  batch - The batch
+ * @param  path  - Path to the source file
+ * @return batch on success, NULL on error
+*/
+static sic_batch* addJob(sic_batch* batch, const char* path)
+{
+	if (batch->numJobs == batch->jobCapacity)
+	{
+		uint32_t newCapacity = batch->jobCapacity * 2;
+		batch_job* newJobs = (batch_job*)realloc(batch->jobs, newCapacity * sizeof(batch_job));
+		if (!newJobs)
+		{
+			fprintf(stderr, "[ERROR]: could not grow the batch job array.\n");
+			return NULL;
+		}
+		batch->jobs = newJobs;
+		batch->jobCapacity = newCapacity;
+	}
+
+	batch_job* job = &batch->jobs[batch->numJobs];
+	memset(job, 0, sizeof(batch_job));
+	size_t len = strlen(path);
+	const char* extension = SCOFF_OBJ_EXTENSION;
+	if (batch->assembler->objectFormat == SCOFF_FORMAT_BIN) extension = SCOFF_BIN_EXTENSION;
+	else if (batch->assembler->objectFormat == SCOFF_FORMAT_IMAGE) extension = IMAGE_EXTENSION;
+	job->sourcePath = (char*)malloc(len + 1);
+	job->objectPath = (char*)malloc(len + strlen(extension) + 1);
+	if (!job->sourcePath || !job->objectPath)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the paths of a batch job.\n");
+		free(job->sourcePath);
+		free(job->objectPath);
+		return NULL;
+	}
+	memcpy(job->sourcePath, path, len + 1);
+	memcpy(job->objectPath, path, len);
+	strcpy(job->objectPath + len, extension);
+
+	batch->numJobs++;
+	return batch;
+}
+
+sic_batch* createBatch(const sic_assembler* assembler, uint32_t numWorkers)
+{
+	sic_batch* batch = (sic_batch*)calloc(1, sizeof(sic_batch));
+	if (!batch)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the batch.\n");
+		return NULL;
+	}
+
+	batch->jobs = (batch_job*)malloc(BATCH_INITIAL_JOBS * sizeof(batch_job));
+	if (!batch->jobs)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the batch jobs.\n");
+		free(batch);
+		return NULL;
+	}
+
+	batch->assembler = assembler;
+	batch->jobCapacity = BATCH_INITIAL_JOBS;
+	batch->numWorkers = numWorkers;
+	return batch;
+}
+
+void freeBatch(sic_batch* batch)
+{
+	if (!batch) return;
+
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+	{
+		free(batch->jobs[i].sourcePath);
+		free(batch->jobs[i].objectPath);
+		free(batch->jobs[i].source);
+		free(batch->jobs[i].object);
+	}
+	free(batch->jobs);
+	free(batch);
+}
+
+sic_batch* batchAddPath(sic_batch* batch, const char* path)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", path);
+		return NULL;
+	}
+
+	if (!S_ISDIR(st.st_mode))
+		return addJob(batch, path);
+
+	// only the sources directly inside the directory are assembled
+	DIR* dir = opendir(path);
+	if (!dir)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the directory \"%s\": %s.\n", path, strerror(errno));
+		return NULL;
+	}
+
+	char filePath[SIC_LEN_BUFFER + 1];
+	size_t dirLen = strlen(path);
+	uint8_t needsSlash = (dirLen > 0 && path[dirLen - 1] != '/');
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN) continue;
+		if (!isAssemblySource(entry->d_name)) continue;
+
+		// a truncated path would assemble some other file, so a path which does not fit is skipped
+		int pathLen = snprintf(filePath, sizeof(filePath), "%s%s%s", path, needsSlash ? "/" : "", entry->d_name);
+		if (pathLen < 0 || (size_t)pathLen >= sizeof(filePath))
+		{
+			fprintf(stderr, "[WARN]: Skipped \"%s\", its path is longer than %d characters.\n", entry->d_name, SIC_LEN_BUFFER);
+			continue;
+		}
+		if (addJob(batch, filePath) == NULL)
+		{
+			closedir(dir);
+			return NULL;
+		}
+	}
+
+	closedir(dir);
+	return batch;
+}
+
+void batchCountSyscalls(sic_batch* batch, uint64_t count)
+{
+	__atomic_fetch_add(&batch->syscalls, count, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief readSource is a function that reads the whole source file of the job into memory with blocking syscalls.
+ *
+ * @param  batch - The batch, for the syscall counter
+ * @param  job   - The job being read
+ * @return ASM_OKAY or ASM_FAILED_OPEN
+*/
+static assemble_status readSource(sic_batch* batch, batch_job* job)
+{
+	int fd = open(job->sourcePath, O_RDONLY | O_CLOEXEC);
+	uint64_t syscalls = 1;
+	struct stat st;
+	if (fd < 0 || (syscalls++, fstat(fd, &st)) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", job->sourcePath);
+		if (fd >= 0) close(fd);
+		batchCountSyscalls(batch, syscalls + (fd >= 0));
+		return ASM_FAILED_OPEN;
+	}
+
+	assemble_status status = ASM_OKAY;
+	job->source = (char*)malloc(st.st_size > 0 ? (size_t)st.st_size : 1);
+	if (!job->source)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the source of \"%s\".\n", job->sourcePath);
+		status = ASM_FAILED_OPEN;
+	}
+
+	// short reads are retried until the size reported by fstat is reached or the file ends early
+	while (status == ASM_OKAY && job->sourceLen < (size_t)st.st_size)
+	{
+		ssize_t len = read(fd, job->source + job->sourceLen, (size_t)st.st_size - job->sourceLen);
+		syscalls++;
+		if (len < 0 && errno == EINTR) continue;
+		if (len < 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not read \"%s\": %s.\n", job->sourcePath, strerror(errno));
+			status = ASM_FAILED_OPEN;
+		}
+		if (len <= 0) break;
+		job->sourceLen += (size_t)len;
+	}
+
+	close(fd);
+	batchCountSyscalls(batch, syscalls + 1);
+	return status;
+}
+
+/**
+ * @brief writeObject is a function that writes the assembled object of the job to its object path with blocking syscalls.
+ *
+ * @param  batch - The batch, for the syscall counter
+ * @param  job   - The job being written
+ * @return ASM_OKAY or ASM_FAILED_WRITING_TO_OBJ
+*/
+static assemble_status writeObject(sic_batch* batch, batch_job* job)
+{
+	int fd = open(job->objectPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	uint64_t syscalls = 1;
+	if (fd < 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", job->objectPath);
+		batchCountSyscalls(batch, syscalls);
+		return ASM_FAILED_WRITING_TO_OBJ;
+	}
+
+	assemble_status status = ASM_OKAY;
+	size_t written = 0;
+	while (written < job->objectLen)
+	{
+		ssize_t len = write(fd, job->object + written, job->objectLen - written);
+		syscalls++;
+		if (len < 0 && errno == EINTR) continue;
+		if (len <= 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not write \"%s\": %s.\n", job->objectPath, strerror(errno));
+			status = ASM_FAILED_WRITING_TO_OBJ;
+			break;
+		}
+		written += (size_t)len;
+	}
+
+	if (close(fd) != 0) status = ASM_FAILED_WRITING_TO_OBJ;
+	batchCountSyscalls(batch, syscalls + 1);
+	return status;
+}
+
+/* @brief the argument of runThreadsJob, the job, the batch it belongs to, and the scheduler running it */
+typedef struct {
+	sic_batch* batch;
+	batch_job* job;
+	work_scheduler* sched;
+} batch_task;
+
+/**
+ * @brief runThreadsJob is the thread pool task of the threads engine. It reads, assembles, and writes one job, then frees its buffers.
+ *
+ * @param  arg - The batch_task* being run
+ * @return void
+*/
+static void runThreadsJob(void* arg)
+{
+	batch_task* task = (batch_task*)arg;
+	batch_job* job = task->job;
+	trace_span fileSpan, span;
+	traceBegin(&fileSpan);
+
+	traceBegin(&span);
+	job->status = readSource(task->batch, job);
+	traceEnd(&span, TRACE_CAT_IO, "read", job->sourcePath);
+	if (job->status == ASM_OKAY)
+		job->status = assembleBufferParallel(task->batch->assembler, task->sched, job->source, job->sourceLen, task->batch->chunkBytes,
+			&job->object, &job->objectLen);
+	free(job->source);
+	job->source = NULL;
+
+	if (job->status == ASM_OKAY)
+	{
+		traceBegin(&span);
+		job->status = writeObject(task->batch, job);
+		traceEnd(&span, TRACE_CAT_IO, "write_object", job->objectPath);
+	}
+	free(job->object);
+	job->object = NULL;
+
+	traceEnd(&fileSpan, TRACE_CAT_FILE, "file", job->sourcePath);
+}
+
+int runBatchThreads(sic_batch* batch)
+{
+	batch_task* tasks = (batch_task*)malloc(batch->numJobs * sizeof(batch_task));
+	sched_task* schedTasks = (sched_task*)malloc(batch->numJobs * sizeof(sched_task));
+	work_scheduler* sched = createScheduler(batch->numWorkers);
+	if (!tasks || !schedTasks || !sched)
+	{
+		fprintf(stderr, "[ERROR]: could not start the batch workers.\n");
+		free(tasks);
+		free(schedTasks);
+		freeScheduler(sched);
+		return 1;
+	}
+
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+	{
+		tasks[i].batch = batch;
+		tasks[i].job = &batch->jobs[i];
+		tasks[i].sched = sched;
+		schedTasks[i].task = runThreadsJob;
+		schedTasks[i].arg = &tasks[i];
+		schedTasks[i].cost = batch->jobs[i].cost;
+	}
+
+	// jobs which could not be queued are run here so every job gets a status
+	for (uint32_t i = schedulerSubmitAll(sched, schedTasks, batch->numJobs); i < batch->numJobs; i++)
+		runThreadsJob(schedTasks[i].arg);
+
+	schedulerWait(sched);
+	batch->numSteals = sched->numSteals;
+	freeScheduler(sched);
+	free(schedTasks);
+	free(tasks);
+	return 0;
+}
+
+/**
+ * @brief countFileLines is a function that maps the file and counts its newlines. It is the line count prescan of BATCH_COST_LINES.
+ *
+ * @param  batch - The batch, for the syscall counter
+ * @param  path  - The file to count
+ * @return number of lines, 0 if the file could not be read
+*/
+static uint64_t countFileLines(sic_batch* batch, const char* path)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		batchCountSyscalls(batch, (fd < 0) ? 1 : 3);
+		if (fd >= 0) close(fd);
+		return 0;
+	}
+
+	uint64_t numLines = 0;
+	const char* text = (const char*)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (text != MAP_FAILED)
+	{
+		// memchr is vectorized, so skipping from newline to newline is much faster than a byte loop
+		const char* end = text + st.st_size;
+		for (const char* ptr = text; ptr < end && (ptr = (const char*)memchr(ptr, '\n', (size_t)(end - ptr))) != NULL; ptr++)
+			numLines++;
+		if (text[st.st_size - 1] != '\n') numLines++;
+		munmap((void*)text, (size_t)st.st_size);
+	}
+
+	close(fd);
+	batchCountSyscalls(batch, 5);
+	return numLines;
+}
+
+/**
+ * @brief compareJobCost is the qsort comparator which orders jobs from the most to the least costly.
+ *
+ * @param  a - The first batch_job*
+ * @param  b - The second batch_job*
+ * @return negative if a costs more than b, positive if less, 0 if equal
+*/
+static int compareJobCost(const void* a, const void* b)
+{
+	uint64_t costA = ((const batch_job*)a)->cost;
+	uint64_t costB = ((const batch_job*)b)->cost;
+	return (costA < costB) - (costA > costB);
+}
+
+/**
+ * @brief scheduleJobs is a function that estimates the cost of every job with the cost model of the batch and sorts the jobs from the most
+ * to the least costly, so the biggest sources are started first whichever I/O engine runs them.
+ *
+ * @param  batch - The batch
+ * @return void
+*/
+static void scheduleJobs(sic_batch* batch)
+{
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+	{
+		batch_job* job = &batch->jobs[i];
+		if (batch->costModel == BATCH_COST_LINES)
+			job->cost = countFileLines(batch, job->sourcePath);
+		else
+		{
+			struct stat st;
+			job->cost = (stat(job->sourcePath, &st) == 0) ? (uint64_t)st.st_size : 0;
+			batchCountSyscalls(batch, 1);
+		}
+	}
+
+	qsort(batch->jobs, batch->numJobs, sizeof(batch_job), compareJobCost);
+}
+
+int runBatch(sic_batch* batch, batch_io_engine engine)
+{
+	if (batch->numJobs == 0)
+	{
+		fprintf(stderr, "[ERROR]: The batch has no .sic or .asm files to assemble.\n");
+		return 1;
+	}
+
+	uint64_t start = nowNs();
+	const char* engineName = "thread pool";
+	int result = -1;
+	scheduleJobs(batch);
+
+	if (engine != BATCH_IO_THREADS)
+	{
+		result = runBatchIoUring(batch);
+		if (result < 0)
+			fprintf(stderr, "[WARN]: io_uring is not available, falling back to the thread pool engine.\n");
+		else
+			engineName = "io_uring";
+	}
+	if (result < 0)
+		result = runBatchThreads(batch);
+	if (result != 0) return 1;
+
+	uint64_t elapsed = nowNs() - start;
+
+	batch->numFailed = 0;
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+		if (batch->jobs[i].status != ASM_OKAY)
+			batch->numFailed++;
+
+	double elapsedMs = elapsed / 1e6;
+	double filesPerSec = (elapsed > 0) ? batch->numJobs / (elapsed / 1e9) : 0.0;
+	printf("[INFO]: Assembled %u file(s), %u failed, in %.3f ms with the %s engine: %.1f files/sec, %.2f syscalls/file, %" PRIu64 " steal(s).\n",
+		batch->numJobs, batch->numFailed, elapsedMs, engineName, filesPerSec, (double)batch->syscalls / batch->numJobs, batch->numSteals);
+	fflush(stdout);
+
+	return (batch->numFailed == 0) ? 0 : 1;
+}
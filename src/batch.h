@@ -0,0 +1,148 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef BATCH_H
+#define BATCH_H
+
+// Local includes //
+
+#include "assembler.h"
+#include "scheduler.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define BATCH_INITIAL_JOBS 64
+
+// Structs and enums //
+
+/**
+ * @brief batch_io_engine enum selects how the files of a batch are read and written. BATCH_IO_AUTO uses io_uring when
+ * the kernel allows it and falls back to the thread pool otherwise.
+ */
+typedef enum {
+
+	BATCH_IO_AUTO = 0,
+	BATCH_IO_URING,
+	BATCH_IO_THREADS
+
+} batch_io_engine;
+
+/**
+ * @brief batch_cost_model enum selects how the cost of a job is estimated before the batch is scheduled. BATCH_COST_SIZE uses the
+ * file size from stat, BATCH_COST_LINES maps the file and counts its lines, which is closer to the real work when the line lengths differ a lot.
+ */
+typedef enum {
+
+	BATCH_COST_SIZE = 0,
+	BATCH_COST_LINES
+
+} batch_cost_model;
+
+/**
+ * @brief batch_job is one file of a batch. The source is read completely into memory, assembled with assembleBuffer, and
+ * the object is written out in one go, so the I/O engine is free to schedule the reads and writes of many jobs at once.
+ */
+typedef struct {
+
+	char* sourcePath;
+	char* objectPath;
+	char* source;
+	size_t sourceLen;
+	char* object;
+	size_t objectLen;
+	uint64_t cost;
+	assemble_status status;
+
+} batch_job;
+
+/**
+ * @brief sic_batch holds the jobs of a batch assembly and the counters reported at the end of it. The syscall counter is updated
+ * atomically since workers add to it concurrently. Sources bigger than chunkBytes are split into chunks assembled in parallel,
+ * 0 turns splitting off.
+ */
+typedef struct {
+
+	const sic_assembler* assembler;
+	batch_job* jobs;
+	uint32_t numJobs;
+	uint32_t jobCapacity;
+	uint32_t numWorkers;
+	uint32_t numFailed;
+	uint64_t syscalls;
+	uint64_t numSteals;
+	batch_cost_model costModel;
+	size_t chunkBytes;
+
+} sic_batch;
+
+// Function declarations //
+
+/**
+ * @brief createBatch is a function that allocates an empty batch which will assemble its files with the given assembler.
+ * The function returns the batch or NULL if an error occurred.
+ *
+ * NOTE: that caller needs to free the memory after use by using freeBatch().
+ *
+ * @param  assembler  - The assembler shared by every job.
+ * @param  numWorkers - Number of assembly worker threads, zero for one per CPU.
+ * @return batch or NULL on error
+ */
+sic_batch* createBatch(const sic_assembler* assembler, uint32_t numWorkers);
+
+/**
+ * @brief freeBatch is a function that frees the batch and its jobs. The function returns nothing.
+ *
+ * @param  batch - The batch to be freed.
+ * @return void
+ */
+void freeBatch(sic_batch* batch);
+
+/**
+ * @brief batchAddPath is a function that adds a file to the batch, or every .sic and .asm file directly inside the given directory.
+ * The function returns the batch on success or NULL if the path could not be read or a job could not be allocated.
+ *
+ * @param  batch - The batch the jobs are added to.
+ * @param  path  - A SIC assembly file or a directory of them.
+ * @return batch on success, NULL on error
+ */
+sic_batch* batchAddPath(sic_batch* batch, const char* path);
+
+/**
+ * @brief batchCountSyscalls is a function that adds to the syscall counter of the batch. It is safe to call from any thread.
+ *
+ * @param  batch - The batch being counted.
+ * @param  count - The number of syscalls made.
+ * @return void
+ */
+void batchCountSyscalls(sic_batch* batch, uint64_t count);
+
+/**
+ * @brief runBatchThreads is the thread pool I/O engine. Every job is a task of a work stealing scheduler which reads, assembles, and writes
+ * its own file with plain blocking syscalls. The jobs are dealt to the workers largest first. It is the fallback when io_uring is not available.
+ * The function returns 0 when every job could be run.
+ *
+ * @param  batch - The batch to run.
+ * @return 0 on success, 1 if the scheduler could not be started
+ */
+int runBatchThreads(sic_batch* batch);
+
+/**
+ * @brief runBatch is a function that estimates the cost of every job, orders them from the most to the least costly, and assembles them with the
+ * requested I/O engine. It reports the number of files, files per second, syscalls per file, and steals to stdout.
+ * The function returns 0 if every file assembled, 1 otherwise.
+ *
+ * @param  batch  - The batch to run.
+ * @param  engine - The I/O engine to use.
+ * @return 0 if every file assembled, 1 otherwise
+ */
+int runBatch(sic_batch* batch, batch_io_engine engine);
+
+#endif //BATCH_H
@@ -0,0 +1,139 @@
+#include "debugger.h"
+#include <inttypes.h>
+
+/**
+ * @brief parseAddress is a function that reads an address of a command, in hex or as :N for the first address of source line N.
+ *
+ * @param  arg       - The argument
+ * @param  lineTable - The line table, or NULL
+ * @param  address   - Set to the address
+ * @return 1 if the argument is an address, 0 if not
+*/
+static uint8_t parseAddress(const char* arg, const sic_line_table* lineTable, uint32_t* address)
+{
+	char* end = NULL;
+	if (arg[0] == ':')
+	{
+		unsigned long line = strtoul(arg + 1, &end, 10);
+		if (!lineTable || end == arg + 1 || *end != '\0') return 0;
+		for (uint32_t i = 0; i < lineTable->numEntries; i++)
+		{
+			if (lineTable->entries[i].line != line) continue;
+			*address = lineTable->entries[i].address;
+			return 1;
+		}
+		return 0;
+	}
+
+	unsigned long value = strtoul(arg, &end, 16);
+	if (end == arg || *end != '\0' || value >= SIM_MEMORY_SIZE) return 0;
+	*address = (uint32_t)value;
+	return 1;
+}
+
+/**
+ * @brief printStop is a function that prints why the machine stopped and where, with the source line when there is a line table.
+ *
+ * @param  machine   - The machine
+ * @param  lineTable - The line table, or NULL
+ * @param  out       - Where to print
+ * @return void
+*/
+static void printStop(const sic_machine* machine, const sic_line_table* lineTable, FILE* out)
+{
+	uint32_t line = lineTable ? findLine(lineTable, machine->PC) : LINES_NO_LINE;
+	if (line != LINES_NO_LINE) fprintf(out, "[INFO : %u]: ", line);
+	else fprintf(out, "[INFO]: ");
+
+	fprintf(out, "Stopped with %s at PC %06X after %" PRIu64 " instructions", simStatusName(machine->status), machine->PC,
+		machine->instructions);
+	if (machine->status == SIM_WATCHPOINT)
+		fprintf(out, ", on a %s of %06X", (machine->debug->watchKind == SIM_WATCH_WRITE) ? "write" : "read", machine->debug->watchAddress);
+	else if (machine->status > SIM_LIMIT)
+		fprintf(out, ", address %06X", machine->faultAddress);
+	fprintf(out, ".\n");
+}
+
+/**
+ * @brief dumpMemory is a function that prints the bytes from the address in rows of hex.
+ *
+ * @param  machine - The machine
+ * @param  address - The first byte
+ * @param  len     - The number of bytes
+ * @param  out     - Where to print
+ * @return void
+*/
+static void dumpMemory(const sic_machine* machine, uint32_t address, uint32_t len, FILE* out)
+{
+	if (len > SIM_MEMORY_SIZE - address) len = SIM_MEMORY_SIZE - address;
+	for (uint32_t row = 0; row < len; row += DEBUGGER_DUMP_BYTES)
+	{
+		fprintf(out, "%06X:", address + row);
+		for (uint32_t i = row; i < len && i < row + DEBUGGER_DUMP_BYTES; i++)
+			fprintf(out, " %02X", machine->memory[address + i]);
+		fprintf(out, "\n");
+	}
+}
+
+sim_status runDebugger(sic_machine* machine, const sic_line_table* lineTable, uint64_t maxInstructions, FILE* in, FILE* out)
+{
+	char line[DEBUGGER_LINE_LEN];
+	sim_status status = SIM_RUNNING;
+
+	fprintf(out, DEBUGGER_PROMPT);
+	fflush(out);
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		char command[DEBUGGER_LINE_LEN] = { 0 }, arg[DEBUGGER_LINE_LEN] = { 0 }, count[DEBUGGER_LINE_LEN] = { 0 };
+		int numArgs = sscanf(line, "%255s %255s %255s", command, arg, count);
+		uint32_t address = 0;
+		uint8_t hasAddress = numArgs >= 2 && parseAddress(arg, lineTable, &address);
+		unsigned long len = (numArgs >= 3) ? strtoul(count, NULL, 0) : 0;
+		uint8_t finished = status == SIM_HALTED || status == SIM_RETURNED || status > SIM_LIMIT;
+
+		if (numArgs <= 0) { }
+		else if (strcmp(command, "q") == 0 || strcmp(command, "quit") == 0)
+			break;
+		else if ((strcmp(command, "b") == 0 || strcmp(command, "break") == 0) && hasAddress)
+		{
+			if (setBreakpoint(machine, address, 1)) fprintf(out, "[INFO]: Breakpoint at %06X.\n", address);
+		}
+		else if ((strcmp(command, "d") == 0 || strcmp(command, "delete") == 0) && hasAddress)
+		{
+			if (setBreakpoint(machine, address, 0)) fprintf(out, "[INFO]: Deleted the breakpoint at %06X.\n", address);
+		}
+		else if ((strcmp(command, "w") == 0 || strcmp(command, "watch") == 0 || strcmp(command, "rw") == 0 || strcmp(command, "rwatch") == 0 ||
+			strcmp(command, "aw") == 0 || strcmp(command, "awatch") == 0 || strcmp(command, "uw") == 0 || strcmp(command, "unwatch") == 0) &&
+			hasAddress)
+		{
+			uint8_t kinds = (command[0] == 'w') ? SIM_WATCH_WRITE : (command[0] == 'r') ? SIM_WATCH_READ :
+				(command[0] == 'a') ? SIM_WATCH_READ | SIM_WATCH_WRITE : 0;
+			if (len == 0) len = SIC_WORD_BYTES;
+			if (len <= SIM_MEMORY_SIZE && setWatchpoint(machine, address, (uint32_t)len, kinds))
+				fprintf(out, "[INFO]: %s %lu bytes at %06X.\n", kinds ? "Watching" : "Stopped watching", len, address);
+		}
+		else if (strcmp(command, "c") == 0 || strcmp(command, "continue") == 0 || strcmp(command, "s") == 0 || strcmp(command, "step") == 0)
+		{
+			// a step takes its count as the first argument
+			uint64_t steps = (numArgs >= 2) ? strtoull(arg, NULL, 0) : 1;
+			if (finished) fprintf(out, "[WARN]: The program is not running any more.\n");
+			else
+			{
+				status = runMachine(machine, (command[0] == 's') ? (steps ? steps : 1) : maxInstructions);
+				printStop(machine, lineTable, out);
+			}
+		}
+		else if (strcmp(command, "r") == 0 || strcmp(command, "regs") == 0)
+			fprintf(out, "A=%06X X=%06X L=%06X SW=%06X PC=%06X\n", machine->A, machine->X, machine->L, machine->SW, machine->PC);
+		else if ((strcmp(command, "x") == 0) && hasAddress)
+			dumpMemory(machine, address, len ? (uint32_t)len : DEBUGGER_DUMP_BYTES, out);
+		else
+			fprintf(out, "[WARN]: Unknown command or bad address \"%s\". The commands are break, delete, watch, rwatch, awatch, unwatch, "
+				"continue, step, regs, x and quit.\n", line[strlen(line) - 1] == '\n' ? strtok(line, "\n") : line);
+
+		fprintf(out, DEBUGGER_PROMPT);
+		fflush(out);
+	}
+	fprintf(out, "\n");
+	return status;
+}
@@ -0,0 +1,49 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef DEBUGGER_H // command line debugger of the SIC simulator
+#define DEBUGGER_H
+
+// Local includes //
+
+#include "sim.h"
+#include "lines.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define DEBUGGER_LINE_LEN 256
+#define DEBUGGER_PROMPT "(sicdb) "
+#define DEBUGGER_DUMP_BYTES 16 // bytes dumped by x when no length is given, and bytes per row of the dump
+
+// Function declarations //
+
+/**
+ * @brief runDebugger is a function that reads debugger commands from the stream until the input ends or the quit command, and runs
+ * the loaded machine as they say. The commands are:
+ *   break <at>, delete <at>              set or clear a breakpoint
+ *   watch <at> [len], rwatch, awatch     stop before a write, a read, or either, of the bytes (a word by default)
+ *   unwatch <at> [len]                   stop watching the bytes
+ *   continue, step [n]                   run until something stops the machine, or run n instructions
+ *   regs, x <at> [len]                   print the registers, or dump memory
+ *   quit
+ * An address <at> is in hex, or :N for the first address of source line N when there is a line table. Each command can be shortened
+ * to its first letter, and rw, aw and uw are the watch commands. maxInstructions limits each continue, 0 meaning no limit.
+ *
+ * @param  machine         - The loaded machine.
+ * @param  lineTable       - The line table of the program, or NULL.
+ * @param  maxInstructions - The most instructions a continue runs, 0 for no limit.
+ * @param  in              - Where the commands are read from.
+ * @param  out             - Where the debugger prints.
+ * @return the status the machine last stopped with, SIM_RUNNING if it never ran
+ */
+sim_status runDebugger(sic_machine* machine, const sic_line_table* lineTable, uint64_t maxInstructions, FILE* in, FILE* out);
+
+#endif //DEBUGGER_H
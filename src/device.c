@@ -0,0 +1,214 @@
+#include "device.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+
+/**
+ * @brief createStream is a function that puts a buffer in front of a file descriptor and adds the stream to the devices.
+ *
+ * @param  devices - The devices
+ * @param  fd      - The file descriptor
+ * @param  writing - 1 for an output stream, 0 for an input stream
+ * @param  ownsFd  - 1 if the stream closes the descriptor when it is freed
+ * @return stream or NULL on error
+*/
+static sic_stream* createStream(sic_devices* devices, int fd, uint8_t writing, uint8_t ownsFd)
+{
+	sic_stream* stream = (sic_stream*)sicCalloc(ALLOC_OTHER, 1, sizeof(sic_stream));
+	uint8_t* buffer = (uint8_t*)sicMalloc(ALLOC_OTHER, DEVICE_BUFFER_SIZE);
+	if (!stream || !buffer || devices->numStreams == DEVICE_MAX_STREAMS)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the buffer of a device.\n");
+		sicFree(ALLOC_OTHER, stream);
+		sicFree(ALLOC_OTHER, buffer);
+		return NULL;
+	}
+
+	stream->fd = fd;
+	stream->writing = writing;
+	stream->ownsFd = ownsFd;
+	stream->buffer = buffer;
+	devices->streams[devices->numStreams++] = stream;
+	return stream;
+}
+
+/**
+ * @brief flushStream is a function that writes out the buffer of an output stream. A failed stream prints its error once and drops
+ * everything written to it after.
+ *
+ * @param  stream - The output stream
+ * @return 1 if the buffer was written, 0 if not
+*/
+static uint8_t flushStream(sic_stream* stream)
+{
+	size_t done = 0;
+	while (!stream->failed && done < stream->len)
+	{
+		ssize_t written = write(stream->fd, stream->buffer + done, stream->len - done);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not write to a device: %s.\n", strerror(errno));
+			stream->failed = 1;
+		}
+		else done += (size_t)written;
+	}
+	stream->len = 0;
+	return !stream->failed;
+}
+
+sic_devices* createDevices(void)
+{
+	sic_devices* devices = (sic_devices*)sicCalloc(ALLOC_OTHER, 1, sizeof(sic_devices));
+	if (!devices)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the devices.\n");
+		return NULL;
+	}
+
+	// the first two streams are always stdin and stdout
+	sic_stream* input = createStream(devices, STDIN_FILENO, 0, 0);
+	sic_stream* output = input ? createStream(devices, STDOUT_FILENO, 1, 0) : NULL;
+	if (!output)
+	{
+		freeDevices(devices);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < DEVICE_COUNT; i++)
+	{
+		devices->devices[i].input = input;
+		devices->devices[i].output = output;
+	}
+	return devices;
+}
+
+void freeDevices(sic_devices* devices)
+{
+	if (!devices) return;
+
+	flushDevices(devices);
+	for (uint32_t i = 0; i < devices->numStreams; i++)
+	{
+		if (devices->streams[i]->ownsFd) close(devices->streams[i]->fd);
+		sicFree(ALLOC_OTHER, devices->streams[i]->buffer);
+		sicFree(ALLOC_OTHER, devices->streams[i]);
+	}
+	sicFree(ALLOC_OTHER, devices);
+}
+
+sic_devices* mapDevice(sic_devices* devices, uint8_t number, const char* path, uint8_t writing)
+{
+	sic_stream* stream = NULL;
+	if (strcmp(path, "-") == 0)
+		stream = devices->streams[writing ? 1 : 0];
+	else
+	{
+		int fd = writing ? open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\" for device %02X\n", path, number);
+			return NULL;
+		}
+		stream = createStream(devices, fd, writing, 1);
+		if (!stream)
+		{
+			close(fd);
+			return NULL;
+		}
+	}
+
+	if (writing) devices->devices[number].output = stream;
+	else devices->devices[number].input = stream;
+	return devices;
+}
+
+sic_devices* redirectDevices(sic_devices* devices, const char* path, uint8_t writing)
+{
+	int fd = writing ? open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", path);
+		return NULL;
+	}
+
+	// the stdin or stdout stream is pointed at the file, so every device which has not been mapped follows it
+	sic_stream* stream = devices->streams[writing ? 1 : 0];
+	if (writing) flushStream(stream);
+	if (stream->ownsFd) close(stream->fd);
+	stream->fd = fd;
+	stream->ownsFd = 1;
+	stream->pos = stream->len = 0;
+	stream->eof = stream->failed = 0;
+	return devices;
+}
+
+int deviceRead(sic_devices* devices, uint8_t number)
+{
+	sic_device* device = &devices->devices[number];
+	sic_stream* stream = device->input;
+	if (stream->pos == stream->len)
+	{
+		if (stream->eof) return DEVICE_EOF;
+
+		flushDevices(devices);
+		ssize_t got;
+		do got = read(stream->fd, stream->buffer, DEVICE_BUFFER_SIZE);
+		while (got < 0 && errno == EINTR);
+		if (got <= 0)
+		{
+			if (got < 0) fprintf(stderr, "[ERROR]: Could not read from device %02X: %s.\n", number, strerror(errno));
+			stream->eof = 1;
+			return DEVICE_EOF;
+		}
+		stream->pos = 0;
+		stream->len = (size_t)got;
+	}
+
+	device->bytesRead++;
+	return stream->buffer[stream->pos++];
+}
+
+void deviceWrite(sic_devices* devices, uint8_t number, uint8_t byte)
+{
+	sic_device* device = &devices->devices[number];
+	sic_stream* stream = device->output;
+	if (stream->len == DEVICE_BUFFER_SIZE) flushStream(stream);
+
+	stream->buffer[stream->len++] = byte;
+	device->bytesWritten++;
+}
+
+uint8_t deviceTest(sic_devices* devices, uint8_t number)
+{
+	sic_device* device = &devices->devices[number];
+	device->tests++;
+	if (device->busyLeft > 0)
+	{
+		device->busyLeft--;
+		return 0;
+	}
+
+	device->busyLeft = devices->throttle;
+	return 1;
+}
+
+uint8_t flushDevices(sic_devices* devices)
+{
+	uint8_t flushed = 1;
+	for (uint32_t i = 0; i < devices->numStreams; i++)
+		if (devices->streams[i]->writing && !flushStream(devices->streams[i])) flushed = 0;
+	return flushed;
+}
+
+void printDeviceStats(const sic_devices* devices, FILE* stream)
+{
+	for (uint32_t i = 0; i < DEVICE_COUNT; i++)
+	{
+		const sic_device* device = &devices->devices[i];
+		if (!device->bytesRead && !device->bytesWritten && !device->tests) continue;
+		fprintf(stream, "[INFO]: Device %02X read %" PRIu64 " bytes, wrote %" PRIu64 " bytes, and was tested %" PRIu64 " times.\n", i,
+			device->bytesRead, device->bytesWritten, device->tests);
+	}
+}
@@ -0,0 +1,166 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef DEVICE_H // devices of the SIC simulator
+#define DEVICE_H
+
+// Local includes //
+
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define DEVICE_COUNT 256 // the device of RD, WD and TD is a byte
+#define DEVICE_BUFFER_SIZE (64 * 1024) // bytes moved by each read or write system call
+#define DEVICE_MAX_STREAMS (2 + 2 * DEVICE_COUNT) // stdin and stdout, and an input and an output for every device
+#define DEVICE_EOF -1
+
+// Structs and enums //
+
+/**
+ * @brief sic_stream is a host file or pipe with a buffer in front of it. An input stream is read DEVICE_BUFFER_SIZE bytes at a time and
+ * an output stream is written when its buffer is full or flushed, so RD and WD almost never make a system call.
+ */
+typedef struct
+{
+	int fd;
+	uint8_t writing;
+	uint8_t eof;
+	uint8_t failed;
+	uint8_t ownsFd;
+	size_t pos;
+	size_t len;
+	uint8_t* buffer;
+
+} sic_stream;
+
+/**
+ * @brief sic_device is one of the 256 devices of the machine. RD reads from its input stream and WD writes to its output stream, which
+ * are stdin and stdout until a file is mapped to the device. Several devices can share a stream, but each keeps its own counters.
+ * busyLeft is how many more times TD answers busy before the device is ready again.
+ */
+typedef struct
+{
+	sic_stream* input;
+	sic_stream* output;
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+	uint64_t tests;
+	uint32_t busyLeft;
+
+} sic_device;
+
+/**
+ * @brief sic_devices is every device of a machine and the streams behind them. throttle is how many times TD answers busy before each
+ * time it answers ready, 0 meaning a device is always ready.
+ */
+typedef struct
+{
+	sic_device devices[DEVICE_COUNT];
+	sic_stream* streams[DEVICE_MAX_STREAMS];
+	uint32_t numStreams;
+	uint32_t throttle;
+
+} sic_devices;
+
+// Function declarations //
+
+/**
+ * @brief createDevices is a function that creates the devices of a machine, all of them reading stdin and writing stdout.
+ *
+ * NOTE: that caller needs to free the devices after use by using freeDevices().
+ *
+ * @param  void
+ * @return devices or NULL on error
+ */
+sic_devices* createDevices(void);
+
+/**
+ * @brief freeDevices is a function that flushes the output streams, closes the files which were mapped, and frees the devices. The
+ * function returns nothing.
+ *
+ * @param  devices - The devices to free, may be NULL.
+ * @return void
+ */
+void freeDevices(sic_devices* devices);
+
+/**
+ * @brief mapDevice is a function that maps a host file or pipe to the input or output of a device. An input is opened for reading and an
+ * output is created or truncated, and "-" is stdin or stdout. It prints an error and returns NULL if the file can't be opened.
+ *
+ * @param  devices - The devices.
+ * @param  number  - The device number.
+ * @param  path    - The path of the file, or "-".
+ * @param  writing - 1 to map the output of the device, 0 to map its input.
+ * @return devices or NULL on error
+ */
+sic_devices* mapDevice(sic_devices* devices, uint8_t number, const char* path, uint8_t writing);
+
+/**
+ * @brief redirectDevices is a function that makes every device that reads stdin read the file instead, or every device that writes
+ * stdout write the file instead. It prints an error and returns NULL if the file can't be opened.
+ *
+ * @param  devices - The devices.
+ * @param  path    - The path of the file.
+ * @param  writing - 1 to redirect the outputs, 0 to redirect the inputs.
+ * @return devices or NULL on error
+ */
+sic_devices* redirectDevices(sic_devices* devices, const char* path, uint8_t writing);
+
+/**
+ * @brief deviceRead is a function that reads the next byte of the input of a device, refilling its buffer when it runs out. Before a
+ * refill the outputs are flushed, so a prompt is shown before the program waits for the answer.
+ *
+ * @param  devices - The devices.
+ * @param  number  - The device number.
+ * @return the byte, or DEVICE_EOF at the end of the input or on an error
+ */
+int deviceRead(sic_devices* devices, uint8_t number);
+
+/**
+ * @brief deviceWrite is a function that writes a byte to the output of a device, writing out its buffer when it is full. The function
+ * returns nothing, a failed write is reported once by flushDevices().
+ *
+ * @param  devices - The devices.
+ * @param  number  - The device number.
+ * @param  byte    - The byte to write.
+ * @return void
+ */
+void deviceWrite(sic_devices* devices, uint8_t number, uint8_t byte);
+
+/**
+ * @brief deviceTest is a function that answers TD for a device. A device is always ready unless the devices are throttled.
+ *
+ * @param  devices - The devices.
+ * @param  number  - The device number.
+ * @return 1 if the device is ready, 0 if it is busy
+ */
+uint8_t deviceTest(sic_devices* devices, uint8_t number);
+
+/**
+ * @brief flushDevices is a function that writes out the buffers of every output stream. It prints an error for each stream a write
+ * to has failed.
+ *
+ * @param  devices - The devices.
+ * @return 1 if every output was written, 0 if not
+ */
+uint8_t flushDevices(sic_devices* devices);
+
+/**
+ * @brief printDeviceStats is a function that prints the counters of every device the program used. The function returns nothing.
+ *
+ * @param  devices - The devices.
+ * @param  stream  - Where to print.
+ * @return void
+ */
+void printDeviceStats(const sic_devices* devices, FILE* stream);
+
+#endif //DEVICE_H
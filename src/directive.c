@@ -1,15 +1,5 @@
 #include "directive.h"
 
-/**
- * @brief getConstant is a function that will parse a given const char* for a operand and store the conversion into the in32_t*.
- * The function accepts a const char* to the operands, the operand to store the conversion in, and a uint8_t which will represent the base of the constant.
- * If an error occurs during the conversion, the function will return a directive_callback_status that is not DCS_OKAY.
- * 
- * @param  operands - The string containing the possible operands
- * @param  constant - The constant where the number will be stored
- * @param  base		- The base of the expected operand
- * @return directive_callback_status
-*/
 directive_callback_status getConstant(const char* operands, int32_t* operand, uint8_t base)
 {
 	char* afterOperand;
@@ -42,7 +32,7 @@ directive_callback_status getOperand(char* operands, int32_t* constant, uint8_t
 	if (status != DCS_OKAY) return status;
 
 	// Check to see if there was more operands
-	operands = strtok(NULL, SIC_TOKEN_DELIMITERS);
+	operands = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 	if (operands)
 		if (!checkComment(operands)) // check to see if its a comment, else there was too many operands
 			return DCS_TOO_MANY_OPERANDS;
@@ -129,14 +119,14 @@ hash_table* buildDirectiveTable(void)
 							 directive_callback_resb, directive_callback_resw, directive_callback_resr, directive_callback_exports };
 
 	// allocate the hash table memory
-	hash_table* directiveTable = createHashTable(SIC_DIRECTIVE_TABLE_SIZE);
+	hash_table* directiveTable = createHashTable(SIC_DIRECTIVE_TABLE_SIZE, ALLOC_DIRECTIVES);
 
 	// insert the directive and callback function key-pair into the directive table.
 	for (uint32_t i = 0; i < SIC_NUM_DIRECTIVES; i++)
 	{
 		//malloc and check directive_cb_struct
 		//doing pointer-to-pointer because ANSI c does not allow function pointers to be cast to other pointers. 
-		directive_cb_struct* cbStruct = (directive_cb_struct*)malloc(sizeof(directive_cb_struct));
+		directive_cb_struct* cbStruct = (directive_cb_struct*)sicMalloc(ALLOC_DIRECTIVES, sizeof(directive_cb_struct));
 		if (cbStruct == NULL)
 		{
 			fprintf(stderr, "[ERROR]: malloc failed during directive table construction.\n");
@@ -150,7 +140,7 @@ hash_table* buildDirectiveTable(void)
 		if (insertKVPair(directiveTable, keys[i], cbStruct) != HT_OKAY)
 		{
 			fprintf(stderr, "[ERROR]: failed to insert KV pair into the directive table.\n");
-			free(cbStruct);
+			sicFree(ALLOC_DIRECTIVES, cbStruct);
 			freeHashTableAndValues(directiveTable);
 			return NULL;
 		}
@@ -196,16 +186,16 @@ directive_callback_status directive_callback_end(symbol_table* symbolTable, char
 
 	// we have an optional instruction passed into END instead of address
 	int32_t newEndAddr = 0;
-	uint32_t* addrPtr = (uint32_t*)getKVPair(symbolTable->ht, operands);
-	if (addrPtr == NULL)
+	sic_symbol* symbolValue = (sic_symbol*)getKVPair(symbolTable->ht, operands);
+	if (symbolValue == NULL)
 		return DSC_END_SYMBOL_NULL;
 
 	// else symbol exists so we set the endAddr to the symbol's address and increment counter??
-	newEndAddr = *addrPtr;
+	newEndAddr = symbolValue->address;
 	//symbolTable->locCounter += SIC_WORD_BYTES;
 
 	// Check to see if there was more operands
-	operands = strtok(NULL, SIC_TOKEN_DELIMITERS);
+	operands = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 	if (operands)
 		if (!checkComment(operands)) // check to see if its a comment, else there was too many operands
 			return DCS_TOO_MANY_OPERANDS;
@@ -264,7 +254,7 @@ directive_callback_status directive_callback_byte(symbol_table* symbolTable, cha
 		return DCS_MEMORY_OVERFLOW;
 
 	// Check to see if there was more operands
-	operands = strtok(++rptr, SIC_TOKEN_DELIMITERS);
+	operands = sicTokenize(++rptr, SIC_TOKEN_DELIMITERS);
 	if (operands)
 		if (!checkComment(operands)) // check to see if its a comment, else there was too many operands
 			return DCS_TOO_MANY_OPERANDS;
@@ -62,6 +62,18 @@ typedef struct {
 
 // Function declarations //
 
+/**
+ * @brief getConstant is a function that will parse a given const char* for a operand and store the conversion into the in32_t*.
+ * The function accepts a const char* to the operands, the operand to store the conversion in, and a uint8_t which will represent the base of the constant.
+ * If an error occurs during the conversion, the function will return a directive_callback_status that is not DCS_OKAY.
+ * 
+ * @param  operands - The string containing the possible operands
+ * @param  constant - The constant where the number will be stored
+ * @param  base		- The base of the expected operand
+ * @return directive_callback_status
+*/
+directive_callback_status getConstant(const char* operands, int32_t* operand, uint8_t base);
+
 /**
  * @brief printDCSError is a function that prints a message to stderr whenever directive_callback_status error is passed in. The function will
  * accept a directive_callback_status error, error token string, and a uint32_t for the line number where the error occurred. The function returns nothing.
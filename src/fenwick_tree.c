@@ -0,0 +1,129 @@
+#include "fenwick_tree.h"
+
+// Define constants //
+#define FT_INITIAL_SIZE 64
+#define FT_RESIZE_CONSTANT 2
+
+/* @brief lowBit returns the lowest set bit of a 1-based fenwick index. */
+#define lowBit(i) ((i) & (~(i) + 1))
+
+fenwick_tree* createFenwickTree(uint32_t initialCapacity)
+{
+	fenwick_tree* ft = (fenwick_tree*)sicMalloc(ALLOC_SESSION, sizeof(fenwick_tree));
+	if (!ft)
+	{
+#ifdef _DEBUG
+		fprintf(stderr, "[ERROR]: malloc of fenwick tree failed.\n");
+#endif //_DEBUG
+		return NULL;
+	}
+
+	ft->numElements = 0;
+	ft->capacity = (initialCapacity == 0) ? FT_INITIAL_SIZE : initialCapacity;
+
+	// tree is 1-indexed so it needs one extra slot
+	ft->tree = (uint32_t*)sicCalloc(ALLOC_SESSION, ft->capacity + 1, sizeof(uint32_t));
+	ft->values = (uint32_t*)sicCalloc(ALLOC_SESSION, ft->capacity, sizeof(uint32_t));
+	if (!ft->tree || !ft->values)
+	{
+#ifdef _DEBUG
+		fprintf(stderr, "[ERROR]: calloc of fenwick tree arrays failed.\n");
+#endif //_DEBUG
+		sicFree(ALLOC_SESSION, ft->tree);
+		sicFree(ALLOC_SESSION, ft->values);
+		sicFree(ALLOC_SESSION, ft);
+		return NULL;
+	}
+
+	return ft;
+}
+
+void freeFenwickTree(fenwick_tree* ft)
+{
+	if (ft == NULL) return;
+
+	sicFree(ALLOC_SESSION, ft->tree);
+	sicFree(ALLOC_SESSION, ft->values);
+	sicFree(ALLOC_SESSION, ft);
+}
+
+/**
+ * @brief growFenwickTree is a function that doubles the capacity of the given tree. The partial sums that are already stored do not
+ * depend on the number of elements so the arrays are simply reallocated. Returns the tree on success or NULL if realloc failed.
+ *
+ * @param  ft - The tree to grow
+ * @return ft on success, NULL on error
+*/
+static fenwick_tree* growFenwickTree(fenwick_tree* ft)
+{
+	uint32_t newCapacity = ft->capacity * FT_RESIZE_CONSTANT;
+
+	uint32_t* newTree = (uint32_t*)sicRealloc(ALLOC_SESSION, ft->tree, (newCapacity + 1) * sizeof(uint32_t));
+	if (!newTree) return NULL;
+	ft->tree = newTree;
+
+	uint32_t* newValues = (uint32_t*)sicRealloc(ALLOC_SESSION, ft->values, newCapacity * sizeof(uint32_t));
+	if (!newValues) return NULL;
+	ft->values = newValues;
+
+	ft->capacity = newCapacity;
+	return ft;
+}
+
+fenwick_tree* fenwickPush(fenwick_tree* ft, uint32_t value)
+{
+	if (ft->numElements == ft->capacity)
+	{
+		if (growFenwickTree(ft) == NULL)
+			return NULL;
+	}
+
+	// tree[i] holds the sum of (i - lowBit(i), i], so it can be computed from the prefix sums we already have
+	uint32_t i = ft->numElements + 1;
+	ft->tree[i] = value + fenwickPrefixSum(ft, i - 1) - fenwickPrefixSum(ft, i - lowBit(i));
+	ft->values[ft->numElements] = value;
+	ft->numElements++;
+
+	return ft;
+}
+
+void fenwickSet(fenwick_tree* ft, uint32_t index, uint32_t value)
+{
+	// unsigned wrap around gives us the negative delta for free
+	uint32_t delta = value - ft->values[index];
+	ft->values[index] = value;
+
+	for (uint32_t i = index + 1; i <= ft->numElements; i += lowBit(i))
+		ft->tree[i] += delta;
+}
+
+uint32_t fenwickPrefixSum(const fenwick_tree* ft, uint32_t index)
+{
+	if (index > ft->numElements) index = ft->numElements;
+
+	uint32_t sum = 0;
+	for (uint32_t i = index; i > 0; i -= lowBit(i))
+		sum += ft->tree[i];
+
+	return sum;
+}
+
+uint32_t fenwickFind(const fenwick_tree* ft, uint32_t sum)
+{
+	// find the highest power of two that fits in the tree
+	uint32_t step = 1;
+	while ((step << 1) <= ft->numElements) step <<= 1;
+
+	// binary lifting, pos ends on the last index whose prefix sum is <= sum
+	uint32_t pos = 0;
+	for (; step > 0; step >>= 1)
+	{
+		if (pos + step <= ft->numElements && ft->tree[pos + step] <= sum)
+		{
+			pos += step;
+			sum -= ft->tree[pos];
+		}
+	}
+
+	return pos;
+}
@@ -0,0 +1,95 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+// Local includes //
+
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Structs //
+
+/**
+ * @brief fenwick_tree is a binary indexed tree over an array of uint32_t values. It is used to keep the prefix sums
+ * of the line sizes of an assembly session so that the address of any line can be found, and updated after an edit, in O(log n).
+ * The tree is 1-indexed internally, but every function in the interface uses 0-based indices.
+ */
+typedef struct {
+
+	uint32_t* tree;
+	uint32_t* values;
+	uint32_t numElements;
+	uint32_t capacity;
+
+} fenwick_tree;
+
+// Function declarations //
+
+/**
+ * @brief createFenwickTree is a function that allocates an empty fenwick tree. It will accept a uint32_t for the initial capacity,
+ * pass in zero if the number of elements is unknown. The function returns the allocated tree or NULL if an error occurred.
+ *
+ * @param  initialCapacity - The number of elements to make room for.
+ * @return fenwick tree or NULL on error
+ */
+fenwick_tree* createFenwickTree(uint32_t initialCapacity);
+
+/**
+ * @brief freeFenwickTree is a function that frees the given fenwick tree. The function returns nothing.
+ *
+ * @param  ft - The tree to be freed.
+ * @return void
+ */
+void freeFenwickTree(fenwick_tree* ft);
+
+/**
+ * @brief fenwickPush is a function that appends a value to the end of the tree in O(log n). It will return the given tree
+ * on success, or NULL if the tree could not grow. The tree is left untouched on error.
+ *
+ * @param  ft    - The tree that the value is appended to.
+ * @param  value - The value being appended.
+ * @return ft on success, NULL on error
+ */
+fenwick_tree* fenwickPush(fenwick_tree* ft, uint32_t value);
+
+/**
+ * @brief fenwickSet is a function that replaces the value at the given index and updates the prefix sums in O(log n).
+ * The function does not check the index, caller must make sure it is less than numElements.
+ *
+ * @param  ft    - The tree being updated.
+ * @param  index - The 0-based index of the value.
+ * @param  value - The new value.
+ * @return void
+ */
+void fenwickSet(fenwick_tree* ft, uint32_t index, uint32_t value);
+
+/**
+ * @brief fenwickPrefixSum is a function that returns the sum of the values in [0, index) in O(log n).
+ * An index larger than numElements is clamped to numElements.
+ *
+ * @param  ft    - The tree being queried.
+ * @param  index - The number of values to sum.
+ * @return the prefix sum
+ */
+uint32_t fenwickPrefixSum(const fenwick_tree* ft, uint32_t index);
+
+/**
+ * @brief fenwickFind is a function that finds the first index whose prefix sum, including itself, is greater than the given sum.
+ * For a tree of line sizes this is the line which contains the given offset. The function returns numElements if the sum is past the end.
+ *
+ * @param  ft  - The tree being searched.
+ * @param  sum - The offset being searched for.
+ * @return the 0-based index or numElements if not found
+ */
+uint32_t fenwickFind(const fenwick_tree* ft, uint32_t sum);
+
+#endif //FENWICK_TREE_H
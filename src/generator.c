@@ -0,0 +1,340 @@
+#include "generator.h"
+
+// Define constants //
+#define GEN_LABEL_BASE 36
+#define GEN_RSUB_ODDS 32
+#define GEN_INDEXED_ODDS 8
+#define GEN_MIN_COMMENT_CHARS 10
+#define GEN_MIN_LINES 3
+
+// Structs and enums //
+
+/**
+ * @brief gen_line_kind enum is what a planned code line will be written as.
+ */
+typedef enum
+{
+	GEN_INSTRUCTION = 0,
+	GEN_RSUB,
+	GEN_BYTE_CHAR,
+	GEN_BYTE_HEX,
+	GEN_WORD,
+	GEN_RESB
+
+} gen_line_kind;
+
+/**
+ * @brief gen_line struct is a code line planned before anything is written, so the number of labels is known before the
+ * first forward reference has to pick one. size is the operand length for BYTE and RESB.
+ */
+typedef struct {
+
+	uint8_t kind;
+	uint8_t size;
+	uint8_t hasLabel;
+
+} gen_line;
+
+// Global state //
+
+/* @brief the format 3 instructions which take a memory operand */
+static const char* const genInstructions[] = { "LDA", "STA", "ADD", "SUB", "MUL", "DIV", "COMP", "AND", "OR", "J", "JEQ", "JGT",
+	"JLT", "JSUB", "LDX", "STX", "LDL", "STL", "LDCH", "STCH", "TIX" };
+static const char genLabelDigits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static const char genHexDigits[] = "0123456789ABCDEF";
+
+// Function implementations //
+
+/**
+ * @brief nextRandom is a function that advances the xorshift64* generator and returns its next value.
+ *
+ * @param  state - The generator state, never zero.
+ * @return next random value
+*/
+static uint64_t nextRandom(uint64_t* state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief randomUnit is a function that returns a random double in [0, 1).
+ *
+ * @param  state - The generator state.
+ * @return random double
+*/
+static double randomUnit(uint64_t* state)
+{
+	return (double)(nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief randomBelow is a function that returns a random integer in [0, bound).
+ *
+ * @param  state - The generator state.
+ * @param  bound - The exclusive upper bound, not zero.
+ * @return random integer
+*/
+static uint64_t randomBelow(uint64_t* state, uint64_t bound)
+{
+	return nextRandom(state) % bound;
+}
+
+/**
+ * @brief formatLabel is a function that writes the name of the label with the given index, which is the prefix followed by the index
+ * in base 36 padded to the maximum symbol length. Padding keeps the labels from ever spelling an opcode or directive.
+ *
+ * @param  label - Buffer of at least SIC_MAX_SYMBOL_LEN + 1 chars.
+ * @param  index - The index of the label.
+ * @return void
+*/
+static void formatLabel(char* label, uint64_t index)
+{
+	label[0] = GEN_LABEL_PREFIX;
+	for (int i = GEN_LABEL_DIGITS; i > 0; i--)
+	{
+		label[i] = genLabelDigits[index % GEN_LABEL_BASE];
+		index /= GEN_LABEL_BASE;
+	}
+	label[GEN_LABEL_DIGITS + 1] = '\0';
+}
+
+/**
+ * @brief planLine is a function that picks the kind and size of the next code line and whether it defines a label.
+ *
+ * @param  state  - The generator state.
+ * @param  params - The shape of the program.
+ * @param  line   - The line to fill.
+ * @return number of bytes the line takes in memory
+*/
+static uint32_t planLine(uint64_t* state, const sic_gen_params* params, gen_line* line)
+{
+	uint32_t totalWeight = params->byteWeight + params->wordWeight + params->resbWeight;
+	uint32_t bytes;
+
+	if (totalWeight > 0 && randomUnit(state) < params->dataRatio)
+	{
+		uint32_t pick = (uint32_t)randomBelow(state, totalWeight);
+		if (pick < params->byteWeight)
+		{
+			// half of the constants are characters, the other half hex
+			if (randomBelow(state, 2) == 0)
+			{
+				line->kind = GEN_BYTE_CHAR;
+				line->size = (uint8_t)(1 + randomBelow(state, GEN_MAX_BYTE_CHARS));
+			}
+			else
+			{
+				line->kind = GEN_BYTE_HEX;
+				line->size = (uint8_t)(1 + randomBelow(state, GEN_MAX_BYTE_HEX));
+			}
+			bytes = line->size;
+		}
+		else if (pick < params->byteWeight + params->wordWeight)
+		{
+			line->kind = GEN_WORD;
+			line->size = 0;
+			bytes = SIC_WORD_BYTES;
+		}
+		else
+		{
+			line->kind = GEN_RESB;
+			line->size = (uint8_t)(1 + randomBelow(state, GEN_MAX_RESB));
+			bytes = line->size;
+		}
+	}
+	else
+	{
+		line->kind = (randomBelow(state, GEN_RSUB_ODDS) == 0) ? GEN_RSUB : GEN_INSTRUCTION;
+		line->size = 0;
+		bytes = SIC_WORD_BYTES;
+	}
+
+	line->hasLabel = randomUnit(state) < params->symbolDensity;
+	return bytes;
+}
+
+/**
+ * @brief writeComment is a function that writes one comment line of random lower case words.
+ *
+ * @param  outStream - The stream to write to.
+ * @param  state     - The generator state.
+ * @return void
+*/
+static void writeComment(FILE* outStream, uint64_t* state)
+{
+	char text[GEN_MAX_COMMENT_CHARS + 1];
+	uint32_t len = GEN_MIN_COMMENT_CHARS + (uint32_t)randomBelow(state, GEN_MAX_COMMENT_CHARS - GEN_MIN_COMMENT_CHARS + 1);
+
+	for (uint32_t i = 0; i < len; i++)
+		text[i] = (randomBelow(state, 6) == 0) ? ' ' : (char)('a' + randomBelow(state, 26));
+	text[len] = '\0';
+
+	fprintf(outStream, "# %s\n", text);
+}
+
+/**
+ * @brief writeCodeLine is a function that writes one planned code line. Instruction operands name a label defined further down with
+ * the forward ratio, otherwise one which is already defined. BYTE is followed by a single space since pass one takes the rest of the
+ * line as its operand.
+ *
+ * @param  outStream      - The stream to write to.
+ * @param  state          - The generator state.
+ * @param  params         - The shape of the program.
+ * @param  line           - The planned line.
+ * @param  definedLabels  - The number of labels defined up to and including this line.
+ * @param  summary        - The summary, numSymbols is the total number of labels.
+ * @return void
+*/
+static void writeCodeLine(FILE* outStream, uint64_t* state, const sic_gen_params* params, const gen_line* line, uint64_t definedLabels,
+	sic_gen_summary* summary)
+{
+	char label[SIC_MAX_SYMBOL_LEN + 1] = { 0 };
+	char operand[SIC_MAX_SYMBOL_LEN + 3];
+	char constant[2 * GEN_MAX_BYTE_CHARS + 1];
+
+	if (line->hasLabel)
+		formatLabel(label, definedLabels - 1);
+
+	switch (line->kind)
+	{
+	case GEN_INSTRUCTION:
+	{
+		uint64_t target;
+		if (definedLabels < summary->numSymbols && randomUnit(state) < params->forwardRatio)
+		{
+			target = definedLabels + randomBelow(state, summary->numSymbols - definedLabels);
+			summary->numForwardRefs++;
+		}
+		else
+			target = randomBelow(state, definedLabels);
+
+		formatLabel(operand, target);
+		if (randomBelow(state, GEN_INDEXED_ODDS) == 0)
+			strcat(operand, ",X");
+
+		const char* mnemonic = genInstructions[randomBelow(state, sizeof(genInstructions) / sizeof(genInstructions[0]))];
+		fprintf(outStream, "%-8s%-8s%s\n", label, mnemonic, operand);
+		break;
+	}
+	case GEN_RSUB:
+		fprintf(outStream, "%-8sRSUB\n", label);
+		break;
+	case GEN_BYTE_CHAR:
+		for (uint32_t i = 0; i < line->size; i++)
+			constant[i] = (char)('A' + randomBelow(state, 26));
+		constant[line->size] = '\0';
+		fprintf(outStream, "%-8sBYTE C'%s'\n", label, constant);
+		break;
+	case GEN_BYTE_HEX:
+		for (uint32_t i = 0; i < 2u * line->size; i++)
+			constant[i] = genHexDigits[randomBelow(state, 16)];
+		constant[2 * line->size] = '\0';
+		fprintf(outStream, "%-8sBYTE X'%s'\n", label, constant);
+		break;
+	case GEN_WORD:
+		fprintf(outStream, "%-8s%-8s%u\n", label, "WORD", (uint32_t)randomBelow(state, GEN_MAX_WORD + 1));
+		break;
+	case GEN_RESB:
+		fprintf(outStream, "%-8s%-8s%u\n", label, "RESB", line->size);
+		break;
+	}
+}
+
+void initGenParams(sic_gen_params* params)
+{
+	params->numLines = 10000;
+	params->symbolDensity = 0.25;
+	params->dataRatio = 0.2;
+	params->byteWeight = 1;
+	params->wordWeight = 1;
+	params->resbWeight = 1;
+	params->commentRatio = 0.1;
+	params->forwardRatio = 0.33;
+	params->seed = 1;
+}
+
+sic_gen_summary* generateSICProgram(FILE* outStream, const sic_gen_params* params, sic_gen_summary* summary)
+{
+	if (params->numLines < GEN_MIN_LINES)
+	{
+		fprintf(stderr, "[ERROR]: A generated program needs at least %d lines for START, one instruction and END.\n", GEN_MIN_LINES);
+		return NULL;
+	}
+
+	memset(summary, 0, sizeof(sic_gen_summary));
+	uint64_t state = params->seed ? params->seed : 1;
+
+	// every line but START and END is either code or a comment
+	uint64_t bodyLines = params->numLines - 2;
+	uint64_t wantedCode = (uint64_t)((double)bodyLines * (1.0 - params->commentRatio) + 0.5);
+	if (wantedCode < 1) wantedCode = 1;
+	if (wantedCode > bodyLines) wantedCode = bodyLines;
+
+	// every code line takes at least one byte, so the plan never needs more entries than there is memory
+	uint64_t maxPlanned = (wantedCode < SIC_MEMORY_LIMIT) ? wantedCode : SIC_MEMORY_LIMIT;
+	gen_line* plan = (gen_line*)malloc(maxPlanned * sizeof(gen_line));
+	if (!plan)
+	{
+		fprintf(stderr, "[ERROR]: Could not allocate the plan of the generated program.\n");
+		return NULL;
+	}
+
+	// plan the code lines until the program is as long as asked for or memory is full
+	uint32_t locCounter = GEN_START_ADDRESS;
+	while (summary->numCodeLines < maxPlanned)
+	{
+		gen_line* line = &plan[summary->numCodeLines];
+		uint32_t bytes = planLine(&state, params, line);
+		if (locCounter + bytes > SIC_MEMORY_LIMIT)
+			break;
+
+		// the first line always has a label so there is one for operands and END to name
+		if (summary->numCodeLines == 0) line->hasLabel = 1;
+		if (line->hasLabel) summary->numSymbols++;
+
+		locCounter += bytes;
+		summary->numCodeLines++;
+	}
+
+	summary->numLines = params->numLines;
+	summary->clampedLines = wantedCode - summary->numCodeLines;
+	summary->numComments = bodyLines - summary->numCodeLines;
+	summary->programLength = locCounter - GEN_START_ADDRESS;
+
+	// write the program, spreading the comments evenly at random between the code lines
+	fprintf(outStream, "%-8s%-8s%X\n", GEN_PROGRAM_NAME, "START", GEN_START_ADDRESS);
+
+	uint64_t codeLeft = summary->numCodeLines;
+	uint64_t commentsLeft = summary->numComments;
+	uint64_t definedLabels = 0;
+	uint64_t lineIndex = 0;
+	while (codeLeft + commentsLeft > 0)
+	{
+		if (commentsLeft > 0 && randomBelow(&state, codeLeft + commentsLeft) < commentsLeft)
+		{
+			writeComment(outStream, &state);
+			commentsLeft--;
+			continue;
+		}
+
+		const gen_line* line = &plan[lineIndex++];
+		if (line->hasLabel) definedLabels++;
+		writeCodeLine(outStream, &state, params, line, definedLabels, summary);
+		codeLeft--;
+	}
+
+	char firstLabel[SIC_MAX_SYMBOL_LEN + 1];
+	formatLabel(firstLabel, 0);
+	fprintf(outStream, "%-8s%-8s%s\n", "", "END", firstLabel);
+	free(plan);
+
+	if (ferror(outStream))
+	{
+		fprintf(stderr, "[ERROR]: Could not write the generated program.\n");
+		return NULL;
+	}
+	return summary;
+}
@@ -0,0 +1,94 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+// Local includes //
+
+#include "sic.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define GEN_PROGRAM_NAME "BENCH"
+#define GEN_START_ADDRESS 0
+#define GEN_LABEL_PREFIX 'L'
+#define GEN_LABEL_DIGITS (SIC_MAX_SYMBOL_LEN - 1)
+#define GEN_MAX_RESB 32
+#define GEN_MAX_BYTE_CHARS 8
+#define GEN_MAX_BYTE_HEX 4
+#define GEN_MAX_WORD 65535
+#define GEN_MAX_COMMENT_CHARS 60
+
+// Structs //
+
+/**
+ * @brief sic_gen_params struct holds the knobs of the synthetic program generator. The ratios are between 0 and 1.
+ * symbolDensity is the share of the code lines which define a label, dataRatio the share of the code lines which are
+ * BYTE, WORD or RESB directives (split by the three weights), commentRatio the share of all lines which are comments, and
+ * forwardRatio the share of the operands which name a label defined further down. The same seed always gives the same program.
+ */
+typedef struct {
+
+	uint64_t numLines;
+	double symbolDensity;
+	double dataRatio;
+	uint32_t byteWeight;
+	uint32_t wordWeight;
+	uint32_t resbWeight;
+	double commentRatio;
+	double forwardRatio;
+	uint64_t seed;
+
+} sic_gen_params;
+
+/**
+ * @brief sic_gen_summary struct describes the program which was generated. clampedLines is the number of code lines
+ * which were turned into comments because the program would not have fit in the SIC address space.
+ */
+typedef struct {
+
+	uint64_t numLines;
+	uint64_t numCodeLines;
+	uint64_t numComments;
+	uint64_t numSymbols;
+	uint64_t numForwardRefs;
+	uint64_t clampedLines;
+	uint32_t programLength;
+
+} sic_gen_summary;
+
+// Function declarations //
+
+/**
+ * @brief initGenParams is a function that fills the given params with the defaults: 10000 lines, a label on a quarter of the code
+ * lines, a fifth of the code lines as data split evenly between BYTE, WORD and RESB, a tenth of the lines as comments, and a third of the
+ * operands as forward references.
+ *
+ * @param  params - The params to fill.
+ * @return void
+ */
+void initGenParams(sic_gen_params* params);
+
+/**
+ * @brief generateSICProgram is a function that writes a valid SIC program with the shape given by the params to the stream. The program
+ * always starts with START, ends with END, and has exactly numLines lines (at least three). Only format 3 instructions and the BYTE, WORD
+ * and RESB directives are used, so it assembles with this assembler. Since SIC only has 32 KiB of memory, once the program is full the rest
+ * of the code lines are written as comments, which is recorded in the summary. The function returns the summary or NULL on error.
+ *
+ * @param  outStream - The stream the program is written to.
+ * @param  params    - The shape of the program.
+ * @param  summary   - Filled with what was generated.
+ * @return summary or NULL on error
+ */
+sic_gen_summary* generateSICProgram(FILE* outStream, const sic_gen_params* params, sic_gen_summary* summary);
+
+#endif //GENERATOR_H
@@ -27,9 +27,9 @@ static uint32_t hashFunction(const char* key, uint32_t arraySize)
 	return hash;
 }
 
-hash_table* createHashTable(uint32_t initialSize)
+hash_table* createHashTable(uint32_t initialSize, alloc_subsystem subsystem)
 {
-	hash_table* ht = malloc(sizeof(hash_table));
+	hash_table* ht = sicMalloc(subsystem, sizeof(hash_table));
 
 	// check to see if malloc allocated before attempting to access
 	if (ht == NULL) 
@@ -44,35 +44,23 @@ hash_table* createHashTable(uint32_t initialSize)
 	// set initial buffer size based on argument
 	ht->numElements = 0;
 	ht->currentSize = (initialSize == 0) ? HT_INITIAL_SIZE : initialSize;
+	ht->subsystem = subsystem;
 
 	// create the buffer for KV
-	ht->p_KVArray = (key_value*)calloc(ht->currentSize, sizeof(key_value));
+	ht->p_KVArray = (key_value*)sicCalloc(subsystem, ht->currentSize, sizeof(key_value));
 	if (ht->p_KVArray == NULL)
 	{
 #ifdef _DEBUG
 		fprintf(stderr, "[ERROR]: calloc of key-value array within hash table failed.\n");
 #endif //_DEBUG
 
-		free(ht);
+		sicFree(subsystem, ht);
 		return NULL;
 	}
 	
 	return ht;
 }
 
-/**
- * @brief growHashTable is a function which dynamically resizes the KV array of a given hash table. 
- * The function accepts a point to the hash table as the argument and returns a pointer to newly
- * resized hash table on successful reallocation. The function returns NULL if an error occurred during
- * KV array realloc. The function assumes that the pointer is valid and was checked before calling the function.
- *
- * Note: Since the current collision handling is quadratic probing using a capacity that is a power of two,
- * the function will double the size of the KV array. If the probing function changes this function might need to
- * as well.
- * 
- * @param  ht - The hash table which will be reallocated
- * @return the newly reallocted hash table
-*/
 hash_table* growHashTable(hash_table* ht)
 {
 	uint32_t oldCapacity = ht->currentSize;
@@ -80,7 +68,8 @@ hash_table* growHashTable(hash_table* ht)
 	key_value* oldBuffer = ht->p_KVArray;
 
 	uint32_t newCapacity = oldCapacity * HT_RESIZE_CONSTANT;
-	key_value* newBuffer = (key_value*)calloc(newCapacity, sizeof(key_value));
+	key_value* newBuffer = (key_value*)sicCalloc(ht->subsystem, newCapacity, sizeof(key_value));
+	STATS_ADD(htResizes, 1);
 
 	// check to see if calloc was successful
 	if (newBuffer == NULL)
@@ -114,12 +103,12 @@ hash_table* growHashTable(hash_table* ht)
 			}
 
 			// else we get rid of old key
-			free((char*)oldBuffer[i].key);
+			sicFree(ht->subsystem, (char*)oldBuffer[i].key);
 		}
 	}
 
 	// reallocation successful, freeing old memory
-	free(oldBuffer);
+	sicFree(ht->subsystem, oldBuffer);
 	return ht;
 }
 
@@ -131,11 +120,11 @@ void freeHashTable(hash_table* ht)
 	for (uint32_t i = 0; i < ht->currentSize; i++)
 	{
 		if (ht->p_KVArray[i].key != NULL)
-			free((char*)ht->p_KVArray[i].key);
+			sicFree(ht->subsystem, (char*)ht->p_KVArray[i].key);
 	}
 
-	free(ht->p_KVArray);
-	free(ht);
+	sicFree(ht->subsystem, ht->p_KVArray);
+	sicFree(ht->subsystem, ht);
 }
 
 void freeHashTableAndValues(hash_table* ht)
@@ -147,13 +136,13 @@ void freeHashTableAndValues(hash_table* ht)
 	{
 		if (ht->p_KVArray[i].key != NULL)
 		{
-			free(ht->p_KVArray[i].value);
-			free((char*)ht->p_KVArray[i].key);
+			sicFree(ht->subsystem, ht->p_KVArray[i].value);
+			sicFree(ht->subsystem, (char*)ht->p_KVArray[i].key);
 		}
 	}
 
-	free(ht->p_KVArray);
-	free(ht);
+	sicFree(ht->subsystem, ht->p_KVArray);
+	sicFree(ht->subsystem, ht);
 }
 
 ht_status insertKVPair(hash_table* ht, const char* key, void* value)
@@ -187,14 +176,17 @@ ht_status insertKVPair(hash_table* ht, const char* key, void* value)
 			return HT_KEY_DUPLICATE;
 		}
 
-		index = (hashIndex + x*x) % ht->currentSize; // quadratic probing
+		index = (hashIndex + x * (x + 1) / 2) % ht->currentSize; // quadratic probing with triangular numbers
 		x++;
 	}
+	STATS_ADD(htInserts, 1);
+	STATS_ADD(htInsertProbes, x);
+	STATS_MAX(htMaxProbe, x);
 
 	// found open index
 	// need to make a copy of key so we don't have to worry about old one getting freed.
 	size_t len = strlen(key) + 1;
-	const char* newKey = (char*)malloc(len * sizeof(char));
+	const char* newKey = (char*)sicMalloc(ht->subsystem, len * sizeof(char));
 	if (newKey == NULL)
 	{
 #ifdef _DEBUG
@@ -242,17 +234,25 @@ void* getKVPair(const hash_table* ht, const char* key)
 	uint32_t hashIndex = hashFunction(key, ht->currentSize);
 	uint32_t index = hashIndex;
 
-	// loop using quadratic probing to resolve collisions
+	void* value = NULL;
+
+	// loop using quadratic probing to resolve collisions, x ends as the number of slots looked at
 	while (ht->p_KVArray[index].key != NULL)
 	{
 		// check for a match key
 		if (strcmp(key, ht->p_KVArray[index].key) == 0)
-			return ht->p_KVArray[index].value;
+		{
+			value = ht->p_KVArray[index].value;
+			break;
+		}
 
-		index = (hashIndex + x * x) % ht->currentSize; // quadratic probing
+		index = (hashIndex + x * (x + 1) / 2) % ht->currentSize; // quadratic probing with triangular numbers
 		x++;
 	}
+	STATS_ADD(htLookups, 1);
+	STATS_ADD(htLookupProbes, x);
+	STATS_MAX(htMaxProbe, x);
 
-	// didn't find a match
-	return NULL;
+	// NULL if there was no match
+	return value;
 }
\ No newline at end of file
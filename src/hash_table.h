@@ -5,6 +5,8 @@
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 
+#include "alloc.h"
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -24,12 +26,16 @@ typedef struct {
 
 } key_value;
 
-/* @brief The HT which contains a pointer to the KV array, the number of elements, and the current array size. */
+/**
+ * @brief The HT which contains a pointer to the KV array, the number of elements, and the current array size. The table, its keys,
+ * and the values freed by freeHashTableAndValues are charged to the subsystem.
+ */
 typedef struct {
 
 	key_value* p_KVArray;
 	uint32_t numElements;
 	uint32_t currentSize;
+	alloc_subsystem subsystem;
 
 } hash_table;
 
@@ -58,9 +64,10 @@ typedef enum {
  * NULL if an error occurred.
  * 
  * @param  initialSize - the starting size 
+ * @param  subsystem   - the subsystem the memory of the table is charged to
  * @return hash table
  */
-hash_table* createHashTable(uint32_t initialSize);
+hash_table* createHashTable(uint32_t initialSize, alloc_subsystem subsystem);
 
 /**
  * @brief freeHashTable is a function that frees the dynamically allocated memory of the hash table. The function accepts a 
@@ -105,4 +112,20 @@ ht_status insertKVPair(hash_table* ht, const char* key, void* value);
   */
 void* getKVPair(const hash_table* ht, const char* key);
 
+/**
+ * @brief growHashTable is a function which dynamically resizes the KV array of a given hash table. 
+ * The function accepts a point to the hash table as the argument and returns a pointer to newly
+ * resized hash table on successful reallocation. The function returns NULL if an error occurred during
+ * KV array realloc. The function assumes that the pointer is valid and was checked before calling the function.
+ *
+ * Note: Since the current collision handling is quadratic probing using a capacity that is a power of two,
+ * the function will double the size of the KV array. The probe offsets are the triangular numbers, which visit every
+ * slot of a power of two sized array, so a free slot is always found. If the probing function changes this function might need to
+ * as well.
+ * 
+ * @param  ht - The hash table which will be reallocated
+ * @return the newly reallocted hash table
+*/
+hash_table* growHashTable(hash_table* ht);
+
 #endif //HASH_TABLE_H
\ No newline at end of file
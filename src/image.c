@@ -0,0 +1,180 @@
+#include "image.h"
+#include "scoff_reader.h"
+
+/**
+ * @brief putU32 is a function that stores the value as a 32 bit little endian integer.
+ *
+ * @param  bytes - Where to store it
+ * @param  value - The value
+ * @return void
+*/
+static void putU32(uint8_t* bytes, uint32_t value)
+{
+	for (uint32_t i = 0; i < 4; i++)
+		bytes[i] = (value >> (8 * i)) & 0xFF;
+}
+
+/**
+ * @brief getU32 is a function that loads a 32 bit little endian integer.
+ *
+ * @param  bytes - Where it is stored
+ * @return the value
+*/
+static uint32_t getU32(const uint8_t* bytes)
+{
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+sic_image* createImageFromRecords(const sic_scoff_records* records)
+{
+	sic_image* image = (sic_image*)sicMalloc(ALLOC_OTHER, sizeof(sic_image));
+	if (!image)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the memory image.\n");
+		return NULL;
+	}
+	image->startAddress = (uint32_t)strtoul(records->header.startAddr, NULL, 16);
+	image->length = (uint32_t)strtoul(records->header.lengthOfProgram, NULL, 16);
+	image->entryPoint = (uint32_t)strtoul(records->end.firstInstruction, NULL, 16);
+
+	// the gaps left by RESB and RESW are zero
+	image->bytes = (uint8_t*)sicCalloc(ALLOC_OTHER, image->length + 1, 1);
+	if (!image->bytes)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the %u bytes of the memory image.\n", image->length);
+		sicFree(ALLOC_OTHER, image);
+		return NULL;
+	}
+
+	// place the object code of every T record at its address
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		uint32_t addr = (uint32_t)strtoul(t->startAddr, NULL, 16);
+		uint32_t numBytes = (uint32_t)strtoul(t->lengthOfObj, NULL, 16);
+		if (addr < image->startAddress || addr - image->startAddress + numBytes > image->length)
+		{
+			fprintf(stderr, "[ERROR]: The T record at %06X is outside of the program, which is %06X to %06X.\n", addr,
+				image->startAddress, image->startAddress + image->length);
+			freeImage(image);
+			return NULL;
+		}
+
+		if (!decodeHex(t->objectCode, numBytes, image->bytes + (addr - image->startAddress)))
+		{
+			fprintf(stderr, "[ERROR]: The T record at %06X has object code which is not hex.\n", addr);
+			freeImage(image);
+			return NULL;
+		}
+	}
+
+	return image;
+}
+
+void freeImage(sic_image* image)
+{
+	if (!image) return;
+
+	sicFree(ALLOC_OTHER, image->bytes);
+	sicFree(ALLOC_OTHER, image);
+}
+
+sic_image* readImage(const uint8_t* data, size_t len)
+{
+	if (!isImage(data, len) || len < IMAGE_HEADER_LEN || len - IMAGE_HEADER_LEN != getU32(data + 12))
+	{
+		fprintf(stderr, "[ERROR]: The file is not a memory image, or its length does not match its header.\n");
+		return NULL;
+	}
+
+	sic_image* image = (sic_image*)sicMalloc(ALLOC_OTHER, sizeof(sic_image));
+	if (!image)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the memory image.\n");
+		return NULL;
+	}
+	image->startAddress = getU32(data + 4);
+	image->entryPoint = getU32(data + 8);
+	image->length = getU32(data + 12);
+	image->bytes = (uint8_t*)sicMalloc(ALLOC_OTHER, image->length + 1);
+	if (!image->bytes)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the %u bytes of the memory image.\n", image->length);
+		sicFree(ALLOC_OTHER, image);
+		return NULL;
+	}
+	memcpy(image->bytes, data + IMAGE_HEADER_LEN, image->length);
+
+	return image;
+}
+
+uint8_t isImage(const uint8_t* data, size_t len)
+{
+	return len >= IMAGE_MAGIC_LEN && memcmp(data, IMAGE_MAGIC, IMAGE_MAGIC_LEN) == 0;
+}
+
+sic_image* writeImageToStream(sic_image* image, FILE* outFile)
+{
+	uint8_t header[IMAGE_HEADER_LEN];
+	memcpy(header, IMAGE_MAGIC, IMAGE_MAGIC_LEN);
+	putU32(header + 4, image->startAddress);
+	putU32(header + 8, image->entryPoint);
+	putU32(header + 12, image->length);
+
+	size_t written = fwrite(header, 1, IMAGE_HEADER_LEN, outFile);
+	written += fwrite(image->bytes, 1, image->length, outFile);
+	STATS_ADD(bytesWritten, written);
+
+	if (ferror(outFile))
+	{
+		fprintf(stderr, "[ERROR]: An error occurred while writing the memory image to the stream.\n");
+		return NULL;
+	}
+
+	return image;
+}
+
+sic_scoff_records* writeSCOFFImageToStream(sic_scoff_records* records, FILE* outFile)
+{
+	sic_image* image = createImageFromRecords(records);
+	if (!image) return NULL;
+
+	sic_image* written = writeImageToStream(image, outFile);
+	freeImage(image);
+	return written ? records : NULL;
+}
+
+sic_scoff_records* writeSCOFFImageToFile(sic_scoff_records* records, char* fileName)
+{
+	// name the image the way writeSCOFFToFile names the object, with the image extension
+	char* folder = strrchr(fileName, '\\');
+	if (folder++) fileName = folder;
+
+	size_t bufferBytes = strlen(fileName) + IMAGE_EXTENSION_LEN + 1;
+	char* buffer = (char*)sicMalloc(ALLOC_OTHER, bufferBytes);
+	if (!buffer)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc temporary buffer during ouput of the memory image to file.\n");
+		return NULL;
+	}
+	strcpy(buffer, fileName);
+	strcat(buffer, IMAGE_EXTENSION);
+
+	FILE* outFile = fopen(buffer, "wb");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the memory image.\n", buffer);
+		sicFree(ALLOC_OTHER, buffer);
+		return NULL;
+	}
+
+	sic_scoff_records* written = writeSCOFFImageToStream(records, outFile);
+	if (fclose(outFile) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not close the memory image file \"%s\".\n", buffer);
+		written = NULL;
+	}
+
+	sicFree(ALLOC_OTHER, buffer);
+	return written;
+}
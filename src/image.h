@@ -0,0 +1,117 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef IMAGE_H // flat memory image of an assembled SIC program
+#define IMAGE_H
+
+// Local includes //
+
+#include "scoff.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define IMAGE_MAGIC "SICI"
+#define IMAGE_MAGIC_LEN 4
+#define IMAGE_HEADER_LEN 16
+#define IMAGE_EXTENSION ".img"
+#define IMAGE_EXTENSION_LEN 4
+
+// Structs and enums //
+
+/**
+ * @brief sic_image is the memory of a SIC program once it is loaded, from the start address to the end of the program. The bytes no
+ * T record covers, such as the ones reserved by RESB and RESW, are zero.
+ *
+ * The image file is a 16 byte header followed by the length bytes of memory, so the memory of a mapped image starts 16 byte aligned.
+ * The header is the magic "SICI", then the start address, the entry point and the length as 32 bit little endian integers.
+ */
+typedef struct
+{
+	uint32_t startAddress;
+	uint32_t entryPoint;
+	uint32_t length;
+	uint8_t* bytes;
+
+} sic_image;
+
+// Function declarations //
+
+/**
+ * @brief createImageFromRecords is a function that loads the T records into a zeroed image the size of the program in the header, the
+ * way a loader placing the program at its start address would. The M records are not applied since the object code already holds the
+ * addresses for that start address. It prints an error and returns NULL if a T record is outside of the program.
+ *
+ * NOTE: that caller needs to free the image after use by using freeImage().
+ *
+ * @param  records - The records of the program.
+ * @return image or NULL on error
+ */
+sic_image* createImageFromRecords(const sic_scoff_records* records);
+
+/**
+ * @brief freeImage is a function that frees the image and its memory. The function returns nothing.
+ *
+ * @param  image - The image to free, may be NULL.
+ * @return void
+ */
+void freeImage(sic_image* image);
+
+/**
+ * @brief readImage is a function that reads an image file back into an image, copying its memory. It prints an error and returns NULL
+ * if the data is not an image file or its length does not match the header.
+ *
+ * NOTE: that caller needs to free the image after use by using freeImage().
+ *
+ * @param  data - The image file.
+ * @param  len  - The length of the file.
+ * @return image or NULL on error
+ */
+sic_image* readImage(const uint8_t* data, size_t len);
+
+/**
+ * @brief isImage is a function that checks if the data starts with the magic of the image file.
+ *
+ * @param  data - The data.
+ * @param  len  - The length of the data.
+ * @return 1 if it does, 0 if not
+ */
+uint8_t isImage(const uint8_t* data, size_t len);
+
+/**
+ * @brief writeImageToStream is a function that writes the image file, the header and then the memory, to the stream.
+ *
+ * @param  image   - The image to write.
+ * @param  outFile - The stream to write to.
+ * @return image or NULL on error
+ */
+sic_image* writeImageToStream(sic_image* image, FILE* outFile);
+
+/**
+ * @brief writeSCOFFImageToStream is a function that loads the records into an image and writes the image file to the stream.
+ *
+ * @param  records - The records of the program.
+ * @param  outFile - The stream to write to.
+ * @return records or NULL on error
+ */
+sic_scoff_records* writeSCOFFImageToStream(sic_scoff_records* records, FILE* outFile);
+
+/**
+ * @brief writeSCOFFImageToFile is a function that loads the records into an image and writes it to the image file named after the
+ * source file, which is the file name with the .img extension, the same way writeSCOFFToFile() names the text object.
+ *
+ * @param  records  - The records of the program.
+ * @param  fileName - The name of the source file.
+ * @return records or NULL on error
+ */
+sic_scoff_records* writeSCOFFImageToFile(sic_scoff_records* records, char* fileName);
+
+#endif //IMAGE_H
@@ -0,0 +1,670 @@
+#include "io_uring_engine.h"
+
+#ifdef SIC_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Structs and enums //
+
+/**
+ * @brief uring_op enum is the operation a completion belongs to. It is stored in the low bits of the user data of every
+ * submission, the job index is stored in the rest.
+ */
+typedef enum {
+
+	URING_OP_OPEN_SOURCE = 0,
+	URING_OP_STATX,
+	URING_OP_READ,
+	URING_OP_CLOSE_SOURCE,
+	URING_OP_OPEN_OBJECT,
+	URING_OP_WRITE,
+	URING_OP_CLOSE_OBJECT,
+	URING_OP_WAKEUP
+
+} uring_op;
+
+/**
+ * @brief uring_ring holds the mapped submission and completion queues of the ring. Only the thread driving the engine touches them.
+ */
+typedef struct {
+
+	int fd;
+	uint32_t* sqHead;
+	uint32_t* sqTail;
+	uint32_t* sqArray;
+	uint32_t sqMask;
+	uint32_t sqEntries;
+	uint32_t localTail;
+	uint32_t toSubmit;
+	struct io_uring_sqe* sqes;
+
+	uint32_t* cqHead;
+	uint32_t* cqTail;
+	uint32_t cqMask;
+	struct io_uring_cqe* cqes;
+
+	void* sqRing;
+	size_t sqRingSize;
+	void* cqRing;
+	size_t cqRingSize;
+	size_t sqesSize;
+
+} uring_ring;
+
+/**
+ * @brief uring_job is the I/O state of one batch job. The open and the statx of the source are submitted together, so opensPending counts
+ * down to zero before the read can start. fd is the source while reading and the object while writing.
+ */
+typedef struct {
+
+	struct statx stx;
+	int fd;
+	uint8_t opensPending;
+	uint8_t failed;
+	uint8_t done;
+	size_t written;
+
+} uring_job;
+
+typedef struct uring_engine uring_engine;
+
+/* @brief the argument of the assembly task, the engine and the index of the job */
+typedef struct {
+	uring_engine* engine;
+	uint32_t index;
+} uring_task;
+
+/**
+ * @brief uring_engine is the state shared by the ring thread and the assembly workers. Workers only touch the done queue and the eventfd.
+ */
+struct uring_engine {
+
+	sic_batch* batch;
+	uring_ring ring;
+	uring_job* states;
+	uring_task* tasks;
+	work_scheduler* sched;
+
+	int wakeFd;
+	uint64_t wakeValue;
+	uint8_t wakeArmed;
+	uint8_t wakeKicked;
+
+	pthread_mutex_t doneLock;
+	uint32_t* doneQueue;
+	uint32_t numDone;
+
+	uint32_t nextJob;
+	uint32_t inFlight;
+	uint32_t numFinished;
+	uint32_t opsPending;
+
+};
+
+/**
+ * @brief setupRing is a function that creates the ring, maps its queues, and probes that every operation the engine uses is supported.
+ *
+ * @param  engine - The engine
+ * @return 0 on success, -1 if io_uring can't be used
+*/
+static int setupRing(uring_engine* engine)
+{
+	uring_ring* ring = &engine->ring;
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	memset(ring, 0, sizeof(uring_ring));
+	ring->sqRing = ring->cqRing = ring->sqes = MAP_FAILED;
+
+	ring->fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	batchCountSyscalls(engine->batch, 1);
+	if (ring->fd < 0) return -1;
+
+	// the rings share one mapping on any kernel new enough to have the file operations we need
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)) return -1;
+	if (ring->cqRingSize > ring->sqRingSize) ring->sqRingSize = ring->cqRingSize;
+
+	ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	batchCountSyscalls(engine->batch, 2);
+	if (ring->sqRing == MAP_FAILED || ring->sqes == MAP_FAILED) return -1;
+	ring->cqRing = ring->sqRing;
+
+	char* sq = (char*)ring->sqRing;
+	ring->sqHead = (uint32_t*)(sq + params.sq_off.head);
+	ring->sqTail = (uint32_t*)(sq + params.sq_off.tail);
+	ring->sqArray = (uint32_t*)(sq + params.sq_off.array);
+	ring->sqMask = *(uint32_t*)(sq + params.sq_off.ring_mask);
+	ring->sqEntries = params.sq_entries;
+	ring->localTail = *ring->sqTail;
+
+	char* cq = (char*)ring->cqRing;
+	ring->cqHead = (uint32_t*)(cq + params.cq_off.head);
+	ring->cqTail = (uint32_t*)(cq + params.cq_off.tail);
+	ring->cqMask = *(uint32_t*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	// opening and closing files through the ring needs 5.6, so check instead of failing every job later
+	const uint8_t neededOps[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE };
+	size_t probeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1, probeSize);
+	if (!probe) return -1;
+
+	int result = (int)syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256);
+	batchCountSyscalls(engine->batch, 1);
+	for (uint32_t i = 0; result == 0 && i < sizeof(neededOps); i++)
+	{
+		if (neededOps[i] > probe->last_op || !(probe->ops[neededOps[i]].flags & IO_URING_OP_SUPPORTED))
+			result = -1;
+	}
+	free(probe);
+	return (result == 0) ? 0 : -1;
+}
+
+/**
+ * @brief teardownRing is a function that unmaps the queues and closes the ring.
+ *
+ * @param  engine - The engine
+ * @return void
+*/
+static void teardownRing(uring_engine* engine)
+{
+	uring_ring* ring = &engine->ring;
+	uint64_t syscalls = 0;
+	if (ring->sqes != MAP_FAILED) { munmap(ring->sqes, ring->sqesSize); syscalls++; }
+	if (ring->sqRing != MAP_FAILED) { munmap(ring->sqRing, ring->sqRingSize); syscalls++; }
+	if (ring->fd >= 0) { close(ring->fd); syscalls++; }
+	batchCountSyscalls(engine->batch, syscalls);
+}
+
+/**
+ * @brief submitAndWait is a function that hands every queued submission to the kernel and waits for at least the given number of completions.
+ *
+ * @param  engine  - The engine
+ * @param  waitNum - The number of completions to wait for
+ * @return 0 on success, -1 if io_uring_enter failed
+*/
+static int submitAndWait(uring_engine* engine, uint32_t waitNum)
+{
+	uring_ring* ring = &engine->ring;
+	__atomic_store_n(ring->sqTail, ring->localTail, __ATOMIC_RELEASE);
+
+	for (;;)
+	{
+		// the time blocked in here is the time the ring thread had nothing to do but wait for I/O or an assembly
+		trace_span span;
+		traceBegin(&span);
+		int submitted = (int)syscall(__NR_io_uring_enter, ring->fd, ring->toSubmit, waitNum, waitNum ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		traceEnd(&span, TRACE_CAT_IO, "io_wait", NULL);
+		batchCountSyscalls(engine->batch, 1);
+		if (submitted >= 0)
+		{
+			ring->toSubmit -= (uint32_t)submitted;
+			return 0;
+		}
+		if (errno == EINTR) continue;
+
+		// the completion queue is full, reaping will make room
+		if (errno == EAGAIN || errno == EBUSY) return 0;
+		return -1;
+	}
+}
+
+/**
+ * @brief queueOp is a function that fills the next submission queue entry. The queue is sized so that it can't run out with
+ * URING_MAX_IN_FLIGHT jobs, but it is flushed first if it ever does.
+ *
+ * @param  engine - The engine
+ * @param  opcode - The io_uring opcode
+ * @param  index  - The job index
+ * @param  op     - The engine operation, stored in the user data
+ * @return the entry to fill in
+*/
+static struct io_uring_sqe* queueOp(uring_engine* engine, uint8_t opcode, uint32_t index, uring_op op)
+{
+	uring_ring* ring = &engine->ring;
+	if (ring->localTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries)
+		submitAndWait(engine, 0);
+
+	uint32_t slot = ring->localTail & ring->sqMask;
+	struct io_uring_sqe* sqe = &ring->sqes[slot];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = opcode;
+	sqe->user_data = ((uint64_t)index << URING_OP_BITS) | (uint64_t)op;
+	ring->sqArray[slot] = slot;
+	ring->localTail++;
+	ring->toSubmit++;
+	engine->opsPending++;
+	return sqe;
+}
+
+/**
+ * @brief queueClose is a function that closes the current file of the job through the ring.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @param  op     - URING_OP_CLOSE_SOURCE or URING_OP_CLOSE_OBJECT
+ * @return void
+*/
+static void queueClose(uring_engine* engine, uint32_t index, uring_op op)
+{
+	struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_CLOSE, index, op);
+	sqe->fd = engine->states[index].fd;
+	engine->states[index].fd = -1;
+}
+
+/**
+ * @brief queueRead is a function that reads the rest of the source of the job.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @return void
+*/
+static void queueRead(uring_engine* engine, uint32_t index)
+{
+	batch_job* job = &engine->batch->jobs[index];
+	struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_READ, index, URING_OP_READ);
+	sqe->fd = engine->states[index].fd;
+	sqe->addr = (uint64_t)(uintptr_t)(job->source + job->sourceLen);
+	sqe->len = (uint32_t)(engine->states[index].stx.stx_size - job->sourceLen);
+	sqe->off = job->sourceLen;
+}
+
+/**
+ * @brief queueWrite is a function that writes the rest of the object of the job.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @return void
+*/
+static void queueWrite(uring_engine* engine, uint32_t index)
+{
+	batch_job* job = &engine->batch->jobs[index];
+	uring_job* state = &engine->states[index];
+	struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_WRITE, index, URING_OP_WRITE);
+	sqe->fd = state->fd;
+	sqe->addr = (uint64_t)(uintptr_t)(job->object + state->written);
+	sqe->len = (uint32_t)(job->objectLen - state->written);
+	sqe->off = state->written;
+}
+
+/**
+ * @brief armWakeup is a function that reads the eventfd through the ring, so a finished assembly completes the wait in io_uring_enter.
+ *
+ * @param  engine - The engine
+ * @return void
+*/
+static void armWakeup(uring_engine* engine)
+{
+	struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_READ, 0, URING_OP_WAKEUP);
+	sqe->fd = engine->wakeFd;
+	sqe->addr = (uint64_t)(uintptr_t)&engine->wakeValue;
+	sqe->len = sizeof(engine->wakeValue);
+	engine->wakeArmed = 1;
+}
+
+/**
+ * @brief finishJob is a function that retires a job, freeing its buffers and making room for the next one.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @param  status - The final status of the job, ASM_OKAY keeps the status set by the assembly
+ * @return void
+*/
+static void finishJob(uring_engine* engine, uint32_t index, assemble_status status)
+{
+	batch_job* job = &engine->batch->jobs[index];
+	if (status != ASM_OKAY) job->status = status;
+	free(job->source);
+	free(job->object);
+	job->source = job->object = NULL;
+	engine->states[index].done = 1;
+	engine->inFlight--;
+	engine->numFinished++;
+}
+
+/**
+ * @brief startJob is a function that opens and stats the source of the next job in one submission.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @return void
+*/
+static void startJob(uring_engine* engine, uint32_t index)
+{
+	batch_job* job = &engine->batch->jobs[index];
+	uring_job* state = &engine->states[index];
+	state->fd = -1;
+	state->opensPending = 2;
+	engine->inFlight++;
+
+	struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_OPENAT, index, URING_OP_OPEN_SOURCE);
+	sqe->fd = AT_FDCWD;
+	sqe->addr = (uint64_t)(uintptr_t)job->sourcePath;
+	sqe->open_flags = O_RDONLY | O_CLOEXEC;
+
+	sqe = queueOp(engine, IORING_OP_STATX, index, URING_OP_STATX);
+	sqe->fd = AT_FDCWD;
+	sqe->addr = (uint64_t)(uintptr_t)job->sourcePath;
+	sqe->len = STATX_SIZE;
+	sqe->off = (uint64_t)(uintptr_t)&state->stx;
+}
+
+/**
+ * @brief assembleUringJob is the scheduler task which assembles a job once its source is in memory, then hands it back to the ring.
+ *
+ * @param  arg - The uring_task* being run
+ * @return void
+*/
+static void assembleUringJob(void* arg)
+{
+	uring_task* task = (uring_task*)arg;
+	uring_engine* engine = task->engine;
+	batch_job* job = &engine->batch->jobs[task->index];
+	trace_span span;
+
+	traceBegin(&span);
+	job->status = assembleBufferParallel(engine->batch->assembler, engine->sched, job->source, job->sourceLen, engine->batch->chunkBytes,
+		&job->object, &job->objectLen);
+	traceEnd(&span, TRACE_CAT_FILE, "file", job->sourcePath);
+	free(job->source);
+	job->source = NULL;
+
+	pthread_mutex_lock(&engine->doneLock);
+	engine->doneQueue[engine->numDone++] = task->index;
+	pthread_mutex_unlock(&engine->doneLock);
+
+	uint64_t one = 1;
+	if (write(engine->wakeFd, &one, sizeof(one)) < 0)
+		fprintf(stderr, "[WARN]: Could not wake up the io_uring engine: %s.\n", strerror(errno));
+	batchCountSyscalls(engine->batch, 1);
+}
+
+/**
+ * @brief startAssembly is a function that closes the source and submits the job to the scheduler once it is read, with its size as the cost.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @return void
+*/
+static void startAssembly(uring_engine* engine, uint32_t index)
+{
+	queueClose(engine, index, URING_OP_CLOSE_SOURCE);
+	if (schedulerSubmit(engine->sched, assembleUringJob, &engine->tasks[index], engine->batch->jobs[index].sourceLen) == NULL)
+		finishJob(engine, index, ASM_FAILED_OPEN);
+}
+
+/**
+ * @brief startRead is a function that allocates the source buffer once both the open and the statx of the source completed.
+ *
+ * @param  engine - The engine
+ * @param  index  - The job index
+ * @return void
+*/
+static void startRead(uring_engine* engine, uint32_t index)
+{
+	batch_job* job = &engine->batch->jobs[index];
+	uring_job* state = &engine->states[index];
+
+	if (!state->failed)
+	{
+		job->source = (char*)malloc(state->stx.stx_size > 0 ? (size_t)state->stx.stx_size : 1);
+		if (!job->source)
+		{
+			fprintf(stderr, "[ERROR]: could not malloc the source of \"%s\".\n", job->sourcePath);
+			state->failed = 1;
+		}
+	}
+
+	if (state->failed)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", job->sourcePath);
+		if (state->fd >= 0) queueClose(engine, index, URING_OP_CLOSE_SOURCE);
+		finishJob(engine, index, ASM_FAILED_OPEN);
+		return;
+	}
+
+	// an empty file goes straight to the assembler, which reports it
+	if (state->stx.stx_size == 0)
+		startAssembly(engine, index);
+	else
+		queueRead(engine, index);
+}
+
+/**
+ * @brief drainDone is a function that takes every job assembled since the last wakeup and opens its object file.
+ *
+ * @param  engine - The engine
+ * @return void
+*/
+static void drainDone(uring_engine* engine)
+{
+	pthread_mutex_lock(&engine->doneLock);
+	for (uint32_t i = 0; i < engine->numDone; i++)
+	{
+		uint32_t index = engine->doneQueue[i];
+		batch_job* job = &engine->batch->jobs[index];
+		if (job->status != ASM_OKAY)
+		{
+			finishJob(engine, index, ASM_OKAY);
+			continue;
+		}
+
+		struct io_uring_sqe* sqe = queueOp(engine, IORING_OP_OPENAT, index, URING_OP_OPEN_OBJECT);
+		sqe->fd = AT_FDCWD;
+		sqe->addr = (uint64_t)(uintptr_t)job->objectPath;
+		sqe->len = 0644;
+		sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+	}
+	engine->numDone = 0;
+	pthread_mutex_unlock(&engine->doneLock);
+}
+
+/**
+ * @brief handleCompletion is a function that advances the job a completion belongs to to its next step.
+ *
+ * @param  engine - The engine
+ * @param  cqe    - The completion
+ * @return void
+*/
+static void handleCompletion(uring_engine* engine, const struct io_uring_cqe* cqe)
+{
+	uint32_t index = (uint32_t)(cqe->user_data >> URING_OP_BITS);
+	uring_op op = (uring_op)(cqe->user_data & URING_OP_MASK);
+	int result = cqe->res;
+	batch_job* job = &engine->batch->jobs[index];
+	uring_job* state = &engine->states[index];
+	engine->opsPending--;
+
+	switch (op)
+	{
+	case URING_OP_WAKEUP:
+		engine->wakeArmed = 0;
+		drainDone(engine);
+		if (engine->numFinished < engine->batch->numJobs)
+			armWakeup(engine);
+		break;
+
+	case URING_OP_OPEN_SOURCE:
+	case URING_OP_STATX:
+		if (result < 0) state->failed = 1;
+		else if (op == URING_OP_OPEN_SOURCE) state->fd = result;
+		if (--state->opensPending == 0)
+			startRead(engine, index);
+		break;
+
+	case URING_OP_READ:
+		if (result < 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not read \"%s\": %s.\n", job->sourcePath, strerror(-result));
+			queueClose(engine, index, URING_OP_CLOSE_SOURCE);
+			finishJob(engine, index, ASM_FAILED_OPEN);
+			break;
+		}
+
+		// short reads are resubmitted until the size from statx is reached or the file ends early
+		job->sourceLen += (size_t)result;
+		if (result > 0 && job->sourceLen < state->stx.stx_size)
+			queueRead(engine, index);
+		else
+			startAssembly(engine, index);
+		break;
+
+	case URING_OP_OPEN_OBJECT:
+		if (result < 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", job->objectPath);
+			finishJob(engine, index, ASM_FAILED_WRITING_TO_OBJ);
+			break;
+		}
+		state->fd = result;
+		if (job->objectLen > 0)
+			queueWrite(engine, index);
+		else
+			queueClose(engine, index, URING_OP_CLOSE_OBJECT);
+		break;
+
+	case URING_OP_WRITE:
+		if (result <= 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not write \"%s\": %s.\n", job->objectPath, strerror(result < 0 ? -result : EIO));
+			job->status = ASM_FAILED_WRITING_TO_OBJ;
+			queueClose(engine, index, URING_OP_CLOSE_OBJECT);
+			break;
+		}
+		state->written += (size_t)result;
+		if (state->written < job->objectLen)
+			queueWrite(engine, index);
+		else
+			queueClose(engine, index, URING_OP_CLOSE_OBJECT);
+		break;
+
+	case URING_OP_CLOSE_OBJECT:
+		finishJob(engine, index, (result < 0) ? ASM_FAILED_WRITING_TO_OBJ : ASM_OKAY);
+		break;
+
+	case URING_OP_CLOSE_SOURCE:
+		break;
+	}
+}
+
+/**
+ * @brief runEngine is a function that keeps up to URING_MAX_IN_FLIGHT jobs going through the ring until every job is finished
+ * and every submission has completed.
+ *
+ * @param  engine - The engine
+ * @return 0 on success, 1 if io_uring_enter failed
+*/
+static int runEngine(uring_engine* engine)
+{
+	uring_ring* ring = &engine->ring;
+	sic_batch* batch = engine->batch;
+	armWakeup(engine);
+
+	while (engine->numFinished < batch->numJobs || engine->opsPending > 0)
+	{
+		while (engine->inFlight < URING_MAX_IN_FLIGHT && engine->nextJob < batch->numJobs)
+			startJob(engine, engine->nextJob++);
+
+		// the wakeup read has to complete before its buffer goes away
+		if (engine->numFinished == batch->numJobs && engine->wakeArmed && !engine->wakeKicked)
+		{
+			uint64_t one = 1;
+			if (write(engine->wakeFd, &one, sizeof(one)) < 0) return 1;
+			batchCountSyscalls(batch, 1);
+			engine->wakeKicked = 1;
+		}
+
+		if (submitAndWait(engine, 1) != 0)
+		{
+			fprintf(stderr, "[ERROR]: io_uring_enter failed: %s.\n", strerror(errno));
+			return 1;
+		}
+
+		uint32_t head = *ring->cqHead;
+		uint32_t tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		while (head != tail)
+		{
+			handleCompletion(engine, &ring->cqes[head & ring->cqMask]);
+			head++;
+		}
+		__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+	}
+	return 0;
+}
+
+int runBatchIoUring(sic_batch* batch)
+{
+	uring_engine engine;
+	memset(&engine, 0, sizeof(engine));
+	engine.batch = batch;
+	engine.wakeFd = -1;
+
+	if (setupRing(&engine) != 0)
+	{
+		teardownRing(&engine);
+		return -1;
+	}
+
+	engine.states = (uring_job*)calloc(batch->numJobs, sizeof(uring_job));
+	engine.tasks = (uring_task*)malloc(batch->numJobs * sizeof(uring_task));
+	engine.doneQueue = (uint32_t*)malloc(batch->numJobs * sizeof(uint32_t));
+	engine.wakeFd = eventfd(0, EFD_CLOEXEC);
+	batchCountSyscalls(batch, 1);
+	engine.sched = createScheduler(batch->numWorkers);
+
+	int result = 1;
+	if (engine.states && engine.tasks && engine.doneQueue && engine.wakeFd >= 0 && engine.sched)
+	{
+		pthread_mutex_init(&engine.doneLock, NULL);
+		for (uint32_t i = 0; i < batch->numJobs; i++)
+		{
+			engine.tasks[i].engine = &engine;
+			engine.tasks[i].index = i;
+		}
+
+		result = runEngine(&engine);
+
+		// the workers may still be using the done queue if the ring failed part way
+		batch->numSteals = engine.sched->numSteals;
+		freeScheduler(engine.sched);
+		engine.sched = NULL;
+		for (uint32_t i = 0; i < batch->numJobs; i++)
+		{
+			if (engine.states[i].done) continue;
+			batch->jobs[i].status = ASM_FAILED_OPEN;
+			if (engine.states[i].fd > 0) close(engine.states[i].fd);
+		}
+		pthread_mutex_destroy(&engine.doneLock);
+	}
+	else
+		fprintf(stderr, "[ERROR]: could not set up the io_uring engine.\n");
+
+	teardownRing(&engine);
+	freeScheduler(engine.sched);
+	if (engine.wakeFd >= 0) close(engine.wakeFd);
+	free(engine.states);
+	free(engine.tasks);
+	free(engine.doneQueue);
+	return result;
+}
+
+#else
+
+int runBatchIoUring(sic_batch* batch)
+{
+	(void)batch;
+	return -1;
+}
+
+#endif //SIC_HAVE_IO_URING
@@ -0,0 +1,45 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef IO_URING_ENGINE_H
+#define IO_URING_ENGINE_H
+
+// Local includes //
+
+#include "batch.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define SIC_HAVE_IO_URING 1
+#endif
+#endif
+
+#define URING_ENTRIES 256
+#define URING_MAX_IN_FLIGHT 64
+#define URING_OP_BITS 3
+#define URING_OP_MASK ((1 << URING_OP_BITS) - 1)
+
+// Function declarations //
+
+/**
+ * @brief runBatchIoUring is the io_uring I/O engine. A single thread drives one ring that opens, stats, reads, writes and closes the files of
+ * many jobs at once without blocking, while the assembly itself runs on the work stealing scheduler. Finished assemblies are handed back to the ring through
+ * an eventfd, so the submitting thread only ever sleeps in io_uring_enter. Syscalls are reaped in batches, which is where the savings over the
+ * thread pool engine come from.
+ *
+ * @param  batch - The batch to run.
+ * @return 0 on success, 1 if the engine failed part way, -1 if io_uring is not available and nothing was done
+ */
+int runBatchIoUring(sic_batch* batch);
+
+#endif //IO_URING_ENGINE_H
@@ -0,0 +1,184 @@
+#include "lines.h"
+#include "scoff_bin.h"
+
+sic_line_table* createLineTable(void)
+{
+	sic_line_table* table = (sic_line_table*)sicCalloc(ALLOC_OTHER, 1, sizeof(sic_line_table));
+	if (table) table->entries = (sic_line_entry*)sicMalloc(ALLOC_OTHER, LINES_INITIAL_ENTRIES * sizeof(sic_line_entry));
+	if (!table || !table->entries)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the line table.\n");
+		freeLineTable(table);
+		return NULL;
+	}
+
+	table->capacity = LINES_INITIAL_ENTRIES;
+	return table;
+}
+
+void freeLineTable(sic_line_table* table)
+{
+	if (!table) return;
+
+	sicFree(ALLOC_OTHER, table->entries);
+	sicFree(ALLOC_OTHER, table);
+}
+
+sic_line_table* lineTableAdd(sic_line_table* table, uint32_t address, uint32_t size, uint32_t line)
+{
+	if (table->numEntries == table->capacity)
+	{
+		sic_line_entry* grown = (sic_line_entry*)sicRealloc(ALLOC_OTHER, table->entries, 2 * table->capacity * sizeof(sic_line_entry));
+		if (!grown)
+		{
+			fprintf(stderr, "[ERROR]: Could not grow the line table.\n");
+			return NULL;
+		}
+		table->entries = grown;
+		table->capacity *= 2;
+	}
+
+	table->entries[table->numEntries].address = address;
+	table->entries[table->numEntries].line = line;
+	table->numEntries++;
+	table->endAddress = address + size;
+	return table;
+}
+
+uint32_t findLine(const sic_line_table* table, uint32_t address)
+{
+	if (table->numEntries == 0 || address < table->entries[0].address || address >= table->endAddress) return LINES_NO_LINE;
+
+	// find the last entry which starts at or before the address
+	uint32_t low = 0;
+	uint32_t high = table->numEntries - 1;
+	while (low < high)
+	{
+		uint32_t mid = low + (high - low + 1) / 2;
+		if (table->entries[mid].address <= address) low = mid;
+		else high = mid - 1;
+	}
+	return table->entries[low].line;
+}
+
+sic_line_table* writeLineTableToFile(sic_line_table* table, const char* fileName)
+{
+	// name the table the way writeSCOFFToFile names the object, with the .lines extension
+	const char* folder = strrchr(fileName, '\\');
+	if (folder++) fileName = folder;
+
+	size_t bufferBytes = strlen(fileName) + LINES_EXTENSION_LEN + 1;
+	char* buffer = (char*)sicMalloc(ALLOC_OTHER, bufferBytes);
+	if (!buffer)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc temporary buffer during ouput of the line table to file.\n");
+		return NULL;
+	}
+	strcpy(buffer, fileName);
+	strcat(buffer, LINES_EXTENSION);
+
+	FILE* outFile = fopen(buffer, "wb");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the line table.\n", buffer);
+		sicFree(ALLOC_OTHER, buffer);
+		return NULL;
+	}
+
+	fwrite(LINES_MAGIC, 1, LINES_MAGIC_LEN, outFile);
+	fputc(LINES_VERSION, outFile);
+	putVarint(table->numEntries, outFile);
+
+	uint32_t previousAddress = 0;
+	uint32_t previousLine = 0;
+	for (uint32_t i = 0; i < table->numEntries; i++)
+	{
+		putVarint(table->entries[i].address - previousAddress, outFile);
+		putVarint(zigzag((int64_t)table->entries[i].line - previousLine), outFile);
+		previousAddress = table->entries[i].address;
+		previousLine = table->entries[i].line;
+	}
+	putVarint(table->endAddress - previousAddress, outFile);
+
+	sic_line_table* written = table;
+	int failed = ferror(outFile);
+	if (fclose(outFile) != 0 || failed)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the line table file \"%s\".\n", buffer);
+		written = NULL;
+	}
+
+	sicFree(ALLOC_OTHER, buffer);
+	return written;
+}
+
+/**
+ * @brief readLineEntries is a function that reads the entries and the end address of a .lines file into the table, after the magic
+ * and version have been checked.
+ *
+ * @param  table - The table being read into
+ * @param  data  - The contents of the file
+ * @param  len   - The length of the data
+ * @param  pos   - The position, left at the problem on error
+ * @return NULL on success, or the problem with the file
+*/
+static const char* readLineEntries(sic_line_table* table, const uint8_t* data, size_t len, size_t* pos)
+{
+	uint64_t numEntries;
+	if (!getVarint(data, len, pos, &numEntries)) return "the number of entries is cut short";
+
+	// every entry takes at least 2 bytes, so a bad count can't make the table huge
+	if (numEntries > (len - *pos) / 2) return "there are fewer entries than the count says";
+
+	uint64_t address = 0;
+	int64_t line = 0;
+	for (uint64_t i = 0; i < numEntries; i++)
+	{
+		uint64_t addressDelta, lineDelta;
+		if (!getVarint(data, len, pos, &addressDelta) || !getVarint(data, len, pos, &lineDelta)) return "an entry is cut short";
+		if (i > 0 && addressDelta == 0) return "two entries start at the same address";
+
+		address += addressDelta;
+		line += unzigzag(lineDelta);
+		if (address > SIC_MEMORY_LIMIT) return "an entry is past the end of SIC memory";
+		if (line <= LINES_NO_LINE || line > UINT32_MAX) return "an entry has a line number out of range";
+		if (lineTableAdd(table, (uint32_t)address, 1, (uint32_t)line) == NULL) return "the table could not be grown";
+	}
+
+	uint64_t endDelta;
+	if (!getVarint(data, len, pos, &endDelta)) return "the end address is cut short";
+	if (numEntries > 0 && endDelta == 0) return "the last entry is empty";
+	if (address + endDelta > SIC_MEMORY_LIMIT + 1) return "the end address is past the end of SIC memory";
+	table->endAddress = (uint32_t)(address + endDelta);
+
+	if (*pos != len) return "there is more after the end address";
+	return NULL;
+}
+
+sic_line_table* readLineTable(const uint8_t* data, size_t len)
+{
+	if (len < LINES_MAGIC_LEN + 1 || memcmp(data, LINES_MAGIC, LINES_MAGIC_LEN) != 0)
+	{
+		fprintf(stderr, "[ERROR : 0]: The file is not a line table, it does not start with \"%s\".\n", LINES_MAGIC);
+		return NULL;
+	}
+	if (data[LINES_MAGIC_LEN] != LINES_VERSION)
+	{
+		fprintf(stderr, "[ERROR : %d]: The line table is version %u, only version %d can be read.\n", LINES_MAGIC_LEN, data[LINES_MAGIC_LEN],
+			LINES_VERSION);
+		return NULL;
+	}
+
+	sic_line_table* table = createLineTable();
+	if (!table) return NULL;
+
+	size_t pos = LINES_MAGIC_LEN + 1;
+	const char* problem = readLineEntries(table, data, len, &pos);
+	if (problem)
+	{
+		fprintf(stderr, "[ERROR : %zu]: The line table is not valid, %s.\n", pos, problem);
+		freeLineTable(table);
+		return NULL;
+	}
+	return table;
+}
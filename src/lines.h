@@ -0,0 +1,127 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef LINES_H // address to source line table
+#define LINES_H
+
+// Local includes //
+
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define LINES_MAGIC "SICL"
+#define LINES_MAGIC_LEN 4
+#define LINES_VERSION 1
+#define LINES_EXTENSION ".lines"
+#define LINES_EXTENSION_LEN 6
+#define LINES_INITIAL_ENTRIES 256
+#define LINES_NO_LINE 0 // source lines are counted from 1
+
+// Structs and enums //
+
+/**
+ * @brief sic_line_entry is the start of a range of addresses which belong to one source line. The range runs up to the address of the
+ * next entry, or the end address of the table for the last one.
+ */
+typedef struct
+{
+	uint32_t address;
+	uint32_t line;
+
+} sic_line_entry;
+
+/**
+ * @brief sic_line_table maps the addresses of a program back to the source lines which put bytes there. The entries are sorted by
+ * address and only lines which take up memory have one, so comments and lines like START and END are never found.
+ *
+ * The .lines file is, in order:
+ *   magic "SICL" and a version byte,
+ *   the number of entries as a varint,
+ *   for each entry its distance from the address of the one before (from 0 for the first) as a varint, and its distance from the line
+ *   of the one before (from 0 for the first) as a zigzag varint,
+ *   and the distance from the address of the last entry to the end address as a varint.
+ *
+ * The addresses and lines of a source only go up, so each entry is almost always 2 bytes.
+ */
+typedef struct
+{
+	sic_line_entry* entries;
+	uint32_t numEntries;
+	uint32_t capacity;
+	uint32_t endAddress;
+
+} sic_line_table;
+
+// Function declarations //
+
+/**
+ * @brief createLineTable is a function that creates an empty line table.
+ *
+ * NOTE: that caller needs to free the table after use by using freeLineTable().
+ *
+ * @param  void
+ * @return table or NULL on error
+ */
+sic_line_table* createLineTable(void);
+
+/**
+ * @brief freeLineTable is a function that frees the line table. The function returns nothing.
+ *
+ * @param  table - The table to free, may be NULL.
+ * @return void
+ */
+void freeLineTable(sic_line_table* table);
+
+/**
+ * @brief lineTableAdd is a function that adds the range of a source line which starts at the address and ends where the next one
+ * starts. The addresses have to be added in increasing order, and the end address of the table moves to the end of the range.
+ *
+ * @param  table   - The table.
+ * @param  address - The first address of the line.
+ * @param  size    - The number of bytes the line takes up, more than 0.
+ * @param  line    - The source line number.
+ * @return table or NULL on error
+ */
+sic_line_table* lineTableAdd(sic_line_table* table, uint32_t address, uint32_t size, uint32_t line);
+
+/**
+ * @brief findLine is a function that finds the source line which put the byte at the address there, with a binary search.
+ *
+ * @param  table   - The table.
+ * @param  address - The address, such as the PC of an instruction.
+ * @return the line, or LINES_NO_LINE if no line covers the address
+ */
+uint32_t findLine(const sic_line_table* table, uint32_t address);
+
+/**
+ * @brief writeLineTableToFile is a function that writes the table to the .lines file named after the source file, which is the
+ * file name with the .lines extension, the same way writeSCOFFToFile() names the text object.
+ *
+ * @param  table    - The table to write.
+ * @param  fileName - The name of the source file.
+ * @return table or NULL on error
+ */
+sic_line_table* writeLineTableToFile(sic_line_table* table, const char* fileName);
+
+/**
+ * @brief readLineTable is a function that reads a .lines file back into a table. It checks that the addresses only go up and stay
+ * inside SIC memory, and prints the byte offset of the first problem and returns NULL if the data is not such a file.
+ *
+ * NOTE: that caller needs to free the table after use by using freeLineTable().
+ *
+ * @param  data - The contents of the .lines file.
+ * @param  len  - The length of the data.
+ * @return table or NULL on error
+ */
+sic_line_table* readLineTable(const uint8_t* data, size_t len);
+
+#endif //LINES_H
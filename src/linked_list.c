@@ -2,7 +2,7 @@
 
 linked_list* createLinkedList(void)
 {
-	linked_list* list = (linked_list*)malloc(sizeof(linked_list));
+	linked_list* list = (linked_list*)sicMalloc(ALLOC_LIST_NODES, sizeof(linked_list));
 	if (!list)
 	{
 #ifdef _DEBUG
@@ -26,7 +26,7 @@ void* addToList(linked_list* list, void* data)
 	}
 
 	// allocate node
-	ll_node* node = (ll_node*)malloc(sizeof(ll_node));
+	ll_node* node = (ll_node*)sicMalloc(ALLOC_LIST_NODES, sizeof(ll_node));
 	if (!node)
 	{
 #ifdef _DEBUG
@@ -48,6 +48,23 @@ void* addToList(linked_list* list, void* data)
 	return data;
 }
 
+linked_list* appendList(linked_list* list, linked_list* source)
+{
+	if (source->head == NULL) return list;
+
+	// splice the source nodes after the tail
+	if (list->head == NULL)
+		list->head = source->head;
+	else
+		list->tail->next = source->head;
+
+	list->tail = source->tail;
+	list->numberOfElements += source->numberOfElements;
+	source->head = source->tail = NULL;
+	source->numberOfElements = 0;
+	return list;
+}
+
 void freeList(linked_list* list)
 {
 	if (list == NULL)
@@ -65,10 +82,10 @@ void freeList(linked_list* list)
 	{
 		tmp = current;
 		current = current->next;
-		free(tmp);
+		sicFree(ALLOC_LIST_NODES, tmp);
 	}
 	
-	free(list);
+	sicFree(ALLOC_LIST_NODES, list);
 }
 
 void freeListAndValues(linked_list* list)
@@ -88,9 +105,9 @@ void freeListAndValues(linked_list* list)
 	{
 		tmp = current;
 		current = current->next;
-		free(tmp->data);
-		free(tmp);
+		sicFree(list->valueSubsystem, tmp->data);
+		sicFree(ALLOC_LIST_NODES, tmp);
 	}
 
-	free(list);
+	sicFree(ALLOC_LIST_NODES, list);
 }
@@ -5,6 +5,10 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
+// Local includes //
+
+#include "alloc.h"
+
 // Standard library includes //
 
 #include <stdlib.h>
@@ -31,13 +35,15 @@ typedef struct ll_node
 /**
  * @brief linked_list holds the number of elements within the linked list and a reference to the head and tail of the linked list.
  * The linked list will only provide an add(data) operation, freeList(linked_list), and freeListAndValues(linked_list).
- * Traversal of the list can be done manually by looping through the nodes from head to tail.
+ * Traversal of the list can be done manually by looping through the nodes from head to tail. The list and its nodes are charged
+ * to ALLOC_LIST_NODES, the values freed by freeListAndValues to valueSubsystem.
  */
 typedef struct
 {
 	uint32_t numberOfElements;
 	ll_node* head;
 	ll_node* tail;
+	alloc_subsystem valueSubsystem;
 }linked_list;
 
 // Functions //
@@ -64,6 +70,17 @@ linked_list* createLinkedList(void);
 */
 void* addToList(linked_list* list, void* data);
 
+/**
+ * @brief appendList will move every node of the source list to the end of the destination list in O(1). The function
+ * will accept the destination and source linked_list pointers. The source list is left empty but is not freed.
+ * The function returns the destination list.
+ *
+ * @param  list   - The linked list the nodes are added to
+ * @param  source - The linked list the nodes are taken from
+ * @return list
+*/
+linked_list* appendList(linked_list* list, linked_list* source);
+
 /**
  * @brief freeList will free the given linked list and nodes. The function will accept a linked_list pointer
  * to the list that they want freed. The function returns nothing.
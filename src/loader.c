@@ -0,0 +1,134 @@
+#include "loader.h"
+
+/**
+ * @brief compareRelocEntries is the qsort comparator which orders the entries by offset, and the narrower field first at the same offset.
+ *
+ * @param  a - The first sic_reloc_entry*
+ * @param  b - The second sic_reloc_entry*
+ * @return negative if a goes first, positive if b does, 0 if they are the same field
+*/
+static int compareRelocEntries(const void* a, const void* b)
+{
+	const sic_reloc_entry* entryA = (const sic_reloc_entry*)a;
+	const sic_reloc_entry* entryB = (const sic_reloc_entry*)b;
+	if (entryA->offset != entryB->offset) return (entryA->offset < entryB->offset) ? -1 : 1;
+	return (int)entryA->numBytes - (int)entryB->numBytes;
+}
+
+sic_reloc_table* createRelocTable(const sic_scoff_records* records)
+{
+	sic_reloc_table* table = (sic_reloc_table*)sicCalloc(ALLOC_OTHER, 1, sizeof(sic_reloc_table));
+	if (!table)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the relocation table.\n");
+		return NULL;
+	}
+	table->startAddress = (uint32_t)strtoul(records->header.startAddr, NULL, 16);
+	uint32_t length = (uint32_t)strtoul(records->header.lengthOfProgram, NULL, 16);
+
+	table->entries = (sic_reloc_entry*)sicMalloc(ALLOC_OTHER, (records->modifications->numberOfElements + 1) * sizeof(sic_reloc_entry));
+	if (!table->entries)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the entries of the relocation table.\n");
+		sicFree(ALLOC_OTHER, table);
+		return NULL;
+	}
+
+	// turn every M record into the bytes and bits it patches
+	uint8_t sorted = 1;
+	table->addressesOnly = 1;
+	for (ll_node* node = records->modifications->head; node; node = node->next)
+	{
+		sic_scoff_mod* mod = (sic_scoff_mod*)node->data;
+		uint32_t addr = (uint32_t)strtoul(mod->startAddr, NULL, 16);
+		uint32_t halfBytes = (uint32_t)strtoul(mod->lenOfModificationHB, NULL, 16);
+		sic_reloc_entry* entry = &table->entries[table->numEntries];
+		entry->numBytes = (uint8_t)((halfBytes + 1) / 2);
+		entry->mask = (uint32_t)((1ULL << (4 * halfBytes)) - 1);
+		entry->sign = (mod->modificationFlag == '-') ? -1 : 1;
+		entry->offset = addr - table->startAddress;
+
+		if (halfBytes == 0 || halfBytes > LOADER_MAX_HALF_BYTES || (mod->modificationFlag != '+' && mod->modificationFlag != '-'))
+		{
+			fprintf(stderr, "[ERROR]: The M record at %06X can't be relocated, it must be 1 to 6 half bytes with a + or - flag.\n", addr);
+			freeRelocTable(table);
+			return NULL;
+		}
+		if (addr < table->startAddress || entry->offset + entry->numBytes > length)
+		{
+			fprintf(stderr, "[ERROR]: The M record at %06X is outside of the program.\n", addr);
+			freeRelocTable(table);
+			return NULL;
+		}
+
+		if (table->numEntries > 0 && compareRelocEntries(entry - 1, entry) > 0) sorted = 0;
+		if (entry->numBytes != 2 || entry->mask != 0xFFFF || entry->sign != 1) table->addressesOnly = 0;
+		table->numEntries++;
+	}
+
+	// the assembler writes the records in address order already, so this is only for objects from elsewhere
+	if (!sorted) qsort(table->entries, table->numEntries, sizeof(sic_reloc_entry), compareRelocEntries);
+
+	return table;
+}
+
+void freeRelocTable(sic_reloc_table* table)
+{
+	if (!table) return;
+
+	sicFree(ALLOC_OTHER, table->entries);
+	sicFree(ALLOC_OTHER, table);
+}
+
+sic_image* relocateImage(const sic_image* image, const sic_reloc_table* table, uint32_t base)
+{
+	if ((uint64_t)base + image->length > SIC_MEMORY_LIMIT + 1)
+	{
+		fprintf(stderr, "[ERROR]: The program is %u bytes long and does not fit in the SIC memory at %06X.\n", image->length, base);
+		return NULL;
+	}
+
+	sic_image* moved = (sic_image*)sicMalloc(ALLOC_OTHER, sizeof(sic_image));
+	uint8_t* bytes = (uint8_t*)sicMalloc(ALLOC_OTHER, image->length + 1);
+	if (!moved || !bytes)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the relocated image.\n");
+		sicFree(ALLOC_OTHER, moved);
+		sicFree(ALLOC_OTHER, bytes);
+		return NULL;
+	}
+	memcpy(bytes, image->bytes, image->length);
+	moved->bytes = bytes;
+	moved->length = image->length;
+	moved->startAddress = base;
+	uint32_t delta = base - table->startAddress; // wraps when moving down, which the masks undo
+	moved->entryPoint = (image->entryPoint + delta) & SIC_WORD_MASK;
+
+	const sic_reloc_entry* entries = table->entries;
+	if (table->addressesOnly)
+	{
+		// every field is the 16 bits after an opcode
+		for (uint32_t i = 0; i < table->numEntries; i++)
+		{
+			uint8_t* field = bytes + entries[i].offset;
+			uint32_t value = (((uint32_t)field[0] << 8) | field[1]) + delta;
+			field[0] = (uint8_t)(value >> 8);
+			field[1] = (uint8_t)value;
+		}
+		return moved;
+	}
+
+	for (uint32_t i = 0; i < table->numEntries; i++)
+	{
+		uint8_t* field = bytes + entries[i].offset;
+		uint32_t value = 0;
+		for (uint8_t b = 0; b < entries[i].numBytes; b++)
+			value = (value << 8) | field[b];
+
+		uint32_t patched = (value + (entries[i].sign > 0 ? delta : 0 - delta)) & entries[i].mask;
+		value = (value & ~entries[i].mask) | patched;
+		for (int32_t b = entries[i].numBytes - 1; b >= 0; b--, value >>= 8)
+			field[b] = (uint8_t)value;
+	}
+	return moved;
+}
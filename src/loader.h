@@ -0,0 +1,91 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef LOADER_H // relocating loader
+#define LOADER_H
+
+// Local includes //
+
+#include "scoff.h"
+#include "image.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define LOADER_MAX_HALF_BYTES 6 // a field is at most a SIC word
+
+// Structs and enums //
+
+/**
+ * @brief sic_reloc_entry is one field the loader patches, worked out from an M record. The offset is from the start of the image and
+ * the field is the low half bytes * 4 bits of the numBytes bytes there, read big endian. The sign is +1 for an M record with the '+'
+ * flag and -1 for '-'.
+ */
+typedef struct
+{
+	uint32_t offset;
+	uint32_t mask;
+	uint8_t numBytes;
+	int8_t sign;
+
+} sic_reloc_entry;
+
+/**
+ * @brief sic_reloc_table is every M record of an object turned into entries and sorted by offset, so moving the program to a new base
+ * is one pass from the front of the image to the back. It is built once per object and used for every base. When every entry is a
+ * '+' on the 4 half bytes after an opcode, which is all the SIC assembler writes, the table is marked as addresses only and the pass
+ * is a loop over 16 bit fields with nothing else to look at.
+ */
+typedef struct
+{
+	uint32_t startAddress;
+	uint32_t numEntries;
+	uint8_t addressesOnly;
+	sic_reloc_entry* entries;
+
+} sic_reloc_table;
+
+// Function declarations //
+
+/**
+ * @brief createRelocTable is a function that builds the relocation table of an object from its M records. It prints an error and
+ * returns NULL if an M record is outside of the program or its field can't be relocated.
+ *
+ * NOTE: that caller needs to free the table after use by using freeRelocTable().
+ *
+ * @param  records - The records of the object.
+ * @return table or NULL on error
+ */
+sic_reloc_table* createRelocTable(const sic_scoff_records* records);
+
+/**
+ * @brief freeRelocTable is a function that frees the relocation table. The function returns nothing.
+ *
+ * @param  table - The table to free, may be NULL.
+ * @return void
+ */
+void freeRelocTable(sic_reloc_table* table);
+
+/**
+ * @brief relocateImage is a function that copies the image of the program to a new image placed at the base address, and adds the
+ * distance it moved to every field in the relocation table in one pass. The entry point moves with it. It prints an error and returns
+ * NULL if the program does not fit in the SIC memory at that base.
+ *
+ * NOTE: that caller needs to free the image after use by using freeImage().
+ *
+ * @param  image - The image at the start address the object was assembled for.
+ * @param  table - The relocation table of the same object.
+ * @param  base  - The address to place the program at.
+ * @return image or NULL on error
+ */
+sic_image* relocateImage(const sic_image* image, const sic_reloc_table* table, uint32_t base);
+
+#endif //LOADER_H
@@ -11,169 +11,225 @@
 
 // Define constants //
 #define NUM_CLI_ARGS 2
+#define WATCH_FLAG "--watch"
+#define JOBS_FLAG "--jobs"
+#define BATCH_FLAG "--batch"
+#define IO_FLAG "--io"
+#define IO_URING_NAME "uring"
+#define IO_THREADS_NAME "threads"
+#define COST_FLAG "--cost"
+#define COST_SIZE_NAME "size"
+#define COST_LINES_NAME "lines"
+#define CHUNK_FLAG "--chunk-kib"
+#define STATS_FLAG "--stats"
+#define STATS_JSON_FLAG "--stats-json"
+#define PERF_FLAG "--perf-counters"
+#define TRACE_FLAG "--trace"
+#define FORMAT_TEXT_FLAG "--format=text"
+#define FORMAT_BIN_FLAG "--format=bin"
+#define IMAGE_FLAG "--image"
+#define LINES_FLAG "--lines"
+#define SYMBOLS_FLAG "--symbols"
+#define STDIN_PATH "-"
 
 // local includes //
-#include "hash_table.h"
-#include "sic.h"
-#include "directive.h"
-#include "opcode.h"
-#include "scoff.h"
-
-// Enums //
-
-/**
- * @brief cleanup_code enum is used to signal to the main function if anything went wrong, and how to free the memory.
- * This was prefered to the goto statements used previously because its a bit clearer whats going on. Easier to maintaine too.
- */
-typedef enum
-{
-	NO_ERRORS = 0,
-	FAILED_OPCODE_TABLE,
-	FAILED_DIRECTIVE_TABLE,
-	FAILED_SYMBOL_TABLE,
-	FAILED_SEEK,
-	FAILED_RECORD_GEN,
-	FAILED_WRITING_TO_OBJ
-
-} cleanup_code;
+#include "assembler.h"
+#include "watch.h"
+#include "batch.h"
 
 // Function declarations //
 
 /**
- * @brief loadFile is a function that takes in a given file path as const char* and returns a read-mode FILE* on successful open.
- * If the loading of the file was unsuccessful, NULL will be returned instead.
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
  *
- * Note that the FILE* stays open until caller decides to use fclose(). The caller is responsible for closing it.
- * 
- * @param  filePath - The file path to the file to be opened. 
- * @return Pointer to open file or NULL if an error occurred.
- */
-FILE* openFile(const char* filePath);
-
-/**
- * @brief closeFile is a function that will close a given FILE*. The function accepts a FILE* and returns nothing.
- * The function will also set the FILE* to NULL to indicate that it has been closed.
- * 
- * @param  filePath  - The file path to the file to be closed.
+ * @param  programName - argv[0]
  * @return void
 */
-void closeFile(FILE* filePath);
+void printUsage(const char* programName);
 
 /**
  * @brief the main function is the entry point of the program. It will handle passed in arguments and call the helper functions
- * in order to complete the first pass of the assembler.
- * 
+ * in order to assemble a single file (or stdin to stdout when the path is "-"), a batch of files and directories at once, or to watch a directory
+ * and re-assemble the files in it as they change.
+ *
  * @param  argc - number of arguments
  * @param  argv - array of arguments
  * @return return code
 */
 int main(int argc, char** argv)
 {
-	if (argc != NUM_CLI_ARGS)
+	const char* watchDir = NULL;
+	const char* filePath = NULL;
+	uint32_t numWorkers = 0;
+	uint8_t batchMode = 0;
+	batch_io_engine ioEngine = BATCH_IO_AUTO;
+	batch_cost_model costModel = BATCH_COST_SIZE;
+	size_t chunkBytes = 0;
+	uint8_t statsMode = 0; // 0 off, 1 table, 2 JSON
+	uint8_t perfMode = 0;
+	const char* tracePath = NULL;
+	scoff_format objectFormat = SCOFF_FORMAT_TEXT;
+	uint8_t emitLines = 0;
+	uint8_t emitSymbols = 0;
+
+	// every path is kept since a batch takes several of them
+	const char** paths = (const char**)malloc(argc * sizeof(char*));
+	if (!paths) return 1;
+	uint32_t numPaths = 0;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (strcmp(argv[i], WATCH_FLAG) == 0 && i + 1 < argc)
+			watchDir = argv[++i];
+		else if (strcmp(argv[i], JOBS_FLAG) == 0 && i + 1 < argc)
+			numWorkers = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], BATCH_FLAG) == 0)
+			batchMode = 1;
+		else if (strcmp(argv[i], IO_FLAG) == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], IO_URING_NAME) == 0) ioEngine = BATCH_IO_URING;
+			else if (strcmp(argv[i], IO_THREADS_NAME) == 0) ioEngine = BATCH_IO_THREADS;
+			else badArgs = 1;
+		}
+		else if (strcmp(argv[i], COST_FLAG) == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], COST_SIZE_NAME) == 0) costModel = BATCH_COST_SIZE;
+			else if (strcmp(argv[i], COST_LINES_NAME) == 0) costModel = BATCH_COST_LINES;
+			else badArgs = 1;
+		}
+		else if (strcmp(argv[i], CHUNK_FLAG) == 0 && i + 1 < argc)
+			chunkBytes = (size_t)strtoul(argv[++i], NULL, 10) * 1024;
+		else if (strcmp(argv[i], STATS_FLAG) == 0)
+			statsMode = 1;
+		else if (strcmp(argv[i], STATS_JSON_FLAG) == 0)
+			statsMode = 2;
+		else if (strcmp(argv[i], PERF_FLAG) == 0)
+			perfMode = 1;
+		else if (strcmp(argv[i], TRACE_FLAG) == 0 && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (strcmp(argv[i], FORMAT_TEXT_FLAG) == 0)
+			objectFormat = SCOFF_FORMAT_TEXT;
+		else if (strcmp(argv[i], FORMAT_BIN_FLAG) == 0)
+			objectFormat = SCOFF_FORMAT_BIN;
+		else if (strcmp(argv[i], IMAGE_FLAG) == 0)
+			objectFormat = SCOFF_FORMAT_IMAGE;
+		else if (strcmp(argv[i], LINES_FLAG) == 0)
+			emitLines = 1;
+		else if (strcmp(argv[i], SYMBOLS_FLAG) == 0)
+			emitSymbols = 1;
+		else if (argv[i][0] != '-' || strcmp(argv[i], STDIN_PATH) == 0)
+			paths[numPaths++] = argv[i];
+		else
+			badArgs = 1;
+	}
+	if (numPaths > 0) filePath = paths[0];
+
+	// the counters are read around the phases, so they come with the stats table
+	if (perfMode && !statsMode) statsMode = 1;
+
+	// stats are only collected for the one file assembled on this thread and a trace only covers runs which end. The line table and the
+	// symbol map are only written by the two pass assembly of a file on disk, so not in batch mode or for standard input
+	if (badArgs || (watchDir != NULL) + (numPaths > 0) != 1 || (numPaths > 1 && !batchMode) || (batchMode && watchDir) ||
+		(statsMode && (batchMode || watchDir)) || (tracePath && watchDir) ||
+		((emitLines || emitSymbols) && (batchMode || (filePath && strcmp(filePath, STDIN_PATH) == 0))))
 	{
-		fprintf(stderr, "[ERROR]: Please enter the file path to the SIC assembly file as the cli argument.\n");
+		printUsage(argv[0]);
+		free(paths);
 		return 1;
 	}
 
-	// open ASM file and build symbol table
-	FILE* SICFile = openFile(argv[1]);
-	if (!SICFile) return 1;
+	// the trace starts before the tables are built so they show up in it too
+	sic_trace* trace = NULL;
+	if (tracePath)
+	{
+		trace = createTrace();
+		if (!trace)
+		{
+			free(paths);
+			return 1;
+		}
+		sicTrace = trace;
+	}
 
-	// declare local variables
-	cleanup_code errorCode = NO_ERRORS;
-	hash_table* optable = NULL;
-	hash_table* directiveTable = NULL;
-	symbol_table* symbolTable = NULL;
-	sic_scoff_records* records = NULL;
+	sic_stats stats;
+	if (statsMode)
+	{
+		memset(&stats, 0, sizeof(stats));
+		if (perfMode) stats.perf = openPerfCounters();
+		sicStats = &stats;
+	}
 
-	// construct the opcode table and check for errors
-	optable = buildOpcodeTable();
-	if (optable != NULL)
+	// the tables are built once and shared by every file assembled
+	sic_assembler* assembler = createAssembler();
+	if (!assembler)
+	{
+		if (statsMode) closePerfCounters(stats.perf);
+		sicTrace = NULL;
+		freeTrace(trace);
+		free(paths);
+		return 1;
+	}
+	assembler->objectFormat = objectFormat;
+	assembler->emitLines = emitLines;
+	assembler->emitSymbols = emitSymbols;
+
+	int returnCode = 1;
+	sic_batch* batch = NULL;
+	if (watchDir)
+		returnCode = watchDirectory(assembler, watchDir, numWorkers);
+	else if (batchMode)
 	{
-		// construct the directive table and check for errors
-		directiveTable = buildDirectiveTable();
-		if (directiveTable != NULL)
+		batch = createBatch(assembler, numWorkers);
+		if (batch)
 		{
-#ifdef _DEBUG
-			printOptable(optable);
-#endif //_DEBUG
-
-			// Pass one //
-			symbolTable = buildSymbolTable(SICFile, directiveTable, optable);
-			if (symbolTable != NULL)
-			{
-				// Pass two //
-				if (fseek(SICFile, 0L, SEEK_SET) == 0)
-				{
-					// Generate obj file
-					records = generateSCOFFRecords(SICFile, directiveTable, optable, symbolTable);
-					if (records != NULL)
-					{
-						// write object file to disk
-						if (writeSCOFFToFile(records, argv[1]))
-							errorCode = FAILED_WRITING_TO_OBJ;
-					}
-					else
-						errorCode = FAILED_RECORD_GEN;
-				}
-				else
-				{
-					fprintf(stderr, "[ERROR]: Can't seek to the beginning of the assembly file after pass one.\n");
-					errorCode = FAILED_SEEK;
-				}
-			}
-			else
-				errorCode = FAILED_SYMBOL_TABLE;
+			batch->costModel = costModel;
+			batch->chunkBytes = chunkBytes;
 		}
-		else
-			errorCode = FAILED_DIRECTIVE_TABLE;
+		uint32_t i = 0;
+		while (batch && i < numPaths && batchAddPath(batch, paths[i]) != NULL)
+			i++;
+		if (batch && i == numPaths)
+			returnCode = runBatch(batch, ioEngine);
 	}
+	else if (strcmp(filePath, STDIN_PATH) == 0)
+		returnCode = (assembleStream(assembler, stdin, stdout) == ASM_OKAY) ? 0 : 1;
 	else
-		errorCode = FAILED_OPCODE_TABLE;
+		returnCode = (assembleFile(assembler, filePath) == ASM_OKAY) ? 0 : 1;
 
-	
-	// clean up and free any allocated memory
-	switch (errorCode)
+	// the object file is on stdout when assembling stdin, so the stats go to stderr then
+	if (statsMode)
 	{
-	case NO_ERRORS:
-	case FAILED_WRITING_TO_OBJ:
-		freeRecords(records);
-		// fall through
-	case FAILED_RECORD_GEN:
-	case FAILED_SEEK:
-		freeSymbolTable(symbolTable);
-		// fall through
-	case FAILED_SYMBOL_TABLE:
-		freeHashTableAndValues(directiveTable);
-		// fall through
-	case FAILED_DIRECTIVE_TABLE:
-		freeHashTableAndValues(optable);
-		// fall through
-	case FAILED_OPCODE_TABLE:
-		closeFile(SICFile);
+		sicStats = NULL;
+		printStats(&stats, (filePath && strcmp(filePath, STDIN_PATH) == 0) ? stderr : stdout, statsMode == 2);
+		closePerfCounters(stats.perf);
 	}
-	
-	return (errorCode == NO_ERRORS) ? 0 : 1;
-}
 
-FILE* openFile(const char* filePath)
-{
-	FILE* fptr;
-	fptr = fopen(filePath, "r");
-	if (!fptr)
+	// the spans point at the paths of the batch jobs, so the batch is freed after the trace is written
+	if (trace)
 	{
-		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", filePath);
+		sicTrace = NULL;
+		if (writeTrace(trace, tracePath) == NULL) returnCode = 1;
+		freeTrace(trace);
 	}
-	return fptr;
+	freeBatch(batch);
+
+	freeAssembler(assembler);
+	free(paths);
+	return returnCode;
 }
 
-void closeFile(FILE* filePath)
+void printUsage(const char* programName)
 {
-	if (fclose(filePath) != 0)
-	{
-#ifdef _DEBUG
-		fprintf(stderr, "[WARN]: unable to close file pointer during cleanup.\n");
-#endif //_DEBUG
-	}
-	filePath = NULL;
+	fprintf(stderr, "[ERROR]: Please enter the file path to the SIC assembly file as the cli argument.\n");
+	fprintf(stderr, "Usage: %s [%s | %s] [%s] [%s <out.json>] [%s | %s | %s] [%s] [%s] <file.sic | ->\n", programName, STATS_FLAG, STATS_JSON_FLAG,
+		PERF_FLAG, TRACE_FLAG, FORMAT_TEXT_FLAG, FORMAT_BIN_FLAG, IMAGE_FLAG, LINES_FLAG, SYMBOLS_FLAG);
+	fprintf(stderr, "       %s %s <dir> [%s <num workers>] [%s | %s | %s] [%s] [%s]\n", programName, WATCH_FLAG, JOBS_FLAG, FORMAT_TEXT_FLAG,
+		FORMAT_BIN_FLAG, IMAGE_FLAG, LINES_FLAG, SYMBOLS_FLAG);
+	fprintf(stderr, "       %s %s [%s %s|%s] [%s %s|%s] [%s <KiB>] [%s <num workers>] [%s <out.json>] [%s | %s | %s] <file.sic | dir>...\n", programName,
+		BATCH_FLAG, IO_FLAG, IO_URING_NAME, IO_THREADS_NAME, COST_FLAG, COST_SIZE_NAME, COST_LINES_NAME, CHUNK_FLAG, JOBS_FLAG, TRACE_FLAG,
+		FORMAT_TEXT_FLAG, FORMAT_BIN_FLAG, IMAGE_FLAG);
 }
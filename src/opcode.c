@@ -60,7 +60,7 @@ void printOPSError(const opcode_status error, const char* errorToken, const sic_
 hash_table* buildOpcodeTable(void)
 {
 	// malloc optable and ensure it is not null
-	hash_table* opTab = createHashTable(SIC_OPTAB_SIZE);
+	hash_table* opTab = createHashTable(SIC_OPTAB_SIZE, ALLOC_OPTAB);
 	if (!opTab) return NULL;
 
 	// Attempt to open file containing sic opcodes: mnemonic, # operands, format, Opcode
@@ -80,7 +80,7 @@ hash_table* buildOpcodeTable(void)
 	{
 		// Reset mnemonic buffer, malloc a new sic_optable_values struct, and set left pointer
 		memset(mnumonic, 0, SIC_MAX_MNUMONIC_LEN + 1);
-		sic_optable_values* value = malloc(sizeof(sic_optable_values));
+		sic_optable_values* value = sicMalloc(ALLOC_OPTAB, sizeof(sic_optable_values));
 		if (!value)
 		{
 			fprintf(stderr, "[ERROR : %d]: unable to malloc sic_optable_values during optab construction.\n", lineNum);
@@ -91,7 +91,7 @@ hash_table* buildOpcodeTable(void)
 		token = buffer;
 
 		// copy mnemonic into buffer
-		token = strtok(token, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(token, SIC_TOKEN_DELIMITERS);
 		if (!token)
 		{
 			printOPSError(OPS_BAD_INPUT_PARSE, "mnumonic", NULL, lineNum);
@@ -107,7 +107,7 @@ hash_table* buildOpcodeTable(void)
 		strcpy(mnumonic, token);
 
 		// get number of operands
-		token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 		if (!token)
 		{
 			printOPSError(OPS_BAD_INPUT_PARSE, "number of operands", NULL, lineNum);
@@ -117,7 +117,7 @@ hash_table* buildOpcodeTable(void)
 		value->numOperands = (*token) - '0';
 
 		// get instruction format
-		token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 		if (!token)
 		{
 			printOPSError(OPS_BAD_INPUT_PARSE, "instruction format", NULL, lineNum);
@@ -134,7 +134,7 @@ hash_table* buildOpcodeTable(void)
 		else value->instructionFormat = 3;
 
 		// get opcode
-		token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 		value->opcode = (uint8_t)strtol(token, &rptr, 16);
 		// do some error checking here like in directive.c getConstant
 
@@ -146,7 +146,7 @@ hash_table* buildOpcodeTable(void)
 		}
 
 		// check to see if flags need to be set
-		token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 		if (token)
 		{
 			// get optional flags
@@ -167,7 +167,7 @@ hash_table* buildOpcodeTable(void)
 					value->flags |= OP_FLAG_CONDITION_CODE_SET;
 				}
 
-				token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+				token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 			} while (token);
 
 		}
@@ -177,7 +177,7 @@ hash_table* buildOpcodeTable(void)
 		if (insertKVPair(opTab, mnumonic, value) != HT_OKAY)
 		{
 			fprintf(stderr, "[ERROR : %d]: failed to insert KV pair into the opcode table.\n", lineNum);
-			free(value);
+			sicFree(ALLOC_OPTAB, value);
 			freeHashTableAndValues(opTab);
 			return NULL;
 		}
@@ -194,3 +194,22 @@ hash_table* buildOpcodeTable(void)
 	fptr = NULL;
 	return opTab;
 }
+
+sic_reverse_optable* buildReverseOpcodeTable(const hash_table* opTab)
+{
+	sic_reverse_optable* reverse = (sic_reverse_optable*)sicCalloc(ALLOC_OPTAB, 1, sizeof(sic_reverse_optable));
+	if (!reverse)
+	{
+		fprintf(stderr, "[ERROR]: unable to malloc the reverse opcode table.\n");
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < opTab->currentSize; i++)
+	{
+		if (opTab->p_KVArray[i].key == NULL) continue;
+		const sic_optable_values* value = (const sic_optable_values*)opTab->p_KVArray[i].value;
+		reverse->mnemonics[value->opcode] = opTab->p_KVArray[i].key;
+		reverse->values[value->opcode] = value;
+	}
+	return reverse;
+}
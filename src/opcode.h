@@ -18,6 +18,7 @@
 
 // Defines //
 #define SIC_OPCODE_LEN 2
+#define SIC_NUM_OPCODE_BYTES 256 // every value of the opcode byte
 
 // Structs and enums //
 
@@ -71,6 +72,17 @@ typedef struct {
 
 } sic_optable_values;
 
+/**
+ * @brief sic_reverse_optable is the opTab indexed by the opcode byte, for going from object code back to instructions. The mnemonics and
+ * values point into the opTab it was built from, and opcodes with no instruction are NULL.
+ */
+typedef struct {
+
+	const char* mnemonics[SIC_NUM_OPCODE_BYTES];
+	const sic_optable_values* values[SIC_NUM_OPCODE_BYTES];
+
+} sic_reverse_optable;
+
 // Functions //
 
 /**
@@ -110,4 +122,15 @@ void printOPSError(const opcode_status error, const char* errorToken, const sic_
  */
 hash_table* buildOpcodeTable(void);
 
+/**
+ * @brief buildReverseOpcodeTable is a function that builds the 256 entry table of the instructions by opcode from the opTab, so an opcode
+ * byte is decoded with one lookup instead of a search of the mnemonics. The opTab has to outlive the table.
+ *
+ * NOTE: that caller needs to free the table after use with sicFree(ALLOC_OPTAB, ...).
+ *
+ * @param	opTab - The opcode table from buildOpcodeTable().
+ * @return	reverse opcode table or NULL on error
+ */
+sic_reverse_optable* buildReverseOpcodeTable(const hash_table* opTab);
+
 #endif //OPCODE_H
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "perf_counters.h"
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef SIC_HAVE_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif //SIC_HAVE_PERF_EVENTS
+
+// Define constants //
+#define PERF_PARANOID_PATH "/proc/sys/kernel/perf_event_paranoid"
+#define PERF_NAMES_LEN 128
+
+#ifdef SIC_HAVE_PERF_EVENTS
+
+/**
+ * @brief perfEventOpen is a wrapper around the perf_event_open syscall, which glibc does not provide.
+ *
+ * @param  attr  - The event to open.
+ * @param  pid   - The process to count, 0 for the calling thread.
+ * @param  cpu   - The CPU to count on, -1 for any.
+ * @param  group - The group leader, -1 for none.
+ * @param  flags - The flags.
+ * @return file descriptor or -1 on error
+*/
+static int perfEventOpen(struct perf_event_attr* attr, pid_t pid, int cpu, int group, unsigned long flags)
+{
+	return (int)syscall(SYS_perf_event_open, attr, pid, cpu, group, flags);
+}
+
+/**
+ * @brief openCounter is a function that opens one counter of the calling thread, counting in user space only.
+ *
+ * @param  type   - The perf event type.
+ * @param  config - The event of that type.
+ * @return file descriptor or -1 on error, with errno set
+*/
+static int openCounter(uint32_t type, uint64_t config)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return perfEventOpen(&attr, 0, -1, -1, 0);
+}
+
+#endif //SIC_HAVE_PERF_EVENTS
+
+perf_counters* openPerfCounters(void)
+{
+	perf_counters* counters = (perf_counters*)malloc(sizeof(perf_counters));
+	if (!counters)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the performance counters.\n");
+		return NULL;
+	}
+	counters->numOpen = 0;
+	for (uint32_t i = 0; i < PERF_NUM_COUNTERS; i++)
+		counters->fds[i] = -1;
+
+#ifdef SIC_HAVE_PERF_EVENTS
+	const uint32_t types[PERF_NUM_COUNTERS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+		PERF_TYPE_SOFTWARE };
+	const uint64_t configs[PERF_NUM_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS };
+	const char* names[PERF_NUM_COUNTERS] = PERF_COUNTER_NAMES;
+
+	// open what can be opened, and name the rest in one warning
+	char missing[PERF_NAMES_LEN] = { 0 };
+	int firstError = 0;
+	for (uint32_t i = 0; i < PERF_NUM_COUNTERS; i++)
+	{
+		counters->fds[i] = openCounter(types[i], configs[i]);
+		if (counters->fds[i] >= 0)
+		{
+			counters->numOpen++;
+			continue;
+		}
+
+		if (!firstError) firstError = errno;
+		if (missing[0]) strncat(missing, ", ", sizeof(missing) - strlen(missing) - 1);
+		strncat(missing, names[i], sizeof(missing) - strlen(missing) - 1);
+	}
+
+	if (counters->numOpen < PERF_NUM_COUNTERS)
+	{
+		if (firstError == EACCES || firstError == EPERM)
+		{
+			int paranoid = -1;
+			FILE* paranoidFile = fopen(PERF_PARANOID_PATH, "r");
+			if (paranoidFile)
+			{
+				if (fscanf(paranoidFile, "%d", &paranoid) != 1) paranoid = -1;
+				fclose(paranoidFile);
+			}
+			fprintf(stderr, "[WARN]: Not permitted to open the counter(s) %s (kernel.perf_event_paranoid is %d), they are reported as n/a.\n",
+				missing, paranoid);
+		}
+		else
+			fprintf(stderr, "[WARN]: The counter(s) %s are not supported here (%s), they are reported as n/a. Virtual machines often have no PMU.\n",
+				missing, strerror(firstError));
+	}
+#else
+	fprintf(stderr, "[WARN]: Performance counters need Linux perf events, they are reported as n/a.\n");
+#endif //SIC_HAVE_PERF_EVENTS
+
+	return counters;
+}
+
+void readPerfCounters(const perf_counters* counters, uint64_t* values)
+{
+	for (uint32_t i = 0; i < PERF_NUM_COUNTERS; i++)
+	{
+		values[i] = 0;
+		if (counters->fds[i] < 0) continue;
+
+		// value, time enabled, time running
+		uint64_t reading[3];
+		if (read(counters->fds[i], reading, sizeof(reading)) != (ssize_t)sizeof(reading)) continue;
+
+		values[i] = reading[0];
+		if (reading[2] > 0 && reading[2] < reading[1])
+			values[i] = (uint64_t)((double)reading[0] * reading[1] / reading[2]);
+	}
+}
+
+uint8_t isPerfCounterOpen(const perf_counters* counters, perf_counter_id id)
+{
+	return counters != NULL && counters->fds[id] >= 0;
+}
+
+void closePerfCounters(perf_counters* counters)
+{
+	if (!counters) return;
+
+	for (uint32_t i = 0; i < PERF_NUM_COUNTERS; i++)
+		if (counters->fds[i] >= 0) close(counters->fds[i]);
+	free(counters);
+}
@@ -0,0 +1,94 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#define SIC_HAVE_PERF_EVENTS 1
+#endif
+#endif
+
+#define PERF_COUNTER_NAMES { "cycles", "instructions", "cache_misses", "branch_misses", "page_faults" }
+
+// Structs and enums //
+
+/**
+ * @brief perf_counter_id enum is the counters which are opened. The last one is a software counter, so there is still something to
+ * look at on machines without a PMU, such as most virtual machines.
+ */
+typedef enum
+{
+	PERF_CYCLES = 0,
+	PERF_INSTRUCTIONS,
+	PERF_CACHE_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_PAGE_FAULTS,
+	PERF_NUM_COUNTERS
+
+} perf_counter_id;
+
+/**
+ * @brief perf_counters struct holds one perf event file descriptor per counter, -1 for the counters which could not be opened.
+ * They count this thread in user space only, which is all an unprivileged process is allowed to count.
+ */
+typedef struct {
+
+	int fds[PERF_NUM_COUNTERS];
+	uint32_t numOpen;
+
+} perf_counters;
+
+// Function declarations //
+
+/**
+ * @brief openPerfCounters is a function that opens every counter it can for the calling thread. A counter which is not permitted or not
+ * supported is skipped with one warning naming the reason, so the caller carries on either way. It returns NULL only if the struct
+ * could not be allocated.
+ *
+ * NOTE: that caller needs to close the counters after use by using closePerfCounters().
+ *
+ * @param  void
+ * @return counters or NULL on error
+ */
+perf_counters* openPerfCounters(void);
+
+/**
+ * @brief readPerfCounters is a function that reads the current value of every counter. When the kernel had to multiplex a counter the
+ * value is scaled up by the share of time it was running. Counters which are not open read as zero.
+ *
+ * @param  counters - The counters.
+ * @param  values   - Set to PERF_NUM_COUNTERS values.
+ * @return void
+ */
+void readPerfCounters(const perf_counters* counters, uint64_t* values);
+
+/**
+ * @brief isPerfCounterOpen is a function that checks if the given counter could be opened.
+ *
+ * @param  counters - The counters, may be NULL.
+ * @param  id       - The counter.
+ * @return 1 if it is open, 0 if not
+ */
+uint8_t isPerfCounterOpen(const perf_counters* counters, perf_counter_id id);
+
+/**
+ * @brief closePerfCounters is a function that closes the counters and frees them.
+ *
+ * @param  counters - The counters, may be NULL.
+ * @return void
+ */
+void closePerfCounters(perf_counters* counters);
+
+#endif //PERF_COUNTERS_H
@@ -0,0 +1,241 @@
+#include "profile.h"
+#include <inttypes.h>
+
+// Structs //
+
+/**
+ * @brief sim_profile_row is a line, or an address when there is no line table, of the hot line report.
+ */
+typedef struct
+{
+	uint32_t line;
+	uint32_t address;
+	uint64_t count;
+
+} sim_profile_row;
+
+sim_profile* createProfile(void)
+{
+	sim_profile* profile = (sim_profile*)sicCalloc(ALLOC_OTHER, 1, sizeof(sim_profile));
+	if (profile) profile->frames = (sim_profile_frame*)sicMalloc(ALLOC_OTHER, PROFILE_INITIAL_FRAMES * sizeof(sim_profile_frame));
+	if (!profile || !profile->frames)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the profile.\n");
+		freeProfile(profile);
+		return NULL;
+	}
+
+	profile->frameCapacity = PROFILE_INITIAL_FRAMES;
+	profile->numFrames = 1;
+	profile->frames[PROFILE_ROOT].address = 0;
+	profile->frames[PROFILE_ROOT].parent = PROFILE_NO_FRAME;
+	profile->frames[PROFILE_ROOT].firstChild = PROFILE_NO_FRAME;
+	profile->frames[PROFILE_ROOT].nextSibling = PROFILE_NO_FRAME;
+	profile->frames[PROFILE_ROOT].instructions = 0;
+	profile->current = PROFILE_ROOT;
+	return profile;
+}
+
+void freeProfile(sim_profile* profile)
+{
+	if (!profile) return;
+
+	sicFree(ALLOC_OTHER, profile->frames);
+	sicFree(ALLOC_OTHER, profile);
+}
+
+void profileFlush(sim_profile* profile, uint64_t instructions)
+{
+	profile->frames[profile->current].instructions += instructions - profile->lastInstructions;
+	profile->lastInstructions = instructions;
+}
+
+/**
+ * @brief childFrame is a function that finds the frame of the routine at the address called from the parent, making it the first time.
+ *
+ * @param  profile - The profile
+ * @param  parent  - The calling frame
+ * @param  address - The address of the routine
+ * @return the frame, or PROFILE_NO_FRAME if it could not be made
+*/
+static uint32_t childFrame(sim_profile* profile, uint32_t parent, uint32_t address)
+{
+	// a routine has few callees, so they are kept in a list
+	for (uint32_t child = profile->frames[parent].firstChild; child != PROFILE_NO_FRAME; child = profile->frames[child].nextSibling)
+		if (profile->frames[child].address == address) return child;
+
+	if (profile->numFrames == profile->frameCapacity)
+	{
+		sim_profile_frame* grown = (sim_profile_frame*)sicRealloc(ALLOC_OTHER, profile->frames,
+			2 * profile->frameCapacity * sizeof(sim_profile_frame));
+		if (!grown) return PROFILE_NO_FRAME;
+		profile->frames = grown;
+		profile->frameCapacity *= 2;
+	}
+
+	uint32_t child = profile->numFrames++;
+	profile->frames[child].address = address;
+	profile->frames[child].parent = parent;
+	profile->frames[child].firstChild = PROFILE_NO_FRAME;
+	profile->frames[child].nextSibling = profile->frames[parent].firstChild;
+	profile->frames[child].instructions = 0;
+	profile->frames[parent].firstChild = child;
+	return child;
+}
+
+void profileCall(sim_profile* profile, uint32_t address, uint64_t instructions)
+{
+	profileFlush(profile, instructions);
+
+	// calls past the deepest frame, or which have no frame, only need to be matched with their returns
+	uint32_t child = (profile->depth < PROFILE_MAX_DEPTH) ? childFrame(profile, profile->current, address) : PROFILE_NO_FRAME;
+	if (child == PROFILE_NO_FRAME)
+	{
+		profile->truncated = 1;
+		profile->overflow++;
+		return;
+	}
+	profile->current = child;
+	profile->depth++;
+}
+
+void profileReturn(sim_profile* profile, uint64_t instructions)
+{
+	profileFlush(profile, instructions);
+
+	if (profile->overflow > 0) profile->overflow--;
+	else if (profile->current != PROFILE_ROOT)
+	{
+		profile->current = profile->frames[profile->current].parent;
+		profile->depth--;
+	}
+}
+
+/**
+ * @brief compareRows is a qsort comparator which puts the rows with the most instructions first, and rows with as many in address order.
+ *
+ * @param  a - The first row
+ * @param  b - The second row
+ * @return less than, equal to or greater than zero
+*/
+static int compareRows(const void* a, const void* b)
+{
+	const sim_profile_row* left = (const sim_profile_row*)a;
+	const sim_profile_row* right = (const sim_profile_row*)b;
+	if (left->count != right->count) return (left->count > right->count) ? -1 : 1;
+	return (left->address > right->address) - (left->address < right->address);
+}
+
+void printHotLines(const sim_profile* profile, const sic_line_table* lineTable, uint32_t top, FILE* stream)
+{
+	uint32_t maxRows = lineTable ? lineTable->numEntries : PROFILE_NUM_ADDRESSES;
+	sim_profile_row* rows = (sim_profile_row*)sicMalloc(ALLOC_OTHER, (maxRows + 1) * sizeof(sim_profile_row));
+	if (!rows)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the hot line report.\n");
+		return;
+	}
+
+	uint64_t total = 0;
+	for (uint32_t at = 0; at < PROFILE_NUM_ADDRESSES; at++)
+		total += profile->counts[at];
+
+	// each line adds up the instructions in its range of addresses, whatever is left ran outside of every line
+	uint32_t numRows = 0;
+	uint64_t unmapped = total;
+	for (uint32_t i = 0; i < maxRows; i++)
+	{
+		sim_profile_row row = { LINES_NO_LINE, i, 0 };
+		if (lineTable)
+		{
+			uint32_t end = (i + 1 < lineTable->numEntries) ? lineTable->entries[i + 1].address : lineTable->endAddress;
+			row.line = lineTable->entries[i].line;
+			row.address = lineTable->entries[i].address;
+			for (uint32_t at = row.address; at < end; at++)
+				row.count += profile->counts[at];
+			unmapped -= row.count;
+		}
+		else row.count = profile->counts[i];
+
+		if (row.count > 0) rows[numRows++] = row;
+	}
+	qsort(rows, numRows, sizeof(sim_profile_row), compareRows);
+
+	fprintf(stream, "[INFO]: The %u hottest %s of %" PRIu64 " instructions:\n", (numRows < top) ? numRows : top,
+		lineTable ? "lines" : "addresses", total);
+	fprintf(stream, "%8s  %7s  %14s  %6s\n", "line", "address", "instructions", "share");
+	for (uint32_t i = 0; i < numRows && i < top; i++)
+	{
+		if (lineTable) fprintf(stream, "%8u", rows[i].line);
+		else fprintf(stream, "%8s", "-");
+		fprintf(stream, "  %06X   %14" PRIu64 "  %5.1f%%\n", rows[i].address, rows[i].count, 100.0 * rows[i].count / (total ? total : 1));
+	}
+	if (lineTable && unmapped > 0)
+		fprintf(stream, "[WARN]: %" PRIu64 " instructions ran at addresses which are not on any line of the source.\n", unmapped);
+	if (profile->truncated)
+		fprintf(stream, "[WARN]: The calls were nested too deep to keep every frame, the deepest ones are counted in their callers.\n");
+
+	sicFree(ALLOC_OTHER, rows);
+}
+
+/**
+ * @brief printFrameName is a function that prints the name of a frame in the folded stacks.
+ *
+ * @param  outFile   - The folded stack file
+ * @param  frame     - The frame
+ * @param  isRoot    - 1 for the frame of the main routine
+ * @param  lineTable - The line table, or NULL
+ * @param  symbols   - The symbol map, or NULL
+ * @return void
+*/
+static void printFrameName(FILE* outFile, const sim_profile_frame* frame, uint8_t isRoot, const sic_line_table* lineTable,
+	const sic_symbol_map* symbols)
+{
+	const sic_symbol_entry* symbol = (symbols && !isRoot) ? findSymbolByAddress(symbols, frame->address) : NULL;
+	if (isRoot || symbol)
+	{
+		fputs(isRoot ? "main" : symbol->name, outFile);
+		return;
+	}
+
+	uint32_t line = lineTable ? findLine(lineTable, frame->address) : LINES_NO_LINE;
+	if (line != LINES_NO_LINE) fprintf(outFile, "sub_%06X_line%u", frame->address, line);
+	else fprintf(outFile, "sub_%06X", frame->address);
+}
+
+const sim_profile* writeFoldedStacks(const sim_profile* profile, const sic_line_table* lineTable, const sic_symbol_map* symbols,
+	const char* path)
+{
+	FILE* outFile = fopen(path, "w");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the folded stacks.\n", path);
+		return NULL;
+	}
+
+	uint32_t stack[PROFILE_MAX_DEPTH + 1];
+	for (uint32_t i = 0; i < profile->numFrames; i++)
+	{
+		if (profile->frames[i].instructions == 0) continue;
+
+		// walk up to the main routine, then print the frames back down
+		uint32_t depth = 0;
+		for (uint32_t frame = i; frame != PROFILE_NO_FRAME; frame = profile->frames[frame].parent)
+			stack[depth++] = frame;
+		while (depth > 0)
+		{
+			depth--;
+			printFrameName(outFile, &profile->frames[stack[depth]], stack[depth] == PROFILE_ROOT, lineTable, symbols);
+			fputc(depth > 0 ? ';' : ' ', outFile);
+		}
+		fprintf(outFile, "%" PRIu64 "\n", profile->frames[i].instructions);
+	}
+
+	int failed = ferror(outFile);
+	if (fclose(outFile) != 0 || failed)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the folded stacks to \"%s\".\n", path);
+		return NULL;
+	}
+	return profile;
+}
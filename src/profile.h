@@ -0,0 +1,146 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef PROFILE_H // execution profile of the SIC simulator
+#define PROFILE_H
+
+// Local includes //
+
+#include "sic.h"
+#include "lines.h"
+#include "symbols.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define PROFILE_NUM_ADDRESSES (SIC_MEMORY_LIMIT + 1 + SIC_WORD_BYTES) // every address the PC can reach, past the end of memory included
+#define PROFILE_ROOT 0 // the frame of the main routine
+#define PROFILE_NO_FRAME 0xFFFFFFFF
+#define PROFILE_INITIAL_FRAMES 64
+#define PROFILE_MAX_DEPTH 256 // calls nested deeper are counted in the deepest frame
+#define PROFILE_TOP_LINES 20
+
+// Structs and enums //
+
+/**
+ * @brief sim_profile_frame is a node of the call tree, a routine called through one chain of JSUBs from the main routine. address is
+ * the target of the JSUB, and instructions is how many instructions ran in the routine itself, not in the routines it called.
+ */
+typedef struct
+{
+	uint32_t address;
+	uint32_t parent;
+	uint32_t firstChild;
+	uint32_t nextSibling;
+	uint64_t instructions;
+
+} sim_profile_frame;
+
+/**
+ * @brief sim_profile is what a profiled run counts: how many times the instruction at each address ran, and the call tree, where a JSUB
+ * enters a child of the current frame and an RSUB goes back to its parent. The instructions between two calls or returns are added to
+ * the frame they ran in when the second one happens, so the tree costs nothing between them. lastInstructions is the instruction count
+ * of the machine at the last call or return.
+ */
+typedef struct
+{
+	uint64_t counts[PROFILE_NUM_ADDRESSES];
+
+	sim_profile_frame* frames;
+	uint32_t numFrames;
+	uint32_t frameCapacity;
+	uint32_t current;
+	uint32_t depth;
+	uint32_t overflow;
+	uint64_t lastInstructions;
+	uint8_t truncated;
+
+} sim_profile;
+
+// Function declarations //
+
+/**
+ * @brief createProfile is a function that creates an empty profile, with only the frame of the main routine.
+ *
+ * NOTE: that caller needs to free the profile after use by using freeProfile().
+ *
+ * @param  void
+ * @return profile or NULL on error
+ */
+sim_profile* createProfile(void);
+
+/**
+ * @brief freeProfile is a function that frees the profile. The function returns nothing.
+ *
+ * @param  profile - The profile to free, may be NULL.
+ * @return void
+ */
+void freeProfile(sim_profile* profile);
+
+/**
+ * @brief profileCall is a function that enters the routine at the address from the current frame, for a JSUB. If its frame can't
+ * be made the calls are counted in the current frame and the profile is marked as truncated. The function returns nothing.
+ *
+ * @param  profile      - The profile.
+ * @param  address      - The target of the JSUB.
+ * @param  instructions - The instructions the machine has run, the JSUB included.
+ * @return void
+ */
+void profileCall(sim_profile* profile, uint32_t address, uint64_t instructions);
+
+/**
+ * @brief profileReturn is a function that goes back to the frame which called the current one, for an RSUB. An RSUB in the main
+ * routine stays in it. The function returns nothing.
+ *
+ * @param  profile      - The profile.
+ * @param  instructions - The instructions the machine has run, the RSUB included.
+ * @return void
+ */
+void profileReturn(sim_profile* profile, uint64_t instructions);
+
+/**
+ * @brief profileFlush is a function that adds the instructions run since the last call or return to the current frame, for when the
+ * machine stops. The function returns nothing.
+ *
+ * @param  profile      - The profile.
+ * @param  instructions - The instructions the machine has run.
+ * @return void
+ */
+void profileFlush(sim_profile* profile, uint64_t instructions);
+
+/**
+ * @brief printHotLines is a function that prints the source lines which ran the most instructions, with their share of the run. Without
+ * a line table it prints the addresses instead. The function returns nothing.
+ *
+ * @param  profile   - The profile.
+ * @param  lineTable - The line table of the program, or NULL.
+ * @param  top       - The most lines to print.
+ * @param  stream    - Where to print.
+ * @return void
+ */
+void printHotLines(const sim_profile* profile, const sic_line_table* lineTable, uint32_t top, FILE* stream);
+
+/**
+ * @brief writeFoldedStacks is a function that writes the call tree as folded stacks, one line per frame which ran any instructions,
+ * with the frames from the main routine down separated by ';' and then the instruction count. It is the input of flamegraph.pl and
+ * speedscope. A routine is named after the symbol at its address when there is a symbol map, and otherwise sub_ and its address, and
+ * the line of its address when there is a line table.
+ *
+ * @param  profile   - The profile.
+ * @param  lineTable - The line table of the program, or NULL.
+ * @param  symbols   - The symbol map of the program, or NULL.
+ * @param  path      - The file to write.
+ * @return profile or NULL on error
+ */
+const sim_profile* writeFoldedStacks(const sim_profile* profile, const sic_line_table* lineTable, const sic_symbol_map* symbols,
+	const char* path);
+
+#endif //PROFILE_H
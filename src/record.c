@@ -0,0 +1,550 @@
+#include "record.h"
+
+// the pages of memory at the start of a trace are kept when they differ from zeros
+static const uint8_t zeroPage[RECORD_PAGE_SIZE];
+
+/**
+ * @brief bufferVarint is a function that writes the value as a varint to the buffer, the same way putVarint writes it to a stream.
+ *
+ * @param  out   - Where to write
+ * @param  value - The value
+ * @return the byte after the varint
+*/
+static inline uint8_t* bufferVarint(uint8_t* out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (uint8_t)value;
+	return out;
+}
+
+/**
+ * @brief writeRegisters is a function that writes the registers to the trace as varints.
+ *
+ * @param  outFile   - The trace file
+ * @param  registers - The registers
+ * @return the number of bytes written
+*/
+static uint64_t writeRegisters(FILE* outFile, const sim_registers* registers)
+{
+	return putVarint(registers->A, outFile) + putVarint(registers->X, outFile) + putVarint(registers->L, outFile) +
+		putVarint(registers->SW, outFile) + putVarint(registers->PC, outFile);
+}
+
+/**
+ * @brief writePages is a function that writes the bitmap of the pages of memory which differ from the base, then those pages.
+ *
+ * @param  outFile - The trace file
+ * @param  memory  - The memory
+ * @param  base    - What the memory is compared to, NULL for zeros
+ * @return the number of bytes written
+*/
+static uint64_t writePages(FILE* outFile, const uint8_t* memory, const uint8_t* base)
+{
+	uint8_t map[RECORD_PAGE_MAP_BYTES] = { 0 };
+	uint32_t numPages = 0;
+	for (uint32_t page = 0; page < RECORD_NUM_PAGES; page++)
+	{
+		const uint8_t* against = base ? base + (page << RECORD_PAGE_BITS) : zeroPage;
+		if (memcmp(memory + (page << RECORD_PAGE_BITS), against, RECORD_PAGE_SIZE) == 0) continue;
+		map[page / 8] |= (uint8_t)(1 << (page % 8));
+		numPages++;
+	}
+
+	fwrite(map, 1, RECORD_PAGE_MAP_BYTES, outFile);
+	for (uint32_t page = 0; page < RECORD_NUM_PAGES; page++)
+		if (map[page / 8] & (1 << (page % 8))) fwrite(memory + (page << RECORD_PAGE_BITS), 1, RECORD_PAGE_SIZE, outFile);
+	return RECORD_PAGE_MAP_BYTES + (uint64_t)numPages * RECORD_PAGE_SIZE;
+}
+
+sim_record* createRecord(const char* path, const uint8_t* memory, const sim_registers* registers, uint64_t instructions)
+{
+	sim_record* record = (sim_record*)sicCalloc(ALLOC_OTHER, 1, sizeof(sim_record));
+	if (record)
+	{
+		record->initial = (uint8_t*)sicMalloc(ALLOC_OTHER, RECORD_MEMORY_SIZE);
+		record->keyframeMemory = (uint8_t*)sicMalloc(ALLOC_OTHER, RECORD_MEMORY_SIZE);
+		record->steps = (uint8_t*)sicMalloc(ALLOC_OTHER, RECORD_CHUNK_BYTES + RECORD_MAX_STEP_BYTES);
+		record->index = (sim_record_index*)sicMalloc(ALLOC_OTHER, 16 * sizeof(sim_record_index));
+	}
+	if (!record || !record->initial || !record->keyframeMemory || !record->steps || !record->index)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the trace.\n");
+		freeRecord(record);
+		return NULL;
+	}
+	record->indexCapacity = 16;
+	record->path = path;
+	record->startInstructions = instructions;
+	memcpy(record->initial, memory, RECORD_MEMORY_SIZE);
+
+	record->outFile = fopen(path, "wb");
+	if (!record->outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the trace.\n", path);
+		freeRecord(record);
+		return NULL;
+	}
+
+	fwrite(RECORD_MAGIC, 1, RECORD_MAGIC_LEN, record->outFile);
+	fputc(RECORD_VERSION, record->outFile);
+	record->offset = RECORD_MAGIC_LEN + 1;
+	record->offset += writeRegisters(record->outFile, registers);
+	record->offset += writePages(record->outFile, memory, NULL);
+	return record;
+}
+
+/**
+ * @brief closeChunk is a function that writes the chunk being recorded to the trace and adds it to the index. A failed write marks
+ * the recording as failed.
+ *
+ * @param  record - The record
+ * @return void
+*/
+static void closeChunk(sim_record* record)
+{
+	if (record->numChunks == record->indexCapacity)
+	{
+		sim_record_index* grown = (sim_record_index*)sicRealloc(ALLOC_OTHER, record->index, 2 * record->indexCapacity * sizeof(sim_record_index));
+		if (!grown)
+		{
+			record->failed = 1;
+			return;
+		}
+		record->index = grown;
+		record->indexCapacity *= 2;
+	}
+	record->index[record->numChunks].firstStep = record->numSteps - record->chunkSteps;
+	record->index[record->numChunks].offset = record->offset;
+	record->numChunks++;
+
+	record->offset += putVarint(record->chunkSteps, record->outFile);
+	record->offset += putVarint(record->stepBytes, record->outFile);
+	record->offset += writeRegisters(record->outFile, &record->keyframe);
+	record->offset += writePages(record->outFile, record->keyframeMemory, record->initial);
+	record->offset += fwrite(record->steps, 1, record->stepBytes, record->outFile);
+	if (ferror(record->outFile)) record->failed = 1;
+
+	record->open = 0;
+	record->chunkSteps = 0;
+	record->stepBytes = 0;
+}
+
+/**
+ * @brief finishStep is a function that adds the step of the pending instruction to the chunk, from the state before it and the state
+ * after. The chunk is written once it is full.
+ *
+ * @param  record - The record
+ * @param  after  - The registers after the instruction
+ * @param  memory - The memory after the instruction
+ * @return void
+*/
+static void finishStep(sim_record* record, const sim_registers* after, const uint8_t* memory)
+{
+	const sim_registers* before = &record->before;
+	uint8_t* flags = record->steps + record->stepBytes;
+	uint8_t* out = flags + 1;
+	*flags = 0;
+
+	if (before->A != after->A) { *flags |= RECORD_STEP_A; out = bufferVarint(out, before->A ^ after->A); }
+	if (before->X != after->X) { *flags |= RECORD_STEP_X; out = bufferVarint(out, before->X ^ after->X); }
+	if (before->L != after->L) { *flags |= RECORD_STEP_L; out = bufferVarint(out, before->L ^ after->L); }
+	if (before->SW != after->SW) { *flags |= RECORD_STEP_SW; out = bufferVarint(out, before->SW ^ after->SW); }
+	if (after->PC != before->PC + RECORD_INSTRUCTION_BYTES) { *flags |= RECORD_STEP_JUMP; out = bufferVarint(out, before->PC ^ after->PC); }
+
+	// a store of the value already there changed nothing, so it is left out
+	if (record->writeLen && memcmp(record->written, memory + record->writeAt, record->writeLen) != 0)
+	{
+		*flags |= (record->writeLen == 1) ? RECORD_STEP_BYTE : RECORD_STEP_WORD;
+		out = bufferVarint(out, record->writeAt);
+		for (uint32_t i = 0; i < record->writeLen; i++)
+			*out++ = record->written[i] ^ memory[record->writeAt + i];
+	}
+
+	record->stepBytes = (uint32_t)(out - record->steps);
+	record->chunkSteps++;
+	record->numSteps++;
+	record->pending = 0;
+	if (record->chunkSteps == RECORD_CHUNK_STEPS || record->stepBytes >= RECORD_CHUNK_BYTES) closeChunk(record);
+}
+
+void recordStep(sim_record* record, const sim_registers* registers, const uint8_t* memory, uint32_t writeAt, uint8_t len)
+{
+	if (record->failed) return;
+	if (record->pending) finishStep(record, registers, memory);
+
+	// a chunk starts with a keyframe of the state before its first step
+	if (!record->open)
+	{
+		record->keyframe = *registers;
+		memcpy(record->keyframeMemory, memory, RECORD_MEMORY_SIZE);
+		record->open = 1;
+	}
+
+	// a store outside memory faults, so it never finishes its step
+	record->before = *registers;
+	record->writeAt = writeAt;
+	record->writeLen = ((uint64_t)writeAt + len <= RECORD_MEMORY_SIZE) ? len : 0;
+	if (record->writeLen) memcpy(record->written, memory + writeAt, record->writeLen);
+	record->pending = 1;
+}
+
+void recordStop(sim_record* record, const sim_registers* registers, const uint8_t* memory, uint64_t instructions)
+{
+	if (record->failed || !record->pending) return;
+
+	if (instructions == record->startInstructions + record->numSteps + 1) finishStep(record, registers, memory);
+	record->pending = 0;
+}
+
+sim_record* finishRecord(sim_record* record)
+{
+	if (!record->failed && record->open && record->chunkSteps > 0) closeChunk(record);
+
+	uint64_t indexOffset = record->offset;
+	putVarint(record->numChunks, record->outFile);
+	putVarint(record->numSteps, record->outFile);
+	for (uint32_t i = 0; i < record->numChunks; i++)
+	{
+		putVarint(record->index[i].firstStep - (i ? record->index[i - 1].firstStep : 0), record->outFile);
+		putVarint(record->index[i].offset - (i ? record->index[i - 1].offset : 0), record->outFile);
+	}
+	for (uint32_t i = 0; i < 8; i++)
+		fputc((int)((indexOffset >> (8 * i)) & 0xFF), record->outFile);
+	fwrite(RECORD_MAGIC, 1, RECORD_MAGIC_LEN, record->outFile);
+
+	int failed = ferror(record->outFile) || record->failed;
+	int closeFailed = fclose(record->outFile) != 0;
+	record->outFile = NULL;
+	if (failed || closeFailed)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the trace to \"%s\".\n", record->path);
+		return NULL;
+	}
+	return record;
+}
+
+void freeRecord(sim_record* record)
+{
+	if (!record) return;
+
+	if (record->outFile) fclose(record->outFile);
+	sicFree(ALLOC_OTHER, record->initial);
+	sicFree(ALLOC_OTHER, record->keyframeMemory);
+	sicFree(ALLOC_OTHER, record->steps);
+	sicFree(ALLOC_OTHER, record->index);
+	sicFree(ALLOC_OTHER, record);
+}
+
+/**
+ * @brief readRegisters is a function that reads the registers of a trace and checks they are words.
+ *
+ * @param  data      - The trace
+ * @param  len       - The length of the data
+ * @param  pos       - The position, moved past the registers
+ * @param  registers - Set to the registers
+ * @return 1 on success, 0 if they are cut short or too big
+*/
+static uint8_t readRegisters(const uint8_t* data, size_t len, size_t* pos, sim_registers* registers)
+{
+	uint32_t* fields[] = { &registers->A, &registers->X, &registers->L, &registers->SW, &registers->PC };
+	for (uint32_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		uint64_t value;
+		if (!getVarint(data, len, pos, &value) || value > SIC_WORD_MASK) return 0;
+		*fields[i] = (uint32_t)value;
+	}
+	return 1;
+}
+
+/**
+ * @brief readPages is a function that reads a page bitmap and its pages over the memory, which holds the base they were compared to.
+ *
+ * @param  data   - The trace
+ * @param  len    - The length of the data
+ * @param  pos    - The position, moved past the pages
+ * @param  memory - The memory
+ * @return 1 on success, 0 if the pages are cut short
+*/
+static uint8_t readPages(const uint8_t* data, size_t len, size_t* pos, uint8_t* memory)
+{
+	if (len - *pos < RECORD_PAGE_MAP_BYTES) return 0;
+	const uint8_t* map = data + *pos;
+	*pos += RECORD_PAGE_MAP_BYTES;
+
+	for (uint32_t page = 0; page < RECORD_NUM_PAGES; page++)
+	{
+		if (!(map[page / 8] & (1 << (page % 8)))) continue;
+		if (len - *pos < RECORD_PAGE_SIZE) return 0;
+		memcpy(memory + (page << RECORD_PAGE_BITS), data + *pos, RECORD_PAGE_SIZE);
+		*pos += RECORD_PAGE_SIZE;
+	}
+	return 1;
+}
+
+/**
+ * @brief checkStep is a function that checks the step at the position is whole and stays inside memory, and moves past it.
+ *
+ * @param  data - The trace
+ * @param  end  - The end of the steps of the chunk
+ * @param  pos  - The position of the step
+ * @return 1 if the step is valid, 0 if not
+*/
+static uint8_t checkStep(const uint8_t* data, size_t end, size_t* pos)
+{
+	if (*pos >= end) return 0;
+	uint8_t flags = data[(*pos)++];
+	if ((flags & ~RECORD_STEP_FLAGS) || ((flags & RECORD_STEP_BYTE) && (flags & RECORD_STEP_WORD))) return 0;
+
+	uint64_t value;
+	for (uint8_t bit = RECORD_STEP_A; bit <= RECORD_STEP_JUMP; bit <<= 1)
+		if ((flags & bit) && (!getVarint(data, end, pos, &value) || value > SIC_WORD_MASK)) return 0;
+
+	if (flags & (RECORD_STEP_BYTE | RECORD_STEP_WORD))
+	{
+		uint32_t bytes = (flags & RECORD_STEP_BYTE) ? SIC_BYTE : SIC_WORD_BYTES;
+		if (!getVarint(data, end, pos, &value) || value + bytes > RECORD_MEMORY_SIZE || end - *pos < bytes) return 0;
+		*pos += bytes;
+	}
+	return 1;
+}
+
+/**
+ * @brief applyStep is a function that applies a checked step to the state of the replay, forward or back. Every change is an XOR,
+ * so only the PC of a step which did not jump needs to know the way.
+ *
+ * @param  replay  - The replay
+ * @param  pos     - The position of the step
+ * @param  forward - 1 to apply it, 0 to undo it
+ * @return void
+*/
+static void applyStep(sim_replay* replay, size_t pos, uint8_t forward)
+{
+	uint8_t flags = replay->data[pos++];
+	uint64_t value;
+	uint32_t* fields[] = { &replay->registers.A, &replay->registers.X, &replay->registers.L, &replay->registers.SW, &replay->registers.PC };
+	for (uint32_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		if (!(flags & (1 << i))) continue;
+		getVarint(replay->data, replay->len, &pos, &value);
+		*fields[i] ^= (uint32_t)value;
+	}
+	if (!(flags & RECORD_STEP_JUMP))
+		replay->registers.PC = forward ? replay->registers.PC + RECORD_INSTRUCTION_BYTES : replay->registers.PC - RECORD_INSTRUCTION_BYTES;
+
+	if (flags & (RECORD_STEP_BYTE | RECORD_STEP_WORD))
+	{
+		uint32_t bytes = (flags & RECORD_STEP_BYTE) ? SIC_BYTE : SIC_WORD_BYTES;
+		getVarint(replay->data, replay->len, &pos, &value);
+		for (uint32_t i = 0; i < bytes; i++)
+			replay->memory[value + i] ^= replay->data[pos + i];
+	}
+}
+
+/**
+ * @brief loadChunk is a function that puts the replay at the first step of the chunk, from its keyframe, and finds the offset of each
+ * of its steps, checking them on the way.
+ *
+ * @param  replay - The replay
+ * @param  chunk  - The chunk
+ * @param  pos    - Set to the position of the problem on error
+ * @return NULL on success, or the problem with the chunk
+*/
+static const char* loadChunk(sim_replay* replay, uint32_t chunk, size_t* pos)
+{
+	replay->chunk = RECORD_NO_CHUNK;
+	*pos = replay->index[chunk].offset;
+	size_t end = (chunk + 1 < replay->numChunks) ? replay->index[chunk + 1].offset : replay->indexOffset;
+	uint64_t expected = ((chunk + 1 < replay->numChunks) ? replay->index[chunk + 1].firstStep : replay->numSteps) -
+		replay->index[chunk].firstStep;
+
+	uint64_t numSteps, stepBytes;
+	if (!getVarint(replay->data, end, pos, &numSteps) || !getVarint(replay->data, end, pos, &stepBytes)) return "a chunk header is cut short";
+	if (numSteps != expected) return "a chunk has a different number of steps than the index says";
+	if (!readRegisters(replay->data, end, pos, &replay->registers)) return "a keyframe has registers which are cut short or too big";
+	memcpy(replay->memory, replay->initial, RECORD_MEMORY_SIZE);
+	if (!readPages(replay->data, end, pos, replay->memory)) return "the pages of a keyframe are cut short";
+	if (stepBytes != end - *pos) return "the steps of a chunk do not end where the next chunk starts";
+
+	// every step takes at least a byte, so a bad count can't make the offsets huge
+	if (numSteps > stepBytes) return "a chunk has more steps than bytes";
+	uint64_t* offsets = (uint64_t*)sicRealloc(ALLOC_OTHER, replay->offsets, (numSteps + 1) * sizeof(uint64_t));
+	if (!offsets) return "the offsets of its steps could not be malloced";
+	replay->offsets = offsets;
+
+	for (uint64_t i = 0; i < numSteps; i++)
+	{
+		offsets[i] = *pos;
+		if (!checkStep(replay->data, end, pos)) return "a step is cut short or is outside memory";
+	}
+	offsets[numSteps] = *pos;
+	if (*pos != end) return "there is more after the last step of a chunk";
+
+	replay->chunk = chunk;
+	replay->chunkSteps = (uint32_t)numSteps;
+	replay->step = replay->index[chunk].firstStep;
+	return NULL;
+}
+
+/**
+ * @brief readReplayIndex is a function that reads the start of the trace and its index, after the magic and version have been checked.
+ *
+ * @param  replay - The replay being read into
+ * @param  pos    - The position, left at the problem on error
+ * @return NULL on success, or the problem with the file
+*/
+static const char* readReplayIndex(sim_replay* replay, size_t* pos)
+{
+	const uint8_t* data = replay->data;
+	size_t len = replay->len - RECORD_FOOTER_LEN;
+	if (!readRegisters(data, len, pos, &replay->start)) return "the registers at the start are cut short or too big";
+	if (!readPages(data, len, pos, replay->initial)) return "the memory at the start is cut short";
+	size_t headerEnd = *pos;
+
+	*pos = len;
+	if (memcmp(data + len + 8, RECORD_MAGIC, RECORD_MAGIC_LEN) != 0) return "the footer does not end with the magic";
+	replay->indexOffset = 0;
+	for (uint32_t i = 0; i < 8; i++)
+		replay->indexOffset |= (uint64_t)data[len + i] << (8 * i);
+	if (replay->indexOffset < headerEnd || replay->indexOffset >= len) return "the index is not between the start and the footer";
+
+	*pos = replay->indexOffset;
+	uint64_t numChunks;
+	if (!getVarint(data, len, pos, &numChunks) || !getVarint(data, len, pos, &replay->numSteps)) return "the index header is cut short";
+
+	// every entry takes at least 2 bytes, so a bad count can't make the index huge
+	if (numChunks > (len - *pos) / 2) return "there are fewer chunks than the count says";
+	if ((numChunks == 0) != (replay->numSteps == 0)) return "the number of steps does not match the chunks";
+	replay->index = (sim_record_index*)sicMalloc(ALLOC_OTHER, (numChunks + 1) * sizeof(sim_record_index));
+	if (!replay->index) return "the index could not be malloced";
+	replay->numChunks = (uint32_t)numChunks;
+
+	for (uint32_t i = 0; i < replay->numChunks; i++)
+	{
+		uint64_t stepDelta, offsetDelta;
+		if (!getVarint(data, len, pos, &stepDelta) || !getVarint(data, len, pos, &offsetDelta)) return "an index entry is cut short";
+		if ((i == 0) ? stepDelta != 0 : stepDelta == 0) return "the chunks do not start at step 0 and move forward";
+		if (i > 0 && offsetDelta == 0) return "two chunks start at the same offset";
+
+		replay->index[i].firstStep = (i ? replay->index[i - 1].firstStep : 0) + stepDelta;
+		replay->index[i].offset = (i ? replay->index[i - 1].offset : 0) + offsetDelta;
+		if (replay->index[i].firstStep >= replay->numSteps) return "a chunk starts past the last step";
+		if (replay->index[i].offset < headerEnd || replay->index[i].offset >= replay->indexOffset) return "a chunk is outside the chunks";
+	}
+	if (*pos != len) return "there is more after the index";
+	return NULL;
+}
+
+sim_replay* openReplay(const uint8_t* data, size_t len)
+{
+	if (len < RECORD_MAGIC_LEN + 1 + RECORD_FOOTER_LEN || memcmp(data, RECORD_MAGIC, RECORD_MAGIC_LEN) != 0)
+	{
+		fprintf(stderr, "[ERROR : 0]: The file is not a trace, it does not start with \"%s\".\n", RECORD_MAGIC);
+		return NULL;
+	}
+	if (data[RECORD_MAGIC_LEN] != RECORD_VERSION)
+	{
+		fprintf(stderr, "[ERROR : %d]: The trace is version %u, only version %d can be read.\n", RECORD_MAGIC_LEN, data[RECORD_MAGIC_LEN],
+			RECORD_VERSION);
+		return NULL;
+	}
+
+	sim_replay* replay = (sim_replay*)sicCalloc(ALLOC_OTHER, 1, sizeof(sim_replay));
+	if (!replay)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the replay.\n");
+		return NULL;
+	}
+	replay->data = data;
+	replay->len = len;
+	replay->chunk = RECORD_NO_CHUNK;
+
+	size_t pos = RECORD_MAGIC_LEN + 1;
+	const char* problem = readReplayIndex(replay, &pos);
+	if (!problem && replay->numChunks > 0) problem = loadChunk(replay, 0, &pos);
+	if (problem)
+	{
+		fprintf(stderr, "[ERROR : %zu]: The trace is not valid, %s.\n", pos, problem);
+		freeReplay(replay);
+		return NULL;
+	}
+
+	if (replay->numChunks == 0)
+	{
+		replay->registers = replay->start;
+		memcpy(replay->memory, replay->initial, RECORD_MEMORY_SIZE);
+	}
+	return replay;
+}
+
+void freeReplay(sim_replay* replay)
+{
+	if (!replay) return;
+
+	sicFree(ALLOC_OTHER, replay->index);
+	sicFree(ALLOC_OTHER, replay->offsets);
+	sicFree(ALLOC_OTHER, replay);
+}
+
+sim_replay* replaySeek(sim_replay* replay, uint64_t step)
+{
+	if (step > replay->numSteps)
+	{
+		fprintf(stderr, "[ERROR]: The trace has %llu steps, there is no step %llu.\n", (unsigned long long)replay->numSteps,
+			(unsigned long long)step);
+		return NULL;
+	}
+	if (replay->numChunks == 0) return replay;
+
+	// the last chunk which starts at or before the step
+	uint32_t low = 0;
+	uint32_t high = replay->numChunks - 1;
+	while (low < high)
+	{
+		uint32_t mid = low + (high - low + 1) / 2;
+		if (replay->index[mid].firstStep <= step) low = mid;
+		else high = mid - 1;
+	}
+
+	if (low != replay->chunk || step < replay->step)
+	{
+		size_t pos;
+		const char* problem = loadChunk(replay, low, &pos);
+		if (problem)
+		{
+			fprintf(stderr, "[ERROR : %zu]: The trace is not valid, %s.\n", pos, problem);
+			return NULL;
+		}
+	}
+	while (replay->step < step)
+	{
+		applyStep(replay, replay->offsets[replay->step - replay->index[replay->chunk].firstStep], 1);
+		replay->step++;
+	}
+	return replay;
+}
+
+sim_replay* replayStep(sim_replay* replay, uint8_t forward)
+{
+	if (replay->chunk == RECORD_NO_CHUNK || (forward ? replay->step == replay->numSteps : replay->step == 0)) return NULL;
+
+	uint64_t inChunk = replay->step - replay->index[replay->chunk].firstStep;
+	if (forward)
+	{
+		// the last step of a chunk ends where the keyframe of the next one starts
+		if (inChunk == replay->chunkSteps) return replaySeek(replay, replay->step + 1);
+		applyStep(replay, replay->offsets[inChunk], 1);
+		replay->step++;
+	}
+	else
+	{
+		// the step before a chunk is undone by replaying the chunk before up to it
+		if (inChunk == 0) return replaySeek(replay, replay->step - 1);
+		applyStep(replay, replay->offsets[inChunk - 1], 0);
+		replay->step--;
+	}
+	return replay;
+}
@@ -0,0 +1,241 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef RECORD_H // execution traces of the SIC simulator, recorded and replayed
+#define RECORD_H
+
+// Local includes //
+
+#include "sic.h"
+#include "scoff_bin.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define RECORD_MAGIC "SICR"
+#define RECORD_MAGIC_LEN 4
+#define RECORD_VERSION 1
+#define RECORD_MEMORY_SIZE (SIC_MEMORY_LIMIT + 1)
+#define RECORD_PAGE_BITS 8
+#define RECORD_PAGE_SIZE (1 << RECORD_PAGE_BITS)
+#define RECORD_NUM_PAGES (RECORD_MEMORY_SIZE >> RECORD_PAGE_BITS)
+#define RECORD_PAGE_MAP_BYTES (RECORD_NUM_PAGES / 8)
+#define RECORD_FOOTER_LEN (8 + RECORD_MAGIC_LEN) // the offset of the index and the magic again
+#define RECORD_CHUNK_STEPS 65536 // a chunk ends after this many steps or RECORD_CHUNK_BYTES of them, whichever comes first
+#define RECORD_CHUNK_BYTES (256 * 1024)
+#define RECORD_MAX_STEP_BYTES 32 // the flags, 5 register varints, and a write
+#define RECORD_INSTRUCTION_BYTES 3
+#define RECORD_NO_CHUNK 0xFFFFFFFF
+
+// the flags byte of a step, which says what the instruction changed
+#define RECORD_STEP_A     0x01
+#define RECORD_STEP_X     0x02
+#define RECORD_STEP_L     0x04
+#define RECORD_STEP_SW    0x08
+#define RECORD_STEP_JUMP  0x10 // the PC did not move on to the next instruction
+#define RECORD_STEP_BYTE  0x20 // the instruction stored a byte
+#define RECORD_STEP_WORD  0x40 // the instruction stored a word
+#define RECORD_STEP_FLAGS 0x7F
+
+// Structs and enums //
+
+/**
+ * @brief sim_registers is the registers of a SIC machine, as they are kept in a trace.
+ */
+typedef struct
+{
+	uint32_t A;
+	uint32_t X;
+	uint32_t L;
+	uint32_t SW;
+	uint32_t PC;
+
+} sim_registers;
+
+/**
+ * @brief sim_record_index is where a chunk of a trace starts, by the step it starts with and by its offset in the file.
+ */
+typedef struct
+{
+	uint64_t firstStep;
+	uint64_t offset;
+
+} sim_record_index;
+
+/**
+ * @brief sim_record is a trace being recorded. Each instruction is recorded as a step: a flags byte saying what it changed, then the
+ * changes as varints, each register as the XOR of its value before and after, the PC only when it did not move on by one instruction,
+ * and the address and the XOR of the bytes a store changed. Since every change is an XOR the same step takes the machine forward and
+ * back. A step is started when its instruction is dispatched and finished when the next one is, so the run loop never has to look at
+ * an instruction after it ran; instructions which faulted are not recorded.
+ *
+ * The file is the magic, the version, the registers as varints and the memory at the start, where memory is a bitmap of the 256 byte
+ * pages which differ from a base followed by those pages, the base being zeros here. Then come the chunks, each with its number of
+ * steps and their length in bytes as varints, a keyframe of the registers and the memory at its first step, with the memory at the
+ * start as the base, and the steps. Last is the index, the number of chunks and of steps then each chunk's first step and offset as
+ * deltas, and a footer of the index offset as 8 little endian bytes and the magic again.
+ */
+typedef struct
+{
+	FILE* outFile;
+	const char* path;
+	uint8_t* initial;
+	uint64_t offset;
+	uint64_t startInstructions;
+	uint64_t numSteps;
+
+	// the chunk being recorded
+	uint8_t* steps;
+	uint32_t stepBytes;
+	uint32_t chunkSteps;
+	uint8_t open;
+	sim_registers keyframe;
+	uint8_t* keyframeMemory;
+
+	// the step started by the last instruction dispatched
+	uint8_t pending;
+	sim_registers before;
+	uint32_t writeAt;
+	uint8_t writeLen;
+	uint8_t written[SIC_WORD_BYTES];
+
+	sim_record_index* index;
+	uint32_t numChunks;
+	uint32_t indexCapacity;
+	uint8_t failed;
+
+} sim_record;
+
+/**
+ * @brief sim_replay is a trace opened for replay and the state of the machine at one of its steps, which is how many of the recorded
+ * instructions have run. The chunk of that step is decoded into the offsets of its steps, so stepping either way within it only applies
+ * one step.
+ */
+typedef struct
+{
+	const uint8_t* data;
+	size_t len;
+	sim_registers start;
+	uint8_t initial[RECORD_MEMORY_SIZE];
+	sim_record_index* index;
+	uint32_t numChunks;
+	uint64_t numSteps;
+	uint64_t indexOffset;
+
+	// the state at the current step
+	sim_registers registers;
+	uint8_t memory[RECORD_MEMORY_SIZE];
+	uint64_t step;
+
+	// the chunk of the current step, with the offset of each of its steps and of its end
+	uint32_t chunk;
+	uint64_t* offsets;
+	uint32_t chunkSteps;
+
+} sim_replay;
+
+// Function declarations //
+
+/**
+ * @brief createRecord is a function that creates the trace file and writes the state the machine starts from to it.
+ *
+ * NOTE: that caller needs to finish the trace with finishRecord() and free it after use by using freeRecord().
+ *
+ * @param  path         - The trace file to write.
+ * @param  memory       - The memory of the machine.
+ * @param  registers    - The registers of the machine.
+ * @param  instructions - The instructions the machine has run so far.
+ * @return record or NULL on error
+ */
+sim_record* createRecord(const char* path, const uint8_t* memory, const sim_registers* registers, uint64_t instructions);
+
+/**
+ * @brief recordStep is a function that finishes the step of the instruction before, whose results are the registers and memory now,
+ * and starts the step of the instruction about to run. A store keeps the bytes it is about to change. A recording which failed stops
+ * recording and is reported by finishRecord(). The function returns nothing.
+ *
+ * @param  record    - The record.
+ * @param  registers - The registers before the instruction, with the PC at the instruction.
+ * @param  memory    - The memory of the machine.
+ * @param  writeAt   - The address the instruction stores to.
+ * @param  len       - The bytes the instruction stores, 0 if it is not a store.
+ * @return void
+ */
+void recordStep(sim_record* record, const sim_registers* registers, const uint8_t* memory, uint32_t writeAt, uint8_t len);
+
+/**
+ * @brief recordStop is a function that finishes the step of the last instruction dispatched when the machine stops, if it ran, which it
+ * did if the machine counted it. The function returns nothing.
+ *
+ * @param  record       - The record.
+ * @param  registers    - The registers of the stopped machine.
+ * @param  memory       - The memory of the machine.
+ * @param  instructions - The instructions the machine has run.
+ * @return void
+ */
+void recordStop(sim_record* record, const sim_registers* registers, const uint8_t* memory, uint64_t instructions);
+
+/**
+ * @brief finishRecord is a function that writes the last chunk, the index and the footer, and closes the trace file.
+ *
+ * @param  record - The record.
+ * @return record or NULL if the trace could not be written
+ */
+sim_record* finishRecord(sim_record* record);
+
+/**
+ * @brief freeRecord is a function that frees the record, closing its file if it was not finished. The function returns nothing.
+ *
+ * @param  record - The record to free, may be NULL.
+ * @return void
+ */
+void freeRecord(sim_record* record);
+
+/**
+ * @brief openReplay is a function that reads the header and index of a trace and puts the replay at its first step. The data has to
+ * outlive the replay. Everything in the file is checked before it is used, and errors are reported by their byte offset.
+ *
+ * NOTE: that caller needs to free the replay after use by using freeReplay().
+ *
+ * @param  data - The contents of the trace file.
+ * @param  len  - The length of the data.
+ * @return replay or NULL on error
+ */
+sim_replay* openReplay(const uint8_t* data, size_t len);
+
+/**
+ * @brief freeReplay is a function that frees the replay. The function returns nothing.
+ *
+ * @param  replay - The replay to free, may be NULL.
+ * @return void
+ */
+void freeReplay(sim_replay* replay);
+
+/**
+ * @brief replaySeek is a function that moves the replay to the step, finding its chunk in the index with a binary search and then
+ * applying the steps of the chunk up to it from its keyframe. Steps in the current chunk ahead of the replay are applied from where it is.
+ *
+ * @param  replay - The replay.
+ * @param  step   - The step, from 0 to the number of steps in the trace.
+ * @return replay or NULL on error
+ */
+sim_replay* replaySeek(sim_replay* replay, uint64_t step);
+
+/**
+ * @brief replayStep is a function that applies the next step, or undoes the last one.
+ *
+ * @param  replay  - The replay.
+ * @param  forward - 1 to step forward, 0 to step back.
+ * @return replay or NULL at either end of the trace or on error
+ */
+sim_replay* replayStep(sim_replay* replay, uint8_t forward);
+
+#endif //RECORD_H
@@ -0,0 +1,389 @@
+#include "scheduler.h"
+#include <sched.h>
+#include <unistd.h>
+
+// Define constants //
+#define SCHEDULER_RESIZE_CONSTANT 2
+
+// Global state //
+
+/* @brief the scheduler and deque of the worker running on this thread, NULL on threads which are not workers */
+static _Thread_local work_scheduler* currentScheduler = NULL;
+static _Thread_local uint32_t currentWorker = 0;
+static _Thread_local uint32_t stealSeed = 0;
+
+/**
+ * @brief dequePush is a function that adds a task to the head or the tail of the deque, growing it if it is full.
+ *
+ * @param  deque  - The deque
+ * @param  task   - The task to add
+ * @param  atHead - 1 to add at the head, 0 to add at the tail
+ * @return deque on success, NULL if it could not grow
+*/
+static work_deque* dequePush(work_deque* deque, const sched_task* task, uint8_t atHead)
+{
+	pthread_mutex_lock(&deque->lock);
+
+	// grow the ring buffer, unrolling it so the head starts at zero again
+	if (deque->count == deque->capacity)
+	{
+		uint32_t newCapacity = deque->capacity * SCHEDULER_RESIZE_CONSTANT;
+		sched_task* newTasks = (sched_task*)malloc(newCapacity * sizeof(sched_task));
+		if (!newTasks)
+		{
+			pthread_mutex_unlock(&deque->lock);
+			fprintf(stderr, "[ERROR]: could not grow a scheduler deque.\n");
+			return NULL;
+		}
+
+		for (uint32_t i = 0; i < deque->count; i++)
+			newTasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+
+		free(deque->tasks);
+		deque->tasks = newTasks;
+		deque->capacity = newCapacity;
+		deque->head = 0;
+	}
+
+	if (atHead)
+	{
+		deque->head = (deque->head + deque->capacity - 1) % deque->capacity;
+		deque->tasks[deque->head] = *task;
+	}
+	else
+		deque->tasks[(deque->head + deque->count) % deque->capacity] = *task;
+	__atomic_store_n(&deque->count, deque->count + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->queuedCost, deque->queuedCost + task->cost, __ATOMIC_RELAXED);
+
+	pthread_mutex_unlock(&deque->lock);
+	return deque;
+}
+
+/**
+ * @brief dequePop is a function that takes a task from the head or the tail of the deque.
+ *
+ * @param  deque  - The deque
+ * @param  task   - Set to the task taken
+ * @param  atHead - 1 to take from the head, 0 to take from the tail
+ * @return 1 if a task was taken, 0 if the deque was empty
+*/
+static uint8_t dequePop(work_deque* deque, sched_task* task, uint8_t atHead)
+{
+	// peek without the lock first so empty deques don't bounce their lock between cores
+	if (__atomic_load_n(&deque->count, __ATOMIC_RELAXED) == 0) return 0;
+
+	pthread_mutex_lock(&deque->lock);
+	if (deque->count == 0)
+	{
+		pthread_mutex_unlock(&deque->lock);
+		return 0;
+	}
+
+	if (atHead)
+	{
+		*task = deque->tasks[deque->head];
+		deque->head = (deque->head + 1) % deque->capacity;
+	}
+	else
+		*task = deque->tasks[(deque->head + deque->count - 1) % deque->capacity];
+	__atomic_store_n(&deque->count, deque->count - 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&deque->queuedCost, deque->queuedCost - task->cost, __ATOMIC_RELAXED);
+
+	pthread_mutex_unlock(&deque->lock);
+	return 1;
+}
+
+/**
+ * @brief notifyWorkers is a function that moves the generation counter and wakes one or all of the sleeping workers.
+ *
+ * @param  sched - The scheduler
+ * @param  all   - 1 to wake every worker, 0 to wake one
+ * @return void
+*/
+static void notifyWorkers(work_scheduler* sched, uint8_t all)
+{
+	pthread_mutex_lock(&sched->idleLock);
+	sched->generation++;
+	if (all)
+		pthread_cond_broadcast(&sched->workReady);
+	else
+		pthread_cond_signal(&sched->workReady);
+	pthread_mutex_unlock(&sched->idleLock);
+}
+
+/**
+ * @brief findTask is a function that takes the next task for the calling thread. A worker takes the head of its own deque first,
+ * then every thread steals from the tail of the other deques starting at a random one so thieves spread out.
+ *
+ * @param  sched - The scheduler
+ * @param  task  - Set to the task found
+ * @return 1 if a task was found, 0 if every deque is empty
+*/
+static uint8_t findTask(work_scheduler* sched, sched_task* task)
+{
+	uint8_t isWorker = (currentScheduler == sched);
+	if (isWorker && dequePop(&sched->deques[currentWorker], task, 1))
+		return 1;
+
+	// xorshift, seeded from the stack address so threads don't all start at the same victim
+	if (stealSeed == 0) stealSeed = (uint32_t)(uintptr_t)&task | 1;
+	stealSeed ^= stealSeed << 13;
+	stealSeed ^= stealSeed >> 17;
+	stealSeed ^= stealSeed << 5;
+
+	uint32_t start = stealSeed % sched->numDeques;
+	for (uint32_t i = 0; i < sched->numDeques; i++)
+	{
+		uint32_t victim = (start + i) % sched->numDeques;
+		if (isWorker && victim == currentWorker) continue;
+		if (dequePop(&sched->deques[victim], task, 0))
+		{
+			if (isWorker)
+				__atomic_fetch_add(&sched->numSteals, 1, __ATOMIC_RELAXED);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief runTask is a function that runs a task and signals allDone if it was the last one pending.
+ *
+ * @param  sched - The scheduler
+ * @param  task  - The task to run
+ * @return void
+*/
+static void runTask(work_scheduler* sched, const sched_task* task)
+{
+	task->task(task->arg);
+
+	if (__atomic_sub_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		pthread_mutex_lock(&sched->idleLock);
+		pthread_cond_broadcast(&sched->allDone);
+		pthread_mutex_unlock(&sched->idleLock);
+	}
+}
+
+/**
+ * @brief workerLoop is the function every worker thread runs. It runs tasks from its own deque, steals when it is empty, and sleeps
+ * when every deque is empty until a submit moves the generation counter. It returns once the scheduler is shut down.
+ *
+ * @param  arg - The work_scheduler* the worker belongs to
+ * @return NULL
+*/
+static void* workerLoop(void* arg)
+{
+	work_scheduler* sched = (work_scheduler*)arg;
+	currentScheduler = sched;
+	currentWorker = __atomic_fetch_add(&sched->nextWorkerId, 1, __ATOMIC_RELAXED);
+
+	sched_task task;
+	while (1)
+	{
+		// read the generation before looking so a submit racing with the search is not missed
+		uint64_t seen = __atomic_load_n(&sched->generation, __ATOMIC_ACQUIRE);
+		if (findTask(sched, &task))
+		{
+			runTask(sched, &task);
+			continue;
+		}
+
+		pthread_mutex_lock(&sched->idleLock);
+		while (sched->generation == seen && !sched->shutdown)
+			pthread_cond_wait(&sched->workReady, &sched->idleLock);
+		uint8_t stop = sched->shutdown && sched->pending == 0;
+		pthread_mutex_unlock(&sched->idleLock);
+
+		if (stop) break;
+	}
+
+	return NULL;
+}
+
+work_scheduler* createScheduler(uint32_t numWorkers)
+{
+	if (numWorkers == 0)
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		numWorkers = (online > 0) ? (uint32_t)online : 1;
+	}
+
+	work_scheduler* sched = (work_scheduler*)malloc(sizeof(work_scheduler));
+	if (!sched)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the scheduler.\n");
+		return NULL;
+	}
+	memset(sched, 0, sizeof(work_scheduler));
+
+	sched->workers = (pthread_t*)malloc(numWorkers * sizeof(pthread_t));
+	sched->deques = (work_deque*)calloc(numWorkers, sizeof(work_deque));
+	if (!sched->workers || !sched->deques)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the scheduler.\n");
+		free(sched->workers);
+		free(sched->deques);
+		free(sched);
+		return NULL;
+	}
+
+	pthread_mutex_init(&sched->idleLock, NULL);
+	pthread_cond_init(&sched->workReady, NULL);
+	pthread_cond_init(&sched->allDone, NULL);
+
+	for (uint32_t i = 0; i < numWorkers; i++)
+	{
+		sched->deques[i].capacity = SCHEDULER_DEQUE_SIZE;
+		sched->deques[i].tasks = (sched_task*)malloc(SCHEDULER_DEQUE_SIZE * sizeof(sched_task));
+		pthread_mutex_init(&sched->deques[i].lock, NULL);
+		sched->numDeques++;
+		if (!sched->deques[i].tasks)
+		{
+			fprintf(stderr, "[ERROR]: could not malloc memory for the scheduler.\n");
+			freeScheduler(sched);
+			return NULL;
+		}
+	}
+
+	// start the workers, keep however many started if one fails
+	for (uint32_t i = 0; i < numWorkers; i++)
+	{
+		if (pthread_create(&sched->workers[i], NULL, workerLoop, sched) != 0)
+		{
+			fprintf(stderr, "[WARN]: could only start %u of %u worker threads.\n", i, numWorkers);
+			break;
+		}
+		sched->numWorkers++;
+	}
+
+	if (sched->numWorkers == 0)
+	{
+		freeScheduler(sched);
+		return NULL;
+	}
+
+	return sched;
+}
+
+work_scheduler* schedulerSubmit(work_scheduler* sched, thread_pool_task task, void* arg, uint64_t cost)
+{
+	sched_task newTask = { task, arg, cost };
+	uint8_t isWorker = (currentScheduler == sched);
+
+	// a worker keeps its subtasks, anyone else hands the task to the least loaded deque
+	uint32_t target = currentWorker;
+	if (!isWorker)
+	{
+		target = 0;
+		for (uint32_t i = 1; i < sched->numDeques; i++)
+			if (__atomic_load_n(&sched->deques[i].queuedCost, __ATOMIC_RELAXED) < __atomic_load_n(&sched->deques[target].queuedCost, __ATOMIC_RELAXED))
+				target = i;
+	}
+
+	__atomic_add_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+	if (dequePush(&sched->deques[target], &newTask, isWorker) == NULL)
+	{
+		__atomic_sub_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+		return NULL;
+	}
+
+	notifyWorkers(sched, 0);
+	return sched;
+}
+
+/**
+ * @brief compareTaskCost is the qsort comparator which orders tasks from the most to the least costly.
+ *
+ * @param  a - The first sched_task*
+ * @param  b - The second sched_task*
+ * @return negative if a costs more than b, positive if less, 0 if equal
+*/
+static int compareTaskCost(const void* a, const void* b)
+{
+	uint64_t costA = ((const sched_task*)a)->cost;
+	uint64_t costB = ((const sched_task*)b)->cost;
+	return (costA < costB) - (costA > costB);
+}
+
+uint32_t schedulerSubmitAll(work_scheduler* sched, sched_task* tasks, uint32_t numTasks)
+{
+	qsort(tasks, numTasks, sizeof(sched_task), compareTaskCost);
+
+	uint64_t* dealt = (uint64_t*)calloc(sched->numDeques, sizeof(uint64_t));
+	if (!dealt)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory to deal the scheduler tasks.\n");
+		return 0;
+	}
+
+	// longest processing time first, every task goes to the deque with the least work dealt so far
+	uint32_t numQueued = 0;
+	for (; numQueued < numTasks; numQueued++)
+	{
+		uint32_t target = 0;
+		for (uint32_t d = 1; d < sched->numDeques; d++)
+			if (dealt[d] < dealt[target])
+				target = d;
+
+		__atomic_add_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+		if (dequePush(&sched->deques[target], &tasks[numQueued], 0) == NULL)
+		{
+			__atomic_sub_fetch(&sched->pending, 1, __ATOMIC_ACQ_REL);
+			break;
+		}
+		dealt[target] += tasks[numQueued].cost;
+	}
+
+	free(dealt);
+	notifyWorkers(sched, 1);
+	return numQueued;
+}
+
+void schedulerJoin(work_scheduler* sched, uint32_t* counter)
+{
+	sched_task task;
+	while (__atomic_load_n(counter, __ATOMIC_ACQUIRE) != 0)
+	{
+		// help instead of blocking, the tasks being waited on may be sitting in this worker's own deque
+		if (findTask(sched, &task))
+			runTask(sched, &task);
+		else
+			sched_yield();
+	}
+}
+
+void schedulerWait(work_scheduler* sched)
+{
+	pthread_mutex_lock(&sched->idleLock);
+	while (__atomic_load_n(&sched->pending, __ATOMIC_ACQUIRE) != 0)
+		pthread_cond_wait(&sched->allDone, &sched->idleLock);
+	pthread_mutex_unlock(&sched->idleLock);
+}
+
+void freeScheduler(work_scheduler* sched)
+{
+	if (!sched) return;
+
+	// let the workers drain the deques then join them
+	schedulerWait(sched);
+	pthread_mutex_lock(&sched->idleLock);
+	sched->shutdown = 1;
+	pthread_cond_broadcast(&sched->workReady);
+	pthread_mutex_unlock(&sched->idleLock);
+
+	for (uint32_t i = 0; i < sched->numWorkers; i++)
+		pthread_join(sched->workers[i], NULL);
+
+	for (uint32_t i = 0; i < sched->numDeques; i++)
+	{
+		pthread_mutex_destroy(&sched->deques[i].lock);
+		free(sched->deques[i].tasks);
+	}
+	pthread_mutex_destroy(&sched->idleLock);
+	pthread_cond_destroy(&sched->workReady);
+	pthread_cond_destroy(&sched->allDone);
+	free(sched->deques);
+	free(sched->workers);
+	free(sched);
+}
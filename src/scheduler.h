@@ -0,0 +1,142 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Local includes //
+
+#include "thread_pool.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Defines //
+
+#define SCHEDULER_DEQUE_SIZE 64
+
+// Structs //
+
+/**
+ * @brief sched_task is a task waiting in one of the deques of a scheduler. The cost is an estimate of how long the task runs,
+ * in any unit as long as every task of a scheduler uses the same one.
+ */
+typedef struct {
+
+	thread_pool_task task;
+	void* arg;
+	uint64_t cost;
+
+} sched_task;
+
+/**
+ * @brief work_deque is the ring buffer of tasks owned by one worker. The owner takes tasks from the head, other workers steal
+ * from the tail. The deque grows when it is full. queuedCost is the sum of the costs of the tasks in it.
+ */
+typedef struct {
+
+	sched_task* tasks;
+	uint32_t capacity;
+	uint32_t head;
+	uint32_t count;
+	uint64_t queuedCost;
+	pthread_mutex_t lock;
+
+} work_deque;
+
+/**
+ * @brief work_scheduler is a pool of workers which each own a deque of tasks and steal from the others when theirs runs dry.
+ * Tasks submitted from a worker go to the head of its own deque, so the subtasks of a job run on the core which split it unless
+ * another core is idle. pending counts the submitted tasks which have not finished. Idle workers sleep until the generation
+ * counter moves, which every submit does. There is one deque per requested worker even if fewer threads could be started, the
+ * deques of missing workers are emptied by stealing.
+ */
+typedef struct {
+
+	pthread_t* workers;
+	uint32_t numWorkers;
+	work_deque* deques;
+	uint32_t numDeques;
+	uint32_t nextWorkerId;
+	uint32_t pending;
+	uint64_t numSteals;
+
+	uint64_t generation;
+	uint8_t shutdown;
+	pthread_mutex_t idleLock;
+	pthread_cond_t workReady;
+	pthread_cond_t allDone;
+
+} work_scheduler;
+
+// Function declarations //
+
+/**
+ * @brief createScheduler is a function that starts the given number of workers, each with its own deque. If zero is given, one worker per
+ * online CPU is started. The function returns the scheduler or NULL if an error occurred.
+ *
+ * NOTE: that caller needs to free the scheduler after use by using freeScheduler().
+ *
+ * @param  numWorkers - The number of threads to start.
+ * @return scheduler or NULL on error
+ */
+work_scheduler* createScheduler(uint32_t numWorkers);
+
+/**
+ * @brief schedulerSubmit is a function that queues one task. From a worker the task goes to the head of the worker's own deque,
+ * from any other thread it goes to the deque with the least queued cost. It returns the scheduler on success or NULL if the deque could not grow.
+ *
+ * @param  sched - The scheduler which will run the task.
+ * @param  task  - The function to run.
+ * @param  arg   - The argument given to the function.
+ * @param  cost  - The estimated cost of the task.
+ * @return scheduler on success, NULL on error
+ */
+work_scheduler* schedulerSubmit(work_scheduler* sched, thread_pool_task task, void* arg, uint64_t cost);
+
+/**
+ * @brief schedulerSubmitAll is a function that queues a set of tasks largest first. Every task, from the most to the least costly,
+ * is dealt to the deque with the least cost so far, so each worker starts with its largest task and the deques end up balanced.
+ * The tasks are sorted in place. It returns how many of them were queued, which is less than numTasks only if a deque could not grow,
+ * in which case the tasks from that index on were not queued.
+ *
+ * @param  sched    - The scheduler which will run the tasks.
+ * @param  tasks    - The tasks, they are sorted in place.
+ * @param  numTasks - The number of tasks.
+ * @return number of tasks queued
+ */
+uint32_t schedulerSubmitAll(work_scheduler* sched, sched_task* tasks, uint32_t numTasks);
+
+/**
+ * @brief schedulerJoin is a function that waits for the counter to reach zero, running queued or stolen tasks while it waits instead of
+ * blocking. The tasks being waited on are expected to decrement the counter atomically when they finish. It can be called from a task.
+ *
+ * @param  sched   - The scheduler running the tasks.
+ * @param  counter - The number of tasks still running.
+ * @return void
+ */
+void schedulerJoin(work_scheduler* sched, uint32_t* counter);
+
+/**
+ * @brief schedulerWait is a function that blocks until every submitted task has finished. It must not be called from a task.
+ *
+ * @param  sched - The scheduler to wait on.
+ * @return void
+ */
+void schedulerWait(work_scheduler* sched);
+
+/**
+ * @brief freeScheduler is a function that waits for the queued tasks to finish, joins the workers, and frees the scheduler.
+ *
+ * @param  sched - The scheduler to be freed.
+ * @return void
+ */
+void freeScheduler(work_scheduler* sched);
+
+#endif //SCHEDULER_H
@@ -1,15 +1,8 @@
 #include "scoff.h"
 
-/**
- * @brief createRecords is a function that will allocate the sic_scoff_records struct and set its fields to zero.
- * It will return a NULL on error. The function will return the newly allocated records if successful.
- *
- * @param  void
- * @return records that were generated, or NULL on error.
- */
 sic_scoff_records* createRecords(void)
 {
-	sic_scoff_records* records = (sic_scoff_records*)malloc(sizeof(sic_scoff_records));
+	sic_scoff_records* records = (sic_scoff_records*)sicMalloc(ALLOC_OTHER, sizeof(sic_scoff_records));
 	if (!records)
 	{
 		fprintf(stderr, "[ERROR]: Malloc failed during the creation of a new records struct.\n");
@@ -20,9 +13,11 @@ sic_scoff_records* createRecords(void)
 	// allocate the linked lists
 	records->texts = createLinkedList();
 	if (!records->texts) return NULL;
+	records->texts->valueSubsystem = ALLOC_TEXT_RECORDS;
 
 	records->modifications = createLinkedList();
 	if (!records->modifications) return NULL;
+	records->modifications->valueSubsystem = ALLOC_MOD_RECORDS;
 
 	// set magicChars
 	records->header.magicChar = 'H';
@@ -44,21 +39,13 @@ void freeRecords(sic_scoff_records* records)
 	freeListAndValues(records->modifications);
 
 	// free the struct
-	free(records);
+	sicFree(ALLOC_OTHER, records);
 }
 
-/**
- * @brief createTextRecord is a function that will allocate the memory for a Text record.
- * The function accepts nothing and returns a newly allocated sic_scoff_text structure. It will return NULL
- * on error. The function also sets the magic char of the text record before returning.
- *
- * @param  void
- * @return newly allocated text record or NULL if an error occurred.
-*/
 sic_scoff_text* createTextRecord(void)
 {
 	// allocate and zero struct
-	sic_scoff_text* text = (sic_scoff_text*)malloc(sizeof(sic_scoff_text));
+	sic_scoff_text* text = (sic_scoff_text*)sicMalloc(ALLOC_TEXT_RECORDS, sizeof(sic_scoff_text));
 	if (!text)
 	{
 		fprintf(stderr, "[ERROR]: Malloc failed during the allocation of a new text struct.\n");
@@ -72,18 +59,10 @@ sic_scoff_text* createTextRecord(void)
 	return text;
 }
 
-/**
- * @brief createModificationRecord is a function that will allocate the memory for a modification record.
- * The function accepts nothing and returns a newly allocated sic_scoff_mod structure. It will return NULL
- * on error. The function also sets the magic char of the mod record before returning. 
- * 
- * @param  void
- * @return newly allocated modification record or NULL if an error occurred.
-*/
 sic_scoff_mod* createModificationRecord(void)
 {
 	// allocate and zero struct
-	sic_scoff_mod* modification = (sic_scoff_mod*)malloc(sizeof(sic_scoff_mod));
+	sic_scoff_mod* modification = (sic_scoff_mod*)sicMalloc(ALLOC_MOD_RECORDS, sizeof(sic_scoff_mod));
 	if (!modification)
 	{
 		fprintf(stderr, "[ERROR]: Malloc failed during the allocation of a new modification struct.\n");
@@ -97,18 +76,6 @@ sic_scoff_mod* createModificationRecord(void)
 	return modification;
 }
 
-/**
- * @brief ASCIIToHexConvertion is a function that will write the hex representation of a character string
- * to the text record's object code. This function will accept the text record it will write in, the
- * pointer to the character string, and laslty the length of the character string. 
- * The function will return the given text record pointer on success,
- * and if an error occured it will return NULL.
- * 
- * @param  t		- The text record which will be used to hold the ascii hex. 
- * @param  string	- The character string which will be converted to hex and added to t-record.
- * @param  length   - The length of the character string.
- * @return char*	- After the last written character. Used for multi text record constants.
-*/
 char* ASCIIToHexConvertion(sic_scoff_text* t, char* string, int32_t length)
 {
 	for (int32_t i = 0; i < length; i++)
@@ -141,13 +108,13 @@ sic_scoff_records* secondPassDirectiveHelper(symbol_table* symTab, char* token,
 	if (strcmp(token, "WORD") == 0)
 	{
 		uint32_t address = *lc;
-		uint32_t word = strtol(strtok(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
+		uint32_t word = strtol(sicTokenize(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
 
 		// text record
 		sic_scoff_text* t = createTextRecord();
 		sprintf(t->startAddr, "%0*X", SCOFF_TEXT_ADDR_LEN, address);
 		sprintf(t->lengthOfObj, "%0*X", SCOFF_TEXT_SIZE_LEN, SIC_WORD_BYTES);
-		sprintf(t->objectCode, "%0*X", SCOFF_TEXT_OBJ_CODE_LEN/10, word); // how would i do the max size instead of small text records
+		sprintf(t->objectCode, "%0*X", SCOFF_TEXT_OBJ_CODE_LEN/10, word & SIC_WORD_MASK); // how would i do the max size instead of small text records
 																		  // maybe have helper function that calcs how many characters i can place before i need a new record?
 
 		// add to list, and increment local lc
@@ -159,7 +126,7 @@ sic_scoff_records* secondPassDirectiveHelper(symbol_table* symTab, char* token,
 
 	if (strcmp(token, "RESB") == 0)
 	{
-		uint32_t operand = strtol(strtok(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
+		uint32_t operand = strtol(sicTokenize(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
 
 		// dont make a record, just increment counter again
 		(*lc) += operand * SIC_BYTE;
@@ -169,7 +136,7 @@ sic_scoff_records* secondPassDirectiveHelper(symbol_table* symTab, char* token,
 
 	if (strcmp(token, "RESW") == 0)
 	{
-		uint32_t operand = strtol(strtok(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
+		uint32_t operand = strtol(sicTokenize(NULL, SIC_TOKEN_DELIMITERS), NULL, 10);
 
 		// dont make a record, just increment counter again
 		(*lc) += operand * SIC_WORD_BYTES;
@@ -181,7 +148,7 @@ sic_scoff_records* secondPassDirectiveHelper(symbol_table* symTab, char* token,
 	{
 		// parse string
 		uint8_t parseHex;
-		char* lptr = strtok(NULL, "\r\n");
+		char* lptr = sicTokenize(NULL, "\r\n");
 		char* rptr;
 
 		if (*lptr == 'C') parseHex = 0;
@@ -210,7 +177,9 @@ sic_scoff_records* secondPassDirectiveHelper(symbol_table* symTab, char* token,
 				sic_scoff_text* t = createTextRecord();
 				sprintf(t->startAddr, "%0*X", SCOFF_TEXT_ADDR_LEN, currentLC);
 				sprintf(t->lengthOfObj, "%0*X", SCOFF_TEXT_SIZE_LEN, currentBytesNeeded);
-				memcpy(t->objectCode, lptr, currentLen);
+				// pass one allowed either case, the records always hold upper case hex like every other field
+				for (uint32_t i = 0; i < currentLen; i++)
+					t->objectCode[i] = (char)toupper((unsigned char)lptr[i]);
 				addToList(record->texts, t);
 
 				lptr += currentLen;
@@ -291,7 +260,7 @@ sic_scoff_records* secondPassInstructionHelper(symbol_table* symTab, sic_optable
 	}
 	else // has an operand, so we parse
 	{
-		char* operand = strtok(NULL, SIC_TOKEN_DELIMITERS);
+		char* operand = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 		char* indexedSubStr = strstr(operand, SCOFF_INDEXED_SUBSTR);
 		if (indexedSubStr)
 		{
@@ -301,14 +270,14 @@ sic_scoff_records* secondPassInstructionHelper(symbol_table* symTab, sic_optable
 
 		// get symbol address, and handle indexed addressing if necessary
 		uint32_t symAddr;
-		uint32_t* addrPtr = (uint32_t*)getKVPair(symTab->ht, operand);
-		if (!addrPtr)
+		sic_symbol* symbolValue = (sic_symbol*)getKVPair(symTab->ht, operand);
+		if (!symbolValue)
 		{
 			printOPSError(OPS_INVALID_SYM_GIVEN, operand, NULL, lineNum);
-			free(text);
+			sicFree(ALLOC_TEXT_RECORDS, text);
 			return NULL;
 		}
-		symAddr = *addrPtr;
+		symAddr = symbolValue->address;
 
 		if (indexed)
 			symAddr |= SCOFF_INDEXED_BIT;
@@ -353,7 +322,7 @@ sic_scoff_records* generateSCOFFRecords(FILE* openSIC, hash_table* directiveTabl
 	{
 		// check to see if its a comment
 		token = buffer;
-		token = strtok(token, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(token, SIC_TOKEN_DELIMITERS);
 		if (checkComment(token)) { lineNum++; continue; }
 
 		// reset symbol and value pointers
@@ -386,7 +355,7 @@ sic_scoff_records* generateSCOFFRecords(FILE* openSIC, hash_table* directiveTabl
 		else // its a symbol
 		{
 			symbol = token;
-			token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 
 			// directive/opcode
 			if ((voidPtrVal = getKVPair(directiveTable, token)) != NULL)
@@ -424,11 +393,48 @@ sic_scoff_records* generateSCOFFRecords(FILE* openSIC, hash_table* directiveTabl
 	return records;
 }
 
+sic_scoff_records* writeSCOFFToStream(sic_scoff_records* records, FILE* outFile)
+{
+	// output header record, counting the bytes written for the stats
+	int64_t written = fprintf(outFile, "%c%s%s%s\n", records->header.magicChar, records->header.programName, 
+		records->header.startAddr, records->header.lengthOfProgram); 
+
+	// output all text records
+	ll_node* node = records->texts->head;
+	while (node)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		written += fprintf(outFile, "%c%s%s%s\n", t->magicChar, t->startAddr, t->lengthOfObj, t->objectCode);
+		node = node->next;
+	}
+	
+	// output all modification records
+	node = records->modifications->head;
+	while (node)
+	{
+		sic_scoff_mod* mod = (sic_scoff_mod*)node->data;
+		written += fprintf(outFile, "%c%s%s%c%s\n", mod->magicChar, mod->startAddr, mod->lenOfModificationHB, mod->modificationFlag, mod->symbolName);
+		node = node->next;
+	}
+	
+	// output end record
+	written += fprintf(outFile, "%c%s", records->end.magicChar, records->end.firstInstruction);
+	STATS_ADD(bytesWritten, written);
+
+	if (ferror(outFile))
+	{
+		fprintf(stderr, "[ERROR]: An error occurred while writing the records to the OBJ stream.\n");
+		return NULL;
+	}
+
+	return records;
+}
+
 sic_scoff_records* writeSCOFFToFile(sic_scoff_records* records, char* fileName)
 {
 	// allocate enough space for new filename with extension and concat the new string
 	size_t bufferBytes = strlen(fileName) + SCOFF_OBJ_EXTENSION_LEN + 1;
-	char* buffer = (char*)malloc(bufferBytes);
+	char* buffer = (char*)sicMalloc(ALLOC_OTHER, bufferBytes);
 	if (!buffer)
 	{
 		fprintf(stderr, "[ERROR]: Could not malloc temporary buffer during ouput of OBJ to file.\n");
@@ -447,42 +453,19 @@ sic_scoff_records* writeSCOFFToFile(sic_scoff_records* records, char* fileName)
 	if (!outFile)
 	{
 		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output OBJ file.\n", buffer);
-		free(buffer);
+		sicFree(ALLOC_OTHER, buffer);
 		return NULL;
 	}
 
 	// output to file // 
-	// output header record
-	fprintf(outFile, "%c%s%s%s\n", records->header.magicChar, records->header.programName, 
-		records->header.startAddr, records->header.lengthOfProgram); 
-
-	// output all text records
-	ll_node* node = records->texts->head;
-	while (node)
-	{
-		sic_scoff_text* t = (sic_scoff_text*)node->data;
-		fprintf(outFile, "%c%s%s%s\n", t->magicChar, t->startAddr, t->lengthOfObj, t->objectCode);
-		node = node->next;
-	}
-	
-	// output all modification records
-	node = records->modifications->head;
-	while (node)
-	{
-		sic_scoff_mod* mod = (sic_scoff_mod*)node->data;
-		fprintf(outFile, "%c%s%s%c%s\n", mod->magicChar, mod->startAddr, mod->lenOfModificationHB, mod->modificationFlag, mod->symbolName);
-		node = node->next;
-	}
-	
-	// output end record
-	fprintf(outFile, "%c%s", records->end.magicChar, records->end.firstInstruction);
+	sic_scoff_records* written = writeSCOFFToStream(records, outFile);
 
 #ifdef _DEBUG
 	printf("[Info]: Successfully wrote records to the object file \"%s\".\n", buffer);
 #endif //_DEBUG
 
 	// close file and free allocated buffer
-	free(buffer);
+	sicFree(ALLOC_OTHER, buffer);
 	if (fclose(outFile) != 0)
 	{
 #ifdef _DEBUG
@@ -490,5 +473,142 @@ sic_scoff_records* writeSCOFFToFile(sic_scoff_records* records, char* fileName)
 #endif //_DEBUG
 	}
 
+	return written;
+}
+
+/**
+ * @brief isHexField is a function that checks that the field is made of upper case hex digits only, the way the records are written.
+ *
+ * @param  field - The start of the field
+ * @param  len   - The length of the field
+ * @return 1 if it is, 0 if not
+*/
+static uint8_t isHexField(const char* field, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		if (!isdigit((unsigned char)field[i]) && (field[i] < 'A' || field[i] > 'F'))
+			return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief readSCOFFLine is a function that parses one line of a SCOFF object into the records. The kind of record must be allowed where
+ * it appears, which stage tracks: 0 before the header, 1 in the text records, 2 in the modification records, and 3 after the end record.
+ *
+ * @param  records - The records being read into
+ * @param  line    - The line without its newline
+ * @param  len     - The length of the line
+ * @param  stage   - The stage of the object, updated for the record read
+ * @return NULL on success, or the problem with the line
+*/
+static const char* readSCOFFLine(sic_scoff_records* records, const char* line, size_t len, uint8_t* stage)
+{
+	char kind = (len > 0) ? line[0] : '\0';
+	if (*stage == 3) return "there is more after the end record";
+	if (*stage == 0 && kind != 'H') return "the object does not start with a header record";
+
+	if (kind == 'H')
+	{
+		if (*stage != 0) return "there is a second header record";
+		if (len != 1 + 3 * SCOFF_HEADER_FIELD_LEN) return "the header record is not 19 characters long";
+		if (!isHexField(line + 1 + SCOFF_HEADER_FIELD_LEN, 2 * SCOFF_HEADER_FIELD_LEN)) return "the header record has an address which is not hex";
+
+		memcpy(records->header.programName, line + 1, SCOFF_HEADER_FIELD_LEN);
+		memcpy(records->header.startAddr, line + 1 + SCOFF_HEADER_FIELD_LEN, SCOFF_HEADER_FIELD_LEN);
+		memcpy(records->header.lengthOfProgram, line + 1 + 2 * SCOFF_HEADER_FIELD_LEN, SCOFF_HEADER_FIELD_LEN);
+		*stage = 1;
+		return NULL;
+	}
+
+	if (kind == 'T')
+	{
+		if (*stage != 1) return "a text record comes after a modification record";
+		size_t fieldsLen = 1 + SCOFF_TEXT_ADDR_LEN + SCOFF_TEXT_SIZE_LEN;
+		if (len < fieldsLen || !isHexField(line + 1, len - 1)) return "the text record is not made of hex digits";
+
+		char lengthOfObj[SCOFF_TEXT_SIZE_LEN + 1] = { 0 };
+		memcpy(lengthOfObj, line + 1 + SCOFF_TEXT_ADDR_LEN, SCOFF_TEXT_SIZE_LEN);
+		size_t numBytes = strtoul(lengthOfObj, NULL, 16);
+		if (numBytes * SIC_CHARACTERS_PER_BYTE > SCOFF_TEXT_OBJ_CODE_LEN) return "the text record holds more than 30 bytes";
+		if (len != fieldsLen + numBytes * SIC_CHARACTERS_PER_BYTE) return "the text record length does not match its object code";
+
+		sic_scoff_text* t = createTextRecord();
+		if (!t) return "out of memory";
+		memcpy(t->startAddr, line + 1, SCOFF_TEXT_ADDR_LEN);
+		memcpy(t->lengthOfObj, lengthOfObj, SCOFF_TEXT_SIZE_LEN);
+		memcpy(t->objectCode, line + fieldsLen, len - fieldsLen);
+		if (addToList(records->texts, t) == NULL)
+		{
+			sicFree(ALLOC_TEXT_RECORDS, t);
+			return "out of memory";
+		}
+		return NULL;
+	}
+
+	if (kind == 'M')
+	{
+		size_t fieldsLen = 1 + SCOFF_MOD_ADDR_LEN + SCOFF_MOD_SIZE_LEN + 1;
+		if (len < fieldsLen || len > fieldsLen + SCOFF_MOD_SYMBOL_LEN) return "the modification record is not 10 to 16 characters long";
+		if (!isHexField(line + 1, SCOFF_MOD_ADDR_LEN + SCOFF_MOD_SIZE_LEN)) return "the modification record has an address which is not hex";
+
+		sic_scoff_mod* mod = createModificationRecord();
+		if (!mod) return "out of memory";
+		memcpy(mod->startAddr, line + 1, SCOFF_MOD_ADDR_LEN);
+		memcpy(mod->lenOfModificationHB, line + 1 + SCOFF_MOD_ADDR_LEN, SCOFF_MOD_SIZE_LEN);
+		mod->modificationFlag = line[fieldsLen - 1];
+		memcpy(mod->symbolName, line + fieldsLen, len - fieldsLen);
+		if (addToList(records->modifications, mod) == NULL)
+		{
+			sicFree(ALLOC_MOD_RECORDS, mod);
+			return "out of memory";
+		}
+		*stage = 2;
+		return NULL;
+	}
+
+	if (kind == 'E')
+	{
+		if (len != 1 + SCOFF_END_FIRST_INSTRUCTION_LEN || !isHexField(line + 1, len - 1)) return "the end record is not an E and 6 hex digits";
+		memcpy(records->end.firstInstruction, line + 1, SCOFF_END_FIRST_INSTRUCTION_LEN);
+		*stage = 3;
+		return NULL;
+	}
+
+	return "the record is not an H, T, M, or E record";
+}
+
+sic_scoff_records* readSCOFF(const char* text, size_t len)
+{
+	sic_scoff_records* records = createRecords();
+	if (!records) return NULL;
+
+	uint8_t stage = 0;
+	uint32_t lineNum = 1;
+	size_t pos = 0;
+	while (pos < len)
+	{
+		const char* newline = (const char*)memchr(text + pos, '\n', len - pos);
+		size_t lineLen = newline ? (size_t)(newline - (text + pos)) : len - pos;
+
+		const char* problem = readSCOFFLine(records, text + pos, lineLen, &stage);
+		if (problem)
+		{
+			fprintf(stderr, "[ERROR : %u]: The object is not valid SCOFF at byte %zu, %s.\n", lineNum, pos, problem);
+			freeRecords(records);
+			return NULL;
+		}
+
+		pos += lineLen + 1;
+		lineNum++;
+	}
+
+	if (stage != 3)
+	{
+		fprintf(stderr, "[ERROR : %u]: The object is not valid SCOFF at byte %zu, it has no end record.\n", lineNum, len);
+		freeRecords(records);
+		return NULL;
+	}
 	return records;
-}
\ No newline at end of file
+}
@@ -112,6 +112,35 @@ typedef struct
 
 // Functions //
 
+/**
+ * @brief createRecords is a function that will allocate the sic_scoff_records struct and set its fields to zero.
+ * It will return a NULL on error. The function will return the newly allocated records if successful.
+ *
+ * @param  void
+ * @return records that were generated, or NULL on error.
+ */
+sic_scoff_records* createRecords(void);
+
+/**
+ * @brief createTextRecord is a function that will allocate the memory for a Text record.
+ * The function accepts nothing and returns a newly allocated sic_scoff_text structure. It will return NULL
+ * on error. The function also sets the magic char of the text record before returning.
+ *
+ * @param  void
+ * @return newly allocated text record or NULL if an error occurred.
+*/
+sic_scoff_text* createTextRecord(void);
+
+/**
+ * @brief createModificationRecord is a function that will allocate the memory for a modification record.
+ * The function accepts nothing and returns a newly allocated sic_scoff_mod structure. It will return NULL
+ * on error. The function also sets the magic char of the mod record before returning.
+ *
+ * @param  void
+ * @return newly allocated modification record or NULL if an error occurred.
+*/
+sic_scoff_mod* createModificationRecord(void);
+
 /**
  * @brief freeRecords is a function that will deallocate a givne sic_scoff_records struct.
  * The function will accept a pointer to the struct which will be freed, and the function
@@ -122,6 +151,20 @@ typedef struct
 */
 void freeRecords(sic_scoff_records* records);
 
+/**
+ * @brief ASCIIToHexConvertion is a function that will write the hex representation of a character string
+ * to the text record's object code. This function will accept the text record it will write in, the
+ * pointer to the character string, and laslty the length of the character string. 
+ * The function will return the given text record pointer on success,
+ * and if an error occured it will return NULL.
+ * 
+ * @param  t		- The text record which will be used to hold the ascii hex. 
+ * @param  string	- The character string which will be converted to hex and added to t-record.
+ * @param  length   - The length of the character string.
+ * @return char*	- After the last written character. Used for multi text record constants.
+*/
+char* ASCIIToHexConvertion(sic_scoff_text* t, char* string, int32_t length);
+
 /**
  * @brief generateSCOFFRecords is a function that will do part of pass 2 of the assembler. It will be reponsible for parsing the
  * SIC assembly file again in order to generate the records. The function will accept
@@ -139,6 +182,16 @@ void freeRecords(sic_scoff_records* records);
 sic_scoff_records* generateSCOFFRecords( FILE* openSIC, hash_table* directiveTable, hash_table* opTab, symbol_table* symTab);
 
 
+/**
+ * @brief writeSCOFFToStream is a function that writes the records in the SCOFF text format to an already open stream, such as stdout.
+ * The stream is not closed. The function will return the given records pointer, or NULL if the stream reported a write error.
+ *
+ * @param  records - The records struct that will be written.
+ * @param  outFile - The open stream the records are written to.
+ * @return The given records pointer, or NULL on error.
+*/
+sic_scoff_records* writeSCOFFToStream(sic_scoff_records* records, FILE* outFile);
+
 /**
  * @brief writeSCOFFToFile is a function that takes a records struct and outputs the records into an .obj file for SIC.
  * The function will accept the pointer to a records struct and the fileName which will be given to the newly created .obj file.
@@ -150,4 +203,18 @@ sic_scoff_records* generateSCOFFRecords( FILE* openSIC, hash_table* directiveTab
 */
 sic_scoff_records* writeSCOFFToFile(sic_scoff_records* records, char* fileName);
 
+/**
+ * @brief readSCOFF is a function that parses an object in the SCOFF text format back into records, the reverse of writeSCOFFToStream.
+ * The records have to be in the order the assembler writes them, one header, the text records, the modification records, and the end
+ * record, with every field at its fixed width in upper case hex. Writing the records again gives back the same text. The function prints
+ * the line and byte offset of the first problem and returns NULL if the text is not such an object.
+ *
+ * NOTE: that caller needs to free the records after use by using freeRecords().
+ *
+ * @param  text - The object text.
+ * @param  len  - The length of the text.
+ * @return records or NULL on error
+*/
+sic_scoff_records* readSCOFF(const char* text, size_t len);
+
 #endif //SCOFF_H
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include "scoff_bin.h"
+#include "scoff_reader.h"
+
+uint32_t putVarint(uint64_t value, FILE* outFile)
+{
+	uint8_t bytes[SCOFF_BIN_MAX_VARINT_LEN];
+	uint32_t len = 0;
+	do
+	{
+		bytes[len] = value & 0x7F;
+		value >>= 7;
+		if (value) bytes[len] |= 0x80;
+		len++;
+	} while (value);
+
+	fwrite(bytes, 1, len, outFile);
+	return len;
+}
+
+uint8_t getVarint(const uint8_t* data, size_t len, size_t* pos, uint64_t* value)
+{
+	*value = 0;
+	for (uint32_t shift = 0; shift < 7 * SCOFF_BIN_MAX_VARINT_LEN && *pos < len; shift += 7)
+	{
+		uint8_t byte = data[(*pos)++];
+		*value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return 1;
+	}
+	return 0;
+}
+
+uint64_t zigzag(int64_t delta)
+{
+	return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * @brief hexField is a function that returns the value of a field of hex digits, which the records always hold.
+ *
+ * @param  field - The null terminated field
+ * @return the value of the field
+*/
+static uint32_t hexField(const char* field)
+{
+	return (uint32_t)strtoul(field, NULL, 16);
+}
+
+sic_scoff_records* writeSCOFFBinToStream(sic_scoff_records* records, FILE* outFile)
+{
+	// the object code is checked before anything is written, so a record which is not hex never leaves a partial object behind
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		uint8_t bytes[SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE];
+		uint32_t numBytes = hexField(t->lengthOfObj);
+		if (numBytes > sizeof(bytes) || strlen(t->objectCode) != numBytes * SIC_CHARACTERS_PER_BYTE ||
+			!decodeHex(t->objectCode, numBytes, bytes))
+		{
+			fprintf(stderr, "[ERROR]: The T record at %s does not hold %u bytes of upper case hex, the binary object was not written.\n",
+				t->startAddr, numBytes);
+			return NULL;
+		}
+	}
+
+	uint32_t start = hexField(records->header.startAddr);
+	uint64_t written = fwrite(SCOFF_BIN_MAGIC, 1, SCOFF_BIN_MAGIC_LEN, outFile);
+	fputc(SCOFF_BIN_VERSION, outFile);
+	written += 1 + fwrite(records->header.programName, 1, SCOFF_HEADER_FIELD_LEN, outFile);
+
+	written += putVarint(start, outFile);
+	written += putVarint(hexField(records->header.lengthOfProgram), outFile);
+	written += putVarint(hexField(records->end.firstInstruction), outFile);
+	written += putVarint(records->texts->numberOfElements, outFile);
+	written += putVarint(records->modifications->numberOfElements, outFile);
+
+	// the index, each text record is usually right after the one before it so the delta is 0
+	int64_t previousEnd = start;
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		int64_t addr = hexField(t->startAddr);
+		uint32_t numBytes = hexField(t->lengthOfObj);
+		written += putVarint(zigzag(addr - previousEnd), outFile);
+		fputc(numBytes, outFile);
+		written++;
+		previousEnd = addr + numBytes;
+	}
+
+	// the object code of the text records
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		uint8_t bytes[SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE];
+		uint32_t numBytes = hexField(t->lengthOfObj);
+		decodeHex(t->objectCode, numBytes, bytes);
+		written += fwrite(bytes, 1, numBytes, outFile);
+	}
+
+	// the modification records
+	int64_t previousMod = start;
+	for (ll_node* node = records->modifications->head; node; node = node->next)
+	{
+		sic_scoff_mod* mod = (sic_scoff_mod*)node->data;
+		int64_t addr = hexField(mod->startAddr);
+		uint8_t symLen = (uint8_t)strlen(mod->symbolName);
+		written += putVarint(zigzag(addr - previousMod), outFile);
+		fputc(hexField(mod->lenOfModificationHB), outFile);
+		fputc(mod->modificationFlag, outFile);
+		fputc(symLen, outFile);
+		written += 3 + fwrite(mod->symbolName, 1, symLen, outFile);
+		previousMod = addr;
+	}
+	STATS_ADD(bytesWritten, written);
+
+	if (ferror(outFile))
+	{
+		fprintf(stderr, "[ERROR]: An error occurred while writing the records to the binary object stream.\n");
+		return NULL;
+	}
+
+	return records;
+}
+
+sic_scoff_records* writeSCOFFBinToFile(sic_scoff_records* records, char* fileName)
+{
+	// name the object the way writeSCOFFToFile does, with the binary extension
+	char* folder = strrchr(fileName, '\\');
+	if (folder++) fileName = folder;
+
+	size_t bufferBytes = strlen(fileName) + SCOFF_BIN_EXTENSION_LEN + 1;
+	char* buffer = (char*)sicMalloc(ALLOC_OTHER, bufferBytes);
+	if (!buffer)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc temporary buffer during ouput of the binary object to file.\n");
+		return NULL;
+	}
+	strcpy(buffer, fileName);
+	strcat(buffer, SCOFF_BIN_EXTENSION);
+
+	FILE* outFile = fopen(buffer, "wb");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the binary object.\n", buffer);
+		sicFree(ALLOC_OTHER, buffer);
+		return NULL;
+	}
+
+	sic_scoff_records* written = writeSCOFFBinToStream(records, outFile);
+	if (fclose(outFile) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not close the binary object file \"%s\".\n", buffer);
+		written = NULL;
+	}
+
+	sicFree(ALLOC_OTHER, buffer);
+	return written;
+}
+
+/**
+ * @brief readSCOFFBinRecords is a function that reads the counts, index, object code and modification records of a binary object into
+ * the records, after the magic, version and name have been checked.
+ *
+ * @param  records - The records being read into
+ * @param  data    - The binary object
+ * @param  len     - The length of the object
+ * @param  pos     - The position, left at the problem on error
+ * @return NULL on success, or the problem with the object
+*/
+static const char* readSCOFFBinRecords(sic_scoff_records* records, const uint8_t* data, size_t len, size_t* pos)
+{
+	uint64_t start, length, first, numTexts, numMods;
+	if (!getVarint(data, len, pos, &start) || !getVarint(data, len, pos, &length) || !getVarint(data, len, pos, &first) ||
+		!getVarint(data, len, pos, &numTexts) || !getVarint(data, len, pos, &numMods))
+		return "the header is cut short";
+	if (start > SIC_WORD_MASK || length > SIC_WORD_MASK || first > SIC_WORD_MASK) return "an address in the header is over 24 bits";
+
+	sprintf(records->header.startAddr, "%0*X", SCOFF_HEADER_FIELD_LEN, (uint32_t)start);
+	sprintf(records->header.lengthOfProgram, "%0*X", SCOFF_HEADER_FIELD_LEN, (uint32_t)length);
+	sprintf(records->end.firstInstruction, "%0*X", SCOFF_END_FIRST_INSTRUCTION_LEN, (uint32_t)first);
+
+	// every text record takes at least two bytes of index, which bounds the count before anything is allocated
+	if (numTexts > (len - *pos) / 2) return "the number of text records is larger than the object";
+
+	// the index
+	int64_t previousEnd = (int64_t)start;
+	for (uint64_t i = 0; i < numTexts; i++)
+	{
+		uint64_t delta;
+		if (!getVarint(data, len, pos, &delta) || *pos >= len) return "the index is cut short";
+		int64_t addr = previousEnd + unzigzag(delta);
+		uint8_t numBytes = data[(*pos)++];
+		if (addr < 0 || addr > SIC_WORD_MASK) return "a text record address is over 24 bits";
+		if (numBytes > SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE) return "a text record holds more than 30 bytes";
+
+		sic_scoff_text* t = createTextRecord();
+		if (!t) return "out of memory";
+		sprintf(t->startAddr, "%0*X", SCOFF_TEXT_ADDR_LEN, (uint32_t)addr);
+		sprintf(t->lengthOfObj, "%0*X", SCOFF_TEXT_SIZE_LEN, numBytes);
+		if (addToList(records->texts, t) == NULL)
+		{
+			sicFree(ALLOC_TEXT_RECORDS, t);
+			return "out of memory";
+		}
+		previousEnd = addr + numBytes;
+	}
+
+	// the object code, each record knows its length from the index
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		sic_scoff_text* t = (sic_scoff_text*)node->data;
+		uint32_t numBytes = hexField(t->lengthOfObj);
+		if (len - *pos < numBytes) return "the object code is cut short";
+		for (uint32_t i = 0; i < numBytes; i++)
+			sprintf(t->objectCode + SIC_CHARACTERS_PER_BYTE * i, "%0*X", SIC_CHARACTERS_PER_BYTE, data[(*pos)++]);
+	}
+
+	// the modification records
+	int64_t previousMod = (int64_t)start;
+	for (uint64_t i = 0; i < numMods; i++)
+	{
+		uint64_t delta;
+		if (!getVarint(data, len, pos, &delta) || len - *pos < 3) return "a modification record is cut short";
+		int64_t addr = previousMod + unzigzag(delta);
+		if (addr < 0 || addr > SIC_WORD_MASK) return "a modification record address is over 24 bits";
+		uint8_t halfBytes = data[(*pos)++];
+		char flag = (char)data[(*pos)++];
+		uint8_t symLen = data[(*pos)++];
+		if (symLen > SCOFF_MOD_SYMBOL_LEN) return "a modification record symbol is longer than 6 characters";
+		if (len - *pos < symLen) return "a modification record symbol is cut short";
+
+		sic_scoff_mod* mod = createModificationRecord();
+		if (!mod) return "out of memory";
+		sprintf(mod->startAddr, "%0*X", SCOFF_MOD_ADDR_LEN, (uint32_t)addr);
+		sprintf(mod->lenOfModificationHB, "%0*X", SCOFF_MOD_SIZE_LEN, halfBytes);
+		mod->modificationFlag = flag;
+		memcpy(mod->symbolName, data + *pos, symLen);
+		*pos += symLen;
+		if (addToList(records->modifications, mod) == NULL)
+		{
+			sicFree(ALLOC_MOD_RECORDS, mod);
+			return "out of memory";
+		}
+		previousMod = addr;
+	}
+
+	if (*pos != len) return "there is more after the last modification record";
+	return NULL;
+}
+
+sic_scoff_records* readSCOFFBin(const uint8_t* data, size_t len)
+{
+	size_t fixedLen = SCOFF_BIN_MAGIC_LEN + 1 + SCOFF_HEADER_FIELD_LEN;
+	if (!isSCOFFBin(data, len) || len < fixedLen)
+	{
+		fprintf(stderr, "[ERROR : 0]: The object is not a binary object, it does not start with \"%s\".\n", SCOFF_BIN_MAGIC);
+		return NULL;
+	}
+	if (data[SCOFF_BIN_MAGIC_LEN] != SCOFF_BIN_VERSION)
+	{
+		fprintf(stderr, "[ERROR : %d]: The binary object is version %u, only version %d can be read.\n", SCOFF_BIN_MAGIC_LEN,
+			data[SCOFF_BIN_MAGIC_LEN], SCOFF_BIN_VERSION);
+		return NULL;
+	}
+
+	sic_scoff_records* records = createRecords();
+	if (!records) return NULL;
+	memcpy(records->header.programName, data + SCOFF_BIN_MAGIC_LEN + 1, SCOFF_HEADER_FIELD_LEN);
+
+	size_t pos = fixedLen;
+	const char* problem = readSCOFFBinRecords(records, data, len, &pos);
+	if (problem)
+	{
+		fprintf(stderr, "[ERROR : %zu]: The binary object is not valid, %s.\n", pos, problem);
+		freeRecords(records);
+		return NULL;
+	}
+	return records;
+}
+
+uint8_t isSCOFFBin(const uint8_t* data, size_t len)
+{
+	return len >= SCOFF_BIN_MAGIC_LEN && memcmp(data, SCOFF_BIN_MAGIC, SCOFF_BIN_MAGIC_LEN) == 0;
+}
@@ -0,0 +1,132 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SCOFF_BIN_H // binary form of the SIC Common Object File Format
+#define SCOFF_BIN_H
+
+// Local includes //
+
+#include "scoff.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define SCOFF_BIN_MAGIC "SICB"
+#define SCOFF_BIN_MAGIC_LEN 4
+#define SCOFF_BIN_VERSION 1
+#define SCOFF_BIN_EXTENSION ".sbo"
+#define SCOFF_BIN_EXTENSION_LEN 4
+#define SCOFF_BIN_MAX_VARINT_LEN 10
+
+// Structs and enums //
+
+/**
+ * @brief scoff_format enum is the format the assembler writes its object in. The text format is the SCOFF records as described in
+ * scoff.h, the binary format holds the same records in the layout below, and the image is the loaded memory described in image.h.
+ *
+ * The binary object is, in order:
+ *   magic "SICB", a version byte, and the 6 bytes of the program name,
+ *   the start address, the program length, the first instruction, the number of text records and the number of modification records, as varints,
+ *   the index, which for each text record is its distance from the end of the one before (from the start address for the first) as a zigzag varint and its length in a byte,
+ *   the object code of all the text records as raw bytes,
+ *   and for each modification record its distance from the one before as a zigzag varint, the half bytes, the flag, and the length and characters of the symbol.
+ *
+ * A varint is 7 bits per byte starting from the lowest, with the high bit set on every byte but the last.
+ */
+typedef enum
+{
+	SCOFF_FORMAT_TEXT = 0,
+	SCOFF_FORMAT_BIN,
+	SCOFF_FORMAT_IMAGE
+
+} scoff_format;
+
+// Function declarations //
+
+/**
+ * @brief writeSCOFFBinToStream is a function that writes the records to the stream in the binary object format. The records have to be
+ * ones the assembler generated or readSCOFF() parsed, which keeps every field in upper case hex at its fixed width.
+ *
+ * @param  records - The records to write.
+ * @param  outFile - The stream to write to.
+ * @return records or NULL on error
+ */
+sic_scoff_records* writeSCOFFBinToStream(sic_scoff_records* records, FILE* outFile);
+
+/**
+ * @brief writeSCOFFBinToFile is a function that writes the records to the binary object file named after the source file, which is the
+ * file name with the .sbo extension in the current directory, the same way writeSCOFFToFile() names the text object.
+ *
+ * @param  records  - The records to write.
+ * @param  fileName - The name of the source file.
+ * @return records or NULL on error
+ */
+sic_scoff_records* writeSCOFFBinToFile(sic_scoff_records* records, char* fileName);
+
+/**
+ * @brief readSCOFFBin is a function that reads a binary object back into records. Writing the records as text gives back the same
+ * text object the binary one was made from. The function prints the byte offset of the first problem and returns NULL if the
+ * data is not a binary object.
+ *
+ * NOTE: that caller needs to free the records after use by using freeRecords().
+ *
+ * @param  data - The binary object.
+ * @param  len  - The length of the object.
+ * @return records or NULL on error
+ */
+sic_scoff_records* readSCOFFBin(const uint8_t* data, size_t len);
+
+/**
+ * @brief isSCOFFBin is a function that checks if the data starts with the magic of the binary object format.
+ *
+ * @param  data - The data.
+ * @param  len  - The length of the data.
+ * @return 1 if it does, 0 if not
+ */
+uint8_t isSCOFFBin(const uint8_t* data, size_t len);
+
+/**
+ * @brief putVarint is a function that writes the value to the stream as a varint.
+ *
+ * @param  value   - The value to write.
+ * @param  outFile - The stream.
+ * @return the number of bytes written
+ */
+uint32_t putVarint(uint64_t value, FILE* outFile);
+
+/**
+ * @brief getVarint is a function that reads a varint at the position and moves the position past it.
+ *
+ * @param  data  - The data.
+ * @param  len   - The length of the data.
+ * @param  pos   - The position, moved past the varint.
+ * @param  value - Set to the value read.
+ * @return 1 if a varint was read, 0 if it runs past the end or is too long
+ */
+uint8_t getVarint(const uint8_t* data, size_t len, size_t* pos, uint64_t* value);
+
+/**
+ * @brief zigzag is a function that maps a signed delta to an unsigned one, so that small deltas either way stay small varints.
+ *
+ * @param  delta - The signed delta.
+ * @return the zigzag encoded delta
+ */
+uint64_t zigzag(int64_t delta);
+
+/**
+ * @brief unzigzag is a function that reverses zigzag().
+ *
+ * @param  value - The zigzag encoded delta.
+ * @return the signed delta
+ */
+int64_t unzigzag(uint64_t value);
+
+#endif //SCOFF_BIN_H
@@ -0,0 +1,247 @@
+#include "scoff_reader.h"
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif //__SSE2__
+
+scoff_object* mapObjectFile(const char* path)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", path);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		fprintf(stderr, "[ERROR]: The object file \"%s\" is empty or can't be read.\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	scoff_object* object = (scoff_object*)sicMalloc(ALLOC_OTHER, sizeof(scoff_object));
+	if (!object)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the mapped object.\n");
+		close(fd);
+		return NULL;
+	}
+
+	// the object is read from front to back once
+	object->len = (size_t)st.st_size;
+	object->text = (const char*)mmap(NULL, object->len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (object->text == MAP_FAILED)
+	{
+		fprintf(stderr, "[ERROR]: Could not map the object file \"%s\".\n", path);
+		sicFree(ALLOC_OTHER, object);
+		return NULL;
+	}
+	madvise((void*)object->text, object->len, MADV_SEQUENTIAL);
+
+	return object;
+}
+
+void unmapObjectFile(scoff_object* object)
+{
+	if (!object) return;
+
+	munmap((void*)object->text, object->len);
+	sicFree(ALLOC_OTHER, object);
+}
+
+/**
+ * @brief hexNibble is a function that returns the value of an upper case hex character, or 0xFF if it is not one.
+ *
+ * @param  c - The character
+ * @return the value of the character or 0xFF
+*/
+static inline uint8_t hexNibble(char c)
+{
+	if (c >= '0' && c <= '9') return (uint8_t)(c - '0');
+	if (c >= 'A' && c <= 'F') return (uint8_t)(c - 'A' + 10);
+	return 0xFF;
+}
+
+uint8_t decodeHex(const char* hex, size_t numBytes, uint8_t* bytes)
+{
+	size_t i = 0;
+
+#ifdef __SSE2__
+	// each step checks and decodes 16 characters into 8 bytes: a character is a digit when c - '0' is at most 9 and a letter when
+	// c - 'A' is at most 5 as unsigned bytes, and the even (high) and odd (low) nibbles are joined within each 16 bit lane
+	const __m128i zero = _mm_set1_epi8('0');
+	const __m128i letterA = _mm_set1_epi8('A');
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i five = _mm_set1_epi8(5);
+	const __m128i ten = _mm_set1_epi8(10);
+	const __m128i lowByte = _mm_set1_epi16(0x00FF);
+	for (; i + SCOFF_READER_HEX_BLOCK / 2 <= numBytes; i += SCOFF_READER_HEX_BLOCK / 2)
+	{
+		__m128i chars = _mm_loadu_si128((const __m128i*)(hex + 2 * i));
+		__m128i digit = _mm_sub_epi8(chars, zero);
+		__m128i letter = _mm_sub_epi8(chars, letterA);
+		__m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+		__m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, five), letter);
+		if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) return 0;
+
+		__m128i nibbles = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, ten)));
+		__m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, lowByte), 4);
+		__m128i low = _mm_srli_epi16(nibbles, 8);
+		__m128i joined = _mm_packus_epi16(_mm_or_si128(high, low), _mm_setzero_si128());
+		_mm_storel_epi64((__m128i*)(bytes + i), joined);
+	}
+#endif //__SSE2__
+
+	for (; i < numBytes; i++)
+	{
+		uint8_t high = hexNibble(hex[2 * i]);
+		uint8_t low = hexNibble(hex[2 * i + 1]);
+		if ((high | low) & 0xF0) return 0;
+		bytes[i] = (uint8_t)((high << 4) | low);
+	}
+	return 1;
+}
+
+/**
+ * @brief decodeAddress is a function that decodes a field of 6 hex characters into an address.
+ *
+ * @param  hex  - The 6 hex characters
+ * @param  addr - Set to the address
+ * @return 1 if the field was hex, 0 if not
+*/
+static uint8_t decodeAddress(const char* hex, uint32_t* addr)
+{
+	uint8_t bytes[SIC_WORD_BYTES];
+	if (!decodeHex(hex, SIC_WORD_BYTES, bytes)) return 0;
+	*addr = ((uint32_t)bytes[0] << 16) | ((uint32_t)bytes[1] << 8) | bytes[2];
+	return 1;
+}
+
+/**
+ * @brief readImageLine is a function that loads one line of a SCOFF object into the image, creating the image at the header. The
+ * stage is the same as in readSCOFF(): 0 before the header, 1 in the text records, 2 in the modification records, and 3 after the end.
+ *
+ * @param  image - The image, set at the header
+ * @param  line  - The line without its newline
+ * @param  len   - The length of the line
+ * @param  stage - The stage of the object, updated for the record read
+ * @return NULL on success, or the problem with the line
+*/
+static const char* readImageLine(sic_image** image, const char* line, size_t len, uint8_t* stage)
+{
+	char kind = (len > 0) ? line[0] : '\0';
+	if (*stage == 3) return "there is more after the end record";
+	if (*stage == 0 && kind != 'H') return "the object does not start with a header record";
+
+	if (kind == 'H')
+	{
+		if (*stage != 0) return "there is a second header record";
+		if (len != 1 + 3 * SCOFF_HEADER_FIELD_LEN) return "the header record is not 19 characters long";
+
+		uint32_t start, length;
+		if (!decodeAddress(line + 1 + SCOFF_HEADER_FIELD_LEN, &start) || !decodeAddress(line + 1 + 2 * SCOFF_HEADER_FIELD_LEN, &length))
+			return "the header record has an address which is not hex";
+
+		*image = (sic_image*)sicMalloc(ALLOC_OTHER, sizeof(sic_image));
+		if (!*image) return "out of memory";
+		(*image)->startAddress = start;
+		(*image)->length = length;
+		(*image)->entryPoint = 0;
+		(*image)->bytes = (uint8_t*)sicCalloc(ALLOC_OTHER, length + 1, 1);
+		if (!(*image)->bytes) return "out of memory";
+		*stage = 1;
+		return NULL;
+	}
+
+	if (kind == 'T')
+	{
+		if (*stage != 1) return "a text record comes after a modification record";
+		size_t fieldsLen = 1 + SCOFF_TEXT_ADDR_LEN + SCOFF_TEXT_SIZE_LEN;
+		uint32_t addr;
+		uint8_t numBytes;
+		if (len < fieldsLen || !decodeAddress(line + 1, &addr) || !decodeHex(line + 1 + SCOFF_TEXT_ADDR_LEN, 1, &numBytes))
+			return "the text record is not made of hex digits";
+		if (numBytes * SIC_CHARACTERS_PER_BYTE > SCOFF_TEXT_OBJ_CODE_LEN) return "the text record holds more than 30 bytes";
+		if (len != fieldsLen + numBytes * SIC_CHARACTERS_PER_BYTE) return "the text record length does not match its object code";
+		if (addr < (*image)->startAddress || addr - (*image)->startAddress + numBytes > (*image)->length)
+			return "the text record is outside of the program";
+
+		// the object code is decoded straight into its place in memory
+		if (!decodeHex(line + fieldsLen, numBytes, (*image)->bytes + (addr - (*image)->startAddress)))
+			return "the text record is not made of hex digits";
+		return NULL;
+	}
+
+	if (kind == 'M')
+	{
+		// the image is at the start address the object code was assembled for, so the records are checked and not applied
+		size_t fieldsLen = 1 + SCOFF_MOD_ADDR_LEN + SCOFF_MOD_SIZE_LEN + 1;
+		uint8_t fields[SIC_WORD_BYTES + 1];
+		if (len < fieldsLen || len > fieldsLen + SCOFF_MOD_SYMBOL_LEN) return "the modification record is not 10 to 16 characters long";
+		if (!decodeHex(line + 1, SIC_WORD_BYTES + 1, fields)) return "the modification record has an address which is not hex";
+		*stage = 2;
+		return NULL;
+	}
+
+	if (kind == 'E')
+	{
+		if (len != 1 + SCOFF_END_FIRST_INSTRUCTION_LEN || !decodeAddress(line + 1, &(*image)->entryPoint))
+			return "the end record is not an E and 6 hex digits";
+		*stage = 3;
+		return NULL;
+	}
+
+	return "the record is not an H, T, M, or E record";
+}
+
+sic_image* readSCOFFToImage(const char* text, size_t len)
+{
+	sic_image* image = NULL;
+	uint8_t stage = 0;
+	uint32_t lineNum = 1;
+	size_t pos = 0;
+	const char* problem = NULL;
+	while (pos < len && !problem)
+	{
+		const char* newline = (const char*)memchr(text + pos, '\n', len - pos);
+		size_t lineLen = newline ? (size_t)(newline - (text + pos)) : len - pos;
+
+		problem = readImageLine(&image, text + pos, lineLen, &stage);
+		if (!problem)
+		{
+			pos += lineLen + 1;
+			lineNum++;
+		}
+	}
+
+	if (!problem && stage != 3) problem = "it has no end record";
+	if (problem)
+	{
+		fprintf(stderr, "[ERROR : %u]: The object is not valid SCOFF at byte %zu, %s.\n", lineNum, (pos < len) ? pos : len, problem);
+		freeImage(image);
+		return NULL;
+	}
+	return image;
+}
+
+sic_image* readObjectToImage(const scoff_object* object)
+{
+	const uint8_t* data = (const uint8_t*)object->text;
+	if (isImage(data, object->len))
+		return readImage(data, object->len);
+	if (!isSCOFFBin(data, object->len))
+		return readSCOFFToImage(object->text, object->len);
+
+	sic_scoff_records* records = readSCOFFBin(data, object->len);
+	if (!records) return NULL;
+	sic_image* image = createImageFromRecords(records);
+	freeRecords(records);
+	return image;
+}
@@ -0,0 +1,95 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SCOFF_READER_H
+#define SCOFF_READER_H
+
+// Local includes //
+
+#include "scoff.h"
+#include "image.h"
+#include "scoff_bin.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define SCOFF_READER_HEX_BLOCK 16 // hex characters decoded per SSE2 step
+
+// Structs and enums //
+
+/**
+ * @brief scoff_object is an object file mapped read only into memory, so it is read without being copied.
+ */
+typedef struct
+{
+	const char* text;
+	size_t len;
+
+} scoff_object;
+
+// Function declarations //
+
+/**
+ * @brief mapObjectFile is a function that maps the object file into memory. It prints an error and returns NULL if the file can't
+ * be opened or mapped, or is empty, since no object is empty.
+ *
+ * NOTE: that caller needs to unmap the object after use by using unmapObjectFile().
+ *
+ * @param  path - The path of the object file.
+ * @return object or NULL on error
+ */
+scoff_object* mapObjectFile(const char* path);
+
+/**
+ * @brief unmapObjectFile is a function that unmaps the object and frees the struct. The function returns nothing.
+ *
+ * @param  object - The object to unmap, may be NULL.
+ * @return void
+ */
+void unmapObjectFile(scoff_object* object);
+
+/**
+ * @brief decodeHex is a function that decodes the upper case hex characters into bytes, two characters a byte, checking every character
+ * as it goes. With SSE2 it decodes 16 characters at a time, and the rest one byte at a time.
+ *
+ * @param  hex      - The hex characters, 2 * numBytes of them.
+ * @param  numBytes - The number of bytes to decode.
+ * @param  bytes    - Where the bytes are written.
+ * @return 1 if every character was upper case hex, 0 if not, in which case the bytes are not all set
+ */
+uint8_t decodeHex(const char* hex, size_t numBytes, uint8_t* bytes);
+
+/**
+ * @brief readSCOFFToImage is a function that loads a SCOFF text object straight into a memory image, without building the records.
+ * It checks the object as strictly as readSCOFF() does and gives the same image as createImageFromRecords() on the records readSCOFF()
+ * would return. It prints the line and byte offset of the first problem and returns NULL if the text is not such an object.
+ *
+ * NOTE: that caller needs to free the image after use by using freeImage().
+ *
+ * @param  text - The object text.
+ * @param  len  - The length of the text.
+ * @return image or NULL on error
+ */
+sic_image* readSCOFFToImage(const char* text, size_t len);
+
+/**
+ * @brief readObjectToImage is a function that loads an object of any of the formats the assembler writes into a memory image, telling
+ * them apart by their magic: an image is copied, a binary object is read and its T records loaded, and anything else is read as a
+ * text object with readSCOFFToImage().
+ *
+ * NOTE: that caller needs to free the image after use by using freeImage().
+ *
+ * @param  object - The mapped object.
+ * @return image or NULL on error
+ */
+sic_image* readObjectToImage(const scoff_object* object);
+
+#endif //SCOFF_READER_H
@@ -0,0 +1,945 @@
+#include "session.h"
+
+// Define constants //
+#define SESSION_RESIZE_CONSTANT 2
+#define SESSION_INITIAL_SYMBOLS 64
+
+sic_session* createSession(const hash_table* directiveTable, const hash_table* opTab)
+{
+	sic_session* session = (sic_session*)sicMalloc(ALLOC_SESSION, sizeof(sic_session));
+	if (!session)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the assembly session.\n");
+		return NULL;
+	}
+	memset(session, 0, sizeof(sic_session));
+	session->directiveTable = directiveTable;
+	session->opTab = opTab;
+	session->startLine = SESSION_UNDEFINED_LINE;
+
+	// allocate the line, size, and symbol containers
+	session->lineCapacity = SESSION_INITIAL_LINES;
+	session->lines = (sic_line*)sicMalloc(ALLOC_SESSION, session->lineCapacity * sizeof(sic_line));
+	session->symbolCapacity = SESSION_INITIAL_SYMBOLS;
+	session->symbols = (sic_session_symbol*)sicMalloc(ALLOC_SYMBOLS, session->symbolCapacity * sizeof(sic_session_symbol));
+	session->sizes = createFenwickTree(session->lineCapacity);
+	session->symbolIds = createHashTable(0, ALLOC_SYMBOLS);
+	if (!session->lines || !session->symbols || !session->sizes || !session->symbolIds)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the assembly session.\n");
+		freeSession(session);
+		return NULL;
+	}
+
+	return session;
+}
+
+void freeSession(sic_session* session)
+{
+	if (!session) return;
+
+	// free the BYTE constants held by the lines
+	if (session->lines)
+	{
+		for (uint32_t i = 0; i < session->numLines; i++)
+			sicFree(ALLOC_SESSION, session->lines[i].data);
+		sicFree(ALLOC_SESSION, session->lines);
+	}
+
+	// free the interned symbol names
+	if (session->symbols)
+	{
+		for (uint32_t i = 0; i < session->numSymbols; i++)
+			sicFree(ALLOC_SYMBOLS, session->symbols[i].name);
+		sicFree(ALLOC_SYMBOLS, session->symbols);
+	}
+
+	freeFenwickTree(session->sizes);
+	freeHashTableAndValues(session->symbolIds);
+	sicFree(ALLOC_SESSION, session);
+}
+
+/**
+ * @brief internSymbol is a function that returns the id of the given symbol, adding it to the session if it was never seen.
+ * A newly interned symbol is not defined by any line. The function returns SESSION_NO_SYMBOL if an allocation failed.
+ *
+ * @param  session - The session which holds the symbols
+ * @param  name    - The symbol name
+ * @return symbol id or SESSION_NO_SYMBOL on error
+*/
+static uint32_t internSymbol(sic_session* session, const char* name)
+{
+	uint32_t* idPtr = (uint32_t*)getKVPair(session->symbolIds, name);
+	if (idPtr) return *idPtr;
+
+	// grow the symbol array if needed
+	if (session->numSymbols == session->symbolCapacity)
+	{
+		uint32_t newCapacity = session->symbolCapacity * SESSION_RESIZE_CONSTANT;
+		sic_session_symbol* newSymbols = (sic_session_symbol*)sicRealloc(ALLOC_SYMBOLS, session->symbols, newCapacity * sizeof(sic_session_symbol));
+		if (!newSymbols) return SESSION_NO_SYMBOL;
+		session->symbols = newSymbols;
+		session->symbolCapacity = newCapacity;
+	}
+
+	// copy the name and map it to the new id
+	size_t len = strlen(name) + 1;
+	char* nameCopy = (char*)sicMalloc(ALLOC_SYMBOLS, len);
+	idPtr = (uint32_t*)sicMalloc(ALLOC_SYMBOLS, sizeof(uint32_t));
+	if (!nameCopy || !idPtr)
+	{
+		sicFree(ALLOC_SYMBOLS, nameCopy);
+		sicFree(ALLOC_SYMBOLS, idPtr);
+		return SESSION_NO_SYMBOL;
+	}
+	memcpy(nameCopy, name, len);
+	*idPtr = session->numSymbols;
+
+	if (insertKVPair(session->symbolIds, name, idPtr) != HT_OKAY)
+	{
+		sicFree(ALLOC_SYMBOLS, nameCopy);
+		sicFree(ALLOC_SYMBOLS, idPtr);
+		return SESSION_NO_SYMBOL;
+	}
+
+	session->symbols[*idPtr].name = nameCopy;
+	session->symbols[*idPtr].defLine = SESSION_UNDEFINED_LINE;
+	session->numSymbols++;
+	return *idPtr;
+}
+
+/**
+ * @brief lineSize is a function that returns the number of bytes the given line takes up in memory.
+ *
+ * @param  line - The lexed line
+ * @return size of the line in bytes
+*/
+static uint32_t lineSize(const sic_line* line)
+{
+	switch (line->kind)
+	{
+	case LINE_INSTRUCTION:
+	case LINE_WORD:
+		return SIC_WORD_BYTES;
+	case LINE_BYTE:
+		return line->dataLen;
+	case LINE_RESB:
+		return (uint32_t)line->value * SIC_BYTE;
+	case LINE_RESW:
+		return (uint32_t)line->value * SIC_WORD_BYTES;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief lexDirective is a function that lexes the rest of a line after a directive was found. It follows the same tokenizing rules as
+ * pass one, and calls the directive callback against a scratch symbol table so the operand is validated in exactly the same way.
+ * The size the callback moved the location counter by becomes the size of the line.
+ *
+ * @param  session     - The session which holds the tables and symbols
+ * @param  callback    - The directive callback found in the directive table
+ * @param  token       - Pointer to the strtok'd directive
+ * @param  lineNum     - Line number used for error messages
+ * @param  symbolSeen  - Flag which tells the function if a label came before the directive
+ * @param  out         - The line being filled out
+ * @return session status
+*/
+static session_status lexDirective(sic_session* session, directive_cb_struct* callback, char* token, uint32_t lineNum,
+	uint8_t symbolSeen, sic_line* out)
+{
+	const char* directive = token;
+	char operandCopy[SIC_LEN_BUFFER + 1];
+
+	// same lookahead rules as firstPassDirectiveHelper
+	if (symbolSeen)
+	{
+		if (strcmp("BYTE", directive) == 0)
+			token = sicTokenize(NULL, "\r\n");
+		else
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+	}
+	else
+	{
+		// keep a copy of the BYTE operand so the lookahead doesn't destroy C'HELLO WORLD'
+		uint8_t copied = 0;
+		if (strcmp("BYTE", directive) == 0)
+		{
+			char* rest = sicTokenize(NULL, "");
+			if (rest)
+			{
+				strncpy(operandCopy, rest, SIC_LEN_BUFFER);
+				operandCopy[SIC_LEN_BUFFER] = '\0';
+				copied = 1;
+			}
+			token = rest ? sicTokenize(rest, SIC_TOKEN_DELIMITERS) : NULL;
+		}
+		else
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+
+		if (token)
+		{
+			if (getKVPair(session->directiveTable, token) != NULL || getKVPair(session->opTab, token) != NULL)
+			{
+				printDCSError(DCS_SYM_MATCHES_DIRECTIVE, directive, lineNum);
+				return SESSION_LEX_ERROR;
+			}
+			if (copied) token = operandCopy;
+		}
+	}
+
+	// END is resolved during record generation since it references the symbol table
+	if (strcmp("END", directive) == 0)
+	{
+		out->kind = LINE_END;
+		if (!token) return SESSION_OKAY;
+
+		out->operand = internSymbol(session, token);
+		if (out->operand == SESSION_NO_SYMBOL) return SESSION_MALLOC_FAILED;
+
+		// Check to see if there was more operands
+		token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+		if (token && !checkComment(token))
+		{
+			printDCSError(DCS_TOO_MANY_OPERANDS, token, lineNum);
+			return SESSION_LEX_ERROR;
+		}
+		return SESSION_OKAY;
+	}
+
+	// the scratch table makes the callbacks validate the operand and report the size through the location counter
+	symbol_table scratch;
+	memset(&scratch, 0, sizeof(symbol_table));
+	scratch.startAddress = 0;
+	scratch.endAddress = SIC_NOT_SET_SENTINEL;
+
+	uint8_t isStart = (strcmp("START", directive) == 0);
+	if (isStart) scratch.startAddress = SIC_NOT_SET_SENTINEL;
+
+	directive_callback_status status = callback->funcPointer(&scratch, token);
+	if (status != DCS_OKAY)
+	{
+		printDCSError(status, token, lineNum);
+		return SESSION_LEX_ERROR;
+	}
+
+	if (isStart)
+	{
+		out->kind = LINE_START;
+		out->value = (int32_t)scratch.startAddress;
+	}
+	else if (strcmp("WORD", directive) == 0)
+	{
+		out->kind = LINE_WORD;
+		out->value = (int32_t)strtol(token, NULL, 10);
+	}
+	else if (strcmp("RESB", directive) == 0)
+	{
+		out->kind = LINE_RESB;
+		out->value = (int32_t)(scratch.locCounter / SIC_BYTE);
+	}
+	else if (strcmp("RESW", directive) == 0)
+	{
+		out->kind = LINE_RESW;
+		out->value = (int32_t)(scratch.locCounter / SIC_WORD_BYTES);
+	}
+	else if (strcmp("BYTE", directive) == 0)
+	{
+		// the callback terminated the constant at the closing quote, so it starts two characters in
+		uint8_t parseHex = (token[0] == 'X');
+		const char* constant = token + 2;
+
+		out->kind = LINE_BYTE;
+		out->dataLen = scratch.locCounter;
+		out->data = (uint8_t*)sicMalloc(ALLOC_SESSION, out->dataLen ? out->dataLen : 1);
+		if (!out->data)
+		{
+			fprintf(stderr, "[ERROR : %d]: Malloc failed during the copy of BYTE directive operand.\n", lineNum);
+			return SESSION_MALLOC_FAILED;
+		}
+
+		for (uint32_t i = 0; i < out->dataLen; i++)
+		{
+			if (parseHex)
+			{
+				char hex[SIC_CHARACTERS_PER_BYTE + 1] = { constant[i * 2], constant[i * 2 + 1], '\0' };
+				out->data[i] = (uint8_t)strtol(hex, NULL, 16);
+			}
+			else
+				out->data[i] = (uint8_t)constant[i];
+		}
+	}
+
+	return SESSION_OKAY;
+}
+
+/**
+ * @brief lexInstruction is a function that lexes the rest of a line after an instruction was found. It does the same operand checks as
+ * firstPassInstructionHelper, then keeps the opcode, the interned operand symbol, and the indexed flag for pass two.
+ *
+ * @param  session     - The session which holds the tables and symbols
+ * @param  opcode      - The opcode found in the optab
+ * @param  token       - Pointer to the strtok'd mnemonic
+ * @param  lineNum     - Line number used for error messages
+ * @param  symbolSeen  - Flag which tells the function if a label came before the instruction
+ * @param  out         - The line being filled out
+ * @return session status
+*/
+static session_status lexInstruction(sic_session* session, const sic_optable_values* opcode, char* token, uint32_t lineNum,
+	uint8_t symbolSeen, sic_line* out)
+{
+	// see if expensive edition or floating point supported
+	if (!SIC_EXPENSIVE_EDITION_SUPPORT && (((opcode->flags & OP_FLAG_XE_ONLY) != 0) || ((opcode->flags & OP_FLAG_FLOAT_POINT) != 0)))
+	{
+		printOPSError(OPS_X_EDITION_NOT_SUPPORTED, token, NULL, lineNum);
+		return SESSION_LEX_ERROR;
+	}
+
+	char* originalToken = token;
+	token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+	char* operand = token;
+	uint8_t needOperandCount = 1;
+
+	if (!symbolSeen)
+	{
+		// look ahead to see if the next token is an instruction
+		if (token)
+		{
+			if (getKVPair(session->directiveTable, token) != NULL || getKVPair(session->opTab, token) != NULL)
+			{
+				printOPSError(OPS_SYM_MATCHES_INSTRUCTION, originalToken, NULL, lineNum);
+				return SESSION_LEX_ERROR;
+			}
+		}
+		else
+		{
+			if (opcode->numOperands != 0)
+			{
+				printOPSError(OPS_NO_OPERANDS_GIVEN, originalToken, opcode, lineNum);
+				return SESSION_LEX_ERROR;
+			}
+			needOperandCount = 0;
+		}
+	}
+
+	if (needOperandCount)
+	{
+		// check number of operands
+		uint32_t numOperandsFound = 0;
+		while (token != NULL)
+		{
+			numOperandsFound++;
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+			if (token == NULL) break;
+			if (checkComment(token)) break;
+		}
+
+		if (numOperandsFound != opcode->numOperands)
+		{
+			printOPSError(OPS_WRONG_NUM_OF_OPERANDS, originalToken, opcode, lineNum);
+			return SESSION_LEX_ERROR;
+		}
+	}
+
+	out->kind = LINE_INSTRUCTION;
+	out->opcode = opcode->opcode;
+
+	// intern the operand symbol, it is resolved during record generation
+	if (opcode->numOperands != 0)
+	{
+		char* indexedSubStr = strstr(operand, SCOFF_INDEXED_SUBSTR);
+		if (indexedSubStr)
+		{
+			out->indexed = 1;
+			*indexedSubStr = '\0';
+		}
+
+		out->operand = internSymbol(session, operand);
+		if (out->operand == SESSION_NO_SYMBOL) return SESSION_MALLOC_FAILED;
+	}
+
+	return SESSION_OKAY;
+}
+
+/**
+ * @brief lexLine is a function that turns one source line into its sic_line IR. It follows the same flow as buildSymbolTable, but
+ * the checks which need the whole program (START/END ordering, symbol resolution, memory limit) are left for record generation.
+ * The label is returned through the label pointer so the caller can define it for the right line.
+ *
+ * @param  session - The session which holds the tables and symbols
+ * @param  buffer  - The source line, it will be tokenized in place
+ * @param  lineNum - Line number used for error messages
+ * @param  out     - The line being filled out
+ * @param  label   - Set to the label of the line or NULL
+ * @return session status
+*/
+static session_status lexLine(sic_session* session, char* buffer, uint32_t lineNum, sic_line* out, char** label)
+{
+	void* voidPtrVal;
+	memset(out, 0, sizeof(sic_line));
+	out->label = SESSION_NO_SYMBOL;
+	out->operand = SESSION_NO_SYMBOL;
+	out->dirty = 1;
+	*label = NULL;
+
+	// check to see if its an empty line or comment
+	char* token = sicTokenize(buffer, SIC_TOKEN_DELIMITERS);
+	if (!token)
+	{
+		fprintf(stderr, "[ERROR : %d]: The current line is an empty line. This is not allowed by SIC.\n", lineNum);
+		return SESSION_LEX_ERROR;
+	}
+	if (checkComment(token))
+	{
+		out->kind = LINE_COMMENT;
+		return SESSION_OKAY;
+	}
+
+	// directive or instruction without a label
+	if ((voidPtrVal = getKVPair(session->directiveTable, token)) != NULL)
+		return lexDirective(session, (directive_cb_struct*)voidPtrVal, token, lineNum, 0, out);
+	if ((voidPtrVal = getKVPair(session->opTab, token)) != NULL)
+		return lexInstruction(session, (sic_optable_values*)voidPtrVal, token, lineNum, 0, out);
+
+	// its a symbol, check to see if it is valid
+	sic_symbol_status status = sanitizedSymbol(token);
+	if (status != SYM_OKAY)
+	{
+		printSymbolError(status, token, lineNum);
+		return SESSION_LEX_ERROR;
+	}
+	*label = token;
+	token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
+
+	if (token && (voidPtrVal = getKVPair(session->directiveTable, token)) != NULL)
+		return lexDirective(session, (directive_cb_struct*)voidPtrVal, token, lineNum, 1, out);
+	if (token && (voidPtrVal = getKVPair(session->opTab, token)) != NULL)
+		return lexInstruction(session, (sic_optable_values*)voidPtrVal, token, lineNum, 1, out);
+
+	fprintf(stderr, "[ERROR : %d]: Invalid mnemonic or directive found!. This is what was parsed \"%s\".\n", lineNum, token ? token : "");
+	return SESSION_LEX_ERROR;
+}
+
+/**
+ * @brief defineLabel is a function that makes the given line the definition of the label. It will print an error if a different
+ * line already defines the symbol.
+ *
+ * @param  session   - The session which holds the symbols
+ * @param  label     - The label name
+ * @param  lineIndex - The index of the line defining it
+ * @param  symbolId  - Set to the id of the label
+ * @return session status
+*/
+static session_status defineLabel(sic_session* session, const char* label, uint32_t lineIndex, uint32_t* symbolId)
+{
+	uint32_t id = internSymbol(session, label);
+	if (id == SESSION_NO_SYMBOL) return SESSION_MALLOC_FAILED;
+
+	if (session->symbols[id].defLine != SESSION_UNDEFINED_LINE && session->symbols[id].defLine != lineIndex)
+	{
+		fprintf(stderr, "[ERROR : %d]: Illegal duplicate symbol detected!. The symbol \"%s\" already exists in the symbol table.\n",
+			session->firstLineNum + lineIndex + 1, label);
+		return SESSION_DUPLICATE_SYMBOL;
+	}
+
+	*symbolId = id;
+	return SESSION_OKAY;
+}
+
+/**
+ * @brief pushLine is a function that appends an already lexed line to the session and records its size. On error the line
+ * still owns its data.
+ *
+ * @param  session - The session the line is appended to
+ * @param  line    - The lexed line, its label is already defined
+ * @return session status
+*/
+static session_status pushLine(sic_session* session, const sic_line* line)
+{
+	uint32_t lineIndex = session->numLines;
+	uint32_t lineNum = session->firstLineNum + lineIndex + 1;
+
+	// grow the line array if needed
+	if (session->numLines == session->lineCapacity)
+	{
+		uint32_t newCapacity = session->lineCapacity * SESSION_RESIZE_CONSTANT;
+		sic_line* newLines = (sic_line*)sicRealloc(ALLOC_SESSION, session->lines, newCapacity * sizeof(sic_line));
+		if (!newLines)
+		{
+			fprintf(stderr, "[ERROR : %d]: unable to grow the session line array.\n", lineNum);
+			return SESSION_MALLOC_FAILED;
+		}
+		session->lines = newLines;
+		session->lineCapacity = newCapacity;
+	}
+
+	if (fenwickPush(session->sizes, lineSize(line)) == NULL)
+	{
+		fprintf(stderr, "[ERROR : %d]: unable to grow the session line sizes.\n", lineNum);
+		return SESSION_MALLOC_FAILED;
+	}
+
+	if (line->label != SESSION_NO_SYMBOL)
+		session->symbols[line->label].defLine = lineIndex;
+	if (line->kind == LINE_START && session->startLine == SESSION_UNDEFINED_LINE)
+		session->startLine = lineIndex;
+	session->lines[lineIndex] = *line;
+	session->numLines++;
+
+	return SESSION_OKAY;
+}
+
+session_status sessionAppendLine(sic_session* session, char* line)
+{
+	uint32_t lineIndex = session->numLines;
+	sic_line newLine;
+	char* label;
+
+	session_status status = lexLine(session, line, session->firstLineNum + lineIndex + 1, &newLine, &label);
+	if (status == SESSION_OKAY && label)
+		status = defineLabel(session, label, lineIndex, &newLine.label);
+	if (status == SESSION_OKAY)
+		status = pushLine(session, &newLine);
+
+	if (status != SESSION_OKAY)
+		sicFree(ALLOC_SESSION, newLine.data);
+	return status;
+}
+
+/**
+ * @brief nextTextLine is a function that returns the length of the line starting at the given text, split the same way
+ * fgets(buffer, SIC_LEN_BUFFER, file) splits a file: up to and including the newline, or SIC_LEN_BUFFER - 1 bytes.
+ *
+ * @param  text - The start of the line
+ * @param  len  - The number of bytes left in the text
+ * @return length of the line in bytes
+*/
+static size_t nextTextLine(const char* text, size_t len)
+{
+	size_t maxLen = (len < SIC_LEN_BUFFER - 1) ? len : SIC_LEN_BUFFER - 1;
+	const char* newline = (const char*)memchr(text, '\n', maxLen);
+	return newline ? (size_t)(newline - text) + 1 : maxLen;
+}
+
+session_status sessionAppendText(sic_session* session, const char* text, size_t len)
+{
+	char buffer[SIC_LEN_BUFFER + 1];
+
+	while (len > 0)
+	{
+		size_t lineLen = nextTextLine(text, len);
+		memcpy(buffer, text, lineLen);
+		buffer[lineLen] = '\0';
+		text += lineLen;
+		len -= lineLen;
+
+		session_status status = sessionAppendLine(session, buffer);
+		if (status != SESSION_OKAY) return status;
+	}
+
+	return SESSION_OKAY;
+}
+
+uint32_t sessionTextLineCount(const char* text, size_t len)
+{
+	uint32_t numLines = 0;
+	while (len > 0)
+	{
+		size_t lineLen = nextTextLine(text, len);
+		text += lineLen;
+		len -= lineLen;
+		numLines++;
+	}
+	return numLines;
+}
+
+session_status sessionAppendSession(sic_session* session, sic_session* chunk)
+{
+	// map every symbol id of the chunk to the id of the same name in the session
+	uint32_t* idMap = (uint32_t*)sicMalloc(ALLOC_SESSION, (chunk->numSymbols + 1) * sizeof(uint32_t));
+	if (!idMap)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the symbol map of a session chunk.\n");
+		return SESSION_MALLOC_FAILED;
+	}
+
+	session_status status = SESSION_OKAY;
+	for (uint32_t i = 0; i < chunk->numSymbols && status == SESSION_OKAY; i++)
+	{
+		idMap[i] = internSymbol(session, chunk->symbols[i].name);
+		if (idMap[i] == SESSION_NO_SYMBOL) status = SESSION_MALLOC_FAILED;
+	}
+
+	for (uint32_t i = 0; i < chunk->numLines && status == SESSION_OKAY; i++)
+	{
+		sic_line line = chunk->lines[i];
+		uint32_t lineIndex = session->numLines;
+
+		if (line.label != SESSION_NO_SYMBOL)
+		{
+			line.label = idMap[line.label];
+			if (session->symbols[line.label].defLine != SESSION_UNDEFINED_LINE)
+			{
+				fprintf(stderr, "[ERROR : %d]: Illegal duplicate symbol detected!. The symbol \"%s\" already exists in the symbol table.\n",
+					session->firstLineNum + lineIndex + 1, session->symbols[line.label].name);
+				status = SESSION_DUPLICATE_SYMBOL;
+				break;
+			}
+		}
+		if (line.operand != SESSION_NO_SYMBOL)
+			line.operand = idMap[line.operand];
+
+		// the session owns the BYTE constant once the line is moved
+		status = pushLine(session, &line);
+		if (status == SESSION_OKAY)
+			chunk->lines[i].data = NULL;
+	}
+
+	sicFree(ALLOC_SESSION, idMap);
+	return status;
+}
+
+sic_session* loadSession(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab)
+{
+	char buffer[SIC_LEN_BUFFER + 1] = { 0 };
+
+	sic_session* session = createSession(directiveTable, opTab);
+	if (!session) return NULL;
+
+	// read the open ASM one line at a time
+	while (fgets(buffer, SIC_LEN_BUFFER, openSIC) != NULL)
+	{
+		if (sessionAppendLine(session, buffer) != SESSION_OKAY)
+		{
+			freeSession(session);
+			return NULL;
+		}
+	}
+
+	return session;
+}
+
+session_status sessionEditLine(sic_session* session, uint32_t lineIndex, char* line)
+{
+	if (lineIndex >= session->numLines)
+	{
+		fprintf(stderr, "[ERROR]: Line %u is not in the session, it only has %u lines.\n", lineIndex + 1, session->numLines);
+		return SESSION_BAD_LINE_INDEX;
+	}
+
+	sic_line newLine;
+	char* label;
+	session_status status = lexLine(session, line, session->firstLineNum + lineIndex + 1, &newLine, &label);
+	if (status != SESSION_OKAY)
+	{
+		sicFree(ALLOC_SESSION, newLine.data);
+		return status;
+	}
+
+	if (label && (status = defineLabel(session, label, lineIndex, &newLine.label)) != SESSION_OKAY)
+	{
+		sicFree(ALLOC_SESSION, newLine.data);
+		return status;
+	}
+
+	// the old label is no longer defined unless the new line defines it again
+	sic_line* oldLine = &session->lines[lineIndex];
+	if (oldLine->label != SESSION_NO_SYMBOL)
+		session->symbols[oldLine->label].defLine = SESSION_UNDEFINED_LINE;
+	if (newLine.label != SESSION_NO_SYMBOL)
+		session->symbols[newLine.label].defLine = lineIndex;
+
+	sicFree(ALLOC_SESSION, oldLine->data);
+	*oldLine = newLine;
+	fenwickSet(session->sizes, lineIndex, lineSize(&newLine));
+
+	// keep the first START line, only an edit which takes the START away from it has to look for the next one
+	if (newLine.kind == LINE_START && (session->startLine == SESSION_UNDEFINED_LINE || lineIndex < session->startLine))
+		session->startLine = lineIndex;
+	else if (newLine.kind != LINE_START && lineIndex == session->startLine)
+	{
+		session->startLine = SESSION_UNDEFINED_LINE;
+		for (uint32_t i = lineIndex + 1; i < session->numLines && session->startLine == SESSION_UNDEFINED_LINE; i++)
+		{
+			if (session->lines[i].kind == LINE_START)
+				session->startLine = i;
+		}
+	}
+
+	return SESSION_OKAY;
+}
+
+/**
+ * @brief startAddress is a function that returns the address of the first START line of the session, so the lines always hold the
+ * start address and an edit which is undone or rejected cannot leave a stale one behind. A session with no START starts at 0, the same
+ * as pass one.
+ *
+ * @param  session - The session
+ * @return start address
+*/
+static uint32_t startAddress(const sic_session* session)
+{
+	if (session->startLine == SESSION_UNDEFINED_LINE) return 0;
+	return (uint32_t)session->lines[session->startLine].value;
+}
+
+uint32_t sessionLineAddress(const sic_session* session, uint32_t lineIndex)
+{
+	return startAddress(session) + fenwickPrefixSum(session->sizes, lineIndex);
+}
+
+uint32_t sessionSymbolAddress(const sic_session* session, const char* symbol)
+{
+	uint32_t* idPtr = (uint32_t*)getKVPair(session->symbolIds, symbol);
+	if (!idPtr || session->symbols[*idPtr].defLine == SESSION_UNDEFINED_LINE)
+		return SIC_NOT_SET_SENTINEL;
+
+	return sessionLineAddress(session, session->symbols[*idPtr].defLine);
+}
+
+/**
+ * @brief addTextRecord is a function that creates a text record for the given address and object code and adds it to the records.
+ *
+ * @param  records    - The records the text record is added to
+ * @param  address    - Start address of the object code
+ * @param  numBytes   - Number of bytes in the object code
+ * @param  objectCode - The object code in hex
+ * @return records on success, NULL on error
+*/
+static sic_scoff_records* addTextRecord(sic_scoff_records* records, uint32_t address, uint32_t numBytes, const char* objectCode)
+{
+	sic_scoff_text* t = createTextRecord();
+	if (!t) return NULL;
+
+	sprintf(t->startAddr, "%0*X", SCOFF_TEXT_ADDR_LEN, address);
+	sprintf(t->lengthOfObj, "%0*X", SCOFF_TEXT_SIZE_LEN, numBytes);
+	strcpy(t->objectCode, objectCode);
+
+	if (addToList(records->texts, t) == NULL)
+	{
+		sicFree(ALLOC_TEXT_RECORDS, t);
+		return NULL;
+	}
+	return records;
+}
+
+/**
+ * @brief encodeLine is a function that produces the text and modification records of one line. Instructions are only re-encoded
+ * when the line changed or the address their operand resolves to moved, otherwise the cached object code is reused.
+ *
+ * @param  session  - The session which holds the line
+ * @param  line     - The line being encoded
+ * @param  address  - The address of the line
+ * @param  records  - The records being generated
+ * @return records on success, NULL on error
+*/
+static sic_scoff_records* encodeLine(sic_session* session, sic_line* line, uint32_t address, sic_scoff_records* records)
+{
+	char objectCode[SCOFF_TEXT_OBJ_CODE_LEN + 1];
+
+	if (line->kind == LINE_INSTRUCTION)
+	{
+		// sessionBeginRecords already checked that the operand is defined
+		uint32_t target = 0;
+		if (line->operand != SESSION_NO_SYMBOL)
+		{
+			target = sessionLineAddress(session, session->symbols[line->operand].defLine);
+			if (line->indexed)
+				target |= SCOFF_INDEXED_BIT;
+		}
+
+		if (line->dirty || line->encodedTarget != target)
+		{
+			if (line->operand == SESSION_NO_SYMBOL)
+				sprintf(line->objectCode, "%0*X%0*d", SIC_CHARACTERS_PER_BYTE, line->opcode, SCOFF_INSTRUCTION_PAD, 0);
+			else
+				sprintf(line->objectCode, "%0*X%0*X", SIC_OPCODE_LEN, line->opcode, SCOFF_INSTRUCTION_PAD, target);
+			line->encodedTarget = target;
+			line->dirty = 0;
+			__atomic_fetch_add(&session->numReencoded, 1, __ATOMIC_RELAXED);
+		}
+
+		if (addTextRecord(records, address, SIC_WORD_BYTES, line->objectCode) == NULL)
+			return NULL;
+
+		// instructions with an operand are address dependent so they need a modification record
+		if (line->operand != SESSION_NO_SYMBOL)
+		{
+			sic_scoff_mod* mod = createModificationRecord();
+			if (!mod) return NULL;
+			sprintf(mod->startAddr, "%0*X", SCOFF_MOD_ADDR_LEN, address + SIC_BYTE); // skip opcode byte
+			sprintf(mod->lenOfModificationHB, "%0*X", SCOFF_MOD_SIZE_LEN, SCOFF_MOD_HB);
+			mod->modificationFlag = '+';
+			sprintf(mod->symbolName, "%s", records->header.programName);
+			if (addToList(records->modifications, mod) == NULL)
+			{
+				sicFree(ALLOC_MOD_RECORDS, mod);
+				return NULL;
+			}
+		}
+		return records;
+	}
+
+	if (line->kind == LINE_WORD)
+	{
+		// a negative word is stored in two's complement, which is 24 bits on the SIC
+		sprintf(objectCode, "%0*X", SCOFF_TEXT_OBJ_CODE_LEN / 10, (uint32_t)line->value & SIC_WORD_MASK);
+		return addTextRecord(records, address, SIC_WORD_BYTES, objectCode);
+	}
+
+	if (line->kind == LINE_BYTE)
+	{
+		// split big constants over as many text records as needed
+		uint32_t maxBytes = SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE;
+		for (uint32_t offset = 0; offset < line->dataLen; offset += maxBytes)
+		{
+			uint32_t numBytes = (line->dataLen - offset > maxBytes) ? maxBytes : line->dataLen - offset;
+			for (uint32_t i = 0; i < numBytes; i++)
+				sprintf(objectCode + (i * SIC_CHARACTERS_PER_BYTE), "%0*X", SIC_CHARACTERS_PER_BYTE, line->data[offset + i]);
+
+			if (addTextRecord(records, address + offset, numBytes, objectCode) == NULL)
+				return NULL;
+		}
+	}
+
+	return records;
+}
+
+sic_scoff_records* sessionBeginRecords(sic_session* session)
+{
+	uint8_t startSeen = 0;
+	uint8_t endSeen = 0;
+	uint32_t firstInstruction = SIC_NOT_SET_SENTINEL;
+	uint32_t endAddress = SIC_NOT_SET_SENTINEL;
+	uint32_t programStart = startAddress(session);
+	uint32_t locCounter = programStart;
+	uint32_t programSize = fenwickPrefixSum(session->sizes, session->numLines);
+
+	sic_scoff_records* records = createRecords();
+	if (!records) return NULL;
+
+	for (uint32_t i = 0; i < session->numLines; i++)
+	{
+		sic_line* line = &session->lines[i];
+		uint32_t lineNum = session->firstLineNum + i + 1;
+		directive_callback_status error = DCS_OKAY;
+
+		if (line->kind == LINE_COMMENT) continue;
+
+		// check the rules which need the whole program
+		if (line->kind == LINE_START)
+		{
+			if (startSeen) error = DCS_START_DEFINED_TWICE;
+		}
+		else if (!startSeen)
+			error = DCS_START_NOT_DEFINED;
+		else if (line->kind == LINE_END && endSeen)
+			error = DCS_END_DEFINED_TWICE;
+		else if (line->kind == LINE_INSTRUCTION && endSeen)
+			error = DCS_END_SEEN;
+		else if (locCounter + lineSize(line) > SIC_MEMORY_LIMIT)
+			error = DCS_MEMORY_OVERFLOW;
+
+		if (error != DCS_OKAY)
+		{
+			printDCSError(error, NULL, lineNum);
+			freeRecords(records);
+			return NULL;
+		}
+
+		switch (line->kind)
+		{
+		case LINE_START:
+		{
+			// header record
+			sic_scoff_header* h = &records->header;
+			const char* name = (line->label != SESSION_NO_SYMBOL) ? session->symbols[line->label].name : "";
+			sprintf(h->programName, "%-*s", SCOFF_HEADER_FIELD_LEN, name);
+			sprintf(h->startAddr, "%0*X", SCOFF_HEADER_FIELD_LEN, programStart);
+			sprintf(h->lengthOfProgram, "%0*X", SCOFF_HEADER_FIELD_LEN, programSize);
+			startSeen = 1;
+			break;
+		}
+		case LINE_END:
+			endSeen = 1;
+			if (line->operand != SESSION_NO_SYMBOL)
+			{
+				const sic_session_symbol* symbol = &session->symbols[line->operand];
+				if (symbol->defLine == SESSION_UNDEFINED_LINE)
+				{
+					printDCSError(DSC_END_SYMBOL_NULL, symbol->name, lineNum);
+					freeRecords(records);
+					return NULL;
+				}
+				endAddress = sessionLineAddress(session, symbol->defLine);
+			}
+			else if (firstInstruction == SIC_NOT_SET_SENTINEL)
+			{
+				fprintf(stderr, "[ERRRO : %d]: Cant make END record. First instruction not found.\n", lineNum);
+				freeRecords(records);
+				return NULL;
+			}
+			else
+				endAddress = firstInstruction;
+			break;
+		case LINE_INSTRUCTION:
+			if (firstInstruction == SIC_NOT_SET_SENTINEL)
+				firstInstruction = locCounter;
+
+			// the operand has to be defined by some line for the instruction to be encoded
+			if (line->operand != SESSION_NO_SYMBOL && session->symbols[line->operand].defLine == SESSION_UNDEFINED_LINE)
+			{
+				printOPSError(OPS_INVALID_SYM_GIVEN, session->symbols[line->operand].name, NULL, lineNum);
+				freeRecords(records);
+				return NULL;
+			}
+			break;
+		default:
+			break;
+		}
+
+		locCounter += lineSize(line);
+	}
+
+	// check to see if END was ever seen
+	if (!endSeen)
+	{
+		printDCSError(startSeen ? DCS_END_NOT_DEFINED : DCS_START_NOT_DEFINED, NULL, session->firstLineNum + session->numLines + 1);
+		freeRecords(records);
+		return NULL;
+	}
+
+	sprintf(records->end.firstInstruction, "%0*X", SCOFF_END_FIRST_INSTRUCTION_LEN, endAddress);
+	return records;
+}
+
+sic_scoff_records* sessionEncodeLines(sic_session* session, sic_scoff_records* records, uint32_t firstLine, uint32_t endLine)
+{
+	uint32_t locCounter = sessionLineAddress(session, firstLine);
+
+	for (uint32_t i = firstLine; i < endLine; i++)
+	{
+		sic_line* line = &session->lines[i];
+		if (line->kind == LINE_INSTRUCTION || line->kind == LINE_WORD || line->kind == LINE_BYTE)
+		{
+			if (encodeLine(session, line, locCounter, records) == NULL)
+				return NULL;
+		}
+		locCounter += lineSize(line);
+	}
+
+	return records;
+}
+
+sic_scoff_records* sessionGenerateRecords(sic_session* session)
+{
+	sic_scoff_records* records = sessionBeginRecords(session);
+	if (!records) return NULL;
+
+	if (sessionEncodeLines(session, records, 0, session->numLines) == NULL)
+	{
+		freeRecords(records);
+		return NULL;
+	}
+	return records;
+}
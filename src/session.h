@@ -0,0 +1,266 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SESSION_H
+#define SESSION_H
+
+// Local includes //
+
+#include "hash_table.h"
+#include "fenwick_tree.h"
+#include "directive.h"
+#include "opcode.h"
+#include "scoff.h"
+#include "sic.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define SESSION_NO_SYMBOL 0xFFFFFFFF
+#define SESSION_UNDEFINED_LINE 0xFFFFFFFF
+#define SESSION_INITIAL_LINES 256
+
+// Structs and enums //
+
+/**
+ * @brief session_status enum is used by the session functions to tell the caller what went wrong during
+ * the lexing of a line or the edit of the session. The errors have already been printed to stderr when returned.
+ */
+typedef enum {
+
+	SESSION_OKAY = 0,
+	SESSION_LEX_ERROR = (1 << 0),
+	SESSION_DUPLICATE_SYMBOL = (1 << 1),
+	SESSION_BAD_LINE_INDEX = (1 << 2),
+	SESSION_MALLOC_FAILED = (1 << 3)
+
+} session_status;
+
+/**
+ * @brief sic_line_kind enum holds what a lexed line turned out to be. Each kind knows how big it is,
+ * and what pass two needs to encode it.
+ */
+typedef enum {
+
+	LINE_COMMENT = 0,
+	LINE_START,
+	LINE_END,
+	LINE_INSTRUCTION,
+	LINE_WORD,
+	LINE_BYTE,
+	LINE_RESB,
+	LINE_RESW
+
+} sic_line_kind;
+
+/**
+ * @brief sic_line is the compact IR of one source line. It holds only what pass two needs to encode the line so the raw
+ * text does not have to be kept around. Symbols are interned into the session so label and operand are symbol ids.
+ * The objectCode, encodedAddr, and encodedTarget fields cache the last encoding of an instruction so it is only
+ * re-encoded when the address it resolves to changes.
+ */
+typedef struct {
+
+	uint8_t kind;
+	uint8_t opcode;
+	uint8_t indexed;
+	uint8_t dirty;
+	uint32_t label;
+	uint32_t operand;
+	int32_t value;
+	uint32_t dataLen;
+	uint8_t* data;
+	uint32_t encodedTarget;
+	char objectCode[SIC_WORD_BYTES * SIC_CHARACTERS_PER_BYTE + 1];
+
+} sic_line;
+
+/**
+ * @brief sic_session_symbol is an interned symbol of a session. It holds the name, and the index of the line which
+ * defines it or SESSION_UNDEFINED_LINE if the symbol was only referenced so far.
+ */
+typedef struct {
+
+	char* name;
+	uint32_t defLine;
+
+} sic_session_symbol;
+
+/**
+ * @brief sic_session is a long lived assembly of a single source. It keeps the lexed lines, a fenwick tree of the line sizes, and the
+ * interned symbols so that an edit of one line only re-lexes that line and updates the addresses in O(log n).
+ * The opcode and directive tables are borrowed, the session does not free them. firstLineNum is the number of source lines before
+ * the first line of the session, it is only set when the session lexes a chunk of a bigger source so errors report the real line.
+ * startLine is the index of the first START line, or SESSION_UNDEFINED_LINE if there is none, so the start address is found without a
+ * scan of the lines.
+ */
+typedef struct {
+
+	const hash_table* directiveTable;
+	const hash_table* opTab;
+
+	sic_line* lines;
+	uint32_t numLines;
+	uint32_t lineCapacity;
+	uint32_t startLine;
+	fenwick_tree* sizes;
+
+	hash_table* symbolIds;
+	sic_session_symbol* symbols;
+	uint32_t numSymbols;
+	uint32_t symbolCapacity;
+
+	uint32_t numReencoded;
+	uint32_t firstLineNum;
+
+} sic_session;
+
+// Function declarations //
+
+/**
+ * @brief createSession is a function that allocates an empty session. It accepts the directive table and opcode table which the
+ * session will borrow for its whole life. The function returns the new session, or NULL if an error occurred.
+ *
+ * NOTE: that caller needs to free the memory after use by using freeSession().
+ *
+ * @param  directiveTable - A generated directive table which holds SIC directives and their callbacks.
+ * @param  opTab          - A generated opcode table which holds SIC instructions and their values.
+ * @return session or NULL on error
+ */
+sic_session* createSession(const hash_table* directiveTable, const hash_table* opTab);
+
+/**
+ * @brief freeSession is a function that frees the given session and everything it owns. The function returns nothing.
+ *
+ * @param  session - The session to be freed.
+ * @return void
+ */
+void freeSession(sic_session* session);
+
+/**
+ * @brief sessionAppendLine is a function that lexes the given line and appends it to the end of the session.
+ * The line is tokenized in place so it will be destroyed. The function returns a session_status, errors have already been printed.
+ *
+ * @param  session - The session the line is appended to.
+ * @param  line    - The null-terminated source line.
+ * @return session status
+ */
+session_status sessionAppendLine(sic_session* session, char* line);
+
+/**
+ * @brief loadSession is a function that creates a session and appends every line of the given open SIC file to it.
+ * The function only reads the file once. It returns the loaded session or NULL if a line could not be lexed.
+ *
+ * @param  openSIC        - The opened FILE* to the SIC assembly file.
+ * @param  directiveTable - A generated directive table which holds SIC directives and their callbacks.
+ * @param  opTab          - A generated opcode table which holds SIC instructions and their values.
+ * @return session or NULL on error
+ */
+sic_session* loadSession(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab);
+
+/**
+ * @brief sessionAppendText is a function that appends every line of the given text to the session. The text is split into lines exactly
+ * like loadSession splits a file, so lexing a source in memory gives the same lines as reading it from disk. The text is not modified.
+ *
+ * @param  session - The session the lines are appended to.
+ * @param  text    - The source text, it does not need to be null-terminated.
+ * @param  len     - The number of bytes in the text.
+ * @return session status
+ */
+session_status sessionAppendText(sic_session* session, const char* text, size_t len);
+
+/**
+ * @brief sessionTextLineCount is a function that counts the lines sessionAppendText would split the given text into.
+ *
+ * @param  text - The source text.
+ * @param  len  - The number of bytes in the text.
+ * @return number of lines
+ */
+uint32_t sessionTextLineCount(const char* text, size_t len);
+
+/**
+ * @brief sessionAppendSession is a function that moves every line of a session which lexed a later chunk of the same source to the end
+ * of this session. The symbols of the chunk are interned into this session and the lines are remapped to them, labels defined by both
+ * are reported as duplicates. The chunk is left without lines and can only be freed afterwards.
+ *
+ * @param  session - The session the lines are appended to.
+ * @param  chunk   - The session holding the lines of the next chunk.
+ * @return session status
+ */
+session_status sessionAppendSession(sic_session* session, sic_session* chunk);
+
+/**
+ * @brief sessionEditLine is a function that replaces one line of the session. Only the new line is lexed and the sizes after it are
+ * updated in O(log n). The given text is tokenized in place. If the new line can't be lexed the old line is kept.
+ *
+ * @param  session   - The session being edited.
+ * @param  lineIndex - The 0-based index of the line being replaced.
+ * @param  line      - The new null-terminated source line.
+ * @return session status
+ */
+session_status sessionEditLine(sic_session* session, uint32_t lineIndex, char* line);
+
+/**
+ * @brief sessionLineAddress is a function that returns the address of the given line in O(log n).
+ *
+ * @param  session   - The session being queried.
+ * @param  lineIndex - The 0-based index of the line.
+ * @return address of the line
+ */
+uint32_t sessionLineAddress(const sic_session* session, uint32_t lineIndex);
+
+/**
+ * @brief sessionSymbolAddress is a function that looks up the address of a defined symbol in O(log n).
+ * It returns SIC_NOT_SET_SENTINEL if the symbol does not exist or is not defined by any line.
+ *
+ * @param  session - The session being queried.
+ * @param  symbol  - The symbol name.
+ * @return address of the symbol or SIC_NOT_SET_SENTINEL
+ */
+uint32_t sessionSymbolAddress(const sic_session* session, const char* symbol);
+
+/**
+ * @brief sessionBeginRecords is a function that runs the checks of pass two which need the whole program, in line order, and fills out the
+ * header and end records. The returned records have no text or modification records yet, those are added by sessionEncodeLines.
+ * The function returns the records or NULL on error.
+ *
+ * NOTE: that caller needs to free the records after use by using freeRecords().
+ *
+ * @param  session - The session to generate the records from.
+ * @return sic_scoff_records* or NULL on error
+ */
+sic_scoff_records* sessionBeginRecords(sic_session* session);
+
+/**
+ * @brief sessionEncodeLines is a function that adds the text and modification records of the lines in [firstLine, endLine) to the records.
+ * The session must have passed sessionBeginRecords. Disjoint ranges can be encoded on different threads as long as each has its own records,
+ * which are then appended in line order. The function returns the records or NULL if an allocation failed.
+ *
+ * @param  session   - The session holding the lines.
+ * @param  records   - The records being generated, the header must already be filled out.
+ * @param  firstLine - The 0-based index of the first line to encode.
+ * @param  endLine   - The index one past the last line to encode.
+ * @return records on success, NULL on error
+ */
+sic_scoff_records* sessionEncodeLines(sic_session* session, sic_scoff_records* records, uint32_t firstLine, uint32_t endLine);
+
+/**
+ * @brief sessionGenerateRecords is a function that does pass two from the lexed lines of the session. It checks the ordering rules that
+ * can only be known with the whole program, and re-encodes only the instructions whose resolved address changed since the last call.
+ * The function returns the same records generateSCOFFRecords would, or NULL on error.
+ *
+ * NOTE: that caller needs to free the records after use by using freeRecords().
+ *
+ * @param  session - The session to generate the records from.
+ * @return sic_scoff_records* or NULL on error
+ */
+sic_scoff_records* sessionGenerateRecords(sic_session* session);
+
+#endif //SESSION_H
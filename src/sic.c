@@ -6,6 +6,14 @@
 
 // Function implementations //
 
+char* sicTokenize(char* str, const char* delim)
+{
+	static _Thread_local char* savePtr = NULL;
+	char* token = strtok_r(str, delim, &savePtr);
+	if (token) STATS_ADD(tokens, 1);
+	return token;
+}
+
 uint8_t checkComment(const char* token)
 {
 	if (token[0] == '#')
@@ -32,14 +40,6 @@ void printSymbolError(const sic_symbol_status error, const char* const errorToke
 	}
 }
 
-/**
- * @brief sanitizeSymbol is a function that accepts a const char* to a symbol which will then be checked to see if it follows SIC assembly language
- * specifications. The function will check to see if the symbol starts with the characters [A-Z], no longer than six characters, and does not contain the following:
- * spaces, $, !, =, +, - , (, ), or \@.
- * 
- * @param  symbol - symbol that will be checked to see if it is in proper format.
- * @return symbol status
-*/
 sic_symbol_status sanitizedSymbol(const char* symbol)
 {
 	size_t len = strlen(symbol);
@@ -81,9 +81,9 @@ symbol_table* firstPassDirectiveHelper(symbol_table* symTab, const hash_table* d
 	if (symbolSeen)
 	{
 		if (strcmp("BYTE", token) == 0)
-			token = strtok(NULL, "\r\n");
+			token = sicTokenize(NULL, "\r\n");
 		else
-			token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 	}
 	else
 	{
@@ -91,11 +91,11 @@ symbol_table* firstPassDirectiveHelper(symbol_table* symTab, const hash_table* d
 		// example would be "BYTE C'HELLO WORLD'" would fail because the string would get destroy at C'HELLO
 		if (strcmp("BYTE", token) == 0)
 		{
-			char* tmp = strtok(NULL, ""); // get the rest of string, if it exists
+			char* tmp = sicTokenize(NULL, ""); // get the rest of string, if it exists
 			size_t len = strlen(tmp);
 			if (len > 0)
 			{
-				tempToken = malloc(len + 1);
+				tempToken = sicMalloc(ALLOC_OTHER, len + 1);
 				if (!tempToken) {
 					fprintf(stderr, "[ERROR : %d]: Malloc failed during the copy of BYTE directive operand.", lineNum);
 					freeSymbolTable(symTab);
@@ -103,10 +103,10 @@ symbol_table* firstPassDirectiveHelper(symbol_table* symTab, const hash_table* d
 				}
 				strcpy(tempToken, tmp);
 			}
-			token = strtok(tmp, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(tmp, SIC_TOKEN_DELIMITERS);
 		}
 		else
-			token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 
 		// look ahead to see if the next token is a directive
 		// if operand doesn't exist, we don't throw error in case it is legal like for END directive
@@ -115,7 +115,7 @@ symbol_table* firstPassDirectiveHelper(symbol_table* symTab, const hash_table* d
 			if (getKVPair(directiveTable, token) != NULL || getKVPair(opTab, token) != NULL)
 			{
 				printDCSError(DCS_SYM_MATCHES_DIRECTIVE, originalToken, lineNum);
-				free(tempToken);
+				sicFree(ALLOC_OTHER, tempToken);
 				return NULL;
 			}
 
@@ -130,12 +130,12 @@ symbol_table* firstPassDirectiveHelper(symbol_table* symTab, const hash_table* d
 	if (callbackStatus != DCS_OKAY)
 	{
 		printDCSError(callbackStatus, token, lineNum);
-		if (tempToken) free(tempToken);
+		if (tempToken) sicFree(ALLOC_OTHER, tempToken);
 		return NULL;
 	}
 
 	// clean our tmp token if it was malloced
-	if (tempToken) free(tempToken);
+	if (tempToken) sicFree(ALLOC_OTHER, tempToken);
 
 	// check to see if we have seen START
 	// if not, we need to set symbolAddr again or else it will be invalid
@@ -190,7 +190,7 @@ symbol_table* firstPassInstructionHelper(symbol_table* symTab, const hash_table*
 	}
 
 	char* originalToken = token;
-	token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+	token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 	uint8_t needOperandCount = 1;
 
 	if (!symbolSeen)
@@ -223,7 +223,7 @@ symbol_table* firstPassInstructionHelper(symbol_table* symTab, const hash_table*
 		while (token != NULL)
 		{
 			numOperandsFound++;
-			token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 			if (token == NULL) break;
 			if (checkComment(token)) break;
 		}
@@ -248,10 +248,30 @@ symbol_table* firstPassInstructionHelper(symbol_table* symTab, const hash_table*
 	return symTab;
 }
 
-symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab)
+/**
+ * @brief recordLine is a function that adds the bytes the line just took up to the line table, if there is a table and the line took any.
+ * Lines before START only move the location counter to the start address, so they are never recorded.
+ *
+ * @param  symTab      - The symbol table, with the location counter past the line
+ * @param  lineTable   - The line table, or NULL
+ * @param  lineAddress - The location counter before the line
+ * @param  started     - 1 if START was seen before the line
+ * @param  lineNum     - The line number
+ * @return symTab or NULL on error
+*/
+static symbol_table* recordLine(symbol_table* symTab, sic_line_table* lineTable, uint32_t lineAddress, uint8_t started, uint32_t lineNum)
+{
+	if (!lineTable || !started || symTab->locCounter <= lineAddress) return symTab;
+	if (lineTableAdd(lineTable, lineAddress, symTab->locCounter - lineAddress, lineNum) == NULL) return NULL;
+	return symTab;
+}
+
+symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab, sic_line_table* lineTable)
 {
 	// local variable initialization
 	uint8_t startSeen = 0;
+	uint8_t started = 0;
+	uint32_t lineAddress = 0;
 	uint32_t lineNum = 1;
 	char* token;
 	void* voidPtrVal;
@@ -262,7 +282,7 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 	char* symbol;
 
 	// allocate symbol_table
-	symbol_table* symTab = (symbol_table*)malloc(sizeof(symbol_table));
+	symbol_table* symTab = (symbol_table*)sicMalloc(ALLOC_SYMBOLS, sizeof(symbol_table));
 	if (!symTab)
 	{
 		fprintf(stderr, "[ERROR]: could not malloc memory for the symbol table.\n");
@@ -271,10 +291,10 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 	memset(symTab, 0, sizeof(symbol_table));
 	symTab->startAddress = SIC_NOT_SET_SENTINEL;
 	symTab->endAddress = SIC_NOT_SET_SENTINEL;
-	symTab->ht = createHashTable(0);
+	symTab->ht = createHashTable(0, ALLOC_SYMBOLS);
 	if (!symTab->ht) 
 	{
-		free(symTab);
+		sicFree(ALLOC_SYMBOLS, symTab);
 		return NULL;
 	}
 
@@ -285,9 +305,11 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 	// read the open ASM one line at a time
 	while (fgets(buffer, SIC_LEN_BUFFER, openSIC) != NULL)
 	{
+		STATS_ADD(lines, 1);
+
 		// check to see if its an empty line or comment
 		token = buffer;
-		token = strtok(token, SIC_TOKEN_DELIMITERS);
+		token = sicTokenize(token, SIC_TOKEN_DELIMITERS);
 		if (!token) 
 		{ 
 			fprintf(stderr, "[ERROR : %d]: The current line is an empty line. This is not allowed by SIC.\n", lineNum);
@@ -302,6 +324,8 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 
 		// Set location counter
 		tempSymbolAddress = symTab->locCounter;
+		lineAddress = symTab->locCounter;
+		started = startSeen;
 
 		// Check to see if symbol exists or is directive or instruction
 		// is it a directive / Symbol name matches assembler directive
@@ -309,7 +333,7 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 		{
 			directive_cb_struct* cb = (directive_cb_struct*)voidPtrVal;
 			if (firstPassDirectiveHelper(symTab, directiveTable, opTab, cb, token, lineNum, &tempSymbolAddress,
-				&startSeen, 0) == NULL)
+				&startSeen, 0) == NULL || recordLine(symTab, lineTable, lineAddress, started, lineNum) == NULL)
 			{
 				freeSymbolTable(symTab);
 				return NULL;
@@ -321,7 +345,8 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 		else if ((voidPtrVal = getKVPair(opTab, token)) != NULL) // it is a possible instruction
 		{
 			sic_optable_values* opcode = (sic_optable_values*)voidPtrVal;
-			if (firstPassInstructionHelper(symTab, directiveTable, opTab, opcode, token, lineNum, 0) == NULL)
+			if (firstPassInstructionHelper(symTab, directiveTable, opTab, opcode, token, lineNum, 0) == NULL ||
+				recordLine(symTab, lineTable, lineAddress, started, lineNum) == NULL)
 			{
 				freeSymbolTable(symTab);
 				return NULL;
@@ -341,7 +366,7 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 				return NULL;
 			}
 			symbol = token;
-			token = strtok(NULL, SIC_TOKEN_DELIMITERS);
+			token = sicTokenize(NULL, SIC_TOKEN_DELIMITERS);
 
 			// directive/opcode
 			if ((voidPtrVal = getKVPair(directiveTable, token)) != NULL)
@@ -377,29 +402,34 @@ symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable,
 			return NULL;
 		}
 
-		// malloc symbolAddress and insert the values before inserting into symbol table.
-		uint32_t* symbolAddress = (uint32_t*)malloc(sizeof(uint32_t));
-		if (!symbolAddress)
+		if (recordLine(symTab, lineTable, lineAddress, started, lineNum) == NULL)
 		{
-			fprintf(stderr, "[ERROR : %d]: unable to malloc symbol address during pass one.\n", lineNum);
 			freeSymbolTable(symTab);
 			return NULL;
 		}
-		memset(symbolAddress, 0, sizeof(uint32_t));
 
-		*symbolAddress = tempSymbolAddress;
+		// malloc the symbol and insert the values before inserting into symbol table.
+		sic_symbol* symbolValue = (sic_symbol*)sicMalloc(ALLOC_SYMBOLS, sizeof(sic_symbol));
+		if (!symbolValue)
+		{
+			fprintf(stderr, "[ERROR : %d]: unable to malloc symbol address during pass one.\n", lineNum);
+			freeSymbolTable(symTab);
+			return NULL;
+		}
+		symbolValue->address = tempSymbolAddress;
+		symbolValue->line = lineNum;
 
 		// if insertion failed, free symbol table and print error
-		if (insertKVPair(symTab->ht, symbol, symbolAddress) != HT_OKAY)
+		if (insertKVPair(symTab->ht, symbol, symbolValue) != HT_OKAY)
 		{
 			fprintf(stderr, "[ERROR : %d]: failed to insert KV pair into the symbol table.\n", lineNum);
-			free(symbolAddress);
+			sicFree(ALLOC_SYMBOLS, symbolValue);
 			freeSymbolTable(symTab);
 			return NULL;
 		}
 
 #ifdef _DEBUG
-		printf("%s\t%04X\n", symbol, *symbolAddress);
+		printf("%s\t%04X\n", symbol, symbolValue->address);
 #endif //_DEBUG
 
 		lineNum++;
@@ -423,5 +453,5 @@ void freeSymbolTable(symbol_table* symbolTable)
 {
 	// free the hash_table then symbol_table
 	freeHashTableAndValues(symbolTable->ht);
-	free(symbolTable);
+	sicFree(ALLOC_SYMBOLS, symbolTable);
 }
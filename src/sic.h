@@ -9,6 +9,7 @@
 
 #include "hash_table.h"
 #include "opcode.h"
+#include "lines.h"
 
 // Standard library includes //
 
@@ -21,6 +22,7 @@
 
 #define SIC_MEMORY_LIMIT 0x7FFF
 #define SIC_INTEGER_MAX  0x7FFFFF
+#define SIC_WORD_MASK    0xFFFFFF
 #define SIC_NOT_SET_SENTINEL 0xFFFFFFFF
 #define SIC_SEEN_SENTINEL 0xFFFFFFFE
 #define SIC_WORD_BYTES 3
@@ -54,9 +56,20 @@ typedef enum {
 
 } sic_symbol_status;
 
+/**
+ * @brief sic_symbol is the value a symbol maps to in the symbol table, the address it stands for and the source line which defined it.
+ */
+typedef struct {
+
+	uint32_t address;
+	uint32_t line;
+
+} sic_symbol;
+
 /**
  * @brief symbol_table struct is the struct that will hold the symbol table which will be generated during pass one. The struct will contain
- * the table itself as a hash_table* ht and will also contain the start address, end address, and location counter as uin32_t.
+ * the table itself as a hash_table* ht, whose values are sic_symbol, and will also contain the start address, end address, and location
+ * counter as uin32_t.
  */
 typedef struct {
 
@@ -69,6 +82,17 @@ typedef struct {
 
 // Function declarations //
 
+/**
+ * @brief sicTokenize is a drop in replacement for strtok which keeps its position in thread local storage. The assembler
+ * tokenizes lines across many helper functions by passing NULL to continue, so this lets several files be assembled on different threads
+ * at the same time without the threads clobbering each other's position.
+ *
+ * @param  str   - The string to tokenize, or NULL to continue the last string tokenized on this thread.
+ * @param  delim - The delimiter characters.
+ * @return the next token or NULL if there are no more tokens
+ */
+char* sicTokenize(char* str, const char* delim);
+
 /**
  * @brief checkComment is a function which will see if the given token is a comment or not. If the given token is a comment it will return 1 (TRUE) else
  * it will return 0 (FALSE). The function will accept a const char* to the token which will be checked. The function will not check to see if the const char* is valid.
@@ -88,6 +112,16 @@ uint8_t checkComment(const char* token);
  */
 void printSymbolError(const sic_symbol_status error, const char* errorToken, const uint32_t lineNum);
 
+/**
+ * @brief sanitizedSymbol is a function that accepts a const char* to a symbol which will then be checked to see if it follows SIC assembly language
+ * specifications. The function will check to see if the symbol starts with the characters [A-Z], no longer than six characters, and does not contain the following:
+ * spaces, $, !, =, +, - , (, ), or \@.
+ * 
+ * @param  symbol - symbol that will be checked to see if it is in proper format.
+ * @return symbol status
+*/
+sic_symbol_status sanitizedSymbol(const char* symbol);
+
 /**
  * @brief  * buildSymbolTable is a function that will parse an open SIC assembly file and generate a symbol table for it.
  * The function accepts an open FILE* to the SIC assembly file. The function returns the generated 
@@ -102,9 +136,10 @@ void printSymbolError(const sic_symbol_status error, const char* errorToken, con
  * @param  openSIC			- The opened FILE* to the SIC assembly file which is to be parsed. 
  * @param  directiveTable	- A generated directive table which holds SIC directives and their callbacks. 
  * @param  opTab				- A generated opcode table which holds SIC instructions and their values. 
+ * @param  lineTable			- A line table which gets the address range of every line that takes up memory, or NULL.
  * @return symbol table				 
  */
-symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab);
+symbol_table* buildSymbolTable(FILE* openSIC, const hash_table* directiveTable, const hash_table* opTab, sic_line_table* lineTable);
 
 /**
  * freeSymbolTable is a function that accept a symbol_table pointer and free the allocated memory. The function
@@ -0,0 +1,461 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: End to end benchmark of the assembler over generated SIC programs.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+// Define constants //
+#define LINES_FLAG "--lines"
+#define REPS_FLAG "--reps"
+#define DIR_FLAG "--dir"
+#define OUT_FLAG "--out"
+#define ASM_FLAG "--asm"
+#define SYMBOLS_FLAG "--symbols"
+#define DATA_FLAG "--data"
+#define MIX_FLAG "--mix"
+#define COMMENTS_FLAG "--comments"
+#define FORWARD_FLAG "--forward"
+#define SEED_FLAG "--seed"
+#define DEFAULT_LINES { 1000, 10000, 100000, 1000000 }
+#define NUM_DEFAULT_LINES 4
+#define DEFAULT_REPS 3
+#define DEFAULT_DIR "bench_out"
+#define DEFAULT_ASM "./SIC_asm"
+#define RESULTS_FILE_NAME "results.json"
+#define BENCH_PATH_LEN 1024
+#define NUM_PHASES 4
+#define PHASE_NAMES { "load_tables", "build_symbol_table", "generate_scoff_records", "write_scoff_to_file" }
+
+// local includes //
+#include "assembler.h"
+#include "generator.h"
+
+// Structs //
+
+/**
+ * @brief bench_result struct holds what was measured for one generated program. Times are in milliseconds, the phase times
+ * and the wall time are the best of the repetitions, and the peak RSS is the largest any repetition reached.
+ */
+typedef struct {
+
+	sic_gen_summary gen;
+	uint64_t sourceBytes;
+	uint64_t objectBytes;
+	double wallMin;
+	double wallMedian;
+	long peakRssKiB;
+	double phaseMin[NUM_PHASES];
+	long phasePeakRssKiB;
+
+} bench_result;
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief nowMs is a function that returns the monotonic clock in milliseconds.
+ *
+ * @param  void
+ * @return milliseconds
+*/
+double nowMs(void);
+
+/**
+ * @brief compareDoubles is the qsort comparator used to take the median of the repetitions.
+ *
+ * @param  a - first double
+ * @param  b - second double
+ * @return <0, 0 or >0
+*/
+int compareDoubles(const void* a, const void* b);
+
+/**
+ * @brief runPhases is a function that runs pass one, pass two and the writing of the object file over the source in this process,
+ * timing each of them the same way assembleFile runs them. It is called in a child so each repetition starts from a clean heap.
+ *
+ * @param  sourcePath - The SIC source.
+ * @param  phaseMs    - Set to the time of each phase.
+ * @return 0 on success, 1 on error
+*/
+int runPhases(const char* sourcePath, double* phaseMs);
+
+/**
+ * @brief measurePhases is a function that runs runPhases in a forked child and reads the times back through a pipe. The peak RSS
+ * of the child is taken from wait4.
+ *
+ * @param  sourcePath - The SIC source.
+ * @param  phaseMs    - Set to the time of each phase.
+ * @param  peakRssKiB - Set to the peak RSS of the child.
+ * @return 0 on success, 1 on error
+*/
+int measurePhases(const char* sourcePath, double* phaseMs, long* peakRssKiB);
+
+/**
+ * @brief measureAssembler is a function that runs the assembler binary over the source with its output thrown away, and measures its wall
+ * time from fork to exit and its peak RSS.
+ *
+ * @param  asmPath    - The assembler binary.
+ * @param  sourcePath - The SIC source.
+ * @param  wallMs     - Set to the wall time.
+ * @param  peakRssKiB - Set to the peak RSS of the assembler.
+ * @return 0 on success, 1 if the assembler failed
+*/
+int measureAssembler(const char* asmPath, const char* sourcePath, double* wallMs, long* peakRssKiB);
+
+/**
+ * @brief writeResults is a function that writes the results as JSON to the given path.
+ *
+ * @param  path       - The results file.
+ * @param  params     - The generator params shared by every program.
+ * @param  reps       - The number of repetitions.
+ * @param  results    - The results.
+ * @param  numResults - The number of results.
+ * @return 0 on success, 1 on error
+*/
+int writeResults(const char* path, const sic_gen_params* params, uint32_t reps, const bench_result* results, uint32_t numResults);
+
+/**
+ * @brief the main function is the entry point of the benchmark. For every line count it generates a program, measures the phases
+ * in process and the assembler binary end to end, prints a line per program and writes everything to the results file.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return return code
+*/
+int main(int argc, char** argv)
+{
+	sic_gen_params params;
+	initGenParams(&params);
+	uint32_t reps = DEFAULT_REPS;
+	const char* dir = DEFAULT_DIR;
+	const char* outPath = NULL;
+	const char* asmPath = DEFAULT_ASM;
+
+	uint64_t* lineCounts = (uint64_t*)malloc((argc + NUM_DEFAULT_LINES) * sizeof(uint64_t));
+	if (!lineCounts) return 1;
+	uint32_t numLineCounts = 0;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (i + 1 >= argc)
+			badArgs = 1;
+		else if (strcmp(argv[i], LINES_FLAG) == 0)
+			lineCounts[numLineCounts++] = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], REPS_FLAG) == 0)
+			reps = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], DIR_FLAG) == 0)
+			dir = argv[++i];
+		else if (strcmp(argv[i], OUT_FLAG) == 0)
+			outPath = argv[++i];
+		else if (strcmp(argv[i], ASM_FLAG) == 0)
+			asmPath = argv[++i];
+		else if (strcmp(argv[i], SYMBOLS_FLAG) == 0)
+			params.symbolDensity = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], DATA_FLAG) == 0)
+			params.dataRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], MIX_FLAG) == 0)
+			badArgs = sscanf(argv[++i], "%u:%u:%u", &params.byteWeight, &params.wordWeight, &params.resbWeight) != 3;
+		else if (strcmp(argv[i], COMMENTS_FLAG) == 0)
+			params.commentRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], FORWARD_FLAG) == 0)
+			params.forwardRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], SEED_FLAG) == 0)
+			params.seed = strtoull(argv[++i], NULL, 10);
+		else
+			badArgs = 1;
+	}
+
+	if (badArgs || reps == 0)
+	{
+		printUsage(argv[0]);
+		free(lineCounts);
+		return 1;
+	}
+
+	if (numLineCounts == 0)
+	{
+		const uint64_t defaults[NUM_DEFAULT_LINES] = DEFAULT_LINES;
+		memcpy(lineCounts, defaults, sizeof(defaults));
+		numLineCounts = NUM_DEFAULT_LINES;
+	}
+
+	if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+	{
+		fprintf(stderr, "[ERROR]: Could not create the benchmark directory \"%s\".\n", dir);
+		free(lineCounts);
+		return 1;
+	}
+
+	char resultsPath[BENCH_PATH_LEN];
+	if (!outPath)
+	{
+		snprintf(resultsPath, sizeof(resultsPath), "%s/%s", dir, RESULTS_FILE_NAME);
+		outPath = resultsPath;
+	}
+
+	bench_result* results = (bench_result*)calloc(numLineCounts, sizeof(bench_result));
+	double* walls = (double*)malloc(reps * sizeof(double));
+	if (!results || !walls)
+	{
+		free(results);
+		free(walls);
+		free(lineCounts);
+		return 1;
+	}
+
+	int returnCode = 0;
+	printf("%10s %10s %10s %12s %10s %10s %10s %10s %10s\n", "lines", "wall ms", "lines/s", "peak RSS KiB", "obj bytes", "tables ms",
+		"pass1 ms", "pass2 ms", "write ms");
+
+	uint32_t numResults;
+	for (numResults = 0; numResults < numLineCounts; numResults++)
+	{
+		bench_result* result = &results[numResults];
+		char sourcePath[BENCH_PATH_LEN];
+		char objectPath[BENCH_PATH_LEN + SCOFF_OBJ_EXTENSION_LEN];
+		snprintf(sourcePath, sizeof(sourcePath), "%s/bench_%" PRIu64 ".sic", dir, lineCounts[numResults]);
+		snprintf(objectPath, sizeof(objectPath), "%s%s", sourcePath, SCOFF_OBJ_EXTENSION);
+
+		// generate the program
+		params.numLines = lineCounts[numResults];
+		FILE* sourceFile = fopen(sourcePath, "w");
+		if (!sourceFile)
+		{
+			fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", sourcePath);
+			returnCode = 1;
+			break;
+		}
+		sic_gen_summary* generated = generateSICProgram(sourceFile, &params, &result->gen);
+		if (fclose(sourceFile) != 0 || !generated)
+		{
+			returnCode = 1;
+			break;
+		}
+
+		// best of the repetitions for the phases and the wall time, worst for the memory
+		for (uint32_t r = 0; r < reps && returnCode == 0; r++)
+		{
+			double phaseMs[NUM_PHASES];
+			long rss = 0;
+			if (measurePhases(sourcePath, phaseMs, &rss) != 0 || measureAssembler(asmPath, sourcePath, &walls[r], &result->peakRssKiB) != 0)
+			{
+				fprintf(stderr, "[ERROR]: Assembling \"%s\" failed.\n", sourcePath);
+				returnCode = 1;
+				break;
+			}
+
+			for (uint32_t p = 0; p < NUM_PHASES; p++)
+				if (r == 0 || phaseMs[p] < result->phaseMin[p]) result->phaseMin[p] = phaseMs[p];
+			if (rss > result->phasePeakRssKiB) result->phasePeakRssKiB = rss;
+		}
+		if (returnCode != 0) break;
+
+		qsort(walls, reps, sizeof(double), compareDoubles);
+		result->wallMin = walls[0];
+		result->wallMedian = walls[reps / 2];
+
+		struct stat sourceStat, objectStat;
+		if (stat(sourcePath, &sourceStat) == 0) result->sourceBytes = sourceStat.st_size;
+		if (stat(objectPath, &objectStat) == 0) result->objectBytes = objectStat.st_size;
+
+		printf("%10" PRIu64 " %10.3f %10.0f %12ld %10" PRIu64 " %10.3f %10.3f %10.3f %10.3f\n", result->gen.numLines, result->wallMin,
+			result->gen.numLines / (result->wallMin / 1000.0), result->peakRssKiB, result->objectBytes, result->phaseMin[0], result->phaseMin[1],
+			result->phaseMin[2], result->phaseMin[3]);
+		fflush(stdout);
+	}
+
+	if (writeResults(outPath, &params, reps, results, numResults) != 0)
+		returnCode = 1;
+	else
+		printf("[INFO]: Wrote the benchmark results to \"%s\".\n", outPath);
+
+	free(walls);
+	free(results);
+	free(lineCounts);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "Usage: %s [%s <n>]... [%s <n>] [%s <dir>] [%s <results.json>] [%s <SIC_asm>] [%s <ratio>] [%s <ratio>] "
+		"[%s <byte>:<word>:<resb>] [%s <ratio>] [%s <ratio>] [%s <n>]\n", programName, LINES_FLAG, REPS_FLAG, DIR_FLAG, OUT_FLAG, ASM_FLAG,
+		SYMBOLS_FLAG, DATA_FLAG, MIX_FLAG, COMMENTS_FLAG, FORWARD_FLAG, SEED_FLAG);
+}
+
+double nowMs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+int compareDoubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+int runPhases(const char* sourcePath, double* phaseMs)
+{
+	double start = nowMs();
+	sic_assembler* assembler = createAssembler();
+	if (!assembler) return 1;
+	double tablesDone = nowMs();
+
+	FILE* SICFile = fopen(sourcePath, "r");
+	if (!SICFile)
+	{
+		freeAssembler(assembler);
+		return 1;
+	}
+
+	int returnCode = 1;
+	double passOneDone = 0, passTwoDone = 0, writeDone = 0;
+	symbol_table* symbolTable = buildSymbolTable(SICFile, assembler->directiveTable, assembler->opTab, NULL);
+	passOneDone = nowMs();
+	if (symbolTable && fseek(SICFile, 0L, SEEK_SET) == 0)
+	{
+		sic_scoff_records* records = generateSCOFFRecords(SICFile, assembler->directiveTable, assembler->opTab, symbolTable);
+		passTwoDone = nowMs();
+		if (records)
+		{
+			if (writeSCOFFToFile(records, (char*)sourcePath) != NULL)
+				returnCode = 0;
+			writeDone = nowMs();
+			freeRecords(records);
+		}
+	}
+
+	if (symbolTable) freeSymbolTable(symbolTable);
+	fclose(SICFile);
+	freeAssembler(assembler);
+
+	phaseMs[0] = tablesDone - start;
+	phaseMs[1] = passOneDone - tablesDone;
+	phaseMs[2] = passTwoDone - passOneDone;
+	phaseMs[3] = writeDone - passTwoDone;
+	return returnCode;
+}
+
+int measurePhases(const char* sourcePath, double* phaseMs, long* peakRssKiB)
+{
+	int fds[2];
+	if (pipe(fds) != 0) return 1;
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return 1;
+	}
+	if (pid == 0)
+	{
+		close(fds[0]);
+		int status = runPhases(sourcePath, phaseMs);
+		if (write(fds[1], phaseMs, NUM_PHASES * sizeof(double)) != (ssize_t)(NUM_PHASES * sizeof(double))) status = 1;
+		close(fds[1]);
+		_exit(status);
+	}
+
+	close(fds[1]);
+	ssize_t got = read(fds[0], phaseMs, NUM_PHASES * sizeof(double));
+	close(fds[0]);
+
+	int status;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid) return 1;
+	*peakRssKiB = usage.ru_maxrss;
+
+	return (got == (ssize_t)(NUM_PHASES * sizeof(double)) && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+int measureAssembler(const char* asmPath, const char* sourcePath, double* wallMs, long* peakRssKiB)
+{
+	double start = nowMs();
+	pid_t pid = fork();
+	if (pid < 0) return 1;
+	if (pid == 0)
+	{
+		// the assembler's messages are not part of the measurement
+		int devNull = open("/dev/null", O_WRONLY);
+		if (devNull >= 0)
+		{
+			dup2(devNull, STDOUT_FILENO);
+			dup2(devNull, STDERR_FILENO);
+			close(devNull);
+		}
+		execl(asmPath, asmPath, sourcePath, (char*)NULL);
+		_exit(127);
+	}
+
+	int status;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid) return 1;
+	*wallMs = nowMs() - start;
+	if (usage.ru_maxrss > *peakRssKiB) *peakRssKiB = usage.ru_maxrss;
+
+	return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+int writeResults(const char* path, const sic_gen_params* params, uint32_t reps, const bench_result* results, uint32_t numResults)
+{
+	const char* phaseNames[NUM_PHASES] = PHASE_NAMES;
+	FILE* outFile = fopen(path, "w");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", path);
+		return 1;
+	}
+
+	fprintf(outFile, "{\n  \"reps\": %u,\n", reps);
+	fprintf(outFile, "  \"generator\": { \"symbol_density\": %g, \"data_ratio\": %g, \"byte_weight\": %u, \"word_weight\": %u, \"resb_weight\": %u, "
+		"\"comment_ratio\": %g, \"forward_ratio\": %g, \"seed\": %" PRIu64 " },\n", params->symbolDensity, params->dataRatio, params->byteWeight,
+		params->wordWeight, params->resbWeight, params->commentRatio, params->forwardRatio, params->seed);
+	fprintf(outFile, "  \"runs\": [\n");
+
+	for (uint32_t i = 0; i < numResults; i++)
+	{
+		const bench_result* result = &results[i];
+		fprintf(outFile, "    { \"lines\": %" PRIu64 ", \"code_lines\": %" PRIu64 ", \"comment_lines\": %" PRIu64 ", \"clamped_lines\": %" PRIu64
+			", \"symbols\": %" PRIu64 ", \"forward_refs\": %" PRIu64 ", \"program_bytes\": %u, \"source_bytes\": %" PRIu64 ", \"object_bytes\": %" PRIu64 ",\n",
+			result->gen.numLines, result->gen.numCodeLines, result->gen.numComments, result->gen.clampedLines, result->gen.numSymbols,
+			result->gen.numForwardRefs, result->gen.programLength, result->sourceBytes, result->objectBytes);
+		fprintf(outFile, "      \"wall_ms_min\": %.3f, \"wall_ms_median\": %.3f, \"lines_per_sec\": %.0f, \"peak_rss_kib\": %ld,\n",
+			result->wallMin, result->wallMedian, result->gen.numLines / (result->wallMin / 1000.0), result->peakRssKiB);
+		fprintf(outFile, "      \"phase_ms\": {");
+		for (uint32_t p = 0; p < NUM_PHASES; p++)
+			fprintf(outFile, "%s \"%s\": %.3f", p ? "," : "", phaseNames[p], result->phaseMin[p]);
+		fprintf(outFile, " }, \"phase_peak_rss_kib\": %ld }%s\n", result->phasePeakRssKiB, (i + 1 < numResults) ? "," : "");
+	}
+
+	fprintf(outFile, "  ]\n}\n");
+	if (fclose(outFile) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the results to \"%s\".\n", path);
+		return 1;
+	}
+	return 0;
+}
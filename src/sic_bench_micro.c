@@ -0,0 +1,633 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Microbenchmarks of the data structures and formatting primitives of the assembler.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+// Define constants //
+#define REPS_FLAG "--reps"
+#define WARMUP_FLAG "--warmup"
+#define FILTER_FLAG "--filter"
+#define OUT_FLAG "--out"
+#define DEFAULT_REPS 100
+#define DEFAULT_WARMUP 10
+#define MICRO_SIZES { 64, 1024, 16384 }
+#define NUM_MICRO_SIZES 3
+#define MICRO_NAME_LEN 64
+#define MICRO_KEY_LEN (SIC_MAX_SYMBOL_LEN + 1)
+#define MICRO_KEY_BASE 36
+#define MICRO_STRING_OPS 4096
+#define MICRO_FORMAT_OPS 4096
+#define MICRO_CONSTANT_OPS 4096
+
+// local includes //
+#include "hash_table.h"
+#include "linked_list.h"
+#include "directive.h"
+#include "scoff.h"
+
+// Structs //
+
+/**
+ * @brief micro_bench struct is one microbenchmark. run does one sample: it sets up what it needs, times only the operations being measured
+ * and returns how many of them it did, so the setup of a sample never counts. size is the number of elements the data structure holds.
+ */
+typedef struct micro_bench {
+
+	char name[MICRO_NAME_LEN];
+	uint32_t size;
+	uint64_t (*run)(const struct micro_bench* bench, double* elapsedNs);
+
+} micro_bench;
+
+/**
+ * @brief micro_result struct holds the nanoseconds per operation of a benchmark over its samples.
+ */
+typedef struct {
+
+	double min;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double mean;
+
+} micro_result;
+
+// Global state //
+
+/* @brief the value stored with every key, insertKVPair does not accept NULL */
+static int microValue = 1;
+
+/* @brief read after every traversal and lookup loop so the compiler can't drop them */
+static volatile uintptr_t microSink = 0;
+
+// Function declarations //
+
+/**
+ * @brief nowNs is a function that returns the monotonic clock in nanoseconds.
+ *
+ * @param  void
+ * @return nanoseconds
+*/
+static double nowNs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * @brief makeKeys is a function that allocates count keys shaped like SIC symbols: a letter followed by base 36 digits, six characters long.
+ * The first letter picks a disjoint set of keys, so keys made with different letters never collide.
+ *
+ * @param  count  - The number of keys.
+ * @param  prefix - The first letter of every key.
+ * @return array of count keys of MICRO_KEY_LEN chars each, or NULL on error
+*/
+static char* makeKeys(uint32_t count, char prefix)
+{
+	const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	char* keys = (char*)malloc((size_t)count * MICRO_KEY_LEN);
+	if (!keys) return NULL;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		char* key = keys + (size_t)i * MICRO_KEY_LEN;
+		uint32_t index = i;
+		key[0] = prefix;
+		for (int d = SIC_MAX_SYMBOL_LEN - 1; d > 0; d--)
+		{
+			key[d] = digits[index % MICRO_KEY_BASE];
+			index /= MICRO_KEY_BASE;
+		}
+		key[SIC_MAX_SYMBOL_LEN] = '\0';
+	}
+	return keys;
+}
+
+/**
+ * @brief fillTable is a function that creates a table with the given initial size and inserts every key.
+ *
+ * @param  keys        - The keys.
+ * @param  count       - The number of keys.
+ * @param  initialSize - The initial size given to createHashTable.
+ * @return the table or NULL on error
+*/
+static hash_table* fillTable(const char* keys, uint32_t count, uint32_t initialSize)
+{
+	hash_table* ht = createHashTable(initialSize, ALLOC_OTHER);
+	if (!ht) return NULL;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (insertKVPair(ht, keys + (size_t)i * MICRO_KEY_LEN, &microValue) != HT_OKAY)
+		{
+			freeHashTable(ht);
+			return NULL;
+		}
+	}
+	return ht;
+}
+
+/**
+ * @brief tableSizeFor is a function that returns the power of two initial size which holds count keys without growing.
+ *
+ * @param  count - The number of keys.
+ * @return initial size
+*/
+static uint32_t tableSizeFor(uint32_t count)
+{
+	uint32_t size = 1;
+	while (size < count * 2 + 1)
+		size <<= 1;
+	return size;
+}
+
+/**
+ * @brief benchInsertGrowing times inserting size keys into a table which starts at the default size, so it includes every growHashTable.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchInsertGrowing(const micro_bench* bench, double* elapsedNs)
+{
+	char* keys = makeKeys(bench->size, 'L');
+	if (!keys) return 0;
+
+	double start = nowNs();
+	hash_table* ht = fillTable(keys, bench->size, 0);
+	*elapsedNs = nowNs() - start;
+
+	freeHashTable(ht);
+	free(keys);
+	return ht ? bench->size : 0;
+}
+
+/**
+ * @brief benchInsertPresized times inserting size keys into a table which is big enough from the start.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchInsertPresized(const micro_bench* bench, double* elapsedNs)
+{
+	char* keys = makeKeys(bench->size, 'L');
+	if (!keys) return 0;
+
+	double start = nowNs();
+	hash_table* ht = fillTable(keys, bench->size, tableSizeFor(bench->size));
+	*elapsedNs = nowNs() - start;
+
+	freeHashTable(ht);
+	free(keys);
+	return ht ? bench->size : 0;
+}
+
+/**
+ * @brief benchLookup times looking up size keys in a table of size keys, either the keys in it or as many keys which are not.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @param  hit       - 1 to look up the keys in the table, 0 for keys which are not.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchLookup(const micro_bench* bench, double* elapsedNs, uint8_t hit)
+{
+	char* keys = makeKeys(bench->size, 'L');
+	char* missing = makeKeys(bench->size, 'M');
+	hash_table* ht = keys ? fillTable(keys, bench->size, 0) : NULL;
+	if (!ht || !missing)
+	{
+		freeHashTable(ht);
+		free(keys);
+		free(missing);
+		return 0;
+	}
+
+	const char* lookups = hit ? keys : missing;
+	uintptr_t found = 0;
+	double start = nowNs();
+	for (uint32_t i = 0; i < bench->size; i++)
+		found += (uintptr_t)getKVPair(ht, lookups + (size_t)i * MICRO_KEY_LEN);
+	*elapsedNs = nowNs() - start;
+	microSink = found;
+
+	freeHashTable(ht);
+	free(keys);
+	free(missing);
+	return bench->size;
+}
+
+/**
+ * @brief benchLookupHit times lookups of keys which are in the table.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchLookupHit(const micro_bench* bench, double* elapsedNs)
+{
+	return benchLookup(bench, elapsedNs, 1);
+}
+
+/**
+ * @brief benchLookupMiss times lookups of keys which are not in the table.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchLookupMiss(const micro_bench* bench, double* elapsedNs)
+{
+	return benchLookup(bench, elapsedNs, 0);
+}
+
+/**
+ * @brief benchGrow times one growHashTable of a table which holds size keys and is at its load threshold. The cost per
+ * operation is per key moved.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchGrow(const micro_bench* bench, double* elapsedNs)
+{
+	char* keys = makeKeys(bench->size, 'L');
+	hash_table* ht = keys ? fillTable(keys, bench->size, tableSizeFor(bench->size) / 2) : NULL;
+	if (!ht)
+	{
+		free(keys);
+		return 0;
+	}
+
+	double start = nowNs();
+	hash_table* grown = growHashTable(ht);
+	*elapsedNs = nowNs() - start;
+
+	freeHashTable(ht);
+	free(keys);
+	return grown ? bench->size : 0;
+}
+
+/**
+ * @brief benchListAdd times adding size elements to an empty list.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchListAdd(const micro_bench* bench, double* elapsedNs)
+{
+	linked_list* list = createLinkedList();
+	if (!list) return 0;
+
+	uint64_t added = 0;
+	double start = nowNs();
+	for (uint32_t i = 0; i < bench->size; i++)
+		added += addToList(list, &microValue) != NULL;
+	*elapsedNs = nowNs() - start;
+
+	freeList(list);
+	return added;
+}
+
+/**
+ * @brief benchListTraverse times walking a list of size elements from head to tail the way writeSCOFFToStream does.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchListTraverse(const micro_bench* bench, double* elapsedNs)
+{
+	linked_list* list = createLinkedList();
+	if (!list) return 0;
+	for (uint32_t i = 0; i < bench->size; i++)
+		addToList(list, &microValue);
+
+	uintptr_t sum = 0;
+	double start = nowNs();
+	for (ll_node* node = list->head; node != NULL; node = node->next)
+		sum += (uintptr_t)node->data;
+	*elapsedNs = nowNs() - start;
+	microSink = sum;
+
+	freeList(list);
+	return bench->size;
+}
+
+/**
+ * @brief benchASCIIToHex times ASCIIToHexConvertion on the longest character constant which fits in one text record.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchASCIIToHex(const micro_bench* bench, double* elapsedNs)
+{
+	char string[SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE + 1];
+	int32_t length = bench->size;
+	for (int32_t i = 0; i < length; i++)
+		string[i] = (char)('A' + i % 26);
+	string[length] = '\0';
+
+	sic_scoff_text text;
+	memset(&text, 0, sizeof(text));
+
+	double start = nowNs();
+	for (uint32_t i = 0; i < MICRO_STRING_OPS; i++)
+		ASCIIToHexConvertion(&text, string, length);
+	*elapsedNs = nowNs() - start;
+	microSink = (uintptr_t)text.objectCode[0];
+
+	return MICRO_STRING_OPS;
+}
+
+/**
+ * @brief benchFormatInstruction times the sprintf calls secondPassInstructionHelper makes to fill the text and modification
+ * records of one instruction with an operand.
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchFormatInstruction(const micro_bench* bench, double* elapsedNs)
+{
+	(void)bench;
+	sic_scoff_text text;
+	sic_scoff_mod mod;
+	memset(&text, 0, sizeof(text));
+	memset(&mod, 0, sizeof(mod));
+
+	double start = nowNs();
+	for (uint32_t i = 0; i < MICRO_FORMAT_OPS; i++)
+	{
+		uint32_t lc = (i * SIC_WORD_BYTES) & SIC_MEMORY_LIMIT;
+		sprintf(text.startAddr, "%0*X", SCOFF_TEXT_ADDR_LEN, lc);
+		sprintf(text.lengthOfObj, "%0*X", SCOFF_TEXT_SIZE_LEN, SIC_WORD_BYTES);
+		sprintf(text.objectCode, "%0*X%0*X", SIC_OPCODE_LEN, 0x18, SCOFF_INSTRUCTION_PAD, lc ^ SCOFF_INDEXED_BIT);
+		sprintf(mod.startAddr, "%0*X", SCOFF_MOD_ADDR_LEN, lc + SIC_BYTE);
+		sprintf(mod.lenOfModificationHB, "%0*X", SCOFF_MOD_SIZE_LEN, SCOFF_MOD_HB);
+		sprintf(mod.symbolName, "%s", "BENCH");
+	}
+	*elapsedNs = nowNs() - start;
+	microSink = (uintptr_t)text.objectCode[0] + (uintptr_t)mod.startAddr[0];
+
+	return MICRO_FORMAT_OPS;
+}
+
+/**
+ * @brief benchGetConstant times getConstant on WORD style decimal operands (size 10) or START style hex operands (size 16).
+ *
+ * @param  bench     - The benchmark, size is the number of elements.
+ * @param  elapsedNs - Set to the time of the measured operations.
+ * @return number of operations timed, 0 on error
+*/
+static uint64_t benchGetConstant(const micro_bench* bench, double* elapsedNs)
+{
+	const char* decimals[] = { "0", "3", "4096", "-5", "65535", "8388607", "-8388607", "12" };
+	const char* hexes[] = { "0", "1000", "7FFF", "A", "FF", "2A00", "100", "4B" };
+	const char** operands = (bench->size == 16) ? hexes : decimals;
+	const uint32_t numOperands = sizeof(decimals) / sizeof(decimals[0]);
+
+	int32_t constant = 0;
+	uint64_t okay = 0;
+	double start = nowNs();
+	for (uint32_t i = 0; i < MICRO_CONSTANT_OPS; i++)
+		okay += getConstant(operands[i % numOperands], &constant, (uint8_t)bench->size) == DCS_OKAY;
+	*elapsedNs = nowNs() - start;
+	microSink = (uintptr_t)constant;
+
+	return okay;
+}
+
+/**
+ * @brief compareDoubles is the qsort comparator used to take the percentiles of the samples.
+ *
+ * @param  a - first double
+ * @param  b - second double
+ * @return <0, 0 or >0
+*/
+static int compareDoubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief percentile is a function that returns the given percentile of sorted samples, using the nearest rank.
+ *
+ * @param  sorted     - The sorted samples.
+ * @param  numSamples - The number of samples.
+ * @param  percent    - The percentile, 0 to 100.
+ * @return the percentile
+*/
+static double percentile(const double* sorted, uint32_t numSamples, double percent)
+{
+	uint32_t rank = (uint32_t)(percent / 100.0 * numSamples + 0.5);
+	if (rank < 1) rank = 1;
+	if (rank > numSamples) rank = numSamples;
+	return sorted[rank - 1];
+}
+
+/**
+ * @brief runBench is a function that runs the warm-up samples, which are thrown away, then the timed samples of a benchmark, and
+ * summarizes the nanoseconds per operation.
+ *
+ * @param  bench   - The benchmark.
+ * @param  warmup  - The number of warm-up samples.
+ * @param  reps    - The number of timed samples.
+ * @param  samples - Scratch space for reps doubles.
+ * @param  result  - Filled with the summary.
+ * @return 0 on success, 1 if a sample failed
+*/
+static int runBench(const micro_bench* bench, uint32_t warmup, uint32_t reps, double* samples, micro_result* result)
+{
+	double elapsed;
+	for (uint32_t i = 0; i < warmup; i++)
+		if (bench->run(bench, &elapsed) == 0) return 1;
+
+	double sum = 0;
+	for (uint32_t i = 0; i < reps; i++)
+	{
+		uint64_t ops = bench->run(bench, &elapsed);
+		if (ops == 0) return 1;
+		samples[i] = elapsed / ops;
+		sum += samples[i];
+	}
+
+	qsort(samples, reps, sizeof(double), compareDoubles);
+	result->min = samples[0];
+	result->p50 = percentile(samples, reps, 50);
+	result->p90 = percentile(samples, reps, 90);
+	result->p99 = percentile(samples, reps, 99);
+	result->max = samples[reps - 1];
+	result->mean = sum / reps;
+	return 0;
+}
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief the main function is the entry point of the microbenchmarks. It runs every benchmark whose name contains the filter, prints
+ * the nanoseconds per operation at several percentiles, and writes them as JSON when an output file is given.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return return code
+*/
+int main(int argc, char** argv)
+{
+	uint32_t reps = DEFAULT_REPS;
+	uint32_t warmup = DEFAULT_WARMUP;
+	const char* filter = NULL;
+	const char* outPath = NULL;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (i + 1 >= argc)
+			badArgs = 1;
+		else if (strcmp(argv[i], REPS_FLAG) == 0)
+			reps = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], WARMUP_FLAG) == 0)
+			warmup = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], FILTER_FLAG) == 0)
+			filter = argv[++i];
+		else if (strcmp(argv[i], OUT_FLAG) == 0)
+			outPath = argv[++i];
+		else
+			badArgs = 1;
+	}
+
+	if (badArgs || reps == 0)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	// the table and list benchmarks run at every size, the others at their one natural size
+	const uint32_t sizes[NUM_MICRO_SIZES] = MICRO_SIZES;
+	const struct { const char* name; uint64_t (*run)(const micro_bench*, double*); } sized[] = {
+		{ "ht_insert_growing", benchInsertGrowing },
+		{ "ht_insert_presized", benchInsertPresized },
+		{ "ht_get_hit", benchLookupHit },
+		{ "ht_get_miss", benchLookupMiss },
+		{ "ht_grow", benchGrow },
+		{ "list_add", benchListAdd },
+		{ "list_traverse", benchListTraverse }
+	};
+	const uint32_t numSized = sizeof(sized) / sizeof(sized[0]);
+	const uint32_t maxBenches = numSized * NUM_MICRO_SIZES + 4;
+
+	micro_bench* benches = (micro_bench*)calloc(maxBenches, sizeof(micro_bench));
+	micro_result* results = (micro_result*)calloc(maxBenches, sizeof(micro_result));
+	double* samples = (double*)malloc(reps * sizeof(double));
+	if (!benches || !results || !samples)
+	{
+		free(benches);
+		free(results);
+		free(samples);
+		return 1;
+	}
+
+	uint32_t numBenches = 0;
+	for (uint32_t b = 0; b < numSized; b++)
+	{
+		for (uint32_t s = 0; s < NUM_MICRO_SIZES; s++)
+		{
+			snprintf(benches[numBenches].name, MICRO_NAME_LEN, "%s/%u", sized[b].name, sizes[s]);
+			benches[numBenches].size = sizes[s];
+			benches[numBenches++].run = sized[b].run;
+		}
+	}
+	snprintf(benches[numBenches].name, MICRO_NAME_LEN, "ascii_to_hex/%d", SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE);
+	benches[numBenches].size = SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE;
+	benches[numBenches++].run = benchASCIIToHex;
+	snprintf(benches[numBenches].name, MICRO_NAME_LEN, "scoff_format_instruction");
+	benches[numBenches++].run = benchFormatInstruction;
+	snprintf(benches[numBenches].name, MICRO_NAME_LEN, "get_constant/dec");
+	benches[numBenches].size = 10;
+	benches[numBenches++].run = benchGetConstant;
+	snprintf(benches[numBenches].name, MICRO_NAME_LEN, "get_constant/hex");
+	benches[numBenches].size = 16;
+	benches[numBenches++].run = benchGetConstant;
+
+	// run them
+	int returnCode = 0;
+	uint8_t* ran = (uint8_t*)calloc(numBenches, sizeof(uint8_t));
+	if (!ran) returnCode = 1;
+
+	printf("%-28s %10s %10s %10s %10s %10s   (ns/op, %u samples)\n", "benchmark", "min", "p50", "p90", "p99", "max", reps);
+	for (uint32_t i = 0; i < numBenches && returnCode == 0; i++)
+	{
+		if (filter && !strstr(benches[i].name, filter)) continue;
+		if (runBench(&benches[i], warmup, reps, samples, &results[i]) != 0)
+		{
+			fprintf(stderr, "[ERROR]: The benchmark \"%s\" failed.\n", benches[i].name);
+			returnCode = 1;
+			break;
+		}
+		ran[i] = 1;
+		printf("%-28s %10.2f %10.2f %10.2f %10.2f %10.2f\n", benches[i].name, results[i].min, results[i].p50, results[i].p90, results[i].p99,
+			results[i].max);
+		fflush(stdout);
+	}
+
+	// write the results
+	if (outPath && returnCode == 0)
+	{
+		FILE* outFile = fopen(outPath, "w");
+		if (!outFile)
+		{
+			fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", outPath);
+			returnCode = 1;
+		}
+		else
+		{
+			uint8_t first = 1;
+			fprintf(outFile, "{\n  \"reps\": %u,\n  \"warmup\": %u,\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n", reps, warmup);
+			for (uint32_t i = 0; i < numBenches; i++)
+			{
+				if (!ran[i]) continue;
+				fprintf(outFile, "%s    { \"name\": \"%s\", \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f }",
+					first ? "" : ",\n", benches[i].name, results[i].min, results[i].p50, results[i].p90, results[i].p99, results[i].max, results[i].mean);
+				first = 0;
+			}
+			fprintf(outFile, "\n  ]\n}\n");
+			if (fclose(outFile) != 0)
+				returnCode = 1;
+			else
+				printf("[INFO]: Wrote the microbenchmark results to \"%s\".\n", outPath);
+		}
+	}
+
+	free(ran);
+	free(samples);
+	free(results);
+	free(benches);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "Usage: %s [%s <n>] [%s <n>] [%s <substring>] [%s <results.json>]\n", programName, REPS_FLAG, WARMUP_FLAG, FILTER_FLAG,
+		OUT_FLAG);
+}
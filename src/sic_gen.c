@@ -0,0 +1,120 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Synthetic SIC program generator for benchmarking the assembler.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+// Define constants //
+#define LINES_FLAG "--lines"
+#define SYMBOLS_FLAG "--symbols"
+#define DATA_FLAG "--data"
+#define MIX_FLAG "--mix"
+#define COMMENTS_FLAG "--comments"
+#define FORWARD_FLAG "--forward"
+#define SEED_FLAG "--seed"
+#define OUTPUT_FLAG "-o"
+
+// local includes //
+#include "generator.h"
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief the main function is the entry point of the generator. It parses the shape of the program from the arguments and writes
+ * the program to the output file, or to stdout if none is given.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return return code
+*/
+int main(int argc, char** argv)
+{
+	sic_gen_params params;
+	initGenParams(&params);
+	const char* outPath = NULL;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (i + 1 >= argc)
+			badArgs = 1;
+		else if (strcmp(argv[i], LINES_FLAG) == 0)
+			params.numLines = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], SYMBOLS_FLAG) == 0)
+			params.symbolDensity = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], DATA_FLAG) == 0)
+			params.dataRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], MIX_FLAG) == 0)
+			badArgs = sscanf(argv[++i], "%u:%u:%u", &params.byteWeight, &params.wordWeight, &params.resbWeight) != 3;
+		else if (strcmp(argv[i], COMMENTS_FLAG) == 0)
+			params.commentRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], FORWARD_FLAG) == 0)
+			params.forwardRatio = strtod(argv[++i], NULL);
+		else if (strcmp(argv[i], SEED_FLAG) == 0)
+			params.seed = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], OUTPUT_FLAG) == 0)
+			outPath = argv[++i];
+		else
+			badArgs = 1;
+	}
+
+	if (badArgs)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	FILE* outFile = stdout;
+	if (outPath)
+	{
+		outFile = fopen(outPath, "w");
+		if (!outFile)
+		{
+			fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", outPath);
+			return 1;
+		}
+	}
+
+	sic_gen_summary summary;
+	int returnCode = (generateSICProgram(outFile, &params, &summary) != NULL) ? 0 : 1;
+
+	if (outPath && fclose(outFile) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not close the file \"%s\".\n", outPath);
+		returnCode = 1;
+	}
+
+	if (returnCode == 0)
+	{
+		if (summary.clampedLines > 0)
+			fprintf(stderr, "[WARN]: %" PRIu64 " code line(s) were written as comments since the program filled the SIC memory.\n", summary.clampedLines);
+
+		// the program itself may be on stdout, so the summary only goes there when writing to a file
+		if (outPath)
+			printf("[INFO]: Generated %" PRIu64 " line(s): %" PRIu64 " code, %" PRIu64 " comment(s), %" PRIu64 " symbol(s), %" PRIu64
+				" forward reference(s), 0x%X bytes long.\n", summary.numLines, summary.numCodeLines, summary.numComments, summary.numSymbols,
+				summary.numForwardRefs, summary.programLength);
+	}
+
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "Usage: %s [%s <n>] [%s <ratio>] [%s <ratio>] [%s <byte>:<word>:<resb>] [%s <ratio>] [%s <ratio>] [%s <n>] [%s <file.sic>]\n",
+		programName, LINES_FLAG, SYMBOLS_FLAG, DATA_FLAG, MIX_FLAG, COMMENTS_FLAG, FORWARD_FLAG, SEED_FLAG, OUTPUT_FLAG);
+}
@@ -0,0 +1,240 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Converter between the text SCOFF object and the binary object.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Define constants //
+#define TO_FLAG "--to"
+#define TO_TEXT_NAME "text"
+#define TO_BIN_NAME "bin"
+#define TO_IMAGE_NAME "image"
+#define CHECK_FLAG "--check"
+#define BASE_FLAG "--base"
+#define STDOUT_PATH "-"
+
+// local includes //
+#include "scoff_bin.h"
+#include "scoff_reader.h"
+#include "image.h"
+#include "loader.h"
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief writeRecords is a function that writes the records to the stream in the given format.
+ *
+ * @param  records - The records to write
+ * @param  format  - The format to write them in
+ * @param  outFile - The stream
+ * @return records or NULL on error
+*/
+static sic_scoff_records* writeRecords(sic_scoff_records* records, scoff_format format, FILE* outFile)
+{
+	if (format == SCOFF_FORMAT_BIN)
+		return writeSCOFFBinToStream(records, outFile);
+	if (format == SCOFF_FORMAT_IMAGE)
+		return writeSCOFFImageToStream(records, outFile);
+	return writeSCOFFToStream(records, outFile);
+}
+
+/**
+ * @brief writeRelocatedImage is a function that loads the records into an image, moves it to the base address with the relocation table
+ * built from the M records, and writes the image to the stream.
+ *
+ * @param  records - The records to load
+ * @param  base    - The address to load the program at
+ * @param  outFile - The stream
+ * @return records or NULL on error
+*/
+static sic_scoff_records* writeRelocatedImage(sic_scoff_records* records, uint32_t base, FILE* outFile)
+{
+	sic_image* image = createImageFromRecords(records);
+	sic_reloc_table* table = image ? createRelocTable(records) : NULL;
+	sic_image* moved = table ? relocateImage(image, table, base) : NULL;
+	sic_image* written = moved ? writeImageToStream(moved, outFile) : NULL;
+
+	freeImage(moved);
+	freeRelocTable(table);
+	freeImage(image);
+	return written ? records : NULL;
+}
+
+/**
+ * @brief firstDifference is a function that returns the offset of the first byte where the two buffers differ.
+ *
+ * @param  a    - The first buffer
+ * @param  aLen - The length of the first buffer
+ * @param  b    - The second buffer
+ * @param  bLen - The length of the second buffer
+ * @return the offset of the first difference, or SIZE_MAX if they are the same
+*/
+static size_t firstDifference(const void* a, size_t aLen, const void* b, size_t bLen)
+{
+	size_t len = (aLen < bLen) ? aLen : bLen;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (((const uint8_t*)a)[i] != ((const uint8_t*)b)[i]) return i;
+	}
+	return (aLen == bLen) ? SIZE_MAX : len;
+}
+
+/**
+ * @brief checkRoundTrip is a function that writes the records back in the format they were read from and checks that the result is
+ * the object byte for byte. For a text object it also checks that the image loaded straight from the text is the image loaded from
+ * the records.
+ *
+ * @param  object  - The mapped object
+ * @param  records - The records read from it
+ * @param  format  - The format of the object
+ * @return 0 if the checks pass, 1 if not
+*/
+static int checkRoundTrip(const scoff_object* object, sic_scoff_records* records, scoff_format format)
+{
+	char* written = NULL;
+	size_t writtenLen = 0;
+	FILE* outStream = open_memstream(&written, &writtenLen);
+	if (!outStream || writeRecords(records, format, outStream) == NULL || fclose(outStream) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the records back to memory.\n");
+		free(written);
+		return 1;
+	}
+
+	size_t diff = firstDifference(object->text, object->len, written, writtenLen);
+	free(written);
+	if (diff != SIZE_MAX)
+	{
+		fprintf(stderr, "[ERROR]: The object written back differs from the one read at byte %zu.\n", diff);
+		return 1;
+	}
+
+	if (format == SCOFF_FORMAT_TEXT)
+	{
+		sic_image* direct = readSCOFFToImage(object->text, object->len);
+		sic_image* loaded = createImageFromRecords(records);
+		int mismatch = !direct || !loaded || direct->startAddress != loaded->startAddress || direct->entryPoint != loaded->entryPoint;
+		if (!mismatch) diff = firstDifference(direct->bytes, direct->length, loaded->bytes, loaded->length);
+		freeImage(direct);
+		freeImage(loaded);
+		if (mismatch || diff != SIZE_MAX)
+		{
+			fprintf(stderr, "[ERROR]: The image read straight from the text differs from the image loaded from its records.\n");
+			return 1;
+		}
+	}
+
+	printf("[INFO]: The object round trips byte for byte (%zu bytes, %u T and %u M records).\n", object->len,
+		records->texts->numberOfElements, records->modifications->numberOfElements);
+	return 0;
+}
+
+/**
+ * @brief the main function is the entry point of the converter. It maps the object, works out its format from the magic of the binary
+ * format, and writes it in the other format, or in the one given with --to, to the output file or to stdout if it is "-". An image can
+ * be made from either format but can't be converted back, since it no longer has the records, and --base loads it at another address
+ * by applying the M records. With --check nothing is written, the object is read and written back in its own format to check the reader
+ * and writer agree.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return return code
+*/
+int main(int argc, char** argv)
+{
+	const char* inPath = NULL;
+	const char* outPath = NULL;
+	int8_t toFormat = -1; // -1 is the format the input is not in
+	uint8_t checkMode = 0;
+	int64_t base = -1; // -1 is the start address the object was assembled for
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (strcmp(argv[i], TO_FLAG) == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], TO_TEXT_NAME) == 0) toFormat = SCOFF_FORMAT_TEXT;
+			else if (strcmp(argv[i], TO_BIN_NAME) == 0) toFormat = SCOFF_FORMAT_BIN;
+			else if (strcmp(argv[i], TO_IMAGE_NAME) == 0) toFormat = SCOFF_FORMAT_IMAGE;
+			else badArgs = 1;
+		}
+		else if (strcmp(argv[i], CHECK_FLAG) == 0)
+			checkMode = 1;
+		else if (strcmp(argv[i], BASE_FLAG) == 0 && i + 1 < argc)
+			base = (int64_t)strtoul(argv[++i], NULL, 16);
+		else if (!inPath && argv[i][0] != '-')
+			inPath = argv[i];
+		else if (!outPath && (argv[i][0] != '-' || strcmp(argv[i], STDOUT_PATH) == 0))
+			outPath = argv[i];
+		else
+			badArgs = 1;
+	}
+
+	if (badArgs || !inPath || (!outPath && !checkMode) || (outPath && checkMode) || (base >= 0 && toFormat != SCOFF_FORMAT_IMAGE))
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	scoff_object* object = mapObjectFile(inPath);
+	if (!object) return 1;
+
+	const uint8_t* data = (const uint8_t*)object->text;
+	scoff_format fromFormat = isSCOFFBin(data, object->len) ? SCOFF_FORMAT_BIN : SCOFF_FORMAT_TEXT;
+	if (toFormat < 0) toFormat = (fromFormat == SCOFF_FORMAT_BIN) ? SCOFF_FORMAT_TEXT : SCOFF_FORMAT_BIN;
+	sic_scoff_records* records = (fromFormat == SCOFF_FORMAT_BIN) ? readSCOFFBin(data, object->len) : readSCOFF(object->text, object->len);
+	if (!records)
+	{
+		unmapObjectFile(object);
+		return 1;
+	}
+
+	int returnCode = 1;
+	if (checkMode)
+		returnCode = checkRoundTrip(object, records, fromFormat);
+	else
+	{
+		FILE* outFile = (strcmp(outPath, STDOUT_PATH) == 0) ? stdout : fopen(outPath, "wb");
+		if (outFile)
+		{
+			sic_scoff_records* written = (base >= 0) ? writeRelocatedImage(records, (uint32_t)base, outFile) :
+				writeRecords(records, (scoff_format)toFormat, outFile);
+			returnCode = (written != NULL) ? 0 : 1;
+			if (outFile != stdout && fclose(outFile) != 0)
+			{
+				fprintf(stderr, "[ERROR]: Could not close the file \"%s\".\n", outPath);
+				returnCode = 1;
+			}
+		}
+		else
+			fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", outPath);
+	}
+
+	freeRecords(records);
+	unmapObjectFile(object);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "[ERROR]: Please enter the object file to convert and the file to write it to.\n");
+	fprintf(stderr, "Usage: %s [%s %s|%s|%s] <in.obj | in.sbo> <out | %s>\n", programName, TO_FLAG, TO_TEXT_NAME, TO_BIN_NAME, TO_IMAGE_NAME,
+		STDOUT_PATH);
+	fprintf(stderr, "       %s %s %s %s <hex address> <in.obj | in.sbo> <out | %s>\n", programName, TO_FLAG, TO_IMAGE_NAME, BASE_FLAG, STDOUT_PATH);
+	fprintf(stderr, "       %s %s <in.obj | in.sbo>\n", programName, CHECK_FLAG);
+}
@@ -0,0 +1,563 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Disassembler which turns SIC objects back into source-like listings.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+
+// Define constants //
+#define SYMBOLS_FLAG "--symbols"
+#define JOBS_FLAG "--jobs"
+#define LINE_LEN 256
+#define DIS_LINE_LEN 64 // the longest line a byte of a T record can produce
+#define DIS_PARALLEL_RECORDS 256 // objects with fewer T records than this are disassembled on the calling thread
+#define DIS_RECORDS_PER_TASK 64
+#define DIS_MAX_LINES_PER_RECORD (SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE + 1) // a line a byte, and a RESB for the gap before it
+#define DIS_OBJECT_CODE_LEN (SIC_WORD_BYTES * SIC_CHARACTERS_PER_BYTE)
+
+// local includes //
+#include "opcode.h"
+#include "scoff_bin.h"
+#include "scoff_reader.h"
+#include "image.h"
+#include "thread_pool.h"
+#include "symbols.h"
+
+// Structs //
+
+/**
+ * @brief dis_symbol is a symbol of the map given with --symbols, its name, address and the line of the map it is on.
+ */
+typedef struct
+{
+	char name[SIC_MAX_SYMBOL_LEN + 1];
+	uint32_t address;
+	uint32_t line;
+
+} dis_symbol;
+
+/**
+ * @brief dis_symbol_map is the symbols of the map sorted by address and then by line, so the symbols at an address are found with a
+ * binary search. A .syms map written by the assembler is read in place as binary instead, its entries sorted the same way. The program
+ * name is the label of START, which shares its address with the first instruction.
+ */
+typedef struct
+{
+	dis_symbol* symbols;
+	uint32_t numSymbols;
+	sic_symbol_map* binary;
+	char programName[SCOFF_HEADER_FIELD_LEN + 1];
+
+} dis_symbol_map;
+
+/**
+ * @brief dis_task is a run of T records disassembled into a buffer of its own, so the runs can be done on any thread and printed in order.
+ */
+typedef struct
+{
+	const sic_scoff_text** texts; // every T record of the object, the one before the run tells where the gap before it starts
+	uint32_t programStart; // where the gap before the first T record starts
+	uint32_t first;
+	uint32_t numTexts;
+	const sic_reverse_optable* reverse;
+	const dis_symbol_map* symbols;
+	char* out;
+	size_t len;
+	uint8_t failed;
+
+} dis_task;
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief compareSymbols is a function that orders symbols by address and then by the line of the map they are on for qsort, so symbols at
+ * the same address keep the order of the map.
+ *
+ * @param  a - The first symbol
+ * @param  b - The second symbol
+ * @return less than, equal to or greater than 0 as a goes before, with or after b
+*/
+static int compareSymbols(const void* a, const void* b)
+{
+	const dis_symbol* first = (const dis_symbol*)a;
+	const dis_symbol* second = (const dis_symbol*)b;
+	if (first->address != second->address) return (first->address > second->address) ? 1 : -1;
+	return (first->line > second->line) - (first->line < second->line);
+}
+
+/**
+ * @brief readSymbolMap is a function that reads a symbol map, a symbol and its address in hex on each line, and sorts it by address and
+ * then by line.
+ * Lines which are not a symbol and an address are skipped with a warning.
+ *
+ * @param  path - The symbol map
+ * @param  map  - Filled with the symbols
+ * @return 1 on success, 0 if the map could not be read
+*/
+static uint8_t readSymbolMap(const char* path, dis_symbol_map* map)
+{
+	FILE* inFile = fopen(path, "r");
+	if (!inFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the symbol map \"%s\".\n", path);
+		return 0;
+	}
+
+	uint32_t capacity = 0, lineNumber = 0;
+	char line[LINE_LEN];
+	while (fgets(line, sizeof(line), inFile) != NULL)
+	{
+		char name[LINE_LEN] = { 0 }, address[LINE_LEN] = { 0 };
+		char* end = NULL;
+		lineNumber++;
+		if (sscanf(line, "%255s %255s", name, address) <= 0) continue;
+
+		unsigned long value = strtoul(address, &end, 16);
+		if (strlen(name) > SIC_MAX_SYMBOL_LEN || end == address || *end != '\0' || value > SIC_MEMORY_LIMIT)
+		{
+			fprintf(stderr, "[WARN]: Skipped line %u of the symbol map, which is not a symbol and an address.\n", lineNumber);
+			continue;
+		}
+		if (map->numSymbols == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 64;
+			dis_symbol* grown = (dis_symbol*)realloc(map->symbols, capacity * sizeof(dis_symbol));
+			if (!grown)
+			{
+				fprintf(stderr, "[ERROR]: unable to malloc the symbol map.\n");
+				fclose(inFile);
+				return 0;
+			}
+			map->symbols = grown;
+		}
+		strcpy(map->symbols[map->numSymbols].name, name);
+		map->symbols[map->numSymbols].address = (uint32_t)value;
+		map->symbols[map->numSymbols++].line = lineNumber;
+	}
+	fclose(inFile);
+
+	if (map->numSymbols) qsort(map->symbols, map->numSymbols, sizeof(dis_symbol), compareSymbols);
+	return 1;
+}
+
+/**
+ * @brief symbolIndex is a function that finds the first symbol of the map at or above the address with a binary search.
+ *
+ * @param  map     - The symbol map
+ * @param  address - The address
+ * @return the index of the symbol, or the number of symbols if every symbol is below the address
+*/
+static uint32_t symbolIndex(const dis_symbol_map* map, uint32_t address)
+{
+	if (map->binary) return findFirstSymbolFrom(map->binary, address);
+
+	uint32_t low = 0, high = map->numSymbols;
+	while (low < high)
+	{
+		uint32_t mid = low + (high - low) / 2;
+		if (map->symbols[mid].address < address) low = mid + 1;
+		else high = mid;
+	}
+	return low;
+}
+
+/**
+ * @brief symbolAt is a function that gives the name and address of a symbol of the map. A name of a .syms map which does not end in a NUL
+ * is given as NULL.
+ *
+ * @param  map     - The symbol map
+ * @param  index   - The index of the symbol, below the number of symbols
+ * @param  address - Set to the address of the symbol
+ * @return the name of the symbol or NULL
+*/
+static const char* symbolAt(const dis_symbol_map* map, uint32_t index, uint32_t* address)
+{
+	if (!map->binary)
+	{
+		*address = map->symbols[index].address;
+		return map->symbols[index].name;
+	}
+	const sic_symbol_entry* entry = &map->binary->entries[index];
+	*address = entry->address;
+	return (entry->name[SYMBOLS_NAME_LEN - 1] == '\0') ? entry->name : NULL;
+}
+
+/**
+ * @brief findSymbol is a function that finds the symbol at the address. When several symbols share the address the one on the earliest
+ * line is given, except that the label of START is only given when no other symbol is at its address, so the first instruction and the
+ * operands which jump to it are labelled with its own name.
+ *
+ * @param  map     - The symbol map, may be NULL
+ * @param  address - The address
+ * @return the name of the symbol or NULL if there is none
+*/
+static const char* findSymbol(const dis_symbol_map* map, uint32_t address)
+{
+	if (!map) return NULL;
+
+	const char* found = NULL;
+	uint32_t at = 0;
+	for (uint32_t i = symbolIndex(map, address); i < map->numSymbols; i++)
+	{
+		const char* name = symbolAt(map, i, &at);
+		if (at != address) break;
+		if (!name) continue;
+		if (strcmp(name, map->programName) != 0) return name;
+		if (!found) found = name;
+	}
+	return found;
+}
+
+/**
+ * @brief gapLineEnd is a function that finds where the RESB line of a gap starting at the address ends, which is at the next symbol in the
+ * gap so every reserved label keeps a line of its own, or at the end of the gap.
+ *
+ * @param  map     - The symbol map, may be NULL
+ * @param  address - The address the line starts at
+ * @param  end     - The end of the gap
+ * @return the end of the line
+*/
+static uint32_t gapLineEnd(const dis_symbol_map* map, uint32_t address, uint32_t end)
+{
+	if (!map) return end;
+	uint32_t index = symbolIndex(map, address + 1), next = end;
+	if (index < map->numSymbols) symbolAt(map, index, &next);
+	return (next < end) ? next : end;
+}
+
+/**
+ * @brief gapLines is a function that counts the most RESB lines a gap can be split into, one and one more for every symbol in it.
+ *
+ * @param  map   - The symbol map, may be NULL
+ * @param  start - The start of the gap
+ * @param  end   - The end of the gap
+ * @return the number of lines
+*/
+static uint32_t gapLines(const dis_symbol_map* map, uint32_t start, uint32_t end)
+{
+	if (start >= end) return 0;
+	return 1 + (map ? symbolIndex(map, end) - symbolIndex(map, start) : 0);
+}
+
+/**
+ * @brief formatGap is a function that writes a gap the object has no bytes for as RESB lines, split at every symbol in it so each
+ * reserved label keeps a line of its own.
+ *
+ * @param  map   - The symbol map, may be NULL
+ * @param  start - The start of the gap
+ * @param  end   - The end of the gap
+ * @param  out   - Where the lines are written, room for gapLines() lines
+ * @return the number of characters written
+*/
+static size_t formatGap(const dis_symbol_map* map, uint32_t start, uint32_t end, char* out)
+{
+	size_t len = 0;
+	for (uint32_t at = start; at < end;)
+	{
+		const char* label = findSymbol(map, at);
+		uint32_t lineEnd = gapLineEnd(map, at, end);
+		len += (size_t)sprintf(out + len, "%06X  %-*s  %-8s%-8s%u\n", at, DIS_OBJECT_CODE_LEN, "", label ? label : "", "RESB",
+			lineEnd - at);
+		at = lineEnd;
+	}
+	return len;
+}
+
+/**
+ * @brief formatAddress is a function that writes an operand address as its symbol, or in hex when it has none.
+ *
+ * @param  map     - The symbol map, may be NULL
+ * @param  address - The address
+ * @param  out     - Where the operand is written, at least 7 characters
+ * @return out
+*/
+static char* formatAddress(const dis_symbol_map* map, uint32_t address, char* out)
+{
+	const char* name = findSymbol(map, address);
+	if (name) strcpy(out, name);
+	else sprintf(out, "%04X", address);
+	return out;
+}
+
+/**
+ * @brief textAddress is a function that reads the start address and length of a T record.
+ *
+ * @param  text - The T record
+ * @param  len  - Set to the number of bytes in the record
+ * @return the start address of the record
+*/
+static uint32_t textAddress(const sic_scoff_text* text, uint32_t* len)
+{
+	*len = (uint32_t)strtoul(text->lengthOfObj, NULL, 16);
+	return (uint32_t)strtoul(text->startAddr, NULL, 16);
+}
+
+/**
+ * @brief disassembleTexts is a function that disassembles the T records of a task into its buffer, a line per instruction. Each record
+ * is swept from its start: a byte which is the opcode of a SIC instruction starts a 3 byte instruction, and any other byte, or the bytes
+ * at the end of a record too short for an instruction, become a BYTE. A gap before a record, from the end of the record before it or
+ * from the start of the program, is written by formatGap(). The function is a thread_pool_task.
+ *
+ * @param  arg - The dis_task
+ * @return void
+*/
+static void disassembleTexts(void* arg)
+{
+	dis_task* task = (dis_task*)arg;
+	uint32_t prevEnd = task->programStart, len = 0;
+	if (task->first > 0) prevEnd = textAddress(task->texts[task->first - 1], &len) + len;
+
+	for (uint32_t t = task->first; t < task->first + task->numTexts; t++)
+	{
+		uint8_t bytes[SCOFF_TEXT_OBJ_CODE_LEN / SIC_CHARACTERS_PER_BYTE];
+		uint32_t start = textAddress(task->texts[t], &len);
+		if (len > sizeof(bytes) || strlen(task->texts[t]->objectCode) < len * SIC_CHARACTERS_PER_BYTE ||
+			!decodeHex(task->texts[t]->objectCode, len, bytes))
+		{
+			fprintf(stderr, "[ERROR]: The T record at %06X does not hold %u bytes of hex.\n", start, len);
+			task->failed = 1;
+			return;
+		}
+
+		task->len += formatGap(task->symbols, prevEnd, start, task->out + task->len);
+		prevEnd = start + len;
+
+		for (uint32_t at = 0; at < len;)
+		{
+			uint32_t address = start + at;
+			const char* label = findSymbol(task->symbols, address);
+			const sic_optable_values* values = task->reverse->values[bytes[at]];
+			char operand[SIC_MAX_SYMBOL_LEN + SCOFF_INSTRUCTION_PAD + 1] = { 0 };
+			uint8_t isInstruction = values && values->instructionFormat == 3 && !(values->flags & OP_FLAG_XE_ONLY) &&
+				at + SIC_WORD_BYTES <= len;
+
+			if (isInstruction)
+			{
+				uint32_t target = ((uint32_t)bytes[at + 1] << 8) | bytes[at + 2];
+				if (values->numOperands == 0 && target != 0)
+					isInstruction = 0;
+				else if (values->numOperands != 0)
+				{
+					formatAddress(task->symbols, target & ~SCOFF_INDEXED_BIT, operand);
+					if (target & SCOFF_INDEXED_BIT) strcat(operand, SCOFF_INDEXED_SUBSTR);
+				}
+			}
+
+			if (isInstruction)
+			{
+				task->len += (size_t)sprintf(task->out + task->len, "%06X  %02X%02X%02X  %-8s%-*s%s\n", address, bytes[at], bytes[at + 1],
+					bytes[at + 2], label ? label : "", operand[0] ? 8 : 0, task->reverse->mnemonics[bytes[at]], operand);
+				at += SIC_WORD_BYTES;
+			}
+			else
+			{
+				task->len += (size_t)sprintf(task->out + task->len, "%06X  %02X%-*s  %-8sBYTE    X'%02X'\n", address, bytes[at],
+					DIS_OBJECT_CODE_LEN - SIC_CHARACTERS_PER_BYTE, "", label ? label : "", bytes[at]);
+				at++;
+			}
+		}
+	}
+}
+
+/**
+ * @brief disassemble is a function that disassembles every T record of the object to stdout between a START and an END line. The records
+ * are split into runs which are disassembled on the pool when there are enough of them and on the calling thread when there are not.
+ * The reserved space after the last record, up to the length in the H record, is written as a gap before the END line.
+ *
+ * @param  records    - The records of the object
+ * @param  reverse    - The opcode table by opcode byte
+ * @param  symbols    - The symbol map, may be NULL
+ * @param  numWorkers - The number of workers of the pool, 0 for one per CPU
+ * @return 0 on success, 1 on error
+*/
+static int disassemble(const sic_scoff_records* records, const sic_reverse_optable* reverse, const dis_symbol_map* symbols,
+	uint32_t numWorkers)
+{
+	uint32_t numTexts = records->texts->numberOfElements;
+	uint32_t numTasks = (numTexts + DIS_RECORDS_PER_TASK - 1) / DIS_RECORDS_PER_TASK;
+	const sic_scoff_text** texts = (const sic_scoff_text**)malloc((numTexts + 1) * sizeof(sic_scoff_text*));
+	dis_task* tasks = (dis_task*)calloc(numTasks + 1, sizeof(dis_task));
+	if (!texts || !tasks)
+	{
+		fprintf(stderr, "[ERROR]: unable to malloc the disassembly.\n");
+		free(texts);
+		free(tasks);
+		return 1;
+	}
+	uint32_t i = 0, len = 0;
+	uint32_t programStart = (uint32_t)strtoul(records->header.startAddr, NULL, 16), programEnd = programStart;
+	for (ll_node* node = records->texts->head; node; node = node->next)
+	{
+		texts[i] = (const sic_scoff_text*)node->data;
+		uint32_t textEnd = textAddress(texts[i++], &len) + len;
+		if (textEnd > programEnd) programEnd = textEnd;
+	}
+
+	int returnCode = 0;
+	for (i = 0; i < numTasks && returnCode == 0; i++)
+	{
+		tasks[i].texts = texts;
+		tasks[i].programStart = programStart;
+		tasks[i].first = i * DIS_RECORDS_PER_TASK;
+		tasks[i].numTexts = (numTexts - tasks[i].first < DIS_RECORDS_PER_TASK) ? numTexts - tasks[i].first : DIS_RECORDS_PER_TASK;
+		tasks[i].reverse = reverse;
+		tasks[i].symbols = symbols;
+
+		// a line a byte, and the lines of the gap before each record
+		size_t numLines = (size_t)tasks[i].numTexts * DIS_MAX_LINES_PER_RECORD;
+		for (uint32_t t = tasks[i].first; t < tasks[i].first + tasks[i].numTexts; t++)
+		{
+			uint32_t prevEnd = (t > 0) ? textAddress(texts[t - 1], &len) + len : programStart, start = textAddress(texts[t], &len);
+			numLines += gapLines(symbols, prevEnd, start);
+		}
+		tasks[i].out = (char*)malloc(numLines * DIS_LINE_LEN);
+		if (!tasks[i].out)
+		{
+			fprintf(stderr, "[ERROR]: unable to malloc the disassembly.\n");
+			returnCode = 1;
+		}
+	}
+
+	thread_pool* pool = (returnCode == 0 && numTexts >= DIS_PARALLEL_RECORDS && numWorkers != 1) ? createThreadPool(numWorkers) : NULL;
+	for (i = 0; i < numTasks && returnCode == 0; i++)
+	{
+		if (!pool || !threadPoolSubmit(pool, disassembleTexts, &tasks[i]))
+			disassembleTexts(&tasks[i]);
+	}
+	if (pool) freeThreadPool(pool);
+
+	// the space reserved after the last record, which has no T record to follow it
+	uint32_t reservedEnd = programStart + (uint32_t)strtoul(records->header.lengthOfProgram, NULL, 16);
+	char* reserved = (returnCode == 0) ? (char*)malloc((size_t)gapLines(symbols, programEnd, reservedEnd) * DIS_LINE_LEN + 1) : NULL;
+	if (returnCode == 0 && !reserved)
+	{
+		fprintf(stderr, "[ERROR]: unable to malloc the disassembly.\n");
+		returnCode = 1;
+	}
+
+	// the header, the runs in order, the reserved space and the end
+	char name[SCOFF_HEADER_FIELD_LEN + 1], operand[SIC_MAX_SYMBOL_LEN + 1];
+	strcpy(name, records->header.programName);
+	for (size_t end = strlen(name); end > 0 && isspace((unsigned char)name[end - 1]); end--) name[end - 1] = '\0';
+	if (returnCode == 0) printf("%06X  %-*s  %-8s%-8s%04X\n", programStart, DIS_OBJECT_CODE_LEN, "", name, "START", programStart);
+	for (i = 0; i < numTasks && returnCode == 0; i++)
+	{
+		if (tasks[i].failed) returnCode = 1;
+		else fwrite(tasks[i].out, 1, tasks[i].len, stdout);
+	}
+	if (returnCode == 0)
+		fwrite(reserved, 1, formatGap(symbols, programEnd, reservedEnd, reserved), stdout);
+	if (returnCode == 0)
+		printf("%6s  %-*s  %-8s%-8s%s\n", "", DIS_OBJECT_CODE_LEN, "", "", "END",
+			formatAddress(symbols, (uint32_t)strtoul(records->end.firstInstruction, NULL, 16), operand));
+
+	for (i = 0; i < numTasks; i++) free(tasks[i].out);
+	free(reserved);
+	free(tasks);
+	free(texts);
+	return returnCode;
+}
+
+/**
+ * @brief the main function is the entry point of the disassembler. It reads a text or binary object and prints it as a listing of
+ * instructions and data, with the names of a symbol map given with --symbols in place of the addresses they stand for. The map is the
+ * .syms file the assembler writes, or text with a symbol and its address in hex on each line.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return 0 on success, 1 if the object or the symbol map could not be read
+*/
+int main(int argc, char** argv)
+{
+	const char* objectPath = NULL;
+	const char* symbolsPath = NULL;
+	uint32_t numWorkers = 0;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (strcmp(argv[i], SYMBOLS_FLAG) == 0 && i + 1 < argc)
+			symbolsPath = argv[++i];
+		else if (strcmp(argv[i], JOBS_FLAG) == 0 && i + 1 < argc)
+			numWorkers = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (argv[i][0] != '-' && !objectPath)
+			objectPath = argv[i];
+		else
+			badArgs = 1;
+	}
+	if (badArgs || !objectPath)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	dis_symbol_map symbols = { 0 };
+	scoff_object* symbolsFile = NULL;
+	uint8_t symbolsRead = 1;
+	if (symbolsPath)
+	{
+		// the .syms map is used where it is mapped, a text map is read into the sorted array
+		symbolsFile = mapObjectFile(symbolsPath);
+		if (symbolsFile && isSymbolMap((const uint8_t*)symbolsFile->text, symbolsFile->len))
+		{
+			symbolsRead = (symbols.binary = openSymbolMap((const uint8_t*)symbolsFile->text, symbolsFile->len)) != NULL;
+			if (symbolsRead) symbols.numSymbols = symbols.binary->numSymbols;
+		}
+		else
+			symbolsRead = symbolsFile && readSymbolMap(symbolsPath, &symbols);
+	}
+	if (!symbolsRead)
+	{
+		free(symbols.symbols);
+		unmapObjectFile(symbolsFile);
+		return 1;
+	}
+
+	scoff_object* object = mapObjectFile(objectPath);
+	const uint8_t* data = object ? (const uint8_t*)object->text : NULL;
+	sic_scoff_records* records = NULL;
+	if (object && isImage(data, object->len))
+		fprintf(stderr, "[ERROR]: \"%s\" is an image, which has no records to disassemble. Give the object it was made from.\n", objectPath);
+	else if (object)
+		records = isSCOFFBin(data, object->len) ? readSCOFFBin(data, object->len) : readSCOFF(object->text, object->len);
+
+	if (records)
+	{
+		// the label of START, trimmed of the padding of the H record
+		strcpy(symbols.programName, records->header.programName);
+		for (size_t end = strlen(symbols.programName); end > 0 && isspace((unsigned char)symbols.programName[end - 1]); end--)
+			symbols.programName[end - 1] = '\0';
+	}
+	hash_table* opTab = records ? buildOpcodeTable() : NULL;
+	sic_reverse_optable* reverse = opTab ? buildReverseOpcodeTable(opTab) : NULL;
+	int returnCode = reverse ? disassemble(records, reverse, symbolsPath ? &symbols : NULL, numWorkers) : 1;
+
+	sicFree(ALLOC_OPTAB, reverse);
+	freeHashTableAndValues(opTab);
+	if (records) freeRecords(records);
+	unmapObjectFile(object);
+	free(symbols.symbols);
+	freeSymbolMap(symbols.binary);
+	unmapObjectFile(symbolsFile);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "[ERROR]: Please enter the object to disassemble.\n");
+	fprintf(stderr, "Usage: %s [%s <prog.syms | file>] [%s <num workers>] <prog.obj | prog.sbo>\n", programName, SYMBOLS_FLAG, JOBS_FLAG);
+}
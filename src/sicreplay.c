@@ -0,0 +1,189 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Replay of the execution traces sicsim records, forward and back.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Define constants //
+#define COMMANDS_FLAG "--commands"
+#define LINES_FLAG "--lines"
+#define LINE_LEN 256
+#define PROMPT "(sicreplay) "
+#define DUMP_BYTES 16 // bytes dumped by x when no length is given, and bytes per row of the dump
+
+// local includes //
+#include "record.h"
+#include "lines.h"
+#include "scoff_reader.h"
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief printPosition is a function that prints the step the replay is at and the state of the PC, with its line when there is a
+ * line table. The function returns nothing.
+ *
+ * @param  replay    - The replay
+ * @param  lineTable - The line table, or NULL
+ * @return void
+*/
+static void printPosition(const sim_replay* replay, const sic_line_table* lineTable)
+{
+	uint32_t line = lineTable ? findLine(lineTable, replay->registers.PC) : LINES_NO_LINE;
+	printf("Step %llu of %llu, PC %06X", (unsigned long long)replay->step, (unsigned long long)replay->numSteps, replay->registers.PC);
+	if (line != LINES_NO_LINE) printf(" (line %u)", line);
+	printf(".\n");
+}
+
+/**
+ * @brief dumpMemory is a function that prints the bytes from the address in rows of hex. The function returns nothing.
+ *
+ * @param  replay  - The replay
+ * @param  address - The first byte
+ * @param  len     - The number of bytes
+ * @return void
+*/
+static void dumpMemory(const sim_replay* replay, uint32_t address, uint32_t len)
+{
+	if (len > RECORD_MEMORY_SIZE - address) len = RECORD_MEMORY_SIZE - address;
+	for (uint32_t row = 0; row < len; row += DUMP_BYTES)
+	{
+		printf("%06X:", address + row);
+		for (uint32_t i = row; i < len && i < row + DUMP_BYTES; i++)
+			printf(" %02X", replay->memory[address + i]);
+		printf("\n");
+	}
+}
+
+/**
+ * @brief runCommands is a function that reads replay commands from the stream until it ends or the quit command. The commands are
+ * seek <step>, step [n], back [n], regs, x <hex address> [len], info and quit, and each can be shortened to its first letter.
+ *
+ * @param  replay    - The replay
+ * @param  lineTable - The line table, or NULL
+ * @param  in        - Where the commands are read from
+ * @return void
+*/
+static void runCommands(sim_replay* replay, const sic_line_table* lineTable, FILE* in)
+{
+	char line[LINE_LEN];
+	printf(PROMPT);
+	fflush(stdout);
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		char command[LINE_LEN] = { 0 }, arg[LINE_LEN] = { 0 }, count[LINE_LEN] = { 0 };
+		int numArgs = sscanf(line, "%255s %255s %255s", command, arg, count);
+		char* end = NULL;
+		unsigned long long value = (numArgs >= 2) ? strtoull(arg, &end, (command[0] == 'x') ? 16 : 10) : 1;
+		uint8_t badValue = numArgs >= 2 && (end == arg || *end != '\0');
+
+		if (numArgs <= 0) { }
+		else if (strcmp(command, "q") == 0 || strcmp(command, "quit") == 0)
+			break;
+		else if ((strcmp(command, "seek") == 0 || strcmp(command, "g") == 0) && numArgs >= 2 && !badValue)
+		{
+			if (replaySeek(replay, value)) printPosition(replay, lineTable);
+		}
+		else if ((strcmp(command, "s") == 0 || strcmp(command, "step") == 0 || strcmp(command, "b") == 0 || strcmp(command, "back") == 0) &&
+			!badValue)
+		{
+			uint8_t forward = command[0] == 's';
+			unsigned long long moved = 0;
+			while (moved < value && replayStep(replay, forward)) moved++;
+			if (moved < value) printf("[WARN]: The replay is at the %s of the trace.\n", forward ? "end" : "start");
+			printPosition(replay, lineTable);
+		}
+		else if (strcmp(command, "r") == 0 || strcmp(command, "regs") == 0)
+			printf("A=%06X X=%06X L=%06X SW=%06X PC=%06X\n", replay->registers.A, replay->registers.X, replay->registers.L, replay->registers.SW,
+				replay->registers.PC);
+		else if (strcmp(command, "x") == 0 && numArgs >= 2 && !badValue && value < RECORD_MEMORY_SIZE)
+			dumpMemory(replay, (uint32_t)value, (numArgs >= 3) ? (uint32_t)strtoul(count, NULL, 0) : DUMP_BYTES);
+		else if (strcmp(command, "i") == 0 || strcmp(command, "info") == 0)
+			printf("%llu steps in %u chunks, %zu bytes.\n", (unsigned long long)replay->numSteps, replay->numChunks, replay->len);
+		else
+			fprintf(stderr, "[WARN]: Unknown command or bad argument \"%s\". The commands are seek, step, back, regs, x, info and quit.\n",
+				line[strlen(line) - 1] == '\n' ? strtok(line, "\n") : line);
+
+		printf(PROMPT);
+		fflush(stdout);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief the main function is the entry point of the replay tool. It opens a trace written by sicsim --record and moves through it as
+ * the commands read from stdin, or from the file given with --commands, say.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return 0 on success, 1 if the trace, the line table or the commands could not be read
+*/
+int main(int argc, char** argv)
+{
+	const char* tracePath = NULL;
+	const char* commandsPath = NULL;
+	const char* linesPath = NULL;
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (strcmp(argv[i], COMMANDS_FLAG) == 0 && i + 1 < argc)
+			commandsPath = argv[++i];
+		else if (strcmp(argv[i], LINES_FLAG) == 0 && i + 1 < argc)
+			linesPath = argv[++i];
+		else if (argv[i][0] != '-' && !tracePath)
+			tracePath = argv[i];
+		else
+			badArgs = 1;
+	}
+	if (badArgs || !tracePath)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	scoff_object* traceFile = mapObjectFile(tracePath);
+	sim_replay* replay = traceFile ? openReplay((const uint8_t*)traceFile->text, traceFile->len) : NULL;
+	sic_line_table* lineTable = NULL;
+	if (replay && linesPath)
+	{
+		scoff_object* linesFile = mapObjectFile(linesPath);
+		lineTable = linesFile ? readLineTable((const uint8_t*)linesFile->text, linesFile->len) : NULL;
+		unmapObjectFile(linesFile);
+	}
+	FILE* in = commandsPath ? fopen(commandsPath, "r") : stdin;
+	if (commandsPath && !in) fprintf(stderr, "[ERROR]: Could not open the replay commands \"%s\".\n", commandsPath);
+
+	int returnCode = 1;
+	if (replay && (!linesPath || lineTable) && in)
+	{
+		printPosition(replay, lineTable);
+		runCommands(replay, lineTable, in);
+		returnCode = 0;
+	}
+
+	if (in && in != stdin) fclose(in);
+	freeLineTable(lineTable);
+	freeReplay(replay);
+	unmapObjectFile(traceFile);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "[ERROR]: Please enter the trace to replay.\n");
+	fprintf(stderr, "Usage: %s [%s <file>] [%s <prog.lines>] <prog.trace>\n", programName, COMMANDS_FLAG, LINES_FLAG);
+}
@@ -0,0 +1,394 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+// Project: Simulator which runs the programs the SIC assembler produces.
+
+// library imports
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+// Define constants //
+#define MAX_FLAG "--max-instructions"
+#define STATS_FLAG "--stats"
+#define NO_FUSE_FLAG "--no-fuse"
+#define INPUT_FLAG "--input"
+#define OUTPUT_FLAG "--output"
+#define THROTTLE_FLAG "--throttle"
+#define BATCH_FLAG "--batch"
+#define JOBS_FLAG "--jobs"
+#define TIMEOUT_FLAG "--timeout-ms"
+#define INPUT_SET_FLAG "--input-set"
+#define OUTPUT_DIR_FLAG "--output-dir"
+#define LINES_FLAG "--lines"
+#define PROFILE_FLAG "--profile"
+#define DEBUG_FLAG "--debug"
+#define RECORD_FLAG "--record"
+#define SYMBOLS_FLAG "--symbols"
+
+// local includes //
+#include "sim.h"
+#include "scoff_reader.h"
+#include "sim_batch.h"
+#include "lines.h"
+#include "profile.h"
+#include "debugger.h"
+
+// Function declarations //
+
+/**
+ * @brief printUsage is a function that prints how the program is meant to be called to stderr. The function returns nothing.
+ *
+ * @param  programName - argv[0]
+ * @return void
+*/
+void printUsage(const char* programName);
+
+/**
+ * @brief parseDevice is a function that splits a device mapping of the form XX=path, where XX is the device number in hex.
+ *
+ * @param  arg    - The mapping
+ * @param  number - Set to the device number
+ * @return the path, or NULL if the mapping is not of that form
+*/
+static const char* parseDevice(const char* arg, uint8_t* number)
+{
+	char* end = NULL;
+	unsigned long value = strtoul(arg, &end, 16);
+	if (end == arg || *end != '=' || end[1] == '\0' || value >= DEVICE_COUNT) return NULL;
+	*number = (uint8_t)value;
+	return end + 1;
+}
+
+/**
+ * @brief mapDevices is a function that maps the files of the --input and --output arguments to the devices of the machine.
+ *
+ * @param  machine - The machine
+ * @param  argc    - number of arguments
+ * @param  argv    - array of arguments, already checked by main
+ * @return 1 if every file was opened, 0 if not
+*/
+static uint8_t mapDevices(sic_machine* machine, int argc, char** argv)
+{
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		uint8_t writing = strcmp(argv[i], OUTPUT_FLAG) == 0;
+		if (!writing && strcmp(argv[i], INPUT_FLAG) != 0) continue;
+
+		uint8_t number;
+		const char* path = parseDevice(argv[++i], &number);
+		if (!mapDevice(machine->devices, number, path, writing)) return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief runBatch is a function that runs every object with every input set on a pool of workers and prints a table of the runs.
+ *
+ * @param  isa             - The opcode to handler table
+ * @param  paths           - The objects, or directories of objects
+ * @param  numPaths        - The number of paths
+ * @param  inputSets       - The input files
+ * @param  numInputSets    - The number of input files, 0 to run every object once reading nothing
+ * @param  numWorkers      - The number of runs at once, 0 for one per CPU
+ * @param  maxInstructions - The most instructions of a run, 0 for no limit
+ * @param  timeoutMs       - The longest a run may take, 0 for no limit
+ * @param  fuse            - 1 to use superinstructions
+ * @param  throttle        - How many times TD answers busy before it answers ready
+ * @param  outputDir       - Where the output of each run is written, or NULL to throw it away
+ * @return 0 if every run halted or returned, 1 if not
+*/
+static int runBatch(const sim_isa* isa, const char** paths, uint32_t numPaths, const char** inputSets, uint32_t numInputSets,
+	uint32_t numWorkers, uint64_t maxInstructions, uint64_t timeoutMs, uint8_t fuse, uint32_t throttle, const char* outputDir)
+{
+	sim_batch* batch = createSimBatch(isa, numWorkers);
+	if (!batch) return 1;
+
+	batch->maxInstructions = maxInstructions;
+	batch->timeoutNs = timeoutMs * 1000000ULL;
+	batch->fuse = fuse;
+	batch->throttle = throttle;
+	batch->outputDir = outputDir;
+	for (uint32_t i = 0; i < numPaths; i++)
+	{
+		if (!simBatchAddPath(batch, paths[i]))
+		{
+			freeSimBatch(batch);
+			return 1;
+		}
+	}
+
+	int returnCode = simBatchAddJobs(batch, inputSets, numInputSets) ? runSimBatch(batch) : 1;
+	freeSimBatch(batch);
+	return returnCode;
+}
+
+/**
+ * @brief nowNs is a function that returns the monotonic time in nanoseconds.
+ *
+ * @param  void
+ * @return the time in nanoseconds
+*/
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief printMachine is a function that prints how the run ended, the registers, and how fast it ran to stderr, since stdout is where
+ * the devices write by default.
+ *
+ * @param  machine   - The machine after the run
+ * @param  elapsedNs - How long the run took
+ * @return void
+*/
+static void printMachine(const sic_machine* machine, uint64_t elapsedNs)
+{
+	double seconds = elapsedNs / 1e9;
+	fprintf(stderr, "[INFO]: Stopped with %s at PC %06X after %" PRIu64 " instructions in %.3f ms (%.1f million instructions/sec).\n",
+		simStatusName(machine->status), machine->PC, machine->instructions, elapsedNs / 1e6,
+		(seconds > 0) ? machine->instructions / seconds / 1e6 : 0.0);
+	fprintf(stderr, "[INFO]: A=%06X X=%06X L=%06X SW=%06X, %" PRIu64 " instructions decoded.\n", machine->A, machine->X, machine->L,
+		machine->SW, machine->decodes);
+}
+
+/**
+ * @brief the main function is the entry point of the simulator. It loads the object, which may be a text object, a binary object or a
+ * memory image, and runs it on a SIC machine. Its devices read stdin and write stdout unless files are mapped to them. With --batch it
+ * runs many objects, or one object with many inputs, at once. With --debug it reads debugger commands from the file, or stdin for -, and runs
+ * the program as they say. With --record it writes a trace of the run which sicreplay can step through.
+ *
+ * @param  argc - number of arguments
+ * @param  argv - array of arguments
+ * @return 0 if the program halted or returned, 1 if it faulted, hit the instruction limit, could not be loaded, or its output could not
+ * be written
+*/
+int main(int argc, char** argv)
+{
+	const char* objectPath = NULL;
+	uint64_t maxInstructions = 0;
+	uint8_t statsMode = 0;
+	uint8_t fuse = 1;
+	uint32_t throttle = 0;
+	uint8_t number;
+	uint8_t batchMode = 0;
+	uint8_t mapsDevices = 0;
+	uint32_t numWorkers = 0;
+	uint64_t timeoutMs = 0;
+	const char* outputDir = NULL;
+	const char* linesPath = NULL;
+	const char* foldedPath = NULL;
+	const char* debugPath = NULL;
+	const char* recordPath = NULL;
+	const char* symbolsPath = NULL;
+
+	// the objects and input sets of a batch, there are fewer of each than arguments
+	const char** paths = (const char**)malloc(argc * sizeof(const char*));
+	const char** inputSets = (const char**)malloc(argc * sizeof(const char*));
+	uint32_t numPaths = 0, numInputSets = 0;
+	if (!paths || !inputSets)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the arguments.\n");
+		free(paths);
+		free(inputSets);
+		return 1;
+	}
+
+	// parse the arguments
+	uint8_t badArgs = 0;
+	for (int i = 1; i < argc && !badArgs; i++)
+	{
+		if (strcmp(argv[i], MAX_FLAG) == 0 && i + 1 < argc)
+			maxInstructions = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], STATS_FLAG) == 0)
+			statsMode = 1;
+		else if (strcmp(argv[i], NO_FUSE_FLAG) == 0)
+			fuse = 0;
+		else if ((strcmp(argv[i], INPUT_FLAG) == 0 || strcmp(argv[i], OUTPUT_FLAG) == 0) && i + 1 < argc)
+		{
+			badArgs = !parseDevice(argv[++i], &number);
+			mapsDevices = 1;
+		}
+		else if (strcmp(argv[i], THROTTLE_FLAG) == 0 && i + 1 < argc)
+			throttle = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], BATCH_FLAG) == 0)
+			batchMode = 1;
+		else if (strcmp(argv[i], JOBS_FLAG) == 0 && i + 1 < argc)
+			numWorkers = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], TIMEOUT_FLAG) == 0 && i + 1 < argc)
+			timeoutMs = strtoull(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], INPUT_SET_FLAG) == 0 && i + 1 < argc)
+			inputSets[numInputSets++] = argv[++i];
+		else if (strcmp(argv[i], OUTPUT_DIR_FLAG) == 0 && i + 1 < argc)
+			outputDir = argv[++i];
+		else if (strcmp(argv[i], LINES_FLAG) == 0 && i + 1 < argc)
+			linesPath = argv[++i];
+		else if (strcmp(argv[i], PROFILE_FLAG) == 0 && i + 1 < argc)
+			foldedPath = argv[++i];
+		else if (strcmp(argv[i], DEBUG_FLAG) == 0 && i + 1 < argc)
+			debugPath = argv[++i];
+		else if (strcmp(argv[i], RECORD_FLAG) == 0 && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (strcmp(argv[i], SYMBOLS_FLAG) == 0 && i + 1 < argc)
+			symbolsPath = argv[++i];
+		else if (argv[i][0] != '-')
+			paths[numPaths++] = argv[i];
+		else
+			badArgs = 1;
+	}
+
+	// a batch maps the same input and output to every device of a run, and a single run takes one object
+	// a debugged run stops and starts again, so it is not recorded
+	if (batchMode) badArgs |= mapsDevices || numPaths == 0 || linesPath || foldedPath || debugPath || recordPath || symbolsPath;
+	else badArgs |= numPaths != 1 || numInputSets > 0 || outputDir || timeoutMs || numWorkers || (debugPath && recordPath);
+	if (badArgs)
+	{
+		printUsage(argv[0]);
+		free(paths);
+		free(inputSets);
+		return 1;
+	}
+	objectPath = paths[0];
+
+	// the handlers are bound to the opcodes of the opcode table
+	hash_table* opTab = buildOpcodeTable();
+	sim_isa* isa = opTab ? createSimIsa(opTab) : NULL;
+	freeHashTableAndValues(opTab);
+	if (!isa)
+	{
+		free(paths);
+		free(inputSets);
+		return 1;
+	}
+
+	if (batchMode)
+	{
+		int returnCode = runBatch(isa, paths, numPaths, inputSets, numInputSets, numWorkers, maxInstructions, timeoutMs, fuse, throttle,
+			outputDir);
+		free(paths);
+		free(inputSets);
+		sicFree(ALLOC_OTHER, isa);
+		return returnCode;
+	}
+	free(inputSets);
+
+	scoff_object* object = mapObjectFile(objectPath);
+	sic_image* image = object ? readObjectToImage(object) : NULL;
+	unmapObjectFile(object);
+	free(paths);
+	sic_machine* machine = image ? createMachine(isa) : NULL;
+	if (!machine || !loadMachine(machine, image) || !mapDevices(machine, argc, argv))
+	{
+		freeMachine(machine);
+		freeImage(image);
+		sicFree(ALLOC_OTHER, isa);
+		return 1;
+	}
+	freeImage(image);
+	machine->fuse = fuse;
+	machine->devices->throttle = throttle;
+
+	// the line table is used by the fault message and the profile, a bad one is reported before the run
+	sic_line_table* lineTable = NULL;
+	if (linesPath)
+	{
+		scoff_object* linesFile = mapObjectFile(linesPath);
+		lineTable = linesFile ? readLineTable((const uint8_t*)linesFile->text, linesFile->len) : NULL;
+		unmapObjectFile(linesFile);
+	}
+
+	// the symbol map names the routines of the profile, and is read where it is mapped so it stays mapped for the run
+	scoff_object* symbolsFile = symbolsPath ? mapObjectFile(symbolsPath) : NULL;
+	sic_symbol_map* symbols = symbolsFile ? openSymbolMap((const uint8_t*)symbolsFile->text, symbolsFile->len) : NULL;
+
+	if (foldedPath) machine->profile = createProfile();
+	if (recordPath)
+	{
+		sim_registers registers = { machine->A, machine->X, machine->L, machine->SW, machine->PC };
+		machine->record = createRecord(recordPath, machine->memory, &registers, machine->instructions);
+	}
+	if ((linesPath && !lineTable) || (symbolsPath && !symbols) || (foldedPath && !machine->profile) || (recordPath && !machine->record))
+	{
+		freeLineTable(lineTable);
+		freeSymbolMap(symbols);
+		unmapObjectFile(symbolsFile);
+		freeProfile(machine->profile);
+		freeRecord(machine->record);
+		freeMachine(machine);
+		sicFree(ALLOC_OTHER, isa);
+		return 1;
+	}
+
+	// the debugger takes its commands from a file, or from stdin, which the devices then should not read
+	FILE* debugFile = NULL;
+	if (debugPath)
+	{
+		debugFile = (strcmp(debugPath, "-") == 0) ? stdin : fopen(debugPath, "r");
+		if (!debugFile)
+		{
+			fprintf(stderr, "[ERROR]: Could not open the debugger commands \"%s\".\n", debugPath);
+			freeLineTable(lineTable);
+			freeSymbolMap(symbols);
+			unmapObjectFile(symbolsFile);
+			freeProfile(machine->profile);
+			freeRecord(machine->record);
+			freeMachine(machine);
+			sicFree(ALLOC_OTHER, isa);
+			return 1;
+		}
+	}
+
+	uint64_t startNs = nowNs();
+	sim_status status = debugFile ? runDebugger(machine, lineTable, maxInstructions, debugFile, stderr) : runMachine(machine, maxInstructions);
+	uint64_t elapsedNs = nowNs() - startNs;
+	if (debugFile && debugFile != stdin) fclose(debugFile);
+	uint8_t written = flushDevices(machine->devices);
+
+	uint32_t line = lineTable ? findLine(lineTable, machine->PC) : LINES_NO_LINE;
+	if (status > SIM_LIMIT && line != LINES_NO_LINE)
+		fprintf(stderr, "[ERROR : %u]: The program stopped at PC %06X (address %06X) with the fault: %s.\n", line, machine->PC,
+			machine->faultAddress, simStatusName(status));
+	else if (status > SIM_LIMIT)
+		fprintf(stderr, "[ERROR]: The program stopped at PC %06X (address %06X) with the fault: %s.\n", machine->PC, machine->faultAddress,
+			simStatusName(status));
+	else if (status == SIM_LIMIT)
+		fprintf(stderr, "[WARN]: The program was stopped after %" PRIu64 " instructions.\n", machine->instructions);
+	if (statsMode)
+	{
+		printMachine(machine, elapsedNs);
+		printDeviceStats(machine->devices, stderr);
+	}
+
+	if (machine->profile)
+	{
+		printHotLines(machine->profile, lineTable, PROFILE_TOP_LINES, stderr);
+		if (writeFoldedStacks(machine->profile, lineTable, symbols, foldedPath) == NULL) written = 0;
+	}
+
+	if (machine->record && finishRecord(machine->record) == NULL) written = 0;
+
+	int returnCode = ((status == SIM_HALTED || status == SIM_RETURNED) && written) ? 0 : 1;
+	freeProfile(machine->profile);
+	freeRecord(machine->record);
+	freeLineTable(lineTable);
+	freeSymbolMap(symbols);
+	unmapObjectFile(symbolsFile);
+	freeMachine(machine);
+	sicFree(ALLOC_OTHER, isa);
+	return returnCode;
+}
+
+void printUsage(const char* programName)
+{
+	fprintf(stderr, "[ERROR]: Please enter the object file to run.\n");
+	fprintf(stderr, "Usage: %s [%s <count>] [%s] [%s] [%s <dev>=<file>]... [%s <dev>=<file>]... [%s <count>] [%s <prog.lines>]\n"
+		"\t[%s <out.folded>] [%s <prog.syms>] [%s <commands | -> | %s <out.trace>] <prog.obj | prog.sbo | prog.img>\n", programName, MAX_FLAG,
+		STATS_FLAG, NO_FUSE_FLAG, INPUT_FLAG, OUTPUT_FLAG, THROTTLE_FLAG, LINES_FLAG, PROFILE_FLAG, SYMBOLS_FLAG, DEBUG_FLAG, RECORD_FLAG);
+	fprintf(stderr, "       %s %s [%s <num workers>] [%s <count>] [%s <ms>] [%s <file>]... [%s <dir>] [%s] [%s <count>]\n"
+		"\t<prog.obj | dir>...\n", programName, BATCH_FLAG, JOBS_FLAG, MAX_FLAG, TIMEOUT_FLAG, INPUT_SET_FLAG, OUTPUT_DIR_FLAG, NO_FUSE_FLAG,
+		THROTTLE_FLAG);
+}
@@ -0,0 +1,850 @@
+#include "sim.h"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <linux/memfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+// the instructions the simulator has handlers for, which are the SIC instructions without the XE ones
+static const struct
+{
+	const char* mnemonic;
+	sim_op op;
+
+} simHandlers[] = {
+	{ "ADD", SIM_OP_ADD }, { "AND", SIM_OP_AND }, { "COMP", SIM_OP_COMP }, { "DIV", SIM_OP_DIV }, { "J", SIM_OP_J },
+	{ "JEQ", SIM_OP_JEQ }, { "JGT", SIM_OP_JGT }, { "JLT", SIM_OP_JLT }, { "JSUB", SIM_OP_JSUB }, { "LDA", SIM_OP_LDA },
+	{ "LDCH", SIM_OP_LDCH }, { "LDL", SIM_OP_LDL }, { "LDX", SIM_OP_LDX }, { "MUL", SIM_OP_MUL }, { "OR", SIM_OP_OR },
+	{ "RD", SIM_OP_RD }, { "RSUB", SIM_OP_RSUB }, { "STA", SIM_OP_STA }, { "STCH", SIM_OP_STCH }, { "STL", SIM_OP_STL },
+	{ "STSW", SIM_OP_STSW }, { "STX", SIM_OP_STX }, { "SUB", SIM_OP_SUB }, { "TD", SIM_OP_TD }, { "TIX", SIM_OP_TIX },
+	{ "WD", SIM_OP_WD }
+};
+
+// the superinstructions and the sequences they stand for, picked from the loops SIC programs are made of: a running total, the TIX and
+// JLT which close a counting loop, and a compare followed by a branch
+static const struct
+{
+	sim_op ops[SIM_FUSE_MAX_INSTRUCTIONS];
+	uint8_t count;
+	sim_op fused;
+
+} simFusions[] = {
+	{ { SIM_OP_LDA, SIM_OP_ADD, SIM_OP_STA }, 3, SIM_OP_LDA_ADD_STA },
+	{ { SIM_OP_LDA, SIM_OP_SUB, SIM_OP_STA }, 3, SIM_OP_LDA_SUB_STA },
+	{ { SIM_OP_TIX, SIM_OP_JLT }, 2, SIM_OP_TIX_JLT },
+	{ { SIM_OP_COMP, SIM_OP_JEQ }, 2, SIM_OP_COMP_JEQ },
+	{ { SIM_OP_COMP, SIM_OP_JGT }, 2, SIM_OP_COMP_JGT },
+	{ { SIM_OP_COMP, SIM_OP_JLT }, 2, SIM_OP_COMP_JLT }
+};
+
+// the bytes each instruction reads or writes at its target, and which kind of access that is, for the watchpoints and the stores of
+// a recorded run
+static const struct
+{
+	uint8_t bytes;
+	uint8_t kind;
+
+} simAccess[SIM_NUM_OPS] = {
+	[SIM_OP_ADD] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_AND] = { SIC_WORD_BYTES, SIM_WATCH_READ },
+	[SIM_OP_COMP] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_DIV] = { SIC_WORD_BYTES, SIM_WATCH_READ },
+	[SIM_OP_LDA] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_LDL] = { SIC_WORD_BYTES, SIM_WATCH_READ },
+	[SIM_OP_LDX] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_MUL] = { SIC_WORD_BYTES, SIM_WATCH_READ },
+	[SIM_OP_OR] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_SUB] = { SIC_WORD_BYTES, SIM_WATCH_READ },
+	[SIM_OP_TIX] = { SIC_WORD_BYTES, SIM_WATCH_READ }, [SIM_OP_LDCH] = { SIC_BYTE, SIM_WATCH_READ },
+	[SIM_OP_RD] = { SIC_BYTE, SIM_WATCH_READ }, [SIM_OP_TD] = { SIC_BYTE, SIM_WATCH_READ }, [SIM_OP_WD] = { SIC_BYTE, SIM_WATCH_READ },
+	[SIM_OP_STA] = { SIC_WORD_BYTES, SIM_WATCH_WRITE }, [SIM_OP_STL] = { SIC_WORD_BYTES, SIM_WATCH_WRITE },
+	[SIM_OP_STSW] = { SIC_WORD_BYTES, SIM_WATCH_WRITE }, [SIM_OP_STX] = { SIC_WORD_BYTES, SIM_WATCH_WRITE },
+	[SIM_OP_STCH] = { SIC_BYTE, SIM_WATCH_WRITE }
+};
+
+sim_isa* createSimIsa(const hash_table* opTab)
+{
+	sim_isa* isa = (sim_isa*)sicMalloc(ALLOC_OTHER, sizeof(sim_isa));
+	if (!isa)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the opcode table of the simulator.\n");
+		return NULL;
+	}
+	memset(isa->opOf, SIM_OP_ILLEGAL, sizeof(isa->opOf));
+
+	for (uint32_t i = 0; i < sizeof(simHandlers) / sizeof(simHandlers[0]); i++)
+	{
+		const sic_optable_values* value = (const sic_optable_values*)getKVPair(opTab, simHandlers[i].mnemonic);
+		if (!value || (value->flags & OP_FLAG_XE_ONLY))
+		{
+			fprintf(stderr, "[ERROR]: The instruction \"%s\" is not a SIC instruction in the opcode table.\n", simHandlers[i].mnemonic);
+			sicFree(ALLOC_OTHER, isa);
+			return NULL;
+		}
+		isa->opOf[value->opcode] = (uint8_t)simHandlers[i].op;
+	}
+
+	return isa;
+}
+
+sic_machine* createMachine(const sim_isa* isa)
+{
+	sic_machine* machine = (sic_machine*)sicCalloc(ALLOC_OTHER, 1, sizeof(sic_machine));
+	if (!machine)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the simulated machine.\n");
+		return NULL;
+	}
+	machine->isa = isa;
+	machine->fuse = 1;
+	machine->devices = createDevices();
+	if (!machine->devices)
+	{
+		sicFree(ALLOC_OTHER, machine);
+		return NULL;
+	}
+
+	return machine;
+}
+
+void freeMachine(sic_machine* machine)
+{
+	if (!machine) return;
+
+	freeDevices(machine->devices);
+	sicFree(ALLOC_OTHER, machine->debug);
+	if (machine->mapped) munmap(machine, sizeof(sic_machine));
+	else sicFree(ALLOC_OTHER, machine);
+}
+
+sic_machine* loadMachine(sic_machine* machine, const sic_image* image)
+{
+	if ((uint64_t)image->startAddress + image->length > SIM_MEMORY_SIZE)
+	{
+		fprintf(stderr, "[ERROR]: The program at %06X is %u bytes long and does not fit in the %d bytes of SIC memory.\n",
+			image->startAddress, image->length, SIM_MEMORY_SIZE);
+		return NULL;
+	}
+
+	memset(machine->memory, 0, sizeof(machine->memory));
+	memset(machine->decoded, 0, sizeof(machine->decoded));
+	memcpy(machine->memory + image->startAddress, image->bytes, image->length);
+
+	machine->A = machine->X = 0;
+	machine->SW = SIM_CC_EQUAL;
+	machine->L = SIM_RETURN_ADDRESS;
+	machine->PC = image->entryPoint;
+	machine->instructions = machine->decodes = 0;
+	machine->status = SIM_RUNNING;
+	machine->faultAddress = 0;
+	return machine;
+}
+
+/**
+ * @brief loadWord is a function that loads the word at the address with one 4 byte read. The pad byte after memory keeps the read of
+ * the last word inside the machine, and the fourth byte is shifted out.
+ *
+ * @param  memory - The memory of the machine
+ * @param  at     - The address of the word
+ * @return the word
+*/
+static inline uint32_t loadWord(const uint8_t* memory, uint32_t at)
+{
+	uint32_t bytes;
+	memcpy(&bytes, memory + at, sizeof(bytes));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	bytes = __builtin_bswap32(bytes);
+#endif
+	return bytes >> 8;
+}
+
+/**
+ * @brief storeWord is a function that stores the word at the address with one 4 byte read and write which leaves the fourth byte as it
+ * was. A word stored this way can be forwarded to the 4 byte read of loadWord(), which 3 byte stores can't.
+ *
+ * @param  memory - The memory of the machine
+ * @param  at     - The address of the word
+ * @param  word   - The word to store
+ * @return void
+*/
+static inline void storeWord(uint8_t* memory, uint32_t at, uint32_t word)
+{
+	uint32_t bytes;
+	memcpy(&bytes, memory + at, sizeof(bytes));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	bytes = (bytes & 0xFF000000u) | __builtin_bswap32(word << 8);
+#else
+	bytes = (bytes & 0xFFu) | (word << 8);
+#endif
+	memcpy(memory + at, &bytes, sizeof(bytes));
+}
+
+/**
+ * @brief invalidate is a function that clears the entries of every instruction which could overlap the bytes a store wrote, so they
+ * are decoded again before they run. The entries start SIM_FUSE_MAX_BYTES - 1 before the store, since a superinstruction is cleared
+ * with the entry of its first instruction, and the guard entries before address 0 keep them inside the machine.
+ *
+ * @param  decoded - The entries of the machine, from address 0
+ * @param  at      - The address of the store
+ * @param  len     - The number of bytes stored
+ * @return void
+*/
+static inline void invalidate(sim_decoded* decoded, uint32_t at, uint32_t len)
+{
+	// the offset is taken on the pointer, the address minus the guard would wrap around below address SIM_FUSE_MAX_BYTES - 1
+	sim_decoded* first = decoded + at - (SIM_FUSE_MAX_BYTES - 1);
+#pragma GCC unroll 16
+	for (uint32_t i = 0; i < len + SIM_FUSE_MAX_BYTES - 1; i++)
+		first[i].op = SIM_OP_DECODE;
+}
+
+/**
+ * @brief decodeEntry is a function that decodes the instruction at the address into its entry.
+ *
+ * @param  memory  - The memory of the machine
+ * @param  opOf    - The opcode to handler table
+ * @param  at      - The address of the instruction, which must fit in memory
+ * @param  entry   - The entry of the address
+ * @return void
+*/
+static inline void decodeEntry(const uint8_t* memory, const uint8_t* opOf, uint32_t at, sim_decoded* entry)
+{
+	uint32_t operand = ((uint32_t)memory[at + 1] << 8) | memory[at + 2];
+	entry->op = opOf[memory[at]];
+	entry->indexed = (operand & SCOFF_INDEXED_BIT) != 0;
+	entry->addr = (uint16_t)(operand & SIM_ADDRESS_MASK);
+}
+
+/**
+ * @brief watchHit is a function that checks if an access of the kind to the bytes from the address touches a watched byte. Only the
+ * bytes of a flagged page are looked at.
+ *
+ * @param  debug - The debug state of the machine
+ * @param  at    - The first byte accessed, inside memory
+ * @param  len   - The number of bytes accessed
+ * @param  kind  - SIM_WATCH_READ or SIM_WATCH_WRITE
+ * @param  hitAt - Set to the watched byte
+ * @return 1 if the access hits a watchpoint, 0 if not
+*/
+static inline uint8_t watchHit(const sim_debug* debug, uint32_t at, uint32_t len, uint8_t kind, uint32_t* hitAt)
+{
+	uint32_t first = at >> SIM_WATCH_PAGE_BITS, last = (at + len - 1) >> SIM_WATCH_PAGE_BITS;
+	if (!((debug->watchPages[first / 64] >> (first % 64)) & 1) && !((debug->watchPages[last / 64] >> (last % 64)) & 1)) return 0;
+
+	for (uint32_t i = 0; i < len; i++)
+	{
+		if (!(debug->watches[at + i] & kind)) continue;
+		*hitAt = at + i;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief fuseEntry is a function that turns the freshly decoded entry at the address into a superinstruction when it starts one of the
+ * sequences of simFusions. The entries of the rest of the sequence are decoded as well if they are not, since the superinstruction reads
+ * their operands. The function returns nothing.
+ *
+ * @param  memory      - The memory of the machine
+ * @param  opOf        - The opcode to handler table
+ * @param  decoded     - The entries of the machine, from address 0
+ * @param  at          - The address of the decoded instruction
+ * @param  decodes     - Counts the instructions decoded
+ * @param  breakpoints - The breakpoint of every address, or NULL if there are none
+ * @return void
+*/
+static void fuseEntry(const uint8_t* memory, const uint8_t* opOf, sim_decoded* decoded, uint32_t at, uint64_t* decodes,
+	const uint8_t* breakpoints)
+{
+	for (uint32_t i = 0; i < sizeof(simFusions) / sizeof(simFusions[0]); i++)
+	{
+		uint32_t count = simFusions[i].count;
+		if (decoded[at].op != simFusions[i].ops[0] || at + count * SIM_INSTRUCTION_BYTES > SIM_MEMORY_SIZE) continue;
+
+		uint32_t matched = 1;
+		while (matched < count && opOf[memory[at + matched * SIM_INSTRUCTION_BYTES]] == simFusions[i].ops[matched]) matched++;
+		if (matched < count) continue;
+
+		// the run has to stop at a breakpoint inside the sequence, so the sequence is left as it is
+		for (uint32_t k = 1; breakpoints && k < count; k++)
+			if (breakpoints[at + k * SIM_INSTRUCTION_BYTES]) return;
+
+		for (uint32_t k = 1; k < count; k++)
+		{
+			sim_decoded* next = &decoded[at + k * SIM_INSTRUCTION_BYTES];
+			if (next->op != SIM_OP_DECODE) continue;
+			decodeEntry(memory, opOf, at + k * SIM_INSTRUCTION_BYTES, next);
+			(*decodes)++;
+		}
+		decoded[at].op = (uint8_t)simFusions[i].fused;
+		return;
+	}
+}
+
+// A word is 3 bytes, big endian, and is signed when it is compared, multiplied or divided
+#define LOAD_WORD(at) loadWord(memory, at)
+#define STORE_WORD(at, value) storeWord(memory, at, value)
+#define SIGNED_WORD(value) ((int32_t)((uint32_t)(value) << 8) >> 8)
+#define COMPARE(a, b) ((SIGNED_WORD(a) < SIGNED_WORD(b)) ? SIM_CC_LESS : (SIGNED_WORD(a) == SIGNED_WORD(b)) ? SIM_CC_EQUAL : SIM_CC_GREATER)
+
+sim_status runMachine(sic_machine* machine, uint64_t maxInstructions)
+{
+	// the handlers in the order of sim_op
+	__extension__ static void* const handlers[SIM_NUM_OPS] = {
+		&&op_decode, &&op_illegal, &&op_add, &&op_and, &&op_comp, &&op_div, &&op_j, &&op_jeq, &&op_jgt, &&op_jlt, &&op_jsub,
+		&&op_lda, &&op_ldch, &&op_ldl, &&op_ldx, &&op_mul, &&op_or, &&op_rd, &&op_rsub, &&op_sta, &&op_stch, &&op_stl,
+		&&op_stsw, &&op_stx, &&op_sub, &&op_td, &&op_tix, &&op_wd,
+		&&op_lda_add_sta, &&op_lda_sub_sta, &&op_tix_jlt, &&op_comp_jeq, &&op_comp_jgt, &&op_comp_jlt, &&op_break
+	};
+
+	// a profiled run dispatches every decoded instruction through a handler which counts it first
+	__extension__ static void* const profileHandlers[SIM_NUM_OPS] = {
+		&&op_decode, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile,
+		&&op_profile, &&op_profile_jsub, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile,
+		&&op_profile_rsub, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile,
+		&&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_profile, &&op_break
+	};
+
+	// a run with watched bytes dispatches every decoded instruction through a handler which checks its access first
+	__extension__ static void* const watchHandlers[SIM_NUM_OPS] = {
+		&&op_decode, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch,
+		&&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch,
+		&&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_watch,
+		&&op_watch, &&op_watch, &&op_watch, &&op_watch, &&op_break
+	};
+
+	// a recorded run dispatches every decoded instruction through a handler which records it first
+	__extension__ static void* const recordHandlers[SIM_NUM_OPS] = {
+		&&op_decode, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record,
+		&&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record,
+		&&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record, &&op_record,
+		&&op_record, &&op_record, &&op_record, &&op_record, &&op_break
+	};
+
+	// the registers live in locals while running so the compiler can keep them in host registers
+	uint8_t* memory = machine->memory;
+	sim_decoded* decoded = machine->decoded + SIM_DECODE_GUARD;
+	const uint8_t* opOf = machine->isa->opOf;
+	sim_profile* profile = machine->profile;
+	sim_debug* debug = machine->debug;
+	const uint8_t* breakpoints = (debug && debug->numBreakpoints) ? debug->breakpoints : NULL;
+	uint8_t watching = debug && debug->numWatched;
+	uint8_t resuming = debug && debug->stopped;
+	void* const* run = profile ? profileHandlers : handlers;
+	void* const* dispatch = watching ? watchHandlers : machine->record ? recordHandlers : run;
+	uint8_t fuse = machine->fuse && !profile && !watching && !machine->record;
+	uint32_t A = machine->A, X = machine->X, L = machine->L, SW = machine->SW, pc = machine->PC;
+	uint64_t budget = maxInstructions ? maxInstructions : UINT64_MAX;
+	uint64_t remaining = budget;
+	uint64_t decodes = 0;
+	const sim_decoded* entry = NULL;
+	uint32_t target = 0;
+	sim_status status = SIM_RUNNING;
+
+	// the target of an instruction, and the checks that it stays inside memory
+#define ENTRY_TARGET(of) ((of)->addr + (X & (0 - (uint32_t)(of)->indexed)))
+#define TARGET() ENTRY_TARGET(entry)
+#define CHECK_WORD(at) do { if (__builtin_expect((at) > SIM_MEMORY_SIZE - SIC_WORD_BYTES, 0)) goto memory_fault; } while (0)
+#define CHECK_BYTE(at) do { if (__builtin_expect((at) > SIM_MEMORY_SIZE - 1, 0)) goto memory_fault; } while (0)
+
+	// a store clears the entries of every instruction which could overlap the bytes written
+#define INVALIDATE(at, len) invalidate(decoded, at, len)
+
+#define JUMP(to) do { if (__builtin_expect((to) > SIM_MEMORY_SIZE - 1, 0)) { target = (to); goto jump_fault; } pc = (to); } while (0)
+
+#define DISPATCH() do { if (__builtin_expect(remaining == 0, 0)) goto out_of_budget; remaining--; entry = &decoded[pc]; \
+	pc += SIM_INSTRUCTION_BYTES; __extension__ ({ goto *dispatch[entry->op]; }); } while (0)
+
+	if (pc > SIM_MEMORY_SIZE - 1)
+	{
+		target = pc;
+		goto jump_fault;
+	}
+	DISPATCH();
+
+op_decode:
+	{
+		// an instruction which would run off the end of memory is a PC fault, so the entries past the end stay undecoded
+		uint32_t at = pc - SIM_INSTRUCTION_BYTES;
+		if (at > SIM_MEMORY_SIZE - SIM_INSTRUCTION_BYTES) goto pc_fault;
+
+		sim_decoded* fresh = &decoded[at];
+		decodeEntry(memory, opOf, at, fresh);
+		decodes++;
+		if (fuse) fuseEntry(memory, opOf, decoded, at, &decodes, breakpoints);
+		if (breakpoints && breakpoints[at]) fresh->op = SIM_OP_BREAK;
+		entry = fresh;
+		__extension__ ({ goto *dispatch[entry->op]; });
+	}
+
+	// the trap of a breakpoint stops the run before its instruction, unless the run is carrying on from there, in which case the
+	// instruction the trap took the place of is run
+op_break:
+	if (resuming && remaining == budget - 1) __extension__ ({ goto *run[opOf[memory[pc - SIM_INSTRUCTION_BYTES]]]; });
+	status = SIM_BREAKPOINT;
+	target = pc - SIM_INSTRUCTION_BYTES;
+	goto undo;
+
+	// an instruction which would touch a watched byte stops the run before it changes anything
+op_watch:
+	if (simAccess[entry->op].bytes && !(resuming && remaining == budget - 1))
+	{
+		uint32_t at = TARGET();
+		if (at + simAccess[entry->op].bytes <= (uint32_t)SIM_MEMORY_SIZE && watchHit(debug, at, simAccess[entry->op].bytes, simAccess[entry->op].kind,
+			&target))
+		{
+			status = SIM_WATCHPOINT;
+			debug->watchAddress = target;
+			debug->watchKind = simAccess[entry->op].kind;
+			goto undo;
+		}
+	}
+	__extension__ ({ goto *run[entry->op]; });
+
+	// the step of an instruction is started before it runs, with the bytes it stores, and finished when the next one is dispatched
+op_record:
+	{
+		sim_registers registers = { A, X, L, SW, pc - SIM_INSTRUCTION_BYTES };
+		uint8_t stores = (simAccess[entry->op].kind == SIM_WATCH_WRITE) ? simAccess[entry->op].bytes : 0;
+		recordStep(machine->record, &registers, memory, stores ? TARGET() : 0, stores);
+	}
+	__extension__ ({ goto *run[entry->op]; });
+
+	// the instructions of a profiled run are counted at their address, and JSUB and RSUB also move through the call tree
+op_profile:
+	profile->counts[pc - SIM_INSTRUCTION_BYTES]++;
+	__extension__ ({ goto *handlers[entry->op]; });
+
+op_profile_jsub:
+	profile->counts[pc - SIM_INSTRUCTION_BYTES]++;
+	profileCall(profile, ENTRY_TARGET(entry), machine->instructions + budget - remaining);
+	goto op_jsub;
+
+op_profile_rsub:
+	profile->counts[pc - SIM_INSTRUCTION_BYTES]++;
+	profileReturn(profile, machine->instructions + budget - remaining);
+	goto op_rsub;
+
+op_add:
+	target = TARGET();
+	CHECK_WORD(target);
+	A = (A + LOAD_WORD(target)) & SIC_WORD_MASK;
+	DISPATCH();
+
+op_sub:
+	target = TARGET();
+	CHECK_WORD(target);
+	A = (A - LOAD_WORD(target)) & SIC_WORD_MASK;
+	DISPATCH();
+
+op_mul:
+	target = TARGET();
+	CHECK_WORD(target);
+	A = (uint32_t)((int64_t)SIGNED_WORD(A) * SIGNED_WORD(LOAD_WORD(target))) & SIC_WORD_MASK;
+	DISPATCH();
+
+op_div:
+	{
+		target = TARGET();
+		CHECK_WORD(target);
+		int32_t divisor = SIGNED_WORD(LOAD_WORD(target));
+		if (__builtin_expect(divisor == 0, 0)) goto divide_fault;
+		A = (uint32_t)(SIGNED_WORD(A) / divisor) & SIC_WORD_MASK;
+		DISPATCH();
+	}
+
+op_and:
+	target = TARGET();
+	CHECK_WORD(target);
+	A &= LOAD_WORD(target);
+	DISPATCH();
+
+op_or:
+	target = TARGET();
+	CHECK_WORD(target);
+	A |= LOAD_WORD(target);
+	DISPATCH();
+
+op_comp:
+	target = TARGET();
+	CHECK_WORD(target);
+	SW = COMPARE(A, LOAD_WORD(target));
+	DISPATCH();
+
+op_tix:
+	target = TARGET();
+	CHECK_WORD(target);
+	X = (X + 1) & SIC_WORD_MASK;
+	SW = COMPARE(X, LOAD_WORD(target));
+	DISPATCH();
+
+op_j:
+	target = TARGET();
+	if (__builtin_expect(target == pc - SIM_INSTRUCTION_BYTES, 0)) goto halted;
+	JUMP(target);
+	DISPATCH();
+
+op_jeq:
+	target = TARGET();
+	if (SW == SIM_CC_EQUAL) JUMP(target);
+	DISPATCH();
+
+op_jgt:
+	target = TARGET();
+	if (SW == SIM_CC_GREATER) JUMP(target);
+	DISPATCH();
+
+op_jlt:
+	target = TARGET();
+	if (SW == SIM_CC_LESS) JUMP(target);
+	DISPATCH();
+
+op_jsub:
+	target = TARGET();
+	L = pc;
+	JUMP(target);
+	DISPATCH();
+
+op_rsub:
+	JUMP(L);
+	DISPATCH();
+
+op_lda:
+	target = TARGET();
+	CHECK_WORD(target);
+	A = LOAD_WORD(target);
+	DISPATCH();
+
+op_ldx:
+	target = TARGET();
+	CHECK_WORD(target);
+	X = LOAD_WORD(target);
+	DISPATCH();
+
+op_ldl:
+	target = TARGET();
+	CHECK_WORD(target);
+	L = LOAD_WORD(target);
+	DISPATCH();
+
+op_ldch:
+	target = TARGET();
+	CHECK_BYTE(target);
+	A = (A & ~0xFFu) | memory[target];
+	DISPATCH();
+
+op_sta:
+	target = TARGET();
+	CHECK_WORD(target);
+	STORE_WORD(target, A);
+	INVALIDATE(target, SIC_WORD_BYTES);
+	DISPATCH();
+
+op_stx:
+	target = TARGET();
+	CHECK_WORD(target);
+	STORE_WORD(target, X);
+	INVALIDATE(target, SIC_WORD_BYTES);
+	DISPATCH();
+
+op_stl:
+	target = TARGET();
+	CHECK_WORD(target);
+	STORE_WORD(target, L);
+	INVALIDATE(target, SIC_WORD_BYTES);
+	DISPATCH();
+
+op_stsw:
+	target = TARGET();
+	CHECK_WORD(target);
+	STORE_WORD(target, SW);
+	INVALIDATE(target, SIC_WORD_BYTES);
+	DISPATCH();
+
+op_stch:
+	target = TARGET();
+	CHECK_BYTE(target);
+	memory[target] = (uint8_t)A;
+	INVALIDATE(target, SIC_BYTE);
+	DISPATCH();
+
+op_rd:
+	{
+		target = TARGET();
+		CHECK_BYTE(target);
+		int byte = deviceRead(machine->devices, memory[target]);
+		A = (A & ~0xFFu) | (uint32_t)((byte == DEVICE_EOF) ? 0 : byte); // a zero byte is the end of the input, as in the SIC COPY program
+		DISPATCH();
+	}
+
+op_wd:
+	target = TARGET();
+	CHECK_BYTE(target);
+	deviceWrite(machine->devices, memory[target], (uint8_t)A);
+	DISPATCH();
+
+op_td:
+	target = TARGET();
+	CHECK_BYTE(target);
+	SW = deviceTest(machine->devices, memory[target]) ? SIM_CC_LESS : SIM_CC_EQUAL;
+	DISPATCH();
+
+	// the superinstructions, which check everything that could stop the sequence part way before changing any state, and run the first
+	// instruction on its own handler if anything could
+#define NEXT_ENTRY(n) (entry + (n) * SIM_INSTRUCTION_BYTES)
+
+op_lda_add_sta:
+op_lda_sub_sta:
+	{
+		uint32_t loadAt = TARGET(), operandAt = ENTRY_TARGET(NEXT_ENTRY(1)), storeAt = ENTRY_TARGET(NEXT_ENTRY(2));
+		if (__builtin_expect(remaining < 2 || loadAt > SIM_MEMORY_SIZE - SIC_WORD_BYTES || operandAt > SIM_MEMORY_SIZE - SIC_WORD_BYTES ||
+			storeAt > SIM_MEMORY_SIZE - SIC_WORD_BYTES, 0))
+			goto op_lda;
+		remaining -= 2;
+
+		uint32_t operand = LOAD_WORD(operandAt);
+		A = LOAD_WORD(loadAt) + ((entry->op == SIM_OP_LDA_ADD_STA) ? operand : 0 - operand);
+		A &= SIC_WORD_MASK;
+		STORE_WORD(storeAt, A);
+		INVALIDATE(storeAt, SIC_WORD_BYTES);
+		pc += 2 * SIM_INSTRUCTION_BYTES;
+		DISPATCH();
+	}
+
+op_tix_jlt:
+	{
+		// the branch target is taken with the X the TIX left
+		uint32_t limitAt = TARGET();
+		uint32_t nextX = (X + 1) & SIC_WORD_MASK;
+		const sim_decoded* branch = NEXT_ENTRY(1);
+		uint32_t branchTo = branch->addr + (nextX & (0 - (uint32_t)branch->indexed));
+		if (__builtin_expect(remaining < 1 || limitAt > SIM_MEMORY_SIZE - SIC_WORD_BYTES || branchTo > SIM_MEMORY_SIZE - 1, 0)) goto op_tix;
+		remaining--;
+
+		X = nextX;
+		SW = COMPARE(X, LOAD_WORD(limitAt));
+		pc = (SW == SIM_CC_LESS) ? branchTo : pc + SIM_INSTRUCTION_BYTES;
+		DISPATCH();
+	}
+
+op_comp_jeq:
+op_comp_jgt:
+op_comp_jlt:
+	{
+		uint32_t compareAt = TARGET(), branchTo = ENTRY_TARGET(NEXT_ENTRY(1));
+		if (__builtin_expect(remaining < 1 || compareAt > SIM_MEMORY_SIZE - SIC_WORD_BYTES || branchTo > SIM_MEMORY_SIZE - 1, 0)) goto op_comp;
+		remaining--;
+
+		static const uint8_t takenOn[] = { SIM_CC_EQUAL, SIM_CC_GREATER, SIM_CC_LESS };
+		SW = COMPARE(A, LOAD_WORD(compareAt));
+		pc = (SW == takenOn[entry->op - SIM_OP_COMP_JEQ]) ? branchTo : pc + SIM_INSTRUCTION_BYTES;
+		DISPATCH();
+	}
+
+	// the ways out of the loop, the instruction which stopped it is not counted unless it ran
+op_illegal:
+	status = SIM_ILLEGAL_INSTRUCTION;
+	target = pc - SIM_INSTRUCTION_BYTES;
+	goto uncount;
+pc_fault:
+	status = SIM_PC_FAULT;
+	target = pc - SIM_INSTRUCTION_BYTES;
+	goto undo;
+memory_fault:
+	status = SIM_MEMORY_FAULT;
+	goto uncount;
+divide_fault:
+	status = SIM_DIVIDE_BY_ZERO;
+	goto uncount;
+uncount:
+	// a profiled run counted the faulting instruction before it ran, while an instruction which can't be decoded was never counted
+	if (profile) profile->counts[pc - SIM_INSTRUCTION_BYTES]--;
+undo:
+	pc -= SIM_INSTRUCTION_BYTES;
+	remaining++;
+	goto done;
+halted:
+	pc -= SIM_INSTRUCTION_BYTES;
+	status = SIM_HALTED;
+	goto done;
+jump_fault:
+	status = (target == SIM_RETURN_ADDRESS) ? SIM_RETURNED : SIM_PC_FAULT;
+	pc = target;
+	goto done;
+out_of_budget:
+	status = SIM_LIMIT;
+done:
+	machine->A = A;
+	machine->X = X;
+	machine->L = L;
+	machine->SW = SW;
+	machine->PC = pc;
+	machine->instructions += budget - remaining;
+	machine->decodes += decodes;
+	machine->faultAddress = target;
+	machine->status = status;
+	if (profile) profileFlush(profile, machine->instructions);
+	if (machine->record)
+	{
+		sim_registers registers = { A, X, L, SW, pc };
+		recordStop(machine->record, &registers, memory, machine->instructions);
+	}
+	if (debug) debug->stopped = (status == SIM_BREAKPOINT || status == SIM_WATCHPOINT);
+	return status;
+
+#undef ENTRY_TARGET
+#undef TARGET
+#undef NEXT_ENTRY
+#undef CHECK_WORD
+#undef CHECK_BYTE
+#undef INVALIDATE
+#undef JUMP
+#undef DISPATCH
+}
+
+sic_machine* predecodeMachine(sic_machine* machine)
+{
+	sim_decoded* decoded = machine->decoded + SIM_DECODE_GUARD;
+	for (uint32_t at = 0; at <= SIM_MEMORY_SIZE - SIM_INSTRUCTION_BYTES; at++)
+	{
+		if (decoded[at].op != SIM_OP_DECODE) continue;
+		decodeEntry(machine->memory, machine->isa->opOf, at, &decoded[at]);
+		machine->decodes++;
+	}
+
+	// the sequences are found once every entry they could start with is decoded
+	if (machine->fuse)
+		for (uint32_t at = 0; at <= SIM_MEMORY_SIZE - SIM_INSTRUCTION_BYTES; at++)
+			fuseEntry(machine->memory, machine->isa->opOf, decoded, at, &machine->decodes,
+				(machine->debug && machine->debug->numBreakpoints) ? machine->debug->breakpoints : NULL);
+	return machine;
+}
+
+int saveMachineTemplate(const sic_machine* machine)
+{
+	int fd = (int)syscall(SYS_memfd_create, "sicsim", MFD_CLOEXEC);
+	if (fd < 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not create the shared copy of a machine: %s.\n", strerror(errno));
+		return -1;
+	}
+
+	const uint8_t* bytes = (const uint8_t*)machine;
+	size_t done = 0;
+	while (done < sizeof(sic_machine))
+	{
+		ssize_t written = write(fd, bytes + done, sizeof(sic_machine) - done);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0)
+		{
+			fprintf(stderr, "[ERROR]: Could not write the shared copy of a machine: %s.\n", strerror(errno));
+			close(fd);
+			return -1;
+		}
+		done += (size_t)written;
+	}
+	return fd;
+}
+
+sic_machine* createMachineFromTemplate(int templateFd)
+{
+	void* mapping = mmap(NULL, sizeof(sic_machine), PROT_READ | PROT_WRITE, MAP_PRIVATE, templateFd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "[ERROR]: Could not map the shared copy of a machine: %s.\n", strerror(errno));
+		return NULL;
+	}
+
+	// the first write to a page of the template gives the machine its own copy of that page
+	sic_machine* machine = (sic_machine*)mapping;
+	machine->mapped = 1;
+	machine->profile = NULL;
+	machine->debug = NULL;
+	machine->record = NULL;
+	machine->devices = createDevices();
+	if (!machine->devices)
+	{
+		munmap(mapping, sizeof(sic_machine));
+		return NULL;
+	}
+	return machine;
+}
+
+/**
+ * @brief debugOf is a function that returns the debug state of the machine, creating it the first time.
+ *
+ * @param  machine - The machine
+ * @return debug state or NULL on error
+*/
+static sim_debug* debugOf(sic_machine* machine)
+{
+	if (!machine->debug) machine->debug = (sim_debug*)sicCalloc(ALLOC_OTHER, 1, sizeof(sim_debug));
+	if (!machine->debug) fprintf(stderr, "[ERROR]: Could not malloc the breakpoints and watchpoints.\n");
+	return machine->debug;
+}
+
+sic_machine* setBreakpoint(sic_machine* machine, uint32_t address, uint8_t set)
+{
+	if (address >= SIM_MEMORY_SIZE)
+	{
+		fprintf(stderr, "[ERROR]: The breakpoint at %06X is past the end of SIC memory.\n", address);
+		return NULL;
+	}
+	sim_debug* debug = debugOf(machine);
+	if (!debug) return NULL;
+
+	set = set != 0;
+	if (debug->breakpoints[address] == set) return machine;
+	debug->breakpoints[address] = set;
+	if (set) debug->numBreakpoints++;
+	else debug->numBreakpoints--;
+
+	// the entry of the instruction and of any superinstruction over it are decoded again, with the trap or without it
+	invalidate(machine->decoded + SIM_DECODE_GUARD, address, SIC_BYTE);
+	return machine;
+}
+
+sic_machine* setWatchpoint(sic_machine* machine, uint32_t address, uint32_t len, uint8_t kinds)
+{
+	if ((uint64_t)address + len > SIM_MEMORY_SIZE || len == 0)
+	{
+		fprintf(stderr, "[ERROR]: The watchpoint of %u bytes at %06X is not inside SIC memory.\n", len, address);
+		return NULL;
+	}
+	sim_debug* debug = debugOf(machine);
+	if (!debug) return NULL;
+
+	// superinstructions skip the checks, so they are all decoded again as single instructions when the first byte is watched
+	if (debug->numWatched == 0 && kinds) memset(machine->decoded, 0, sizeof(machine->decoded));
+
+	kinds &= SIM_WATCH_READ | SIM_WATCH_WRITE;
+	for (uint32_t at = address; at < address + len; at++)
+	{
+		debug->numWatched += (kinds != 0) - (debug->watches[at] != 0);
+		debug->watches[at] = kinds;
+	}
+
+	// a page stays flagged while any of its bytes is watched
+	for (uint32_t page = address >> SIM_WATCH_PAGE_BITS; page <= (address + len - 1) >> SIM_WATCH_PAGE_BITS; page++)
+	{
+		uint8_t flagged = 0;
+		for (uint32_t at = page << SIM_WATCH_PAGE_BITS; at < (page + 1) << SIM_WATCH_PAGE_BITS && !flagged; at++)
+			flagged = debug->watches[at] != 0;
+		if (flagged) debug->watchPages[page / 64] |= (uint64_t)1 << (page % 64);
+		else debug->watchPages[page / 64] &= ~((uint64_t)1 << (page % 64));
+	}
+	return machine;
+}
+
+const char* simStatusName(sim_status status)
+{
+	switch (status)
+	{
+	case SIM_RUNNING:				return "running";
+	case SIM_HALTED:				return "halted";
+	case SIM_RETURNED:				return "returned";
+	case SIM_BREAKPOINT:			return "breakpoint";
+	case SIM_WATCHPOINT:			return "watchpoint";
+	case SIM_LIMIT:					return "instruction limit";
+	case SIM_ILLEGAL_INSTRUCTION:	return "illegal instruction";
+	case SIM_MEMORY_FAULT:			return "memory fault";
+	case SIM_PC_FAULT:				return "pc fault";
+	case SIM_DIVIDE_BY_ZERO:		return "divide by zero";
+	}
+	return "unknown";
+}
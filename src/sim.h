@@ -0,0 +1,317 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SIM_H // SIC instruction set simulator
+#define SIM_H
+
+// Local includes //
+
+#include "hash_table.h"
+#include "opcode.h"
+#include "scoff.h"
+#include "image.h"
+#include "device.h"
+#include "profile.h"
+#include "record.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define SIM_MEMORY_SIZE (SIC_MEMORY_LIMIT + 1)
+#define SIM_INSTRUCTION_BYTES 3
+#define SIM_ADDRESS_MASK (SCOFF_INDEXED_BIT - 1)
+#define SIM_RETURN_ADDRESS SIC_WORD_MASK // L starts here, so the RSUB of the main routine hands control back to the simulator
+#define SIM_NUM_OPCODES 256
+#define SIM_MEMORY_PAD 1 // a word is loaded with a 4 byte read, so the last word reads one byte past memory
+#define SIM_FUSE_MAX_INSTRUCTIONS 3 // the most instructions one superinstruction stands for
+#define SIM_FUSE_MAX_BYTES (SIM_FUSE_MAX_INSTRUCTIONS * SIM_INSTRUCTION_BYTES)
+#define SIM_DECODE_GUARD (SIM_FUSE_MAX_BYTES - 1) // entries before address 0, so a store clears the entries before it without a check
+#define SIM_WATCH_PAGE_BITS 8 // a watched byte flags its 256 byte page, and only accesses to flagged pages look at the bytes
+#define SIM_NUM_WATCH_PAGES (SIM_MEMORY_SIZE >> SIM_WATCH_PAGE_BITS)
+#define SIM_WATCH_READ  0x01
+#define SIM_WATCH_WRITE 0x02
+
+// the condition code is kept in the top two bits of the low byte of SW, which is what STSW stores
+#define SIM_CC_LESS    0x00
+#define SIM_CC_EQUAL   0x40
+#define SIM_CC_GREATER 0x80
+
+// Structs and enums //
+
+/**
+ * @brief sim_op enum is the handler an instruction is predecoded to. SIM_OP_DECODE is zero so a cleared entry decodes itself the next
+ * time it runs, and SIM_OP_ILLEGAL is any opcode which is not in the SIC instruction set the simulator runs. The ops after SIM_OP_WD are
+ * superinstructions: the entry of the first instruction of the sequence runs all of them, reading the operands of the rest from their
+ * own entries.
+ */
+typedef enum
+{
+	SIM_OP_DECODE = 0,
+	SIM_OP_ILLEGAL,
+	SIM_OP_ADD,
+	SIM_OP_AND,
+	SIM_OP_COMP,
+	SIM_OP_DIV,
+	SIM_OP_J,
+	SIM_OP_JEQ,
+	SIM_OP_JGT,
+	SIM_OP_JLT,
+	SIM_OP_JSUB,
+	SIM_OP_LDA,
+	SIM_OP_LDCH,
+	SIM_OP_LDL,
+	SIM_OP_LDX,
+	SIM_OP_MUL,
+	SIM_OP_OR,
+	SIM_OP_RD,
+	SIM_OP_RSUB,
+	SIM_OP_STA,
+	SIM_OP_STCH,
+	SIM_OP_STL,
+	SIM_OP_STSW,
+	SIM_OP_STX,
+	SIM_OP_SUB,
+	SIM_OP_TD,
+	SIM_OP_TIX,
+	SIM_OP_WD,
+
+	// superinstructions, which run a common sequence of instructions with one dispatch
+	SIM_OP_LDA_ADD_STA,
+	SIM_OP_LDA_SUB_STA,
+	SIM_OP_TIX_JLT,
+	SIM_OP_COMP_JEQ,
+	SIM_OP_COMP_JGT,
+	SIM_OP_COMP_JLT,
+
+	// the trap a breakpoint patches over the entry of its instruction
+	SIM_OP_BREAK,
+	SIM_NUM_OPS
+
+} sim_op;
+
+/**
+ * @brief sim_status enum is why the simulator stopped. SIM_HALTED is a jump to itself (J *), the usual way a SIC program ends, and
+ * SIM_RETURNED is the RSUB of the main routine. SIM_BREAKPOINT and SIM_WATCHPOINT leave the PC at the instruction which hit them, before
+ * it runs. Everything after SIM_LIMIT is a fault, and the PC is left at the faulting instruction.
+ */
+typedef enum
+{
+	SIM_RUNNING = 0,
+	SIM_HALTED,
+	SIM_RETURNED,
+	SIM_BREAKPOINT,
+	SIM_WATCHPOINT,
+	SIM_LIMIT,
+	SIM_ILLEGAL_INSTRUCTION,
+	SIM_MEMORY_FAULT,
+	SIM_PC_FAULT,
+	SIM_DIVIDE_BY_ZERO
+
+} sim_status;
+
+/**
+ * @brief sim_decoded is one predecoded instruction: the handler, the 15 bit address operand, and whether it is indexed (the
+ * SCOFF_INDEXED_BIT of the operand). There is one per byte of memory so a jump to any address finds its entry directly.
+ */
+typedef struct
+{
+	uint8_t op;
+	uint8_t indexed;
+	uint16_t addr;
+
+} sim_decoded;
+
+/**
+ * @brief sim_isa is the opcode byte to handler table. It is built from the opcode table, so the opcodes come from
+ * res/sic_opcodes.txt and an instruction flagged as XE only is illegal, the same as a byte which is not an opcode at all.
+ */
+typedef struct
+{
+	uint8_t opOf[SIM_NUM_OPCODES];
+
+} sim_isa;
+
+/**
+ * @brief sim_debug is the breakpoints and watchpoints of a machine. A breakpoint is patched over the predecoded entry of its instruction,
+ * so the run only stops when it gets there and costs nothing before. The watched bytes have the kinds of access they watch, and
+ * watchPages flags the pages which have any. A run with no watched bytes loads and stores as usual, and a run with some checks the page
+ * of every load and store but only looks at the bytes of the flagged pages. A run which starts at the instruction it stopped at runs that
+ * instruction instead of stopping on it again. watchAddress and watchKind say which access hit a watchpoint.
+ */
+typedef struct
+{
+	uint8_t breakpoints[SIM_MEMORY_SIZE];
+	uint8_t watches[SIM_MEMORY_SIZE];
+	uint64_t watchPages[(SIM_NUM_WATCH_PAGES + 63) / 64];
+	uint32_t numBreakpoints;
+	uint32_t numWatched;
+	uint8_t stopped;
+	uint32_t watchAddress;
+	uint8_t watchKind;
+
+} sim_debug;
+
+/**
+ * @brief sic_machine is the state of one simulated SIC machine: the registers, the 32 KiB of memory and the predecoded instruction of
+ * every address. A store clears the entries of the instructions it overlaps, so self modifying code is decoded again before it runs.
+ * RD, WD and TD use the device whose number is the byte at their address. When fuse is set, which it is by default, common sequences
+ * of instructions are decoded into superinstructions. When profile is set, every instruction is counted in it on the way to its handler,
+ * and superinstructions are not used so each instruction is counted at its own address. debug holds the breakpoints and watchpoints,
+ * and is only set while debugging. When record is set, every instruction is recorded in the trace on the way to its handler, also
+ * without superinstructions; a recorded run does not check watchpoints.
+ */
+typedef struct
+{
+	uint32_t A;
+	uint32_t X;
+	uint32_t L;
+	uint32_t PC;
+	uint32_t SW;
+
+	uint64_t instructions;
+	uint64_t decodes;
+	sim_status status;
+	uint32_t faultAddress;
+
+	const sim_isa* isa;
+	uint8_t fuse;
+	uint8_t mapped;
+	sic_devices* devices;
+	sim_profile* profile;
+	sim_debug* debug;
+	sim_record* record;
+
+	sim_decoded decoded[SIM_DECODE_GUARD + SIM_MEMORY_SIZE + SIM_INSTRUCTION_BYTES]; // first, so every entry is aligned
+	uint8_t memory[SIM_MEMORY_SIZE + SIM_MEMORY_PAD];
+
+} sic_machine;
+
+// Function declarations //
+
+/**
+ * @brief createSimIsa is a function that builds the opcode to handler table from the opcode table. It prints an error and returns NULL
+ * if an instruction of the SIC instruction set is missing from the opcode table.
+ *
+ * NOTE: that caller needs to free the table after use with sicFree(ALLOC_OTHER, ...).
+ *
+ * @param  opTab - The opcode table from buildOpcodeTable().
+ * @return isa or NULL on error
+ */
+sim_isa* createSimIsa(const hash_table* opTab);
+
+/**
+ * @brief createMachine is a function that allocates a machine with cleared memory and registers. Its devices read stdin and write
+ * stdout until files are mapped to them with mapDevice(), and superinstructions are on.
+ *
+ * NOTE: that caller needs to free the machine after use by using freeMachine().
+ *
+ * @param  isa - The opcode to handler table, shared by every machine.
+ * @return machine or NULL on error
+ */
+sic_machine* createMachine(const sim_isa* isa);
+
+/**
+ * @brief freeMachine is a function that frees the machine and its devices, flushing what was written to them. The function returns
+ * nothing.
+ *
+ * @param  machine - The machine to free, may be NULL.
+ * @return void
+ */
+void freeMachine(sic_machine* machine);
+
+/**
+ * @brief loadMachine is a function that resets the machine and copies the image into its memory at the start address of the image.
+ * The PC is set to the entry point and L to SIM_RETURN_ADDRESS. It prints an error and returns NULL if the image does not fit in memory.
+ *
+ * @param  machine - The machine.
+ * @param  image   - The image to load.
+ * @return machine or NULL on error
+ */
+sic_machine* loadMachine(sic_machine* machine, const sic_image* image);
+
+/**
+ * @brief runMachine is a function that runs the machine until it halts, returns, faults, or has run maxInstructions more instructions.
+ * The instructions are dispatched through the predecoded entries with computed goto. It can be called again to carry on after SIM_LIMIT.
+ * A superinstruction leaves the machine exactly as running its instructions one by one would: when one of them would fault or the
+ * limit falls inside the sequence, the first instruction runs on its own handler and the rest are dispatched one at a time.
+ *
+ * @param  machine         - The machine.
+ * @param  maxInstructions - The most instructions to run, 0 for no limit.
+ * @return the status the machine stopped with
+ */
+sim_status runMachine(sic_machine* machine, uint64_t maxInstructions);
+
+/**
+ * @brief predecodeMachine is a function that decodes the entry of every address of the loaded machine, and the superinstructions
+ * when fuse is set, instead of waiting for each instruction to run. Decoding the data as instructions does no harm, since an entry is
+ * only used if the PC reaches it and a store clears it when the bytes change.
+ *
+ * @param  machine - The loaded machine.
+ * @return machine
+ */
+sic_machine* predecodeMachine(sic_machine* machine);
+
+/**
+ * @brief saveMachineTemplate is a function that copies the loaded machine, usually predecoded, into an anonymous shared memory file
+ * which createMachineFromTemplate() maps for every machine that runs the same program. It prints an error and returns -1 on error.
+ *
+ * NOTE: that caller needs to close the file once no more machines will be made from it. The machines made keep their mapping.
+ *
+ * @param  machine - The loaded machine.
+ * @return the file descriptor of the template or -1 on error
+ */
+int saveMachineTemplate(const sic_machine* machine);
+
+/**
+ * @brief createMachineFromTemplate is a function that maps a copy on write copy of the template, so machines running the same program
+ * share the pages of its memory and predecoded entries until they write to them. The machine gets its own devices, reading stdin and
+ * writing stdout.
+ *
+ * NOTE: that caller needs to free the machine after use by using freeMachine().
+ *
+ * @param  templateFd - The file from saveMachineTemplate().
+ * @return machine or NULL on error
+ */
+sic_machine* createMachineFromTemplate(int templateFd);
+
+/**
+ * @brief setBreakpoint is a function that sets or clears the breakpoint at the address. The entries which could run the instruction are
+ * cleared, so the next time it runs it is decoded into the trap, or back into itself. The machine gets its debug state the first time.
+ *
+ * @param  machine - The machine.
+ * @param  address - The address of the instruction.
+ * @param  set     - 1 to set the breakpoint, 0 to clear it.
+ * @return machine or NULL on error
+ */
+sic_machine* setBreakpoint(sic_machine* machine, uint32_t address, uint8_t set);
+
+/**
+ * @brief setWatchpoint is a function that sets the kinds of access watched on the bytes from the address, SIM_WATCH_READ,
+ * SIM_WATCH_WRITE or both, with 0 clearing them. When the first byte is watched every entry is cleared, since a superinstruction
+ * can't be watched and the entries are decoded without them while anything is watched. The machine gets its debug state the first time.
+ *
+ * @param  machine - The machine.
+ * @param  address - The first byte.
+ * @param  len     - The number of bytes.
+ * @param  kinds   - The kinds of access to watch, 0 for none.
+ * @return machine or NULL on error
+ */
+sic_machine* setWatchpoint(sic_machine* machine, uint32_t address, uint32_t len, uint8_t kinds);
+
+/**
+ * @brief simStatusName is a function that returns a short description of the status.
+ *
+ * @param  status - The status.
+ * @return the description
+ */
+const char* simStatusName(sim_status status);
+
+#endif //SIM_H
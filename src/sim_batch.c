@@ -0,0 +1,380 @@
+#include "sim_batch.h"
+#include "scoff_reader.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief sim_batch_task is the argument of a thread pool task: the batch and the index of the job to run.
+ */
+typedef struct
+{
+	sim_batch* batch;
+	uint32_t job;
+
+} sim_batch_task;
+
+/**
+ * @brief nowNs is a function that returns the monotonic clock in nanoseconds.
+ *
+ * @param  void
+ * @return the time in nanoseconds
+*/
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief isObjectFile is a function that checks if the file name ends with one of the extensions the assembler writes objects with.
+ *
+ * @param  name - The file name
+ * @return 1 if it is an object file, 0 if not
+*/
+static uint8_t isObjectFile(const char* name)
+{
+	const char* extensions[SIM_BATCH_NUM_OBJECT_EXTENSIONS] = SIM_BATCH_OBJECT_EXTENSIONS;
+	size_t len = strlen(name);
+
+	for (uint32_t i = 0; i < SIM_BATCH_NUM_OBJECT_EXTENSIONS; i++)
+	{
+		size_t extLen = strlen(extensions[i]);
+		if (len > extLen && strcmp(name + len - extLen, extensions[i]) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief addProgram is a function that adds an object file to the programs of the batch, unless the same path was added before.
+ *
+ * @param  batch - The batch
+ * @param  path  - Path to the object file
+ * @return batch on success, NULL on error
+*/
+static sim_batch* addProgram(sim_batch* batch, const char* path)
+{
+	if (getKVPair(batch->programOf, path)) return batch;
+
+	if (batch->numPrograms == batch->programCapacity)
+	{
+		uint32_t newCapacity = batch->programCapacity * 2;
+		sim_batch_program* newPrograms = (sim_batch_program*)realloc(batch->programs, newCapacity * sizeof(sim_batch_program));
+		if (!newPrograms)
+		{
+			fprintf(stderr, "[ERROR]: could not grow the batch program array.\n");
+			return NULL;
+		}
+		batch->programs = newPrograms;
+		batch->programCapacity = newCapacity;
+	}
+
+	sim_batch_program* program = &batch->programs[batch->numPrograms];
+	memset(program, 0, sizeof(sim_batch_program));
+	program->templateFd = -1;
+	program->path = (char*)malloc(strlen(path) + 1);
+	if (!program->path)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the path of a batch program.\n");
+		return NULL;
+	}
+	strcpy(program->path, path);
+
+	// the index is stored one up, since a value can't be NULL
+	if (insertKVPair(batch->programOf, path, (void*)(uintptr_t)(batch->numPrograms + 1)) != HT_OKAY)
+	{
+		fprintf(stderr, "[ERROR]: could not index the batch program \"%s\".\n", path);
+		free(program->path);
+		return NULL;
+	}
+	pthread_mutex_init(&program->lock, NULL);
+	batch->numPrograms++;
+	return batch;
+}
+
+sim_batch* createSimBatch(const sim_isa* isa, uint32_t numWorkers)
+{
+	sim_batch* batch = (sim_batch*)calloc(1, sizeof(sim_batch));
+	if (!batch)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the batch.\n");
+		return NULL;
+	}
+
+	batch->programs = (sim_batch_program*)malloc(SIM_BATCH_INITIAL_JOBS * sizeof(sim_batch_program));
+	batch->jobs = (sim_batch_job*)malloc(SIM_BATCH_INITIAL_JOBS * sizeof(sim_batch_job));
+	batch->programOf = createHashTable(0, ALLOC_OTHER);
+	if (!batch->programs || !batch->jobs || !batch->programOf)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the batch jobs.\n");
+		freeSimBatch(batch);
+		return NULL;
+	}
+
+	batch->isa = isa;
+	batch->programCapacity = SIM_BATCH_INITIAL_JOBS;
+	batch->jobCapacity = SIM_BATCH_INITIAL_JOBS;
+	batch->numWorkers = numWorkers;
+	batch->fuse = 1;
+	return batch;
+}
+
+void freeSimBatch(sim_batch* batch)
+{
+	if (!batch) return;
+
+	for (uint32_t i = 0; i < batch->numPrograms; i++)
+	{
+		if (batch->programs[i].templateFd >= 0) close(batch->programs[i].templateFd);
+		pthread_mutex_destroy(&batch->programs[i].lock);
+		free(batch->programs[i].path);
+	}
+	freeHashTable(batch->programOf);
+	free(batch->programs);
+	free(batch->jobs);
+	free(batch);
+}
+
+sim_batch* simBatchAddPath(sim_batch* batch, const char* path)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Couldn't open file path: \"%s\"\n", path);
+		return NULL;
+	}
+
+	if (!S_ISDIR(st.st_mode))
+		return addProgram(batch, path);
+
+	// only the objects directly inside the directory are run
+	DIR* dir = opendir(path);
+	if (!dir)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the directory \"%s\": %s.\n", path, strerror(errno));
+		return NULL;
+	}
+
+	char filePath[SIC_LEN_BUFFER + 1];
+	size_t dirLen = strlen(path);
+	uint8_t needsSlash = (dirLen > 0 && path[dirLen - 1] != '/');
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN) continue;
+		if (!isObjectFile(entry->d_name)) continue;
+
+		snprintf(filePath, sizeof(filePath), "%s%s%s", path, needsSlash ? "/" : "", entry->d_name);
+		if (addProgram(batch, filePath) == NULL)
+		{
+			closedir(dir);
+			return NULL;
+		}
+	}
+
+	closedir(dir);
+	return batch;
+}
+
+sim_batch* simBatchAddJobs(sim_batch* batch, const char** inputPaths, uint32_t numInputs)
+{
+	uint32_t runsEach = numInputs ? numInputs : 1;
+	uint32_t needed = batch->numJobs + batch->numPrograms * runsEach;
+	if (needed > batch->jobCapacity)
+	{
+		sim_batch_job* newJobs = (sim_batch_job*)realloc(batch->jobs, needed * sizeof(sim_batch_job));
+		if (!newJobs)
+		{
+			fprintf(stderr, "[ERROR]: could not grow the batch job array.\n");
+			return NULL;
+		}
+		batch->jobs = newJobs;
+		batch->jobCapacity = needed;
+	}
+
+	// the runs of a program are next to each other, so its template is open for as short a time as possible
+	for (uint32_t p = 0; p < batch->numPrograms; p++)
+	{
+		for (uint32_t i = 0; i < runsEach; i++)
+		{
+			sim_batch_job* job = &batch->jobs[batch->numJobs++];
+			memset(job, 0, sizeof(sim_batch_job));
+			job->program = p;
+			job->inputPath = numInputs ? inputPaths[i] : SIM_BATCH_NO_INPUT;
+		}
+		batch->programs[p].pending += runsEach;
+	}
+	return batch;
+}
+
+/**
+ * @brief loadProgram is a function that loads and predecodes the program and saves it as a template, if no run of it has yet. The
+ * function returns nothing, a program which can't be loaded is left without a template.
+ *
+ * @param  batch   - The batch
+ * @param  program - The program, whose lock is held
+ * @return void
+*/
+static void loadProgram(const sim_batch* batch, sim_batch_program* program)
+{
+	if (program->loaded) return;
+	program->loaded = 1;
+
+	scoff_object* object = mapObjectFile(program->path);
+	sic_image* image = object ? readObjectToImage(object) : NULL;
+	unmapObjectFile(object);
+	sic_machine* machine = image ? createMachine(batch->isa) : NULL;
+	if (machine && loadMachine(machine, image))
+	{
+		machine->fuse = batch->fuse;
+		predecodeMachine(machine);
+		program->templateFd = saveMachineTemplate(machine);
+	}
+	freeMachine(machine);
+	freeImage(image);
+}
+
+/**
+ * @brief runJob is a function that runs one job of the batch on a machine mapped from the template of its program. It is the thread pool
+ * task of runSimBatch, arg is a sim_batch_task. The function returns nothing, the result is stored in the job.
+ *
+ * @param  arg - The task
+ * @return void
+*/
+static void runJob(void* arg)
+{
+	sim_batch_task* task = (sim_batch_task*)arg;
+	sim_batch* batch = task->batch;
+	sim_batch_job* job = &batch->jobs[task->job];
+	sim_batch_program* program = &batch->programs[job->program];
+	uint64_t startNs = nowNs();
+
+	// the last run to map the template closes it, and the mappings keep the pages alive
+	pthread_mutex_lock(&program->lock);
+	loadProgram(batch, program);
+	sic_machine* machine = (program->templateFd >= 0) ? createMachineFromTemplate(program->templateFd) : NULL;
+	if (--program->pending == 0 && program->templateFd >= 0)
+	{
+		close(program->templateFd);
+		program->templateFd = -1;
+	}
+	pthread_mutex_unlock(&program->lock);
+
+	char outputPath[SIC_LEN_BUFFER + 1];
+	snprintf(outputPath, sizeof(outputPath), "%s/%u.out", batch->outputDir ? batch->outputDir : "", task->job);
+	if (!machine || !redirectDevices(machine->devices, job->inputPath, 0) ||
+		!redirectDevices(machine->devices, batch->outputDir ? outputPath : SIM_BATCH_NO_INPUT, 1))
+	{
+		job->outcome = SIM_BATCH_LOAD_FAILED;
+		freeMachine(machine);
+		job->elapsedNs = nowNs() - startNs;
+		return;
+	}
+	machine->devices->throttle = batch->throttle;
+
+	// the machine runs a slice at a time so the timeout is checked without reading the clock for every instruction
+	job->outcome = SIM_BATCH_FINISHED;
+	sim_status status = SIM_LIMIT;
+	while (status == SIM_LIMIT)
+	{
+		uint64_t slice = SIM_BATCH_SLICE;
+		if (batch->maxInstructions)
+		{
+			if (machine->instructions >= batch->maxInstructions) break;
+			if (batch->maxInstructions - machine->instructions < slice) slice = batch->maxInstructions - machine->instructions;
+		}
+
+		status = runMachine(machine, slice);
+		if (status == SIM_LIMIT && batch->timeoutNs && nowNs() - startNs > batch->timeoutNs)
+		{
+			job->outcome = SIM_BATCH_TIMED_OUT;
+			break;
+		}
+	}
+
+	flushDevices(machine->devices);
+	job->status = status;
+	job->instructions = machine->instructions;
+	for (uint32_t i = 0; i < DEVICE_COUNT; i++)
+	{
+		job->bytesRead += machine->devices->devices[i].bytesRead;
+		job->bytesWritten += machine->devices->devices[i].bytesWritten;
+	}
+	freeMachine(machine);
+	job->elapsedNs = nowNs() - startNs;
+}
+
+/**
+ * @brief outcomeName is a function that returns how the job ended, as shown in the table.
+ *
+ * @param  job - The job
+ * @return the description
+*/
+static const char* outcomeName(const sim_batch_job* job)
+{
+	switch (job->outcome)
+	{
+	case SIM_BATCH_PENDING:		return "not run";
+	case SIM_BATCH_TIMED_OUT:	return "timed out";
+	case SIM_BATCH_LOAD_FAILED:	return "load failed";
+	case SIM_BATCH_FINISHED:	break;
+	}
+	return simStatusName(job->status);
+}
+
+int runSimBatch(sim_batch* batch)
+{
+	if (batch->numJobs == 0)
+	{
+		fprintf(stderr, "[ERROR]: The batch has no objects to run.\n");
+		return 1;
+	}
+
+	sim_batch_task* tasks = (sim_batch_task*)malloc(batch->numJobs * sizeof(sim_batch_task));
+	thread_pool* pool = createThreadPool(batch->numWorkers);
+	if (!tasks || !pool)
+	{
+		fprintf(stderr, "[ERROR]: could not start the batch workers.\n");
+		free(tasks);
+		freeThreadPool(pool);
+		return 1;
+	}
+
+	uint64_t startNs = nowNs();
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+	{
+		tasks[i].batch = batch;
+		tasks[i].job = i;
+		if (!threadPoolSubmit(pool, runJob, &tasks[i]))
+			runJob(&tasks[i]);
+	}
+	threadPoolWait(pool);
+	uint64_t elapsedNs = nowNs() - startNs;
+	freeThreadPool(pool);
+	free(tasks);
+
+	// one row per run, then how many runs ended each way
+	uint32_t numPassed = 0;
+	uint64_t totalInstructions = 0;
+	printf("%8s  %-19s  %14s  %10s  %10s  %10s  %s\n", "run", "status", "instructions", "ms", "read", "written", "object (input)");
+	for (uint32_t i = 0; i < batch->numJobs; i++)
+	{
+		const sim_batch_job* job = &batch->jobs[i];
+		uint8_t passed = job->outcome == SIM_BATCH_FINISHED && (job->status == SIM_HALTED || job->status == SIM_RETURNED);
+		numPassed += passed;
+		totalInstructions += job->instructions;
+		printf("%8u  %-19s  %14" PRIu64 "  %10.3f  %10" PRIu64 "  %10" PRIu64 "  %s (%s)\n", i, outcomeName(job), job->instructions,
+			job->elapsedNs / 1e6, job->bytesRead, job->bytesWritten, batch->programs[job->program].path, job->inputPath);
+	}
+
+	double seconds = elapsedNs / 1e9;
+	printf("[INFO]: Ran %u program(s) %u time(s) in %.3f ms: %u halted or returned, %u did not. %.1f runs/sec, %.1f million instructions/sec.\n",
+		batch->numPrograms, batch->numJobs, elapsedNs / 1e6, numPassed, batch->numJobs - numPassed,
+		(seconds > 0) ? batch->numJobs / seconds : 0.0, (seconds > 0) ? totalInstructions / seconds / 1e6 : 0.0);
+	return (numPassed == batch->numJobs) ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SIM_BATCH_H // many simulator runs at once
+#define SIM_BATCH_H
+
+// Local includes //
+
+#include "sim.h"
+#include "hash_table.h"
+#include "thread_pool.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Defines //
+
+#define SIM_BATCH_INITIAL_JOBS 64
+#define SIM_BATCH_SLICE (1u << 20) // instructions run between two checks of the timeout
+#define SIM_BATCH_OBJECT_EXTENSIONS { ".obj", ".sbo", ".img" }
+#define SIM_BATCH_NUM_OBJECT_EXTENSIONS 3
+#define SIM_BATCH_NO_INPUT "/dev/null"
+
+// Structs and enums //
+
+/**
+ * @brief sim_batch_outcome enum is how a run of a batch ended. SIM_BATCH_FINISHED means the machine stopped by itself or at its
+ * instruction limit, and the status of the job says how.
+ */
+typedef enum
+{
+	SIM_BATCH_PENDING = 0,
+	SIM_BATCH_FINISHED,
+	SIM_BATCH_TIMED_OUT,
+	SIM_BATCH_LOAD_FAILED
+
+} sim_batch_outcome;
+
+/**
+ * @brief sim_batch_program is an object file of the batch. It is loaded and predecoded once, by the first of its runs to start, into a
+ * template every run of it maps copy on write, and the template is closed once the last run has mapped it.
+ */
+typedef struct
+{
+	char* path;
+	pthread_mutex_t lock;
+	uint8_t loaded;
+	int templateFd;
+	uint32_t pending;
+
+} sim_batch_program;
+
+/**
+ * @brief sim_batch_job is one run of a batch: a program with an input file, and what the run did.
+ */
+typedef struct
+{
+	uint32_t program;
+	const char* inputPath;
+	sim_batch_outcome outcome;
+	sim_status status;
+	uint64_t instructions;
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+	uint64_t elapsedNs;
+
+} sim_batch_job;
+
+/**
+ * @brief sim_batch holds the programs and runs of a batch and the limits of every run. maxInstructions and timeoutNs are per run, 0
+ * meaning no limit. The output of run i is written to outputDir/i.out, or thrown away if there is no outputDir.
+ */
+typedef struct
+{
+	const sim_isa* isa;
+	sim_batch_program* programs;
+	uint32_t numPrograms;
+	uint32_t programCapacity;
+	hash_table* programOf;
+	sim_batch_job* jobs;
+	uint32_t numJobs;
+	uint32_t jobCapacity;
+
+	uint32_t numWorkers;
+	uint64_t maxInstructions;
+	uint64_t timeoutNs;
+	uint8_t fuse;
+	uint32_t throttle;
+	const char* outputDir;
+
+} sim_batch;
+
+// Function declarations //
+
+/**
+ * @brief createSimBatch is a function that creates an empty batch with no limits and superinstructions on.
+ *
+ * NOTE: that caller needs to free the batch after use by using freeSimBatch().
+ *
+ * @param  isa        - The opcode to handler table.
+ * @param  numWorkers - The number of runs at once, 0 for one per online CPU.
+ * @return batch or NULL on error
+ */
+sim_batch* createSimBatch(const sim_isa* isa, uint32_t numWorkers);
+
+/**
+ * @brief freeSimBatch is a function that frees the batch. The function returns nothing.
+ *
+ * @param  batch - The batch to free, may be NULL.
+ * @return void
+ */
+void freeSimBatch(sim_batch* batch);
+
+/**
+ * @brief simBatchAddPath is a function that adds an object file to the batch, or every .obj, .sbo and .img file directly inside a
+ * directory. The same path given twice is one program. It prints an error and returns NULL if the path can't be opened.
+ *
+ * @param  batch - The batch.
+ * @param  path  - The object file or directory.
+ * @return batch or NULL on error
+ */
+sim_batch* simBatchAddPath(sim_batch* batch, const char* path);
+
+/**
+ * @brief simBatchAddJobs is a function that adds a run of every program with every input file, or one run of every program reading
+ * SIM_BATCH_NO_INPUT if there are no input files. The input paths must outlive the batch.
+ *
+ * @param  batch      - The batch, with its programs added.
+ * @param  inputPaths - The input files.
+ * @param  numInputs  - The number of input files.
+ * @return batch or NULL on error
+ */
+sim_batch* simBatchAddJobs(sim_batch* batch, const char** inputPaths, uint32_t numInputs);
+
+/**
+ * @brief runSimBatch is a function that runs every job of the batch on the thread pool and prints a table of the runs and a summary to
+ * stdout.
+ *
+ * @param  batch - The batch.
+ * @return 0 if every run halted or returned, 1 if not
+ */
+int runSimBatch(sim_batch* batch);
+
+#endif //SIM_BATCH_H
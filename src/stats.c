@@ -0,0 +1,194 @@
+#include "stats.h"
+#include <time.h>
+#include <inttypes.h>
+
+// Define constants //
+#define STATS_PHASE_NAMES { "optab_build", "directive_table_build", "pass_one", "pass_two", "object_write" }
+#define ALLOC_SUBSYSTEM_NAMES { "other", "optab", "directive_table", "symbols", "text_records", "mod_records", "list_nodes", "session" }
+
+// Global state //
+
+_Thread_local sic_stats* sicStats = NULL;
+
+/**
+ * @brief clockMs is a function that reads the given clock in milliseconds.
+ *
+ * @param  clockId - The clock to read.
+ * @return milliseconds
+*/
+static double clockMs(clockid_t clockId)
+{
+	struct timespec now;
+	clock_gettime(clockId, &now);
+	return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+void statsBegin(stats_clock* clock)
+{
+	if (!sicStats) return;
+
+	clock->wallMs = clockMs(CLOCK_MONOTONIC);
+	clock->cpuMs = clockMs(CLOCK_THREAD_CPUTIME_ID);
+	if (sicStats->perf) readPerfCounters(sicStats->perf, clock->perfCounts);
+}
+
+void statsEnd(const stats_clock* clock, stats_phase phase)
+{
+	if (!sicStats) return;
+
+	// the counters are read first so the clocks are not counted in the phase
+	if (sicStats->perf)
+	{
+		uint64_t perfCounts[PERF_NUM_COUNTERS];
+		readPerfCounters(sicStats->perf, perfCounts);
+		for (uint32_t i = 0; i < PERF_NUM_COUNTERS; i++)
+			sicStats->perfCounts[phase][i] += perfCounts[i] - clock->perfCounts[i];
+	}
+
+	sicStats->wallMs[phase] += clockMs(CLOCK_MONOTONIC) - clock->wallMs;
+	sicStats->cpuMs[phase] += clockMs(CLOCK_THREAD_CPUTIME_ID) - clock->cpuMs;
+}
+
+/**
+ * @brief printMemory is a function that prints the allocations, current and peak usage of every subsystem and of all of them together,
+ * as a table or as the body of a JSON object. The peak of the total is its own high water mark, not the sum of the peaks.
+ *
+ * @param  stats     - The stats holding the usage.
+ * @param  outStream - The stream to print to.
+ * @param  json      - 1 for JSON, 0 for the table.
+ * @return void
+*/
+static void printMemory(const sic_stats* stats, FILE* outStream, uint8_t json)
+{
+	const char* subsystemNames[ALLOC_NUM_SUBSYSTEMS] = ALLOC_SUBSYSTEM_NAMES;
+
+	if (json)
+	{
+		fprintf(outStream, "\"memory\": {");
+		for (uint32_t i = 0; i < ALLOC_NUM_SUBSYSTEMS; i++)
+			fprintf(outStream, " \"%s\": { \"allocations\": %" PRIu64 ", \"current_bytes\": %" PRIu64 ", \"peak_bytes\": %" PRIu64 " },",
+				subsystemNames[i], stats->allocCount[i], stats->allocCurrent[i], stats->allocPeak[i]);
+		fprintf(outStream, " \"total\": { \"allocations\": %" PRIu64 ", \"current_bytes\": %" PRIu64 ", \"peak_bytes\": %" PRIu64 " } }, ",
+			stats->allocations, stats->allocCurrentTotal, stats->allocPeakTotal);
+		return;
+	}
+
+	fprintf(outStream, "[INFO]: %-22s %12s %14s %14s\n", "memory", "allocations", "current bytes", "peak bytes");
+	for (uint32_t i = 0; i < ALLOC_NUM_SUBSYSTEMS; i++)
+		fprintf(outStream, "[INFO]: %-22s %12" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n", subsystemNames[i], stats->allocCount[i], stats->allocCurrent[i],
+			stats->allocPeak[i]);
+	fprintf(outStream, "[INFO]: %-22s %12" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n", "total", stats->allocations, stats->allocCurrentTotal,
+		stats->allocPeakTotal);
+}
+
+/**
+ * @brief printPerfCounters is a function that prints the counters of each phase, and their totals per source line, as a table or as the
+ * body of a JSON object. Counters which could not be opened are printed as n/a, or null in JSON.
+ *
+ * @param  stats     - The stats holding the counters.
+ * @param  outStream - The stream to print to.
+ * @param  json      - 1 for JSON, 0 for the table.
+ * @return void
+*/
+static void printPerfCounters(const sic_stats* stats, FILE* outStream, uint8_t json)
+{
+	const char* phaseNames[STATS_NUM_PHASES] = STATS_PHASE_NAMES;
+	const char* counterNames[PERF_NUM_COUNTERS] = PERF_COUNTER_NAMES;
+	uint8_t haveIPC = isPerfCounterOpen(stats->perf, PERF_CYCLES) && isPerfCounterOpen(stats->perf, PERF_INSTRUCTIONS);
+
+	uint64_t totals[PERF_NUM_COUNTERS] = { 0 };
+	for (uint32_t i = 0; i < STATS_NUM_PHASES; i++)
+		for (uint32_t j = 0; j < PERF_NUM_COUNTERS; j++)
+			totals[j] += stats->perfCounts[i][j];
+
+	if (json)
+	{
+		fprintf(outStream, "\"perf\": { \"phases\": {");
+		for (uint32_t i = 0; i < STATS_NUM_PHASES; i++)
+		{
+			const uint64_t* counts = stats->perfCounts[i];
+			fprintf(outStream, "%s \"%s\": {", i ? "," : "", phaseNames[i]);
+			for (uint32_t j = 0; j < PERF_NUM_COUNTERS; j++)
+			{
+				if (isPerfCounterOpen(stats->perf, j)) fprintf(outStream, " \"%s\": %" PRIu64 ",", counterNames[j], counts[j]);
+				else fprintf(outStream, " \"%s\": null,", counterNames[j]);
+			}
+			if (haveIPC && counts[PERF_CYCLES]) fprintf(outStream, " \"ipc\": %.3f }", (double)counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES]);
+			else fprintf(outStream, " \"ipc\": null }");
+		}
+		fprintf(outStream, " }, \"per_line\": {");
+		for (uint32_t j = 0; j < PERF_NUM_COUNTERS; j++)
+		{
+			if (isPerfCounterOpen(stats->perf, j) && stats->lines)
+				fprintf(outStream, "%s \"%s\": %.3f", j ? "," : "", counterNames[j], (double)totals[j] / stats->lines);
+			else fprintf(outStream, "%s \"%s\": null", j ? "," : "", counterNames[j]);
+		}
+		fprintf(outStream, " } }, ");
+		return;
+	}
+
+	fprintf(outStream, "[INFO]: %-22s %14s %14s %6s %12s %13s %11s\n", "phase", "cycles", "instructions", "IPC", "cache misses", "branch misses",
+		"page faults");
+	for (uint32_t i = 0; i <= STATS_NUM_PHASES; i++)
+	{
+		const uint64_t* counts = (i < STATS_NUM_PHASES) ? stats->perfCounts[i] : totals;
+		const int widths[PERF_NUM_COUNTERS] = { 14, 14, 12, 13, 11 };
+		char cells[PERF_NUM_COUNTERS][24];
+		for (uint32_t j = 0; j < PERF_NUM_COUNTERS; j++)
+		{
+			if (isPerfCounterOpen(stats->perf, j)) snprintf(cells[j], sizeof(cells[j]), "%" PRIu64, counts[j]);
+			else snprintf(cells[j], sizeof(cells[j]), "n/a");
+		}
+		char ipc[16] = "n/a";
+		if (haveIPC && counts[PERF_CYCLES]) snprintf(ipc, sizeof(ipc), "%.3f", (double)counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES]);
+
+		fprintf(outStream, "[INFO]: %-22s %*s %*s %6s %*s %*s %*s\n", (i < STATS_NUM_PHASES) ? phaseNames[i] : "total", widths[0], cells[0],
+			widths[1], cells[1], ipc, widths[2], cells[2], widths[3], cells[3], widths[4], cells[4]);
+	}
+
+	fprintf(outStream, "[INFO]: Per source line:");
+	for (uint32_t j = 0; j < PERF_NUM_COUNTERS; j++)
+	{
+		if (isPerfCounterOpen(stats->perf, j) && stats->lines)
+			fprintf(outStream, "%s %.3f %s", j ? "," : "", (double)totals[j] / stats->lines, counterNames[j]);
+		else fprintf(outStream, "%s n/a %s", j ? "," : "", counterNames[j]);
+	}
+	fprintf(outStream, ".\n");
+}
+
+void printStats(const sic_stats* stats, FILE* outStream, uint8_t json)
+{
+	const char* phaseNames[STATS_NUM_PHASES] = STATS_PHASE_NAMES;
+	double probesPerLookup = stats->htLookups ? (double)stats->htLookupProbes / stats->htLookups : 0.0;
+	double probesPerInsert = stats->htInserts ? (double)stats->htInsertProbes / stats->htInserts : 0.0;
+
+	if (json)
+	{
+		fprintf(outStream, "{ \"phases\": {");
+		for (uint32_t i = 0; i < STATS_NUM_PHASES; i++)
+			fprintf(outStream, "%s \"%s\": { \"wall_ms\": %.3f, \"cpu_ms\": %.3f }", i ? "," : "", phaseNames[i], stats->wallMs[i], stats->cpuMs[i]);
+		fprintf(outStream, " }, \"lines\": %" PRIu64 ", \"tokens\": %" PRIu64 ", \"symbols\": %" PRIu64 ", \"text_records\": %" PRIu64
+			", \"mod_records\": %" PRIu64 ", \"bytes_written\": %" PRIu64 ", ", stats->lines, stats->tokens, stats->symbols, stats->textRecords,
+			stats->modRecords, stats->bytesWritten);
+		fprintf(outStream, "\"hash_table\": { \"lookups\": %" PRIu64 ", \"probes_per_lookup\": %.3f, \"inserts\": %" PRIu64 ", \"probes_per_insert\": %.3f, "
+			"\"max_probe\": %" PRIu64 ", \"resizes\": %" PRIu64 " }, ", stats->htLookups, probesPerLookup, stats->htInserts, probesPerInsert,
+			stats->htMaxProbe, stats->htResizes);
+		printMemory(stats, outStream, json);
+		if (stats->perf) printPerfCounters(stats, outStream, json);
+		fprintf(outStream, "\"allocations\": %" PRIu64 ", \"allocated_bytes\": %" PRIu64 " }\n", stats->allocations, stats->allocatedBytes);
+		return;
+	}
+
+	fprintf(outStream, "[INFO]: %-22s %10s %10s\n", "phase", "wall ms", "cpu ms");
+	for (uint32_t i = 0; i < STATS_NUM_PHASES; i++)
+		fprintf(outStream, "[INFO]: %-22s %10.3f %10.3f\n", phaseNames[i], stats->wallMs[i], stats->cpuMs[i]);
+	fprintf(outStream, "[INFO]: %" PRIu64 " line(s), %" PRIu64 " token(s), %" PRIu64 " symbol(s), %" PRIu64 " T record(s), %" PRIu64
+		" M record(s), %" PRIu64 " byte(s) written.\n", stats->lines, stats->tokens, stats->symbols, stats->textRecords, stats->modRecords,
+		stats->bytesWritten);
+	fprintf(outStream, "[INFO]: Hash tables: %" PRIu64 " lookup(s) at %.3f probes each, %" PRIu64 " insert(s) at %.3f probes each, max probe %"
+		PRIu64 ", %" PRIu64 " resize(s).\n", stats->htLookups, probesPerLookup, stats->htInserts, probesPerInsert, stats->htMaxProbe,
+		stats->htResizes);
+	fprintf(outStream, "[INFO]: %" PRIu64 " allocation(s), %" PRIu64 " byte(s).\n", stats->allocations, stats->allocatedBytes);
+	printMemory(stats, outStream, json);
+	if (stats->perf) printPerfCounters(stats, outStream, json);
+}
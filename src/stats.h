@@ -0,0 +1,150 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef STATS_H
+#define STATS_H
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// local includes //
+#include "perf_counters.h"
+
+// Defines //
+
+/*
+ * The counters only cost a load and a branch which is never taken while sicStats is NULL, which it is unless --stats was given.
+ * Building with -DSIC_NO_STATS removes them entirely.
+ */
+#ifdef SIC_NO_STATS
+#define STATS_ADD(field, amount) ((void)0)
+#define STATS_MAX(field, value) ((void)0)
+#else
+#define STATS_ADD(field, amount) do { if (__builtin_expect(sicStats != NULL, 0)) sicStats->field += (amount); } while (0)
+#define STATS_MAX(field, value) do { if (__builtin_expect(sicStats != NULL, 0) && (uint64_t)(value) > sicStats->field) sicStats->field = (value); } while (0)
+#endif //SIC_NO_STATS
+
+// Structs and enums //
+
+/**
+ * @brief stats_phase enum is the steps of an assembly which are timed.
+ */
+typedef enum
+{
+	STATS_PHASE_OPTAB = 0,
+	STATS_PHASE_DIRECTIVES,
+	STATS_PHASE_PASS_ONE,
+	STATS_PHASE_PASS_TWO,
+	STATS_PHASE_WRITE,
+	STATS_NUM_PHASES
+
+} stats_phase;
+
+/**
+ * @brief alloc_subsystem enum is what an allocation is charged to. ALLOC_OTHER is zero so a zeroed struct starts out with it.
+ */
+typedef enum
+{
+	ALLOC_OTHER = 0,
+	ALLOC_OPTAB,
+	ALLOC_DIRECTIVES,
+	ALLOC_SYMBOLS,
+	ALLOC_TEXT_RECORDS,
+	ALLOC_MOD_RECORDS,
+	ALLOC_LIST_NODES,
+	ALLOC_SESSION,
+	ALLOC_NUM_SUBSYSTEMS
+
+} alloc_subsystem;
+
+/**
+ * @brief sic_stats struct holds the times of each phase in milliseconds and the counters of the hot paths. Probes are the slots of a
+ * hash table looked at, so a lookup which finds its key in the first slot is one probe. Allocations count every malloc, calloc and realloc
+ * made through alloc.h and the bytes they asked for. The current and peak usage of each subsystem are in usable bytes, which is what
+ * malloc really handed out. When perf is set the hardware counters are read around each phase as well.
+ */
+typedef struct {
+
+	double wallMs[STATS_NUM_PHASES];
+	double cpuMs[STATS_NUM_PHASES];
+
+	uint64_t lines;
+	uint64_t tokens;
+	uint64_t symbols;
+	uint64_t textRecords;
+	uint64_t modRecords;
+	uint64_t bytesWritten;
+
+	uint64_t htLookups;
+	uint64_t htLookupProbes;
+	uint64_t htMaxProbe;
+	uint64_t htInserts;
+	uint64_t htInsertProbes;
+	uint64_t htResizes;
+
+	uint64_t allocations;
+	uint64_t allocatedBytes;
+	uint64_t allocCount[ALLOC_NUM_SUBSYSTEMS];
+	uint64_t allocCurrent[ALLOC_NUM_SUBSYSTEMS];
+	uint64_t allocPeak[ALLOC_NUM_SUBSYSTEMS];
+	uint64_t allocCurrentTotal;
+	uint64_t allocPeakTotal;
+
+	perf_counters* perf;
+	uint64_t perfCounts[STATS_NUM_PHASES][PERF_NUM_COUNTERS];
+
+} sic_stats;
+
+/**
+ * @brief stats_clock struct is the wall and CPU clocks, and the counters, when a phase began.
+ */
+typedef struct {
+
+	double wallMs;
+	double cpuMs;
+	uint64_t perfCounts[PERF_NUM_COUNTERS];
+
+} stats_clock;
+
+// Global state //
+
+/* @brief the stats of the assembly running on this thread, NULL when they are not collected */
+extern _Thread_local sic_stats* sicStats;
+
+// Function declarations //
+
+/**
+ * @brief statsBegin is a function that reads the clocks at the start of a phase. It does nothing when stats are not collected.
+ *
+ * @param  clock - Set to the current clocks.
+ * @return void
+ */
+void statsBegin(stats_clock* clock);
+
+/**
+ * @brief statsEnd is a function that adds the time since statsBegin to the given phase. It does nothing when stats are not collected.
+ *
+ * @param  clock - The clocks from statsBegin.
+ * @param  phase - The phase which ended.
+ * @return void
+ */
+void statsEnd(const stats_clock* clock, stats_phase phase);
+
+/**
+ * @brief printStats is a function that prints the stats as a table, or as one JSON object, to the given stream. The memory of every subsystem
+ * is printed with its allocations, current and peak usage. The counters of each phase are printed too when they were collected, with the
+ * instructions per cycle and the misses per source line.
+ *
+ * @param  stats     - The stats to print.
+ * @param  outStream - The stream to print to.
+ * @param  json      - 1 for JSON, 0 for the table.
+ * @return void
+ */
+void printStats(const sic_stats* stats, FILE* outStream, uint8_t json);
+
+#endif //STATS_H
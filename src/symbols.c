@@ -0,0 +1,230 @@
+#include "symbols.h"
+#include "hash_table.h"
+
+/**
+ * @brief putU32 is a function that stores the value as a 32 bit little endian integer.
+ *
+ * @param  bytes - Where to store it
+ * @param  value - The value
+ * @return void
+*/
+static void putU32(uint8_t* bytes, uint32_t value)
+{
+	for (uint32_t i = 0; i < 4; i++)
+		bytes[i] = (value >> (8 * i)) & 0xFF;
+}
+
+/**
+ * @brief getU32 is a function that loads a 32 bit little endian integer.
+ *
+ * @param  bytes - Where it is stored
+ * @return the value
+*/
+static uint32_t getU32(const uint8_t* bytes)
+{
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/**
+ * @brief hashName is a function that hashes a symbol name with 32 bit FNV-1a, which the buckets of the map are found with.
+ *
+ * @param  name - The name, at most SYMBOLS_NAME_LEN characters are hashed
+ * @return the hash
+*/
+static uint32_t hashName(const char* name)
+{
+	uint32_t hash = SYMBOLS_FNV_OFFSET;
+	for (uint32_t i = 0; i < SYMBOLS_NAME_LEN && name[i] != '\0'; i++)
+		hash = (hash ^ (uint8_t)name[i]) * SYMBOLS_FNV_PRIME;
+	return hash;
+}
+
+/**
+ * @brief compareEntries is a function that orders entries by address and then by line for qsort.
+ *
+ * @param  a - The first entry
+ * @param  b - The second entry
+ * @return less than, equal to or greater than 0 as a goes before, with or after b
+*/
+static int compareEntries(const void* a, const void* b)
+{
+	const sic_symbol_entry* first = (const sic_symbol_entry*)a;
+	const sic_symbol_entry* second = (const sic_symbol_entry*)b;
+	if (first->address != second->address) return (first->address > second->address) ? 1 : -1;
+	return (first->line > second->line) - (first->line < second->line);
+}
+
+const symbol_table* writeSymbolMapToFile(const symbol_table* symTab, const char* fileName)
+{
+	// name the map the way writeSCOFFToFile names the object, with the .syms extension
+	const char* folder = strrchr(fileName, '\\');
+	if (folder++) fileName = folder;
+
+	uint32_t numSymbols = symTab->ht->numElements;
+	uint32_t numBuckets = 1;
+	while (numBuckets < 2 * numSymbols) numBuckets <<= 1;
+	size_t fileBytes = SYMBOLS_HEADER_LEN + (size_t)numSymbols * sizeof(sic_symbol_entry) + (size_t)numBuckets * sizeof(uint32_t);
+
+	size_t bufferBytes = strlen(fileName) + SYMBOLS_EXTENSION_LEN + 1;
+	char* buffer = (char*)sicMalloc(ALLOC_OTHER, bufferBytes);
+	sic_symbol_entry* entries = (sic_symbol_entry*)sicCalloc(ALLOC_SYMBOLS, numSymbols + 1, sizeof(sic_symbol_entry));
+	uint8_t* file = (uint8_t*)sicCalloc(ALLOC_SYMBOLS, 1, fileBytes);
+	if (!buffer || !entries || !file)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc temporary buffer during ouput of the symbol map to file.\n");
+		sicFree(ALLOC_OTHER, buffer);
+		sicFree(ALLOC_SYMBOLS, entries);
+		sicFree(ALLOC_SYMBOLS, file);
+		return NULL;
+	}
+	strcpy(buffer, fileName);
+	strcat(buffer, SYMBOLS_EXTENSION);
+
+	// gather the symbols out of the hash table and sort them by address
+	uint32_t numEntries = 0;
+	for (uint32_t i = 0; i < symTab->ht->currentSize && numEntries < numSymbols; i++)
+	{
+		if (symTab->ht->p_KVArray[i].key == NULL) continue;
+		const sic_symbol* symbol = (const sic_symbol*)symTab->ht->p_KVArray[i].value;
+		strncpy(entries[numEntries].name, symTab->ht->p_KVArray[i].key, SIC_MAX_SYMBOL_LEN);
+		entries[numEntries].address = symbol->address;
+		entries[numEntries++].line = symbol->line;
+	}
+	qsort(entries, numEntries, sizeof(sic_symbol_entry), compareEntries);
+
+	// the header, the entries, then the buckets, every bucket empty until its entry is placed
+	memcpy(file, SYMBOLS_MAGIC, SYMBOLS_MAGIC_LEN);
+	file[SYMBOLS_MAGIC_LEN] = SYMBOLS_VERSION;
+	putU32(file + 8, numEntries);
+	putU32(file + 12, numBuckets);
+	uint8_t* entryBytes = file + SYMBOLS_HEADER_LEN;
+	uint8_t* bucketBytes = entryBytes + (size_t)numSymbols * sizeof(sic_symbol_entry);
+	memset(bucketBytes, 0xFF, (size_t)numBuckets * sizeof(uint32_t));
+	for (uint32_t i = 0; i < numEntries; i++)
+	{
+		uint8_t* entry = entryBytes + (size_t)i * sizeof(sic_symbol_entry);
+		memcpy(entry, entries[i].name, SYMBOLS_NAME_LEN);
+		putU32(entry + SYMBOLS_NAME_LEN, entries[i].address);
+		putU32(entry + SYMBOLS_NAME_LEN + 4, entries[i].line);
+
+		uint32_t bucket = hashName(entries[i].name) & (numBuckets - 1);
+		while (getU32(bucketBytes + (size_t)bucket * sizeof(uint32_t)) != SYMBOLS_EMPTY_BUCKET)
+			bucket = (bucket + 1) & (numBuckets - 1);
+		putU32(bucketBytes + (size_t)bucket * sizeof(uint32_t), i);
+	}
+
+	const symbol_table* written = symTab;
+	FILE* outFile = fopen(buffer, "wb");
+	if (!outFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode to output the symbol map.\n", buffer);
+		written = NULL;
+	}
+	else
+	{
+		size_t wrote = fwrite(file, 1, fileBytes, outFile);
+		if (fclose(outFile) != 0 || wrote != fileBytes)
+		{
+			fprintf(stderr, "[ERROR]: Could not write the symbol map file \"%s\".\n", buffer);
+			written = NULL;
+		}
+	}
+
+	sicFree(ALLOC_OTHER, buffer);
+	sicFree(ALLOC_SYMBOLS, entries);
+	sicFree(ALLOC_SYMBOLS, file);
+	return written;
+}
+
+uint8_t isSymbolMap(const uint8_t* data, size_t len)
+{
+	return len >= SYMBOLS_MAGIC_LEN && memcmp(data, SYMBOLS_MAGIC, SYMBOLS_MAGIC_LEN) == 0;
+}
+
+sic_symbol_map* openSymbolMap(const uint8_t* data, size_t len)
+{
+	if (!isSymbolMap(data, len))
+	{
+		fprintf(stderr, "[ERROR : 0]: The file is not a symbol map, it does not start with \"%s\".\n", SYMBOLS_MAGIC);
+		return NULL;
+	}
+	if (len < SYMBOLS_HEADER_LEN || data[SYMBOLS_MAGIC_LEN] != SYMBOLS_VERSION)
+	{
+		fprintf(stderr, "[ERROR : %d]: The symbol map is version %u or cut short, only version %d can be read.\n", SYMBOLS_MAGIC_LEN,
+			data[SYMBOLS_MAGIC_LEN], SYMBOLS_VERSION);
+		return NULL;
+	}
+
+	uint32_t numSymbols = getU32(data + 8);
+	uint32_t numBuckets = getU32(data + 12);
+	uint64_t expected = SYMBOLS_HEADER_LEN + (uint64_t)numSymbols * sizeof(sic_symbol_entry) + (uint64_t)numBuckets * sizeof(uint32_t);
+	if (numBuckets == 0 || (numBuckets & (numBuckets - 1)) != 0 || numBuckets < numSymbols || expected != len)
+	{
+		fprintf(stderr, "[ERROR : 8]: The symbol map is not valid, its %u symbols and %u buckets do not fit its %zu bytes.\n", numSymbols,
+			numBuckets, len);
+		return NULL;
+	}
+	if (((uintptr_t)data & (sizeof(uint32_t) - 1)) != 0)
+	{
+		fprintf(stderr, "[ERROR]: The symbol map has to be read from 4 byte aligned memory.\n");
+		return NULL;
+	}
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	fprintf(stderr, "[ERROR]: The symbol map is little endian and is read in place, which needs a little endian machine.\n");
+	return NULL;
+#endif //__BYTE_ORDER__
+
+	sic_symbol_map* map = (sic_symbol_map*)sicMalloc(ALLOC_SYMBOLS, sizeof(sic_symbol_map));
+	if (!map)
+	{
+		fprintf(stderr, "[ERROR]: Could not malloc the symbol map.\n");
+		return NULL;
+	}
+	map->entries = (const sic_symbol_entry*)(data + SYMBOLS_HEADER_LEN);
+	map->buckets = (const uint32_t*)(data + SYMBOLS_HEADER_LEN + (size_t)numSymbols * sizeof(sic_symbol_entry));
+	map->numSymbols = numSymbols;
+	map->numBuckets = numBuckets;
+	return map;
+}
+
+void freeSymbolMap(sic_symbol_map* map)
+{
+	sicFree(ALLOC_SYMBOLS, map);
+}
+
+const sic_symbol_entry* findSymbolByName(const sic_symbol_map* map, const char* name)
+{
+	if (strlen(name) > SIC_MAX_SYMBOL_LEN) return NULL;
+
+	// a full table has no empty bucket to stop at, so at most every bucket is probed once
+	uint32_t bucket = hashName(name) & (map->numBuckets - 1);
+	for (uint32_t probes = 0; probes < map->numBuckets; probes++)
+	{
+		uint32_t index = map->buckets[bucket];
+		if (index == SYMBOLS_EMPTY_BUCKET || index >= map->numSymbols) return NULL;
+		if (strncmp(map->entries[index].name, name, SYMBOLS_NAME_LEN) == 0)
+			return (map->entries[index].name[SYMBOLS_NAME_LEN - 1] == '\0') ? &map->entries[index] : NULL;
+		bucket = (bucket + 1) & (map->numBuckets - 1);
+	}
+	return NULL;
+}
+
+uint32_t findFirstSymbolFrom(const sic_symbol_map* map, uint32_t address)
+{
+	uint32_t low = 0, high = map->numSymbols;
+	while (low < high)
+	{
+		uint32_t mid = low + (high - low) / 2;
+		if (map->entries[mid].address < address) low = mid + 1;
+		else high = mid;
+	}
+	return low;
+}
+
+const sic_symbol_entry* findSymbolByAddress(const sic_symbol_map* map, uint32_t address)
+{
+	uint32_t low = findFirstSymbolFrom(map, address);
+	if (low == map->numSymbols || map->entries[low].address != address || map->entries[low].name[SYMBOLS_NAME_LEN - 1] != '\0')
+		return NULL;
+	return &map->entries[low];
+}
@@ -0,0 +1,138 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef SYMBOLS_H // binary symbol map written by the assembler and read in place
+#define SYMBOLS_H
+
+// Local includes //
+
+#include "sic.h"
+#include "alloc.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define SYMBOLS_MAGIC "SICS"
+#define SYMBOLS_MAGIC_LEN 4
+#define SYMBOLS_VERSION 1
+#define SYMBOLS_EXTENSION ".syms"
+#define SYMBOLS_EXTENSION_LEN 5
+#define SYMBOLS_HEADER_LEN 16
+#define SYMBOLS_NAME_LEN (SIC_MAX_SYMBOL_LEN + 2) // the name and its NUL, padded so an entry is 16 bytes
+#define SYMBOLS_EMPTY_BUCKET 0xFFFFFFFF
+#define SYMBOLS_FNV_OFFSET 2166136261u
+#define SYMBOLS_FNV_PRIME 16777619u
+
+// Structs and enums //
+
+/**
+ * @brief sic_symbol_entry is a symbol as it is stored in the symbol map, its name padded with NULs, its address and the source line
+ * which defined it.
+ */
+typedef struct
+{
+	char name[SYMBOLS_NAME_LEN];
+	uint32_t address;
+	uint32_t line;
+
+} sic_symbol_entry;
+
+/**
+ * @brief sic_symbol_map is a symbol map read in place, so opening one does not depend on how many symbols it has. The entries and
+ * buckets point into the data of the file.
+ *
+ * The .syms file is, in order, with every integer 32 bit little endian:
+ *   magic "SICS", a version byte and 3 zero bytes,
+ *   the number of symbols and the number of buckets, a power of two at least twice the number of symbols,
+ *   the entries, 16 bytes each, sorted by address and then by line,
+ *   and the buckets, each the index of an entry or SYMBOLS_EMPTY_BUCKET. A name hashes with 32 bit FNV-1a to its first bucket, and the
+ *   buckets after it are probed in turn until its entry or an empty bucket.
+ */
+typedef struct
+{
+	const sic_symbol_entry* entries;
+	const uint32_t* buckets;
+	uint32_t numSymbols;
+	uint32_t numBuckets;
+
+} sic_symbol_map;
+
+// Function declarations //
+
+/**
+ * @brief writeSymbolMapToFile is a function that writes the symbols of the table to the .syms file named after the source file, which is
+ * the file name with the .syms extension, the same way writeSCOFFToFile() names the text object.
+ *
+ * @param  symTab   - The symbol table from pass one.
+ * @param  fileName - The name of the source file.
+ * @return symTab or NULL on error
+ */
+const symbol_table* writeSymbolMapToFile(const symbol_table* symTab, const char* fileName);
+
+/**
+ * @brief isSymbolMap is a function that checks if the data starts with the magic of the symbol map.
+ *
+ * @param  data - The contents of a file.
+ * @param  len  - The length of the data.
+ * @return 1 if it is a symbol map, 0 if not
+ */
+uint8_t isSymbolMap(const uint8_t* data, size_t len);
+
+/**
+ * @brief openSymbolMap is a function that checks the header of a .syms file and that its length matches, and points a map at its entries
+ * and buckets. The entries are not read, so the map opens in the same time however many symbols it has; lookups check every index they
+ * follow and that the name they found ends in a NUL instead. The data has to outlive the map and be 4 byte aligned, which a mapped file is.
+ *
+ * NOTE: that caller needs to free the map after use by using freeSymbolMap().
+ *
+ * @param  data - The contents of the .syms file.
+ * @param  len  - The length of the data.
+ * @return map or NULL on error
+ */
+sic_symbol_map* openSymbolMap(const uint8_t* data, size_t len);
+
+/**
+ * @brief freeSymbolMap is a function that frees the map, but not the data it was opened from. The function returns nothing.
+ *
+ * @param  map - The map to free, may be NULL.
+ * @return void
+ */
+void freeSymbolMap(sic_symbol_map* map);
+
+/**
+ * @brief findSymbolByName is a function that finds the symbol with the name through the hash index.
+ *
+ * @param  map  - The map.
+ * @param  name - The name of the symbol.
+ * @return the entry or NULL if there is no such symbol
+ */
+const sic_symbol_entry* findSymbolByName(const sic_symbol_map* map, const char* name);
+
+/**
+ * @brief findFirstSymbolFrom is a function that finds the first of the sorted entries at or above the address with a binary search, so
+ * the symbols at an address, or between two addresses, are the entries from it on.
+ *
+ * @param  map     - The map.
+ * @param  address - The address.
+ * @return the index of the entry, or the number of symbols if every symbol is below the address
+ */
+uint32_t findFirstSymbolFrom(const sic_symbol_map* map, uint32_t address);
+
+/**
+ * @brief findSymbolByAddress is a function that finds the symbol at the address with a binary search of the sorted entries. When several
+ * symbols share the address the one defined first is given.
+ *
+ * @param  map     - The map.
+ * @param  address - The address.
+ * @return the entry or NULL if no symbol is at the address
+ */
+const sic_symbol_entry* findSymbolByAddress(const sic_symbol_map* map, uint32_t address);
+
+#endif //SYMBOLS_H
@@ -0,0 +1,159 @@
+#include "thread_pool.h"
+#include <unistd.h>
+
+// Define constants //
+#define THREAD_POOL_RESIZE_CONSTANT 2
+
+/**
+ * @brief workerLoop is the function every worker thread runs. It waits for a job, runs it outside of the lock,
+ * and signals allDone when the last pending job finishes. It returns once the pool is shut down and the queue is empty.
+ *
+ * @param  arg - The thread_pool* the worker belongs to
+ * @return NULL
+*/
+static void* workerLoop(void* arg)
+{
+	thread_pool* pool = (thread_pool*)arg;
+
+	pthread_mutex_lock(&pool->lock);
+	while (1)
+	{
+		while (pool->queueCount == 0 && !pool->shutdown)
+			pthread_cond_wait(&pool->jobReady, &pool->lock);
+
+		if (pool->queueCount == 0 && pool->shutdown)
+			break;
+
+		// pop the oldest job
+		thread_pool_job job = pool->queue[pool->queueHead];
+		pool->queueHead = (pool->queueHead + 1) % pool->queueCapacity;
+		pool->queueCount--;
+
+		pthread_mutex_unlock(&pool->lock);
+		job.task(job.arg);
+		pthread_mutex_lock(&pool->lock);
+
+		if (--pool->pending == 0)
+			pthread_cond_broadcast(&pool->allDone);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+thread_pool* createThreadPool(uint32_t numWorkers)
+{
+	if (numWorkers == 0)
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		numWorkers = (online > 0) ? (uint32_t)online : 1;
+	}
+
+	thread_pool* pool = (thread_pool*)malloc(sizeof(thread_pool));
+	if (!pool)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the thread pool.\n");
+		return NULL;
+	}
+	memset(pool, 0, sizeof(thread_pool));
+
+	pool->queueCapacity = THREAD_POOL_QUEUE_SIZE;
+	pool->queue = (thread_pool_job*)malloc(pool->queueCapacity * sizeof(thread_pool_job));
+	pool->workers = (pthread_t*)malloc(numWorkers * sizeof(pthread_t));
+	if (!pool->queue || !pool->workers)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the thread pool.\n");
+		free(pool->queue);
+		free(pool->workers);
+		free(pool);
+		return NULL;
+	}
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->jobReady, NULL);
+	pthread_cond_init(&pool->allDone, NULL);
+
+	// start the workers, keep however many started if one fails
+	for (uint32_t i = 0; i < numWorkers; i++)
+	{
+		if (pthread_create(&pool->workers[i], NULL, workerLoop, pool) != 0)
+		{
+			fprintf(stderr, "[WARN]: could only start %u of %u worker threads.\n", i, numWorkers);
+			break;
+		}
+		pool->numWorkers++;
+	}
+
+	if (pool->numWorkers == 0)
+	{
+		freeThreadPool(pool);
+		return NULL;
+	}
+
+	return pool;
+}
+
+thread_pool* threadPoolSubmit(thread_pool* pool, thread_pool_task task, void* arg)
+{
+	pthread_mutex_lock(&pool->lock);
+
+	// grow the ring buffer, unrolling it so the head starts at zero again
+	if (pool->queueCount == pool->queueCapacity)
+	{
+		uint32_t newCapacity = pool->queueCapacity * THREAD_POOL_RESIZE_CONSTANT;
+		thread_pool_job* newQueue = (thread_pool_job*)malloc(newCapacity * sizeof(thread_pool_job));
+		if (!newQueue)
+		{
+			pthread_mutex_unlock(&pool->lock);
+			fprintf(stderr, "[ERROR]: could not grow the thread pool queue.\n");
+			return NULL;
+		}
+
+		for (uint32_t i = 0; i < pool->queueCount; i++)
+			newQueue[i] = pool->queue[(pool->queueHead + i) % pool->queueCapacity];
+
+		free(pool->queue);
+		pool->queue = newQueue;
+		pool->queueCapacity = newCapacity;
+		pool->queueHead = 0;
+	}
+
+	uint32_t tail = (pool->queueHead + pool->queueCount) % pool->queueCapacity;
+	pool->queue[tail].task = task;
+	pool->queue[tail].arg = arg;
+	pool->queueCount++;
+	pool->pending++;
+
+	pthread_cond_signal(&pool->jobReady);
+	pthread_mutex_unlock(&pool->lock);
+	return pool;
+}
+
+void threadPoolWait(thread_pool* pool)
+{
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending != 0)
+		pthread_cond_wait(&pool->allDone, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+void freeThreadPool(thread_pool* pool)
+{
+	if (!pool) return;
+
+	// let the workers drain the queue then join them
+	pthread_mutex_lock(&pool->lock);
+	pool->shutdown = 1;
+	pthread_cond_broadcast(&pool->jobReady);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (uint32_t i = 0; i < pool->numWorkers; i++)
+		pthread_join(pool->workers[i], NULL);
+
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->jobReady);
+	pthread_cond_destroy(&pool->allDone);
+	free(pool->queue);
+	free(pool->workers);
+	free(pool);
+}
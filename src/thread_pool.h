@@ -0,0 +1,95 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Defines //
+
+#define THREAD_POOL_QUEUE_SIZE 64
+
+// Structs //
+
+/* @brief The thread_pool_task typedef is the function pointer type of the work submitted to a thread pool. */
+typedef void (*thread_pool_task)(void*);
+
+/**
+ * @brief thread_pool_job is a task waiting in the queue of a thread pool along with the argument it will be called with.
+ */
+typedef struct {
+	thread_pool_task task;
+	void* arg;
+} thread_pool_job;
+
+/**
+ * @brief thread_pool holds a fixed number of worker threads which pull jobs out of a shared ring buffer queue. The queue grows
+ * when it is full so submitting never blocks. pending counts the jobs which were submitted but have not finished yet.
+ */
+typedef struct {
+
+	pthread_t* workers;
+	uint32_t numWorkers;
+
+	thread_pool_job* queue;
+	uint32_t queueCapacity;
+	uint32_t queueHead;
+	uint32_t queueCount;
+	uint32_t pending;
+	uint8_t shutdown;
+
+	pthread_mutex_t lock;
+	pthread_cond_t jobReady;
+	pthread_cond_t allDone;
+
+} thread_pool;
+
+// Function declarations //
+
+/**
+ * @brief createThreadPool is a function that starts the given number of worker threads. If zero is given, one worker per online CPU is started.
+ * The function returns the pool or NULL if an error occurred.
+ *
+ * NOTE: that caller needs to free the pool after use by using freeThreadPool().
+ *
+ * @param  numWorkers - The number of threads to start.
+ * @return thread pool or NULL on error
+ */
+thread_pool* createThreadPool(uint32_t numWorkers);
+
+/**
+ * @brief threadPoolSubmit is a function that queues a task to be run by one of the workers. It returns the pool on success or NULL if the
+ * queue could not grow.
+ *
+ * @param  pool - The pool which will run the task.
+ * @param  task - The function to run.
+ * @param  arg  - The argument given to the function.
+ * @return pool on success, NULL on error
+ */
+thread_pool* threadPoolSubmit(thread_pool* pool, thread_pool_task task, void* arg);
+
+/**
+ * @brief threadPoolWait is a function that blocks until every submitted task has finished. The function returns nothing.
+ *
+ * @param  pool - The pool to wait on.
+ * @return void
+ */
+void threadPoolWait(thread_pool* pool);
+
+/**
+ * @brief freeThreadPool is a function that waits for the queued tasks to finish, joins the workers, and frees the pool.
+ *
+ * @param  pool - The pool to be freed.
+ * @return void
+ */
+void freeThreadPool(thread_pool* pool);
+
+#endif //THREAD_POOL_H
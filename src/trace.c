@@ -0,0 +1,209 @@
+#include "trace.h"
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <inttypes.h>
+
+// Global state //
+
+sic_trace* sicTrace = NULL;
+
+/* @brief the buffer the calling thread records into, and the trace it belongs to */
+static _Thread_local trace_buffer* threadBuffer = NULL;
+static _Thread_local sic_trace* threadTrace = NULL;
+
+/**
+ * @brief traceNowNs is a function that returns the monotonic clock in nanoseconds.
+ *
+ * @param  void
+ * @return current time in nanoseconds
+*/
+static uint64_t traceNowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+sic_trace* createTrace(void)
+{
+	sic_trace* trace = (sic_trace*)calloc(1, sizeof(sic_trace));
+	if (!trace)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc memory for the trace.\n");
+		return NULL;
+	}
+
+	trace->startNs = traceNowNs();
+	return trace;
+}
+
+void freeTrace(sic_trace* trace)
+{
+	if (!trace) return;
+
+	trace_buffer* buffer = trace->buffers;
+	while (buffer)
+	{
+		trace_buffer* nextBuffer = buffer->next;
+		trace_chunk* chunk = buffer->first;
+		while (chunk)
+		{
+			trace_chunk* nextChunk = chunk->next;
+			free(chunk);
+			chunk = nextChunk;
+		}
+		free(buffer);
+		buffer = nextBuffer;
+	}
+	free(trace);
+}
+
+/**
+ * @brief registerThread is a function that gives the calling thread its own buffer in the given trace. The buffer is pushed onto the list
+ * of the trace with a compare and swap, so threads registering at once never wait on each other.
+ *
+ * @param  trace - The trace
+ * @return the buffer of the thread or NULL on error
+*/
+static trace_buffer* registerThread(sic_trace* trace)
+{
+	trace_buffer* buffer = (trace_buffer*)calloc(1, sizeof(trace_buffer));
+	trace_chunk* chunk = (trace_chunk*)malloc(sizeof(trace_chunk));
+	if (!buffer || !chunk)
+	{
+		free(buffer);
+		free(chunk);
+		return NULL;
+	}
+
+	chunk->numEvents = 0;
+	chunk->next = NULL;
+	buffer->first = buffer->last = chunk;
+	buffer->tid = (uint32_t)syscall(SYS_gettid);
+	buffer->index = __atomic_fetch_add(&trace->numBuffers, 1, __ATOMIC_RELAXED);
+
+	buffer->next = __atomic_load_n(&trace->buffers, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&trace->buffers, &buffer->next, buffer, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+
+	threadBuffer = buffer;
+	threadTrace = trace;
+	return buffer;
+}
+
+void traceBegin(trace_span* span)
+{
+	if (!sicTrace) return;
+
+	span->startNs = traceNowNs();
+}
+
+void traceEnd(const trace_span* span, const char* category, const char* name, const char* detail)
+{
+	sic_trace* trace = sicTrace;
+	if (!trace) return;
+
+	uint64_t endNs = traceNowNs();
+	trace_buffer* buffer = (threadTrace == trace) ? threadBuffer : registerThread(trace);
+	if (!buffer)
+	{
+		__atomic_fetch_add(&trace->droppedEvents, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	// the last chunk is full, chain a new one
+	trace_chunk* chunk = buffer->last;
+	if (chunk->numEvents == TRACE_CHUNK_EVENTS)
+	{
+		trace_chunk* newChunk = (trace_chunk*)malloc(sizeof(trace_chunk));
+		if (!newChunk)
+		{
+			__atomic_fetch_add(&trace->droppedEvents, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		newChunk->numEvents = 0;
+		newChunk->next = NULL;
+		chunk->next = newChunk;
+		buffer->last = chunk = newChunk;
+	}
+
+	trace_event* event = &chunk->events[chunk->numEvents++];
+	event->name = name;
+	event->category = category;
+	event->detail = detail;
+	event->startNs = span->startNs - trace->startNs;
+	event->durNs = endNs - span->startNs;
+}
+
+/**
+ * @brief writeJSONString is a function that writes the given string as a quoted JSON string, escaping the characters JSON requires.
+ *
+ * @param  str       - The string
+ * @param  outStream - The stream to write to
+ * @return void
+*/
+static void writeJSONString(const char* str, FILE* outStream)
+{
+	fputc('"', outStream);
+	for (const unsigned char* ptr = (const unsigned char*)str; *ptr; ptr++)
+	{
+		if (*ptr == '"' || *ptr == '\\') fprintf(outStream, "\\%c", *ptr);
+		else if (*ptr < 0x20) fprintf(outStream, "\\u%04x", *ptr);
+		else fputc(*ptr, outStream);
+	}
+	fputc('"', outStream);
+}
+
+sic_trace* writeTrace(sic_trace* trace, const char* filePath)
+{
+	FILE* traceFile = fopen(filePath, "w");
+	if (!traceFile)
+	{
+		fprintf(stderr, "[ERROR]: Could not open the file \"%s\" in write mode.\n", filePath);
+		return NULL;
+	}
+
+	int pid = (int)getpid();
+	fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	// the tracks are numbered in the order the threads first recorded a span
+	uint8_t first = 1;
+	for (const trace_buffer* buffer = trace->buffers; buffer; buffer = buffer->next)
+	{
+		fprintf(traceFile, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%" PRIu32 ",\"args\":{\"name\":\"thread %" PRIu32 "\"}}",
+			first ? "" : ",\n", pid, buffer->tid, buffer->index);
+		fprintf(traceFile, ",\n{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":%d,\"tid\":%" PRIu32 ",\"args\":{\"sort_index\":%" PRIu32 "}}",
+			pid, buffer->tid, buffer->index);
+		first = 0;
+
+		for (const trace_chunk* chunk = buffer->first; chunk; chunk = chunk->next)
+		{
+			for (uint32_t i = 0; i < chunk->numEvents; i++)
+			{
+				const trace_event* event = &chunk->events[i];
+				fprintf(traceFile, ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f,\"cat\":\"%s\",\"name\":", pid, buffer->tid,
+					event->startNs / 1e3, event->durNs / 1e3, event->category);
+				writeJSONString(event->name, traceFile);
+				if (event->detail)
+				{
+					fprintf(traceFile, ",\"args\":{\"file\":");
+					writeJSONString(event->detail, traceFile);
+					fputc('}', traceFile);
+				}
+				fputc('}', traceFile);
+			}
+		}
+	}
+	fprintf(traceFile, "\n]}\n");
+
+	if (fclose(traceFile) != 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not write the trace to \"%s\".\n", filePath);
+		return NULL;
+	}
+
+	if (trace->droppedEvents)
+		fprintf(stderr, "[WARN]: %" PRIu64 " span(s) were dropped since they could not be stored.\n", trace->droppedEvents);
+	return trace;
+}
@@ -0,0 +1,141 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define TRACE_CHUNK_EVENTS 1024
+
+#define TRACE_CAT_FILE "file"
+#define TRACE_CAT_PHASE "phase"
+#define TRACE_CAT_IO "io"
+
+// Structs and enums //
+
+/**
+ * @brief trace_event is one finished span. The name, category and detail are not copied, so they have to outlive the trace until it is
+ * written. The detail is usually the path of the file being assembled, NULL for none.
+ */
+typedef struct {
+
+	const char* name;
+	const char* category;
+	const char* detail;
+	uint64_t startNs;
+	uint64_t durNs;
+
+} trace_event;
+
+/**
+ * @brief trace_chunk is a fixed block of events, the buffer of a thread grows by chaining more of them so no event ever moves.
+ */
+typedef struct trace_chunk {
+
+	trace_event events[TRACE_CHUNK_EVENTS];
+	uint32_t numEvents;
+	struct trace_chunk* next;
+
+} trace_chunk;
+
+/**
+ * @brief trace_buffer is the events of one thread. Only that thread writes to it, so recording takes no lock. The buffers of a trace are a
+ * list which threads push themselves onto with a compare and swap the first time they record.
+ */
+typedef struct trace_buffer {
+
+	trace_chunk* first;
+	trace_chunk* last;
+	uint32_t tid;
+	uint32_t index;
+	struct trace_buffer* next;
+
+} trace_buffer;
+
+/**
+ * @brief sic_trace holds the buffers of every thread which recorded a span and the clock the timestamps are relative to.
+ */
+typedef struct {
+
+	trace_buffer* buffers;
+	uint32_t numBuffers;
+	uint64_t startNs;
+	uint64_t droppedEvents;
+
+} sic_trace;
+
+/**
+ * @brief trace_span is the start of a span which is still open.
+ */
+typedef struct {
+
+	uint64_t startNs;
+
+} trace_span;
+
+// Global state //
+
+/* @brief the trace every thread records into, NULL when nothing is traced */
+extern sic_trace* sicTrace;
+
+// Function declarations //
+
+/**
+ * @brief createTrace is a function that allocates an empty trace which starts its clock now. The function returns the trace or NULL if
+ * an error occurred.
+ *
+ * NOTE: that caller needs to free the memory after use by using freeTrace().
+ *
+ * @param  void
+ * @return trace or NULL on error
+ */
+sic_trace* createTrace(void);
+
+/**
+ * @brief freeTrace is a function that frees the trace and the buffers of every thread. No thread may be recording into it anymore.
+ *
+ * @param  trace - The trace to be freed.
+ * @return void
+ */
+void freeTrace(sic_trace* trace);
+
+/**
+ * @brief traceBegin is a function that opens a span on the calling thread. It does nothing when nothing is traced.
+ *
+ * @param  span - Set to the start of the span.
+ * @return void
+ */
+void traceBegin(trace_span* span);
+
+/**
+ * @brief traceEnd is a function that closes a span opened by traceBegin on the same thread and records it. It does nothing when nothing
+ * is traced. A span which can't be stored is counted as dropped.
+ *
+ * @param  span     - The span from traceBegin.
+ * @param  category - TRACE_CAT_FILE, TRACE_CAT_PHASE or TRACE_CAT_IO.
+ * @param  name     - The name of the span.
+ * @param  detail   - The file the span is about, or NULL.
+ * @return void
+ */
+void traceEnd(const trace_span* span, const char* category, const char* name, const char* detail);
+
+/**
+ * @brief writeTrace is a function that writes every recorded span as a Chrome trace event file, which about:tracing and Perfetto open.
+ * Every thread is its own track. No thread may be recording into the trace anymore. It returns the trace on success or NULL on error.
+ *
+ * @param  trace    - The trace.
+ * @param  filePath - The path of the JSON file to write.
+ * @return trace on success, NULL on error
+ */
+sic_trace* writeTrace(sic_trace* trace, const char* filePath);
+
+#endif //TRACE_H
@@ -0,0 +1,221 @@
+#include "watch.h"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+// Global state //
+
+/* @brief set by the signal handler so the watch loop can stop and clean up */
+static volatile sig_atomic_t stopWatching = 0;
+
+/**
+ * @brief onStopSignal is the signal handler for SIGINT and SIGTERM. It only sets the stop flag.
+ *
+ * @param  signum - The signal number
+ * @return void
+*/
+static void onStopSignal(int signum)
+{
+	(void)signum;
+	stopWatching = 1;
+}
+
+/**
+ * @brief nowNs is a function that returns the monotonic clock in nanoseconds.
+ *
+ * @param  void
+ * @return current time in nanoseconds
+*/
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief assembleWatchJob is the thread pool task which re-assembles one changed file and times it.
+ *
+ * @param  arg - The watch_job* being assembled
+ * @return void
+*/
+static void assembleWatchJob(void* arg)
+{
+	watch_job* job = (watch_job*)arg;
+	job->startNs = nowNs();
+	job->status = assembleFile(job->assembler, job->filePath);
+	job->endNs = nowNs();
+}
+
+/**
+ * @brief rebuildPending is a function that assembles every file collected during the debounce window on the thread pool, waits for them,
+ * and reports how long each rebuild took. The pending table is emptied before returning, also when the jobs could not be allocated, in
+ * which case the changes are dropped rather than retried on every pass of the watch loop.
+ *
+ * @param  assembler - The shared assembler
+ * @param  pool      - The worker pool
+ * @param  pending   - Hash table of changed file paths to the time of their first event
+ * @return pending on success, NULL if the table could not be recreated
+*/
+static hash_table* rebuildPending(const sic_assembler* assembler, thread_pool* pool, hash_table* pending)
+{
+	uint32_t numJobs = pending->numElements;
+	watch_job* jobs = (watch_job*)calloc(numJobs, sizeof(watch_job));
+	if (!jobs)
+	{
+		fprintf(stderr, "[ERROR]: could not malloc the rebuild jobs, dropping the changes of %u file(s).\n", numJobs);
+		freeHashTableAndValues(pending);
+		return createHashTable(0, ALLOC_OTHER);
+	}
+
+	// hand every changed file to the pool
+	uint64_t batchStart = nowNs();
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < pending->currentSize; i++)
+	{
+		if (pending->p_KVArray[i].key == NULL) continue;
+
+		jobs[j].assembler = assembler;
+		jobs[j].filePath = (char*)pending->p_KVArray[i].key;
+		jobs[j].firstEventNs = *(uint64_t*)pending->p_KVArray[i].value;
+		if (threadPoolSubmit(pool, assembleWatchJob, &jobs[j]) == NULL)
+		{
+			jobs[j].status = ASM_FAILED_OPEN;
+			jobs[j].startNs = jobs[j].endNs = nowNs();
+		}
+		j++;
+	}
+	threadPoolWait(pool);
+	uint64_t batchEnd = nowNs();
+
+	// report the latency of each rebuild
+	uint32_t numFailed = 0;
+	for (j = 0; j < numJobs; j++)
+	{
+		double assembleMs = (jobs[j].endNs - jobs[j].startNs) / 1e6;
+		double sinceChangeMs = (jobs[j].endNs - jobs[j].firstEventNs) / 1e6;
+		if (jobs[j].status == ASM_OKAY)
+			printf("[INFO]: Rebuilt \"%s\" in %.3f ms (%.3f ms after the change).\n", jobs[j].filePath, assembleMs, sinceChangeMs);
+		else
+		{
+			printf("[INFO]: Failed to rebuild \"%s\" after %.3f ms.\n", jobs[j].filePath, assembleMs);
+			numFailed++;
+		}
+	}
+	printf("[INFO]: Rebuilt %u file(s), %u failed, in %.3f ms.\n", numJobs, numFailed, (batchEnd - batchStart) / 1e6);
+	fflush(stdout);
+	free(jobs);
+
+	// start a fresh window
+	freeHashTableAndValues(pending);
+	return createHashTable(0, ALLOC_OTHER);
+}
+
+int watchDirectory(const sic_assembler* assembler, const char* dirPath, uint32_t numWorkers)
+{
+	int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd < 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not initialize inotify: %s.\n", strerror(errno));
+		return 1;
+	}
+
+	// a file is ready once the writer closes it, or when an editor renames its temp file over it
+	if (inotify_add_watch(inotifyFd, dirPath, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		fprintf(stderr, "[ERROR]: Could not watch the directory \"%s\": %s.\n", dirPath, strerror(errno));
+		close(inotifyFd);
+		return 1;
+	}
+
+	thread_pool* pool = createThreadPool(numWorkers);
+	hash_table* pending = createHashTable(0, ALLOC_OTHER);
+	if (!pool || !pending)
+	{
+		freeThreadPool(pool);
+		freeHashTable(pending);
+		close(inotifyFd);
+		return 1;
+	}
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = onStopSignal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+
+	printf("[INFO]: Watching \"%s\" with %u worker(s). Press Ctrl+C to stop.\n", dirPath, pool->numWorkers);
+	fflush(stdout);
+
+	_Alignas(struct inotify_event) char events[WATCH_EVENT_BUFFER];
+	char path[SIC_LEN_BUFFER + 1];
+	uint64_t lastEventNs = 0;
+	size_t dirLen = strlen(dirPath);
+	uint8_t needsSlash = (dirLen > 0 && dirPath[dirLen - 1] != '/');
+
+	while (!stopWatching && pending)
+	{
+		// sleep until an event, or until the burst has been quiet for the debounce window
+		int timeout = -1;
+		if (pending->numElements > 0)
+		{
+			uint64_t quietMs = (nowNs() - lastEventNs) / 1000000ULL;
+			timeout = (quietMs >= WATCH_DEBOUNCE_MS) ? 0 : (int)(WATCH_DEBOUNCE_MS - quietMs);
+		}
+
+		struct pollfd pfd = { inotifyFd, POLLIN, 0 };
+		int ready = poll(&pfd, 1, timeout);
+		if (ready < 0)
+		{
+			if (errno == EINTR) continue;
+			fprintf(stderr, "[ERROR]: poll failed while watching: %s.\n", strerror(errno));
+			break;
+		}
+
+		if (ready == 0)
+		{
+			pending = rebuildPending(assembler, pool, pending);
+			continue;
+		}
+
+		// drain every queued event and collect the changed files
+		ssize_t len;
+		while ((len = read(inotifyFd, events, sizeof(events))) > 0)
+		{
+			for (char* ptr = events; ptr < events + len; )
+			{
+				const struct inotify_event* event = (const struct inotify_event*)ptr;
+				ptr += sizeof(struct inotify_event) + event->len;
+
+				if (event->len == 0 || (event->mask & IN_ISDIR) || !isAssemblySource(event->name))
+					continue;
+
+				// a truncated path would assemble some other file, so a path which does not fit is skipped
+				int pathLen = snprintf(path, sizeof(path), "%s%s%s", dirPath, needsSlash ? "/" : "", event->name);
+				if (pathLen < 0 || (size_t)pathLen >= sizeof(path))
+				{
+					fprintf(stderr, "[WARN]: Skipped \"%s\", its path is longer than %d characters.\n", event->name, SIC_LEN_BUFFER);
+					continue;
+				}
+				lastEventNs = nowNs();
+				if (getKVPair(pending, path) != NULL)
+					continue;
+
+				uint64_t* firstEvent = (uint64_t*)sicMalloc(ALLOC_OTHER, sizeof(uint64_t));
+				if (!firstEvent) continue;
+				*firstEvent = lastEventNs;
+				if (insertKVPair(pending, path, firstEvent) != HT_OKAY)
+					sicFree(ALLOC_OTHER, firstEvent);
+			}
+		}
+	}
+
+	printf("[INFO]: Stopped watching \"%s\".\n", dirPath);
+	freeHashTableAndValues(pending);
+	freeThreadPool(pool);
+	close(inotifyFd);
+	return 0;
+}
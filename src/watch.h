@@ -0,0 +1,57 @@
+// Author(s): Houman Karimi
+// Date: 10/18/2026
+// Course: COP3404
+
+#ifndef WATCH_H
+#define WATCH_H
+
+// Local includes //
+
+#include "assembler.h"
+#include "thread_pool.h"
+#include "hash_table.h"
+
+// Standard library includes //
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+// Defines //
+
+#define WATCH_DEBOUNCE_MS 100
+#define WATCH_EVENT_BUFFER 4096
+
+// Structs //
+
+/**
+ * @brief watch_job is one file that changed and is being re-assembled by a worker. It holds the time of the first change seen
+ * during the debounce window, and the time the worker spent assembling it, so the rebuild latency can be reported.
+ */
+typedef struct {
+
+	const sic_assembler* assembler;
+	char* filePath;
+	uint64_t firstEventNs;
+	uint64_t startNs;
+	uint64_t endNs;
+	assemble_status status;
+
+} watch_job;
+
+// Function declarations //
+
+/**
+ * @brief watchDirectory is a function that watches the given directory with inotify and re-assembles every .sic or .asm file that is
+ * written to it. Bursts of events are debounced, and every file that changed during the burst is assembled once on a pool of worker threads
+ * which all share the given assembler. The latency of every rebuild is printed to stdout. The function runs until SIGINT or SIGTERM.
+ *
+ * @param  assembler  - The assembler whose tables stay loaded for the whole watch.
+ * @param  dirPath    - The directory to watch.
+ * @param  numWorkers - Number of worker threads, zero for one per CPU.
+ * @return 0 on a clean exit, 1 if the watch could not be set up
+ */
+int watchDirectory(const sic_assembler* assembler, const char* dirPath, uint32_t numWorkers);
+
+#endif //WATCH_H
@@ -0,0 +1,132 @@
+#!/bin/sh
+# Author(s): Houman Karimi
+# Date: 10/18/2026
+# Course: COP3404
+# Project: Tests of the object readers, run from the root of the repo by make test. Every sample program in tests/ is assembled to a
+# text object, a binary object and an image, the readers are checked against the writers, and objects broken on purpose have to be
+# rejected with the error which names what is wrong with them.
+
+OUT_DIR=${1:-test_out}
+failures=0
+passes=0
+
+# pass and fail keep the count, the log of the command that failed is shown under it
+pass()
+{
+	passes=$((passes + 1))
+}
+
+fail()
+{
+	failures=$((failures + 1))
+	echo "[FAIL]: $1"
+	sed 's/^/        /' "$OUT_DIR/last.log"
+}
+
+# expect <description> <command...> runs the command and expects it to succeed, and returns 1 if it did not
+expect()
+{
+	description=$1
+	shift
+	if "$@" > "$OUT_DIR/last.log" 2>&1; then pass; else fail "$description"; return 1; fi
+}
+
+# same <description> <expected file> <file> expects the files to be the same byte for byte
+same()
+{
+	if cmp "$2" "$3" > "$OUT_DIR/last.log" 2>&1; then pass; else fail "$1"; fi
+}
+
+# reject <description> <message> <object> expects sic_objconv --check to fail on the object with the message
+reject()
+{
+	if ./sic_objconv --check "$3" > "$OUT_DIR/last.log" 2>&1; then
+		fail "$1 was accepted"
+	elif ! grep -q "^\[ERROR.*$2" "$OUT_DIR/last.log"; then
+		fail "$1 was not rejected with \"$2\""
+	else
+		pass
+	fi
+}
+
+if [ ! -x ./SIC_asm ] || [ ! -x ./sic_objconv ]; then
+	echo "[ERROR]: Build SIC_asm and sic_objconv first, or run make test."
+	exit 1
+fi
+rm -rf "$OUT_DIR"
+mkdir -p "$OUT_DIR"
+
+for source in tests/*.sic; do
+	name=$(basename "$source")
+	program="$OUT_DIR/$name"
+	cp "$source" "$program"
+
+	# the image replaces the object, so each format is a run of its own
+	expect "$name does not assemble to text" ./SIC_asm "$program" || continue
+	expect "$name does not assemble to binary" ./SIC_asm --format=bin "$program"
+	expect "$name does not assemble to an image" ./SIC_asm --image "$program"
+
+	# standard input goes through the session instead of the two passes over the file, and has to give the same object
+	expect "$name does not assemble from standard input" sh -c './SIC_asm - < "$1" > "$1.stdin.obj"' sh "$program"
+	same "$name assembled from standard input is not the object assembled from the file" "$program.obj" "$program.stdin.obj"
+
+	# each reader against its writer, and for text the image loaded straight from it against the one loaded from its records
+	expect "$name.obj does not round trip" ./sic_objconv --check "$program.obj"
+	expect "$name.sbo does not round trip" ./sic_objconv --check "$program.sbo"
+
+	# converting is reading one format and writing the other, so it has to give what the assembler wrote
+	expect "$name.obj does not convert to binary" ./sic_objconv --to bin "$program.obj" "$program.conv.sbo"
+	same "$name.obj converted to binary is not the assembled binary" "$program.sbo" "$program.conv.sbo"
+	expect "$name.sbo does not convert to text" ./sic_objconv --to text "$program.sbo" "$program.conv.obj"
+	same "$name.sbo converted to text is not the assembled text" "$program.obj" "$program.conv.obj"
+	expect "$name.obj does not convert to an image" ./sic_objconv --to image "$program.obj" "$program.text.img"
+	same "$name.obj loaded into an image is not the assembled image" "$program.img" "$program.text.img"
+	expect "$name.sbo does not convert to an image" ./sic_objconv --to image "$program.sbo" "$program.bin.img"
+	same "$name.sbo loaded into an image is not the assembled image" "$program.img" "$program.bin.img"
+done
+
+# batch mode with chunking lexes each source in 1 KiB chunks of sessions, which has to give the objects of the file mode too
+mkdir -p "$OUT_DIR/batch"
+cp tests/*.sic "$OUT_DIR/batch/"
+expect "The samples do not assemble with --batch --chunk-kib 1" ./SIC_asm --batch --chunk-kib 1 "$OUT_DIR/batch"
+for source in tests/*.sic; do
+	name=$(basename "$source")
+	same "$name assembled in batch mode is not the object assembled from the file" "$OUT_DIR/$name.obj" "$OUT_DIR/batch/$name.obj"
+done
+
+# the image holds the bytes of lower.sic's X'1a' and X'fF' at 100C, past the 16 byte header of an image starting at 1000
+image="$OUT_DIR/lower.sic.img"
+if [ -f "$image" ]; then
+	bytes=$(od -An -tx1 -j 28 -N 2 "$image" | tr -d ' \n')
+	echo "read $bytes" > "$OUT_DIR/last.log"
+	if [ "$bytes" = "1aff" ]; then pass; else fail "The image of lower.sic does not hold 1A FF at 100C"; fi
+else
+	failures=$((failures + 1))
+	echo "[FAIL]: tests/lower.sic did not assemble to an image."
+fi
+
+# the strict readers, on the first sample with one thing broken at a time
+object="$OUT_DIR/copy.sic.obj"
+if [ -f "$object" ]; then
+	sed '2s/.$/G/' "$object" > "$OUT_DIR/bad_hex.obj"
+	reject "A T record with a G in its object code" "not made of hex digits" "$OUT_DIR/bad_hex.obj"
+
+	sed '2s/^\(T.\{6\}\)03/\102/' "$object" > "$OUT_DIR/bad_length.obj"
+	reject "A T record with a length of 2 and 3 bytes of object code" "length does not match its object code" "$OUT_DIR/bad_length.obj"
+
+	sed '$d' "$object" > "$OUT_DIR/no_end.obj"
+	reject "An object without its E record" "has no end record" "$OUT_DIR/no_end.obj"
+
+	{ cat "$object"; printf '\nT001000'; } > "$OUT_DIR/trailing.obj"
+	reject "An object with a record after its E record" "more after the end record" "$OUT_DIR/trailing.obj"
+
+	head -c -1 "$OUT_DIR/copy.sic.sbo" > "$OUT_DIR/cut_short.sbo"
+	reject "A binary object missing its last byte" "cut short" "$OUT_DIR/cut_short.sbo"
+else
+	failures=$((failures + 1))
+	echo "[FAIL]: tests/copy.sic did not assemble, so the broken objects could not be made from it."
+fi
+
+rm -f "$OUT_DIR/last.log"
+echo "[INFO]: $passes passed, $failures failed."
+[ "$failures" -eq 0 ]